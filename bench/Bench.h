@@ -0,0 +1,90 @@
+/**
+ * @file Bench.h
+ * @brief Minimal benchmark harness
+ *
+ * Benchmarks are free functions registered with @code BENCHMARK(group, name) @endcode.
+ * Each one receives a @code BenchState @endcode, times the region it cares about with
+ * @code start @endcode and @code stop @endcode and reports the number of operations it
+ * performed. The harness prints nanoseconds per operation and millions of operations per
+ * second for every benchmark whose name contains the filter given on the command line.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BENCH_H
+#define EMBEDDEDCPLUSPLUS_BENCH_H
+
+#include <chrono>
+#include <stdint.h>
+
+namespace bench {
+
+    class BenchState {
+    public:
+        BenchState() : m_elapsed{0}, m_operations{0} {}
+
+        inline void start() {
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        inline void stop() {
+            m_elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_start).count();
+        }
+
+        inline void add_operations(uint64_t operations) {
+            m_operations += operations;
+        }
+
+        inline int64_t elapsed_ns() const {
+            return m_elapsed;
+        }
+
+        inline uint64_t operations() const {
+            return m_operations;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start;
+        int64_t m_elapsed;
+        uint64_t m_operations;
+    };
+
+    typedef void (*bench_function)(BenchState &);
+
+    /**
+     * Registers a benchmark, used through the BENCHMARK macro.
+     *
+     * @param name the full benchmark name
+     * @param function the benchmark body
+     * @return ignored, allows registration at static initialization
+     */
+    int register_benchmark(const char *name, bench_function function);
+
+    /**
+     * Runs every registered benchmark whose name contains the filter.
+     *
+     * @param filter substring to match, nullptr runs everything
+     * @return number of benchmarks run
+     */
+    int run_benchmarks(const char *filter);
+
+    /**
+     * Prevents the compiler from discarding a computed value.
+     *
+     * @param value the value to keep alive
+     */
+    template<typename T>
+    inline void do_not_optimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+}
+
+#define BENCHMARK(group, name) \
+    static void group##_##name(bench::BenchState &state); \
+    static int group##_##name##_registered = \
+            bench::register_benchmark(#group "." #name, group##_##name); \
+    static void group##_##name(bench::BenchState &state)
+
+#endif //EMBEDDEDCPLUSPLUS_BENCH_H
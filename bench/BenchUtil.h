@@ -0,0 +1,71 @@
+/**
+ * @file BenchUtil.h
+ * @brief Key generators shared by the benchmarks
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BENCHUTIL_H
+#define EMBEDDEDCPLUSPLUS_BENCHUTIL_H
+
+#include <stdint.h>
+
+namespace bench {
+
+    /**
+     * Small deterministic xorshift generator so that every run
+     * of a benchmark sees the same keys.
+     */
+    class Random {
+    public:
+        explicit Random(uint32_t seed = 2463534242u) : m_state{seed} {}
+
+        inline uint32_t next() {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    /**
+     * Integer key distributions. Strided keys are multiples of a large
+     * power of two, the worst case for reducing hash codes with a mask
+     * or a power-of-two modulus.
+     */
+    enum KeyPattern {
+        SEQUENTIAL,
+        STRIDED,
+        RANDOM
+    };
+
+    /**
+     * Fill an array with distinct keys following a pattern.
+     * @param keys    the array to fill
+     * @param n       the number of keys
+     * @param pattern the key distribution
+     */
+    inline void fill_keys(uint32_t *keys, uint32_t n, KeyPattern pattern) {
+        Random random;
+        for (uint32_t i = 0; i < n; ++i) {
+            switch (pattern) {
+                case SEQUENTIAL:
+                    keys[i] = i;
+                    break;
+                case STRIDED:
+                    keys[i] = i * 64;
+                    break;
+                case RANDOM:
+                    // xorshift does not repeat a value within its period
+                    keys[i] = random.next();
+                    break;
+            }
+        }
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BENCHUTIL_H
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "Bench.h"
+
+namespace bench {
+
+    static constexpr int MAX_BENCHMARKS = 256;
+
+    struct Registration {
+        const char *name;
+        bench_function function;
+    };
+
+    static Registration &registration(int i) {
+        static Registration registrations[MAX_BENCHMARKS];
+        return registrations[i];
+    }
+
+    static int &num_registered() {
+        static int count = 0;
+        return count;
+    }
+
+    int register_benchmark(const char *name, bench_function function) {
+        int &count = num_registered();
+        if (count < MAX_BENCHMARKS) {
+            registration(count).name = name;
+            registration(count).function = function;
+            ++count;
+        }
+        return count;
+    }
+
+    int run_benchmarks(const char *filter) {
+        int run = 0;
+        printf("%-52s %14s %12s %10s\n", "benchmark", "operations", "ns/op", "Mops/s");
+        for (int i = 0; i < num_registered(); ++i) {
+            Registration &entry = registration(i);
+            if (filter && !strstr(entry.name, filter)) {
+                continue;
+            }
+            BenchState state;
+            entry.function(state);
+            double ns = (double) state.elapsed_ns();
+            double ops = (double) state.operations();
+            printf("%-52s %14llu %12.2f %10.2f\n", entry.name,
+                   (unsigned long long) state.operations(),
+                   ops > 0 ? ns / ops : 0.0,
+                   ns > 0 ? ops * 1000.0 / ns : 0.0);
+            ++run;
+        }
+        return run;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    return bench::run_benchmarks(argc > 1 ? argv[1] : nullptr) > 0 ? 0 : 1;
+}
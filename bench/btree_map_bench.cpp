@@ -0,0 +1,118 @@
+#include <map>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/BTreeMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares B-tree maps with nodes of one and of four cache lines against
+ * std::map, a red-black tree with one node per element. Point lookups and
+ * insertions use random keys. Range queries find the first key not less
+ * than a random bound and visit the following elements in order.
+ */
+static constexpr uint32_t NUM_KEYS = 16384;
+static constexpr uint32_t RANGE = 64;
+static constexpr int ROUNDS = 16;
+
+typedef BTreeMap<uint32_t, uint32_t, Comparator<uint32_t>, 64> line_btree;
+typedef BTreeMap<uint32_t, uint32_t, Comparator<uint32_t>, 256> wide_btree;
+typedef std::map<uint32_t, uint32_t> std_map;
+
+static uint32_t keys[NUM_KEYS];
+
+template<class Map>
+static void fill(Map &map) {
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+        map[keys[i]] = i;
+    }
+}
+
+template<class Map>
+static bool contains(const Map &map, uint32_t key) {
+    return map.contains(key);
+}
+
+static bool contains(const std_map &map, uint32_t key) {
+    return map.count(key) != 0;
+}
+
+template<class Iterator>
+static uint32_t value_of(const Iterator &it) {
+    return *it;
+}
+
+static uint32_t value_of(const std_map::const_iterator &it) {
+    return it->second;
+}
+
+template<class Map>
+static void insert(bench::BenchState &state) {
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    uint32_t size = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        Map map;
+        for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+            map[keys[i]] = i;
+        }
+        size += static_cast<uint32_t>(map.size());
+    }
+    state.stop();
+    bench::do_not_optimize(size);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+template<class Map>
+static void lookup(bench::BenchState &state) {
+    Map map;
+    fill(map);
+    const Map &cmap = map;
+    bench::Random random(99u);
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+            found += contains(cmap, keys[random.next() % NUM_KEYS]);
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+template<class Map>
+static void range(bench::BenchState &state) {
+    Map map;
+    fill(map);
+    const Map &cmap = map;
+    bench::Random random(99u);
+    uint32_t sum = 0;
+    uint64_t visited = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint32_t i = 0; i < NUM_KEYS / RANGE; ++i) {
+            typename Map::const_iterator it = cmap.lower_bound(random.next());
+            for (uint32_t j = 0; j < RANGE && it != cmap.end(); ++j, ++it) {
+                sum += value_of(it);
+                ++visited;
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations(visited);
+}
+
+BENCHMARK(btree_map, insert_btree_64) { insert<line_btree>(state); }
+BENCHMARK(btree_map, insert_btree_256) { insert<wide_btree>(state); }
+BENCHMARK(btree_map, insert_std_map) { insert<std_map>(state); }
+BENCHMARK(btree_map, lookup_btree_64) { lookup<line_btree>(state); }
+BENCHMARK(btree_map, lookup_btree_256) { lookup<wide_btree>(state); }
+BENCHMARK(btree_map, lookup_std_map) { lookup<std_map>(state); }
+BENCHMARK(btree_map, range_btree_64) { range<line_btree>(state); }
+BENCHMARK(btree_map, range_btree_256) { range<wide_btree>(state); }
+BENCHMARK(btree_map, range_std_map) { range<std_map>(state); }
@@ -0,0 +1,94 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+#include "stl/Pair.h"
+
+using namespace wlp;
+
+/*
+ * Compares loading and pruning maps element by element with the
+ * bulk operations, reserve followed by a range insert and erase_if.
+ */
+static constexpr uint16_t NUM_KEYS = 768;
+static constexpr int NUM_MAPS = 64;
+
+typedef Pair<uint32_t, uint32_t> entry;
+
+static void make_entries(entry *entries) {
+    uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+        entries[i] = entry(keys[i], i);
+    }
+}
+
+/**
+ * Loads maps created with a small capacity, inserting
+ * one element at a time or the whole range at once.
+ */
+template<class Map>
+static void load(bench::BenchState &state, bool bulk) {
+    entry entries[NUM_KEYS];
+    make_entries(entries);
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < NUM_MAPS; ++r) {
+        Map map(8, 75);
+        if (bulk) {
+            map.insert(entries, entries + NUM_KEYS);
+        } else {
+            for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+                map.insert(entries[i].first(), entries[i].second());
+            }
+        }
+        sum += map.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) NUM_MAPS * NUM_KEYS);
+}
+
+/**
+ * Erases the half of the elements with odd values, either by
+ * erasing their keys one at a time or with a single erase_if.
+ */
+template<class Map>
+static void prune(bench::BenchState &state, bool bulk) {
+    entry entries[NUM_KEYS];
+    make_entries(entries);
+    uint32_t sum = 0;
+    for (int r = 0; r < NUM_MAPS; ++r) {
+        Map map(1024, 75);
+        map.insert(entries, entries + NUM_KEYS);
+        state.start();
+        if (bulk) {
+            map.erase_if([](uint32_t, uint32_t val) { return val % 2 == 1; });
+        } else {
+            for (uint16_t i = 1; i < NUM_KEYS; i = static_cast<uint16_t>(i + 2)) {
+                map.erase(entries[i].first());
+            }
+        }
+        state.stop();
+        sum += map.size();
+    }
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) NUM_MAPS * NUM_KEYS / 2);
+}
+
+typedef OpenHashMap<uint32_t, uint32_t, Hash<uint32_t, uint32_t>> open_map;
+typedef OpenHashMap<uint32_t, uint32_t, Hash<uint32_t, uint32_t>, Equal<uint32_t>,
+        PowerOfTwoIndex, RobinHoodProbe> robin_hood_map;
+typedef ChainHashMap<uint32_t, uint32_t, Hash<uint32_t, uint32_t>> chain_map;
+
+BENCHMARK(bulk_map, open_load_loop) { load<open_map>(state, false); }
+BENCHMARK(bulk_map, open_load_range) { load<open_map>(state, true); }
+BENCHMARK(bulk_map, chain_load_loop) { load<chain_map>(state, false); }
+BENCHMARK(bulk_map, chain_load_range) { load<chain_map>(state, true); }
+BENCHMARK(bulk_map, open_prune_loop) { prune<open_map>(state, false); }
+BENCHMARK(bulk_map, open_prune_erase_if) { prune<open_map>(state, true); }
+BENCHMARK(bulk_map, robin_hood_prune_loop) { prune<robin_hood_map>(state, false); }
+BENCHMARK(bulk_map, robin_hood_prune_erase_if) { prune<robin_hood_map>(state, true); }
+BENCHMARK(bulk_map, chain_prune_loop) { prune<chain_map>(state, false); }
+BENCHMARK(bulk_map, chain_prune_erase_if) { prune<chain_map>(state, true); }
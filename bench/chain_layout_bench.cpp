@@ -0,0 +1,103 @@
+#include <stdio.h>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares chained maps whose nodes are allocated one at a time and
+ * linked by pointers against maps keeping their nodes in an arena linked
+ * by 32-bit indices. The maps run at a load of two elements per bucket so
+ * that lookups walk chains. Before timing, a quarter of the elements is
+ * erased and inserted again in random order, which scatters the chains
+ * over the node memory as a long-running map would.
+ */
+static constexpr uint32_t NUM_KEYS = 2048;
+static constexpr uint32_t CAPACITY = NUM_KEYS / 2;
+static constexpr int ROUNDS = 128;
+
+typedef ChainHashMap<uint32_t, uint32_t, Hash<uint32_t, size_type>, Equal<uint32_t>,
+        ModuloIndex, NoStoredHash, FullRehash, PointerNodes> pointer_map;
+typedef ChainHashMap<uint32_t, uint32_t, Hash<uint32_t, size_type>, Equal<uint32_t>,
+        ModuloIndex, NoStoredHash, FullRehash, ArenaNodes> arena_map;
+
+template<class Map>
+static void fill(Map &map, uint32_t *keys) {
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+        map[keys[i]] = i;
+    }
+    bench::Random random;
+    for (uint32_t i = 0; i < NUM_KEYS / 4; ++i) {
+        uint32_t &key = keys[random.next() % NUM_KEYS];
+        map.erase(key);
+        map[key] = i;
+    }
+}
+
+template<class Map>
+static void lookup(bench::BenchState &state, const char *name) {
+    static uint32_t keys[NUM_KEYS];
+    Map map(CAPACITY, 255);
+    fill(map, keys);
+    printf("%s node size: %u bytes\n", name, (unsigned) sizeof(typename Map::node_type));
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+            found += map.contains(keys[i]);
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+template<class Map>
+static void iterate(bench::BenchState &state) {
+    static uint32_t keys[NUM_KEYS];
+    Map map(CAPACITY, 255);
+    fill(map, keys);
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+            sum += *it;
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+/**
+ * Erases and inserts elements in pairs, keeping the size constant.
+ */
+template<class Map>
+static void churn(bench::BenchState &state) {
+    static uint32_t keys[NUM_KEYS];
+    Map map(CAPACITY, 255);
+    fill(map, keys);
+    bench::Random random(99u);
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint32_t i = 0; i < NUM_KEYS; ++i) {
+            uint32_t &key = keys[random.next() % NUM_KEYS];
+            map.erase(key);
+            map[key] = i;
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(map.size());
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+BENCHMARK(chain_layout, lookup_pointer) { lookup<pointer_map>(state, "pointer"); }
+BENCHMARK(chain_layout, lookup_arena) { lookup<arena_map>(state, "arena"); }
+BENCHMARK(chain_layout, iterate_pointer) { iterate<pointer_map>(state); }
+BENCHMARK(chain_layout, iterate_arena) { iterate<arena_map>(state); }
+BENCHMARK(chain_layout, churn_pointer) { churn<pointer_map>(state); }
+BENCHMARK(chain_layout, churn_arena) { churn<arena_map>(state); }
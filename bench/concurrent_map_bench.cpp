@@ -0,0 +1,114 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/ConcurrentMap.h"
+
+using namespace wlp;
+
+/*
+ * YCSB style workloads over a preloaded table of records. Every thread
+ * runs the same number of operations on uniformly chosen keys; a read
+ * copies the value of a record and an update rewrites it. Workload A is
+ * half reads and half updates, B is 95% reads and C only reads.
+ *
+ * The baseline is a chained hash map behind a single mutex, the sharded
+ * map locks one of 16 shards per operation. Both are sized up front so
+ * that the timed loop never rehashes.
+ */
+static constexpr uint32_t NUM_RECORDS = 1024;
+static constexpr uint32_t OPS_PER_THREAD = 1 << 16;
+
+/**
+ * Chained hash map serialized by one mutex.
+ */
+class LockedMap {
+public:
+    LockedMap() : m_map(2 * NUM_RECORDS, 75) {}
+
+    void insert_or_assign(uint32_t key, uint32_t val) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_map.insert_or_assign(key, val);
+    }
+
+    bool find(uint32_t key, uint32_t &val) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ChainHashMap<uint32_t, uint32_t>::iterator it = m_map.find(key);
+        if (it == m_map.end()) {
+            return false;
+        }
+        val = *it;
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    ChainHashMap<uint32_t, uint32_t> m_map;
+};
+
+/**
+ * Sharded map with the same interface as the baseline.
+ */
+class ShardedMap {
+public:
+    ShardedMap() : m_map(2 * NUM_RECORDS, 75) {}
+
+    void insert_or_assign(uint32_t key, uint32_t val) {
+        m_map.insert_or_assign(key, val);
+    }
+
+    bool find(uint32_t key, uint32_t &val) {
+        return m_map.find(key, val);
+    }
+
+private:
+    ConcurrentHashMap<uint32_t, uint32_t> m_map;
+};
+
+template<class Map>
+static void run_workload(bench::BenchState &state, uint32_t num_threads, uint32_t read_percent) {
+    Map map;
+    for (uint32_t key = 0; key < NUM_RECORDS; ++key) {
+        map.insert_or_assign(key, key);
+    }
+    std::vector<std::thread> threads;
+    state.start();
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&map, t, read_percent]() {
+            bench::Random random(2463534242u + t);
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < OPS_PER_THREAD; ++i) {
+                uint32_t r = random.next();
+                uint32_t key = (r >> 8) % NUM_RECORDS;
+                if (r % 100 < read_percent) {
+                    uint32_t val = 0;
+                    map.find(key, val);
+                    sum += val;
+                } else {
+                    map.insert_or_assign(key, r);
+                }
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    state.stop();
+    state.add_operations((uint64_t) num_threads * OPS_PER_THREAD);
+}
+
+BENCHMARK(concurrent_map, locked_a_1_thread) { run_workload<LockedMap>(state, 1, 50); }
+BENCHMARK(concurrent_map, sharded_a_1_thread) { run_workload<ShardedMap>(state, 1, 50); }
+BENCHMARK(concurrent_map, locked_a_4_threads) { run_workload<LockedMap>(state, 4, 50); }
+BENCHMARK(concurrent_map, sharded_a_4_threads) { run_workload<ShardedMap>(state, 4, 50); }
+BENCHMARK(concurrent_map, locked_b_1_thread) { run_workload<LockedMap>(state, 1, 95); }
+BENCHMARK(concurrent_map, sharded_b_1_thread) { run_workload<ShardedMap>(state, 1, 95); }
+BENCHMARK(concurrent_map, locked_b_4_threads) { run_workload<LockedMap>(state, 4, 95); }
+BENCHMARK(concurrent_map, sharded_b_4_threads) { run_workload<ShardedMap>(state, 4, 95); }
+BENCHMARK(concurrent_map, locked_c_4_threads) { run_workload<LockedMap>(state, 4, 100); }
+BENCHMARK(concurrent_map, sharded_c_4_threads) { run_workload<ShardedMap>(state, 4, 100); }
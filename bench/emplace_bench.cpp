@@ -0,0 +1,102 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+#include "strings/StaticString.h"
+
+using namespace wlp;
+
+/*
+ * Measures inserting large values, copied from an lvalue, moved from
+ * a temporary, or written once from a character string by try_emplace.
+ */
+static constexpr uint16_t NUM_KEYS = 48;
+static constexpr int ROUNDS = 512;
+
+typedef StaticString<256> string256;
+
+static const char *const TEXT =
+        "sensor reading: temperature 21.5C, humidity 40%, pressure 1013hPa, "
+        "accelerometer 0.01 0.02 9.81, gyroscope 0.00 0.01 0.00, battery 3.7V";
+
+struct sensor_frame {
+    uint32_t timestamp;
+    float samples[60];
+};
+
+enum insert_mode {
+    COPY,
+    MOVE,
+    EMPLACE
+};
+
+template<class Map>
+static void insert_strings(bench::BenchState &state, insert_mode mode) {
+    uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    string256 value(TEXT);
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        Map map(64, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            if (mode == COPY) {
+                map.insert(keys[i], value);
+            } else if (mode == MOVE) {
+                map.insert(keys[i], string256(TEXT));
+            } else {
+                map.try_emplace(keys[i], TEXT);
+            }
+        }
+        sum += map.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+template<class Map>
+static void insert_frames(bench::BenchState &state, insert_mode mode) {
+    uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    sensor_frame frame;
+    frame.timestamp = 0;
+    for (int i = 0; i < 60; ++i) {
+        frame.samples[i] = static_cast<float>(i);
+    }
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        Map map(64, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            frame.timestamp = keys[i];
+            if (mode == COPY) {
+                map.insert(keys[i], frame);
+            } else {
+                map.try_emplace(keys[i], move(frame));
+            }
+        }
+        sum += map.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+typedef Hash<uint32_t, uint32_t> hasher;
+typedef OpenHashMap<uint32_t, string256, hasher> open_strings;
+typedef ChainHashMap<uint32_t, string256, hasher> chain_strings;
+typedef OpenHashMap<uint32_t, sensor_frame, hasher> open_frames;
+typedef ChainHashMap<uint32_t, sensor_frame, hasher> chain_frames;
+
+BENCHMARK(emplace, open_string_copy) { insert_strings<open_strings>(state, COPY); }
+BENCHMARK(emplace, open_string_move) { insert_strings<open_strings>(state, MOVE); }
+BENCHMARK(emplace, open_string_try_emplace) { insert_strings<open_strings>(state, EMPLACE); }
+BENCHMARK(emplace, chain_string_copy) { insert_strings<chain_strings>(state, COPY); }
+BENCHMARK(emplace, chain_string_move) { insert_strings<chain_strings>(state, MOVE); }
+BENCHMARK(emplace, chain_string_try_emplace) { insert_strings<chain_strings>(state, EMPLACE); }
+BENCHMARK(emplace, open_frame_copy) { insert_frames<open_frames>(state, COPY); }
+BENCHMARK(emplace, open_frame_try_emplace) { insert_frames<open_frames>(state, MOVE); }
+BENCHMARK(emplace, chain_frame_copy) { insert_frames<chain_frames>(state, COPY); }
+BENCHMARK(emplace, chain_frame_try_emplace) { insert_frames<chain_frames>(state, MOVE); }
@@ -0,0 +1,98 @@
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "memory/EpochReclaimer.h"
+
+using namespace wlp;
+
+struct BenchNode : EpochEntry {
+    uint64_t value;
+};
+
+static constexpr uint64_t WRITES = 1 << 18;
+
+typedef EpochReclaimer<Allocator, 16, 64> reclaimer_type;
+
+/**
+ * Writer replaces a shared node while readers keep dereferencing it,
+ * every replaced node is retired and reclaimed in bulk.
+ */
+static void run_epoch(bench::BenchState &state, int num_readers) {
+    Allocator pool(sizeof(BenchNode), sizeof(BenchNode) * 1024);
+    reclaimer_type reclaimer(&pool);
+    auto *node = static_cast<BenchNode *>(reclaimer.Allocate());
+    node->value = 0;
+    BenchNode *shared = node;
+    bool done = false;
+    std::vector<std::thread> readers;
+    for (int r = 0; r < num_readers; ++r) {
+        readers.emplace_back([&]() {
+            auto *p = reclaimer.Register();
+            uint64_t sum = 0;
+            while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                {
+                    EpochGuard<reclaimer_type> guard(reclaimer, p);
+                    sum += __atomic_load_n(&shared, __ATOMIC_ACQUIRE)->value;
+                }
+                std::this_thread::yield();
+            }
+            bench::do_not_optimize(sum);
+            reclaimer.Unregister(p);
+        });
+    }
+    auto *p = reclaimer.Register();
+    state.start();
+    for (uint64_t i = 1; i <= WRITES; ++i) {
+        auto *next = static_cast<BenchNode *>(reclaimer.Allocate());
+        next->value = i;
+        reclaimer.Retire(p, __atomic_exchange_n(&shared, next, __ATOMIC_ACQ_REL));
+    }
+    state.stop();
+    state.add_operations(WRITES);
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    reclaimer.Retire(p, shared);
+}
+
+/**
+ * Baseline returning every node to the pool as soon as it is unlinked,
+ * taking the pool lock once per node. Only safe without readers.
+ */
+BENCHMARK(epoch, immediate_free) {
+    Allocator pool(sizeof(BenchNode), sizeof(BenchNode) * 1024);
+    bool lock = false;
+    auto *shared = static_cast<BenchNode *>(pool.Allocate());
+    state.start();
+    for (uint64_t i = 1; i <= WRITES; ++i) {
+        while (__atomic_test_and_set(&lock, __ATOMIC_ACQUIRE));
+        auto *next = static_cast<BenchNode *>(pool.Allocate());
+        __atomic_clear(&lock, __ATOMIC_RELEASE);
+        next->value = i;
+        BenchNode *old = __atomic_exchange_n(&shared, next, __ATOMIC_ACQ_REL);
+        while (__atomic_test_and_set(&lock, __ATOMIC_ACQUIRE));
+        pool.Deallocate(old);
+        __atomic_clear(&lock, __ATOMIC_RELEASE);
+    }
+    state.stop();
+    state.add_operations(WRITES);
+    pool.Deallocate(shared);
+}
+
+BENCHMARK(epoch, retire_0_readers) {
+    run_epoch(state, 0);
+}
+
+BENCHMARK(epoch, retire_1_reader) {
+    run_epoch(state, 1);
+}
+
+BENCHMARK(epoch, retire_4_readers) {
+    run_epoch(state, 4);
+}
+
+BENCHMARK(epoch, retire_8_readers) {
+    run_epoch(state, 8);
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/Hash.h"
+#include "stl/OpenMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares the default hash family against the mixing family. The
+ * throughput benchmarks hash integer keys and strings of a few lengths.
+ * The collision counts reduce the hash codes of a key pattern modulo a
+ * table capacity and count the keys landing in an occupied bucket; a
+ * uniform hash leaves about a fifth of the keys colliding at half load.
+ * The lookups run an open map with the modulo index policy over keys
+ * that identity hashing handles badly.
+ */
+static constexpr uint16_t NUM_KEYS = 1024;
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr int ROUNDS = 256;
+static constexpr uint16_t NUM_STRINGS = 64;
+static constexpr uint16_t MAX_STRING = 64;
+
+static const char *const PATTERN_NAMES[] = {"sequential", "strided", "random"};
+
+template<class Hasher>
+static void hash_integers(bench::BenchState &state) {
+    static uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    Hasher hasher;
+    size_type sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            sum = static_cast<size_type>(sum + hasher(keys[i]));
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+/**
+ * Hashes strings of one length, reporting throughput in strings.
+ */
+template<class Hasher>
+static void hash_strings(bench::BenchState &state, uint16_t length) {
+    static char strings[NUM_STRINGS][MAX_STRING + 1];
+    bench::Random random;
+    for (auto &string : strings) {
+        for (uint16_t c = 0; c < length; ++c) {
+            string[c] = static_cast<char>('a' + random.next() % 26);
+        }
+        string[length] = '\0';
+    }
+    Hasher hasher;
+    size_type sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS * 4; ++r) {
+        for (auto &string : strings) {
+            sum = static_cast<size_type>(sum + hasher(string));
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * 4 * NUM_STRINGS);
+}
+
+/**
+ * Counts the keys of a pattern whose bucket is already occupied.
+ */
+template<class Hasher>
+static void print_collisions(const char *name, bench::KeyPattern pattern) {
+    static uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, pattern);
+    bool occupied[CAPACITY] = {false};
+    Hasher hasher;
+    uint16_t collisions = 0;
+    for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+        size_type bucket = ModuloIndex::index(hasher(keys[i]), CAPACITY);
+        collisions = static_cast<uint16_t>(collisions + occupied[bucket]);
+        occupied[bucket] = true;
+    }
+    printf("%s %s collisions: %u of %u keys\n", name, PATTERN_NAMES[pattern], collisions, NUM_KEYS);
+}
+
+template<class Map, class Hasher>
+static void lookup(bench::BenchState &state, const char *name, bench::KeyPattern pattern) {
+    static uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, pattern);
+    print_collisions<Hasher>(name, pattern);
+    Map map(CAPACITY, 75);
+    for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+        map[keys[i]] = i;
+    }
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            found += map.contains(keys[i]);
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_KEYS);
+}
+
+typedef Hash<uint32_t, size_type> int_hash;
+typedef MixHash<uint32_t, size_type> int_mix_hash;
+typedef Hash<const char *, size_type> string_hash;
+typedef MixHash<const char *, size_type> string_mix_hash;
+typedef OpenHashMap<uint32_t, uint32_t, int_hash, Equal<uint32_t>, ModuloIndex> open_map;
+typedef OpenHashMap<uint32_t, uint32_t, int_mix_hash, Equal<uint32_t>, ModuloIndex> open_mix_map;
+
+BENCHMARK(hash, integer) { hash_integers<int_hash>(state); }
+BENCHMARK(hash, integer_mix) { hash_integers<int_mix_hash>(state); }
+BENCHMARK(hash, string_8) { hash_strings<string_hash>(state, 8); }
+BENCHMARK(hash, string_8_mix) { hash_strings<string_mix_hash>(state, 8); }
+BENCHMARK(hash, string_24) { hash_strings<string_hash>(state, 24); }
+BENCHMARK(hash, string_24_mix) { hash_strings<string_mix_hash>(state, 24); }
+BENCHMARK(hash, string_64) { hash_strings<string_hash>(state, 64); }
+BENCHMARK(hash, string_64_mix) { hash_strings<string_mix_hash>(state, 64); }
+BENCHMARK(hash, lookup_sequential) { lookup<open_map, int_hash>(state, "hash", bench::SEQUENTIAL); }
+BENCHMARK(hash, lookup_sequential_mix) { lookup<open_mix_map, int_mix_hash>(state, "mix_hash", bench::SEQUENTIAL); }
+BENCHMARK(hash, lookup_strided) { lookup<open_map, int_hash>(state, "hash", bench::STRIDED); }
+BENCHMARK(hash, lookup_strided_mix) { lookup<open_mix_map, int_mix_hash>(state, "mix_hash", bench::STRIDED); }
+BENCHMARK(hash, lookup_random) { lookup<open_map, int_hash>(state, "hash", bench::RANDOM); }
+BENCHMARK(hash, lookup_random_mix) { lookup<open_mix_map, int_mix_hash>(state, "mix_hash", bench::RANDOM); }
@@ -0,0 +1,104 @@
+#include <stdio.h>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares reducing hash codes modulo the capacity against taking the
+ * top bits of Fibonacci-mixed hash codes with a power-of-two capacity.
+ * Both use the same capacity, so the modulo maps see what happens to
+ * identity hashes when the capacity is a round number.
+ */
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr uint16_t NUM_KEYS = 1024;
+static constexpr int NUM_MAPS = 16;
+static constexpr int ROUNDS = 4;
+
+static const char *const PATTERN_NAMES[] = {"sequential", "strided", "random"};
+
+/**
+ * Prints the distribution of successful lookup probe lengths
+ * over the keys of a map.
+ */
+template<class Map>
+static void print_histogram(const char *name, const Map &map, const uint32_t *keys, bench::KeyPattern pattern) {
+    static const uint16_t bounds[] = {1, 2, 3, 4, 8, 16, 64, 0xffff};
+    uint32_t counts[sizeof(bounds) / sizeof(bounds[0])] = {0};
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+        uint16_t length = map.probe_length(keys[i]);
+        total += length;
+        size_t b = 0;
+        while (length > bounds[b]) {
+            ++b;
+        }
+        ++counts[b];
+    }
+    printf("%s %s probe lengths (mean %.2f):", name, PATTERN_NAMES[pattern], (double) total / NUM_KEYS);
+    for (size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); ++b) {
+        if (b + 1 == sizeof(bounds) / sizeof(bounds[0])) {
+            printf(" >%u:%u", bounds[b - 1], counts[b]);
+        } else {
+            printf(" <=%u:%u", bounds[b], counts[b]);
+        }
+    }
+    printf("\n");
+}
+
+/**
+ * Fills every map with the keys of a pattern and looks all of
+ * them up, cycling through the maps on every lookup.
+ */
+template<class Map>
+static void lookup(bench::BenchState &state, const char *name, bench::KeyPattern pattern) {
+    static uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, pattern);
+    Map *maps[NUM_MAPS];
+    for (auto &map : maps) {
+        map = new Map(CAPACITY, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            (*map)[keys[i]] = i;
+        }
+    }
+    print_histogram(name, *maps[0], keys, pattern);
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            for (auto &map : maps) {
+                found += map->contains(keys[i]);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * NUM_KEYS);
+    for (auto &map : maps) {
+        delete map;
+    }
+}
+
+typedef Hash<uint32_t, uint16_t> hasher;
+typedef Equal<uint32_t> equals;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex> open_modulo;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, PowerOfTwoIndex> open_pow2;
+typedef ChainHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex> chain_modulo;
+typedef ChainHashMap<uint32_t, uint32_t, hasher, equals, PowerOfTwoIndex> chain_pow2;
+
+BENCHMARK(hash_index, open_modulo_sequential) { lookup<open_modulo>(state, "open_modulo", bench::SEQUENTIAL); }
+BENCHMARK(hash_index, open_pow2_sequential) { lookup<open_pow2>(state, "open_pow2", bench::SEQUENTIAL); }
+BENCHMARK(hash_index, open_modulo_strided) { lookup<open_modulo>(state, "open_modulo", bench::STRIDED); }
+BENCHMARK(hash_index, open_pow2_strided) { lookup<open_pow2>(state, "open_pow2", bench::STRIDED); }
+BENCHMARK(hash_index, open_modulo_random) { lookup<open_modulo>(state, "open_modulo", bench::RANDOM); }
+BENCHMARK(hash_index, open_pow2_random) { lookup<open_pow2>(state, "open_pow2", bench::RANDOM); }
+BENCHMARK(hash_index, chain_modulo_sequential) { lookup<chain_modulo>(state, "chain_modulo", bench::SEQUENTIAL); }
+BENCHMARK(hash_index, chain_pow2_sequential) { lookup<chain_pow2>(state, "chain_pow2", bench::SEQUENTIAL); }
+BENCHMARK(hash_index, chain_modulo_strided) { lookup<chain_modulo>(state, "chain_modulo", bench::STRIDED); }
+BENCHMARK(hash_index, chain_pow2_strided) { lookup<chain_pow2>(state, "chain_pow2", bench::STRIDED); }
+BENCHMARK(hash_index, chain_modulo_random) { lookup<chain_modulo>(state, "chain_modulo", bench::RANDOM); }
+BENCHMARK(hash_index, chain_pow2_random) { lookup<chain_pow2>(state, "chain_pow2", bench::RANDOM); }
@@ -0,0 +1,78 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares full and incremental rehashing. The growth benchmarks time
+ * only the insertion that makes a full map grow, which is the worst
+ * case latency of an insertion, while the fill benchmarks time every
+ * insertion of a map grown from a small capacity.
+ */
+static constexpr uint16_t CAPACITY = 1024;
+static constexpr uint16_t NUM_KEYS = 768;
+static constexpr int NUM_MAPS = 64;
+
+/**
+ * Fills maps up to their maximum load untimed and times
+ * the single insertion that follows.
+ */
+template<class Map>
+static void growth(bench::BenchState &state) {
+    uint32_t keys[NUM_KEYS + 1];
+    bench::fill_keys(keys, NUM_KEYS + 1, bench::RANDOM);
+    uint32_t sum = 0;
+    for (int r = 0; r < NUM_MAPS; ++r) {
+        Map map(CAPACITY, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            map[keys[i]] = i;
+        }
+        state.start();
+        map[keys[NUM_KEYS]] = NUM_KEYS;
+        state.stop();
+        sum += map.capacity();
+    }
+    bench::do_not_optimize(sum);
+    state.add_operations(NUM_MAPS);
+}
+
+/**
+ * Grows maps from a small capacity, so that the average
+ * includes the work of every rehash or migration.
+ */
+template<class Map>
+static void fill(bench::BenchState &state) {
+    uint32_t keys[NUM_KEYS];
+    bench::fill_keys(keys, NUM_KEYS, bench::RANDOM);
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < NUM_MAPS; ++r) {
+        Map map(8, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            map[keys[i]] = i;
+        }
+        sum += map.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) NUM_MAPS * NUM_KEYS);
+}
+
+typedef Hash<uint32_t, uint32_t> hasher;
+typedef Equal<uint32_t> equals;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex, LinearProbe, NoStoredHash, FullRehash> open_full;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex, LinearProbe, NoStoredHash, IncrementalRehash> open_incremental;
+typedef ChainHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex, NoStoredHash, FullRehash> chain_full;
+typedef ChainHashMap<uint32_t, uint32_t, hasher, equals, ModuloIndex, NoStoredHash, IncrementalRehash> chain_incremental;
+
+BENCHMARK(incremental_rehash, open_full_growth) { growth<open_full>(state); }
+BENCHMARK(incremental_rehash, open_incremental_growth) { growth<open_incremental>(state); }
+BENCHMARK(incremental_rehash, chain_full_growth) { growth<chain_full>(state); }
+BENCHMARK(incremental_rehash, chain_incremental_growth) { growth<chain_incremental>(state); }
+BENCHMARK(incremental_rehash, open_full_fill) { fill<open_full>(state); }
+BENCHMARK(incremental_rehash, open_incremental_fill) { fill<open_incremental>(state); }
+BENCHMARK(incremental_rehash, chain_full_fill) { fill<chain_full>(state); }
+BENCHMARK(incremental_rehash, chain_incremental_fill) { fill<chain_incremental>(state); }
@@ -0,0 +1,115 @@
+#include <stdio.h>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/LRUCache.h"
+
+using namespace wlp;
+
+/*
+ * Compares the LRU cache against a cache that stamps every entry with
+ * the time of its last use and scans all entries to find a key or the
+ * entry to evict. Each request looks a key up and caches it on a miss.
+ * Keys are drawn from four times as many keys as the cache holds, with
+ * small keys more likely, so that the hit rate is neither zero nor one.
+ */
+static constexpr uint32_t NUM_REQUESTS = 1 << 16;
+static constexpr int ROUNDS = 4;
+
+/**
+ * Cache evicting the least recently used entry by scanning.
+ */
+template<size_type N>
+class ScanCache {
+public:
+    ScanCache() : m_size(0), m_clock(0) {}
+
+    uint32_t *get(uint32_t key) {
+        for (size_type i = 0; i < m_size; ++i) {
+            if (m_keys[i] == key) {
+                m_stamps[i] = ++m_clock;
+                return &m_vals[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void put(uint32_t key, uint32_t val) {
+        size_type slot = m_size;
+        if (m_size < N) {
+            ++m_size;
+        } else {
+            slot = 0;
+            for (size_type i = 1; i < N; ++i) {
+                if (m_stamps[i] < m_stamps[slot]) {
+                    slot = i;
+                }
+            }
+        }
+        m_keys[slot] = key;
+        m_vals[slot] = val;
+        m_stamps[slot] = ++m_clock;
+    }
+
+private:
+    uint32_t m_keys[N];
+    uint32_t m_vals[N];
+    uint32_t m_stamps[N];
+    size_type m_size;
+    uint32_t m_clock;
+};
+
+static void fill_requests(uint32_t *requests, uint32_t key_space) {
+    bench::Random random;
+    for (uint32_t i = 0; i < NUM_REQUESTS; ++i) {
+        // the minimum of two uniform draws favours small keys
+        uint32_t a = random.next() % key_space;
+        uint32_t b = random.next() % key_space;
+        requests[i] = a < b ? a : b;
+    }
+}
+
+template<class Cache, size_type N>
+static void run(bench::BenchState &state) {
+    static uint32_t requests[NUM_REQUESTS];
+    fill_requests(requests, 4 * N);
+    Cache cache;
+    uint32_t hits = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint32_t i = 0; i < NUM_REQUESTS; ++i) {
+            uint32_t *val = cache.get(requests[i]);
+            if (val) {
+                hits += *val & 1u;
+            } else {
+                cache.put(requests[i], i);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(hits);
+    state.add_operations((uint64_t) ROUNDS * NUM_REQUESTS);
+}
+
+template<size_type N>
+static void report_hit_rate() {
+    static uint32_t requests[NUM_REQUESTS];
+    fill_requests(requests, 4 * N);
+    LRUCache<uint32_t, uint32_t, N> cache;
+    for (uint32_t i = 0; i < NUM_REQUESTS; ++i) {
+        if (!cache.get(requests[i])) {
+            cache.put(requests[i], i);
+        }
+    }
+    printf("capacity %u hit rate: %u%%, evictions: %u\n",
+           (unsigned) N, (unsigned) cache.hit_rate(), (unsigned) cache.evictions());
+}
+
+typedef LRUCache<uint32_t, uint32_t, 16> lru_16;
+typedef LRUCache<uint32_t, uint32_t, 256> lru_256;
+
+BENCHMARK(lru_cache, lru_16) { report_hit_rate<16>(); run<lru_16, 16>(state); }
+BENCHMARK(lru_cache, scan_16) { run<ScanCache<16>, 16>(state); }
+BENCHMARK(lru_cache, lru_256) { report_hit_rate<256>(); run<lru_256, 256>(state); }
+BENCHMARK(lru_cache, scan_256) { run<ScanCache<256>, 256>(state); }
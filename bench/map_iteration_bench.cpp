@@ -0,0 +1,84 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+#include "strings/StaticString.h"
+
+using namespace wlp;
+
+/*
+ * Times visiting every element of a map through its iterators.
+ * String keys make any per-step rehashing of the current key show up.
+ */
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr int NUM_MAPS = 16;
+static constexpr int ROUNDS = 8;
+
+template<class Key>
+static Key make_key(uint32_t x);
+
+template<>
+uint32_t make_key(uint32_t x) {
+    return x;
+}
+
+template<>
+StaticString<16> make_key(uint32_t x) {
+    char buffer[16];
+    for (int i = 0; i < 8; ++i) {
+        buffer[i] = static_cast<char>('a' + ((x >> (i * 4)) & 0xf));
+    }
+    buffer[8] = '\0';
+    return StaticString<16>(buffer);
+}
+
+/**
+ * Fills every map to the given load with random keys and
+ * walks each map from begin() to end().
+ */
+template<class Map, class Key>
+static void iterate(bench::BenchState &state, uint8_t load) {
+    static uint32_t keys[CAPACITY];
+    uint16_t n = static_cast<uint16_t>(CAPACITY * load / 100);
+    bench::fill_keys(keys, n, bench::RANDOM);
+    Map *maps[NUM_MAPS];
+    for (auto &map : maps) {
+        map = new Map(CAPACITY, 100);
+        for (uint16_t i = 0; i < n; ++i) {
+            (*map)[make_key<Key>(keys[i])] = i;
+        }
+    }
+    uint32_t sum = 0;
+    uint64_t visited = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (auto &map : maps) {
+            for (auto it = map->begin(); it != map->end(); ++it) {
+                sum += *it;
+                ++visited;
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations(visited);
+    for (auto &map : maps) {
+        delete map;
+    }
+}
+
+typedef StaticString<16> string16;
+typedef OpenHashMap<uint32_t, uint32_t> open_int;
+typedef ChainHashMap<uint32_t, uint32_t> chain_int;
+typedef OpenHashMap<string16, uint32_t> open_string;
+typedef ChainHashMap<string16, uint32_t> chain_string;
+
+BENCHMARK(map_iteration, open_int_25) { iterate<open_int, uint32_t>(state, 25); }
+BENCHMARK(map_iteration, open_int_75) { iterate<open_int, uint32_t>(state, 75); }
+BENCHMARK(map_iteration, chain_int_25) { iterate<chain_int, uint32_t>(state, 25); }
+BENCHMARK(map_iteration, chain_int_75) { iterate<chain_int, uint32_t>(state, 75); }
+BENCHMARK(map_iteration, open_string_25) { iterate<open_string, string16>(state, 25); }
+BENCHMARK(map_iteration, open_string_75) { iterate<open_string, string16>(state, 75); }
+BENCHMARK(map_iteration, chain_string_25) { iterate<chain_string, string16>(state, 25); }
+BENCHMARK(map_iteration, chain_string_75) { iterate<chain_string, string16>(state, 75); }
@@ -0,0 +1,75 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/OpenMap.h"
+#include "stl/FlatMap.h"
+
+using namespace wlp;
+
+/*
+ * A single map is limited to a few thousand slots by the 16 bit sizes
+ * used by the allocator, small enough to stay in the first level cache.
+ * Lookups are therefore spread over many maps so that the working set
+ * exceeds the cache and the cost of each probe step shows.
+ */
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr int NUM_MAPS = 64;
+static constexpr int ROUNDS = 4;
+
+/**
+ * Fills every map to the given load with odd keys, then looks up either
+ * the inserted keys (hits) or the neighbouring even keys (misses),
+ * cycling through the maps on every lookup.
+ */
+template<class Map>
+static void lookup(bench::BenchState &state, uint8_t load, bool hits) {
+    Map *maps[NUM_MAPS];
+    uint16_t n = static_cast<uint16_t>(CAPACITY * load / 100);
+    static uint32_t keys[CAPACITY];
+    bench::Random random;
+    for (uint16_t i = 0; i < n; ++i) {
+        keys[i] = random.next() | 1;
+    }
+    for (auto &map : maps) {
+        map = new Map(CAPACITY, 100);
+        for (uint16_t i = 0; i < n; ++i) {
+            (*map)[keys[i]] = i;
+        }
+    }
+    if (!hits) {
+        for (uint16_t i = 0; i < n; ++i) {
+            keys[i] &= ~1u;
+        }
+    }
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < n; ++i) {
+            for (auto &map : maps) {
+                found += map->contains(keys[i]);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * n);
+    for (auto &map : maps) {
+        delete map;
+    }
+}
+
+typedef OpenHashMap<uint32_t, uint32_t> pointer_map;
+typedef FlatHashMap<uint32_t, uint32_t> flat_map;
+
+BENCHMARK(open_map, pointer_hit_50) { lookup<pointer_map>(state, 50, true); }
+BENCHMARK(open_map, flat_hit_50) { lookup<flat_map>(state, 50, true); }
+BENCHMARK(open_map, pointer_miss_50) { lookup<pointer_map>(state, 50, false); }
+BENCHMARK(open_map, flat_miss_50) { lookup<flat_map>(state, 50, false); }
+BENCHMARK(open_map, pointer_hit_75) { lookup<pointer_map>(state, 75, true); }
+BENCHMARK(open_map, flat_hit_75) { lookup<flat_map>(state, 75, true); }
+BENCHMARK(open_map, pointer_miss_75) { lookup<pointer_map>(state, 75, false); }
+BENCHMARK(open_map, flat_miss_75) { lookup<flat_map>(state, 75, false); }
+BENCHMARK(open_map, pointer_hit_90) { lookup<pointer_map>(state, 90, true); }
+BENCHMARK(open_map, flat_hit_90) { lookup<flat_map>(state, 90, true); }
+BENCHMARK(open_map, pointer_miss_90) { lookup<pointer_map>(state, 90, false); }
+BENCHMARK(open_map, flat_miss_90) { lookup<flat_map>(state, 90, false); }
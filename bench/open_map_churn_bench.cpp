@@ -0,0 +1,39 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/OpenMap.h"
+#include "stl/FlatMap.h"
+
+using namespace wlp;
+
+static constexpr uint16_t CAPACITY = 1024;
+static constexpr uint16_t LIVE = 512;
+static constexpr uint32_t CHURN = 1 << 16;
+
+/**
+ * Session table churn: the map holds a steady number of live keys and
+ * every operation erases the oldest key and inserts a fresh one.
+ */
+template<class Map>
+static void churn(bench::BenchState &state) {
+    Map map(CAPACITY, 75);
+    uint32_t ring[LIVE];
+    bench::Random random;
+    for (auto &key : ring) {
+        key = random.next();
+        map[key] = key;
+    }
+    state.start();
+    for (uint32_t i = 0; i < CHURN; ++i) {
+        uint32_t &slot = ring[i % LIVE];
+        map.erase(slot);
+        slot = random.next();
+        map[slot] = i;
+    }
+    state.stop();
+    bench::do_not_optimize(map.size());
+    state.add_operations(CHURN);
+}
+
+BENCHMARK(open_map_churn, pointer) { churn<OpenHashMap<uint32_t, uint32_t>>(state); }
+BENCHMARK(open_map_churn, flat) { churn<FlatHashMap<uint32_t, uint32_t>>(state); }
@@ -0,0 +1,67 @@
+#include "Bench.h"
+
+#include "stl/ChainMap.h"
+#include "stl/PerfectHashMap.h"
+
+using namespace wlp;
+
+/*
+ * Dispatches a stream of command names through a command table, either
+ * a chained hash map filled at runtime or a perfect hash map computed
+ * at compile time.
+ */
+static constexpr uint16_t NUM_COMMANDS = 16;
+static constexpr int ROUNDS = 1 << 14;
+
+static constexpr PerfectHashEntry<const char *, int> COMMANDS[NUM_COMMANDS] = {
+        {"start", 1}, {"stop", 2}, {"reset", 3}, {"status", 4},
+        {"arm", 5}, {"disarm", 6}, {"brake", 7}, {"release", 8},
+        {"levitate", 9}, {"land", 10}, {"calibrate", 11}, {"log", 12},
+        {"ping", 13}, {"config", 14}, {"fault", 15}, {"shutdown", 16}};
+
+static constexpr PerfectHashMap<const char *, int, NUM_COMMANDS> perfect_table(COMMANDS);
+
+BENCHMARK(perfect_hash, chain_lookup) {
+    ChainHashMap<const char *, int> table(32, 75);
+    for (const auto &entry : COMMANDS) {
+        table[entry.m_key] = entry.m_val;
+    }
+    int sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (const auto &entry : COMMANDS) {
+            sum += *table.find(entry.m_key);
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_COMMANDS);
+}
+
+BENCHMARK(perfect_hash, perfect_lookup) {
+    int sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (const auto &entry : COMMANDS) {
+            sum += *perfect_table.find(entry.m_key);
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_COMMANDS);
+}
+
+BENCHMARK(perfect_hash, chain_build) {
+    int sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS / 16; ++r) {
+        ChainHashMap<const char *, int> table(32, 75);
+        for (const auto &entry : COMMANDS) {
+            table[entry.m_key] = entry.m_val;
+        }
+        sum += table.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS / 16 * NUM_COMMANDS);
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/OpenMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares probe policies of the open addressed map at high load
+ * factors. Every map uses the power-of-two index policy, which
+ * quadratic probing requires, so only the probe sequence differs.
+ */
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr int NUM_MAPS = 16;
+static constexpr int ROUNDS = 4;
+
+/**
+ * Prints the mean and maximum probe length of the keys.
+ */
+template<class Map>
+static void print_probe_lengths(const char *name, uint8_t load, bool hits, const Map &map,
+                                const uint32_t *keys, uint16_t n) {
+    uint32_t total = 0;
+    uint16_t longest = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+        uint16_t length = map.probe_length(keys[i]);
+        total += length;
+        if (length > longest) {
+            longest = length;
+        }
+    }
+    printf("%s %u%% %s probe lengths: mean %.2f max %u\n",
+           name, load, hits ? "hit" : "miss", (double) total / n, longest);
+}
+
+/**
+ * Fills every map to the given load with random odd keys, then looks
+ * up either the inserted keys or the neighbouring even keys.
+ */
+template<class Map>
+static void lookup(bench::BenchState &state, const char *name, uint8_t load, bool hits) {
+    static uint32_t keys[CAPACITY];
+    uint16_t n = static_cast<uint16_t>(CAPACITY * load / 100);
+    bench::fill_keys(keys, n, bench::RANDOM);
+    for (uint16_t i = 0; i < n; ++i) {
+        keys[i] |= 1;
+    }
+    Map *maps[NUM_MAPS];
+    for (auto &map : maps) {
+        map = new Map(CAPACITY, 100);
+        for (uint16_t i = 0; i < n; ++i) {
+            (*map)[keys[i]] = i;
+        }
+    }
+    if (!hits) {
+        for (uint16_t i = 0; i < n; ++i) {
+            keys[i] &= ~1u;
+        }
+    }
+    print_probe_lengths(name, load, hits, *maps[0], keys, n);
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < n; ++i) {
+            for (auto &map : maps) {
+                found += map->contains(keys[i]);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * n);
+    for (auto &map : maps) {
+        delete map;
+    }
+}
+
+typedef Hash<uint32_t, uint16_t> hasher;
+typedef Equal<uint32_t> equals;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, PowerOfTwoIndex, LinearProbe> linear_map;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, PowerOfTwoIndex, QuadraticProbe> quadratic_map;
+typedef OpenHashMap<uint32_t, uint32_t, hasher, equals, PowerOfTwoIndex, RobinHoodProbe> robin_hood_map;
+
+BENCHMARK(probe_policy, linear_hit_75) { lookup<linear_map>(state, "linear", 75, true); }
+BENCHMARK(probe_policy, quadratic_hit_75) { lookup<quadratic_map>(state, "quadratic", 75, true); }
+BENCHMARK(probe_policy, robin_hood_hit_75) { lookup<robin_hood_map>(state, "robin_hood", 75, true); }
+BENCHMARK(probe_policy, linear_miss_75) { lookup<linear_map>(state, "linear", 75, false); }
+BENCHMARK(probe_policy, quadratic_miss_75) { lookup<quadratic_map>(state, "quadratic", 75, false); }
+BENCHMARK(probe_policy, robin_hood_miss_75) { lookup<robin_hood_map>(state, "robin_hood", 75, false); }
+BENCHMARK(probe_policy, linear_hit_90) { lookup<linear_map>(state, "linear", 90, true); }
+BENCHMARK(probe_policy, quadratic_hit_90) { lookup<quadratic_map>(state, "quadratic", 90, true); }
+BENCHMARK(probe_policy, robin_hood_hit_90) { lookup<robin_hood_map>(state, "robin_hood", 90, true); }
+BENCHMARK(probe_policy, linear_miss_90) { lookup<linear_map>(state, "linear", 90, false); }
+BENCHMARK(probe_policy, quadratic_miss_90) { lookup<quadratic_map>(state, "quadratic", 90, false); }
+BENCHMARK(probe_policy, robin_hood_miss_90) { lookup<robin_hood_map>(state, "robin_hood", 90, false); }
+BENCHMARK(probe_policy, linear_hit_95) { lookup<linear_map>(state, "linear", 95, true); }
+BENCHMARK(probe_policy, quadratic_hit_95) { lookup<quadratic_map>(state, "quadratic", 95, true); }
+BENCHMARK(probe_policy, robin_hood_hit_95) { lookup<robin_hood_map>(state, "robin_hood", 95, true); }
+BENCHMARK(probe_policy, linear_miss_95) { lookup<linear_map>(state, "linear", 95, false); }
+BENCHMARK(probe_policy, quadratic_miss_95) { lookup<quadratic_map>(state, "quadratic", 95, false); }
+BENCHMARK(probe_policy, robin_hood_miss_95) { lookup<robin_hood_map>(state, "robin_hood", 95, false); }
@@ -0,0 +1,116 @@
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+#include "strings/StaticString.h"
+
+using namespace wlp;
+
+/*
+ * Compares maps keyed by strings with and without stored hash codes.
+ * Keys share a long common prefix, so that comparing two different
+ * keys is about as expensive as hashing one.
+ */
+static constexpr uint16_t NUM_KEYS = 768;
+static constexpr int NUM_MAPS = 8;
+static constexpr int ROUNDS = 4;
+
+typedef StaticString<32> string32;
+
+static string32 make_key(uint32_t x) {
+    char buffer[32] = "sensor/telemetry/channel/";
+    for (int i = 0; i < 6; ++i) {
+        buffer[25 + i] = static_cast<char>('a' + ((x >> (i * 4)) & 0xf));
+    }
+    buffer[31] = '\0';
+    return string32(buffer);
+}
+
+static string32 *make_keys(bool hits) {
+    static uint32_t raw[NUM_KEYS];
+    bench::fill_keys(raw, NUM_KEYS, bench::RANDOM);
+    string32 *keys = new string32[NUM_KEYS];
+    for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+        keys[i] = make_key(hits ? raw[i] : ~raw[i]);
+    }
+    return keys;
+}
+
+/**
+ * Looks up either the inserted keys or keys that are absent,
+ * in maps filled to 75% of their capacity.
+ */
+template<class Map>
+static void lookup(bench::BenchState &state, bool hits) {
+    string32 *keys = make_keys(true);
+    Map *maps[NUM_MAPS];
+    for (auto &map : maps) {
+        map = new Map(1024, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            (*map)[keys[i]] = i;
+        }
+    }
+    if (!hits) {
+        delete[] keys;
+        keys = make_keys(false);
+    }
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            for (auto &map : maps) {
+                found += map->contains(keys[i]);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * NUM_KEYS);
+    for (auto &map : maps) {
+        delete map;
+    }
+    delete[] keys;
+}
+
+/**
+ * Grows maps from a small capacity, so that every
+ * insertion pays its share of repeated rehashing.
+ */
+template<class Map>
+static void grow(bench::BenchState &state) {
+    string32 *keys = make_keys(true);
+    uint32_t sum = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS * NUM_MAPS; ++r) {
+        Map map(8, 75);
+        for (uint16_t i = 0; i < NUM_KEYS; ++i) {
+            map[keys[i]] = i;
+        }
+        sum += map.size();
+    }
+    state.stop();
+    bench::do_not_optimize(sum);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * NUM_KEYS);
+    delete[] keys;
+}
+
+typedef Hash<string32, uint16_t> hasher;
+typedef Equal<string32> equals;
+typedef OpenHashMap<string32, uint32_t, hasher, equals, ModuloIndex, LinearProbe, NoStoredHash> open_plain;
+typedef OpenHashMap<string32, uint32_t, hasher, equals, ModuloIndex, LinearProbe, StoredHash> open_stored;
+typedef ChainHashMap<string32, uint32_t, hasher, equals, ModuloIndex, NoStoredHash> chain_plain;
+typedef ChainHashMap<string32, uint32_t, hasher, equals, ModuloIndex, StoredHash> chain_stored;
+
+BENCHMARK(stored_hash, open_plain_hit) { lookup<open_plain>(state, true); }
+BENCHMARK(stored_hash, open_stored_hit) { lookup<open_stored>(state, true); }
+BENCHMARK(stored_hash, open_plain_miss) { lookup<open_plain>(state, false); }
+BENCHMARK(stored_hash, open_stored_miss) { lookup<open_stored>(state, false); }
+BENCHMARK(stored_hash, chain_plain_hit) { lookup<chain_plain>(state, true); }
+BENCHMARK(stored_hash, chain_stored_hit) { lookup<chain_stored>(state, true); }
+BENCHMARK(stored_hash, chain_plain_miss) { lookup<chain_plain>(state, false); }
+BENCHMARK(stored_hash, chain_stored_miss) { lookup<chain_stored>(state, false); }
+BENCHMARK(stored_hash, open_plain_grow) { grow<open_plain>(state); }
+BENCHMARK(stored_hash, open_stored_grow) { grow<open_stored>(state); }
+BENCHMARK(stored_hash, chain_plain_grow) { grow<chain_plain>(state); }
+BENCHMARK(stored_hash, chain_stored_grow) { grow<chain_stored>(state); }
@@ -0,0 +1,102 @@
+#include <unordered_map>
+
+#include "Bench.h"
+#include "BenchUtil.h"
+
+#include "stl/ChainMap.h"
+#include "stl/OpenMap.h"
+#include "stl/SwissMap.h"
+
+using namespace wlp;
+
+/*
+ * Compares the group probing map against the other maps of the
+ * library and std::unordered_map. As in the open map benchmarks,
+ * lookups are spread over many maps so that the working set
+ * exceeds the first level cache.
+ */
+static constexpr uint16_t CAPACITY = 2048;
+static constexpr int NUM_MAPS = 64;
+static constexpr int ROUNDS = 4;
+
+template<class Map>
+static Map *make_map() {
+    return new Map(CAPACITY, 100);
+}
+
+template<>
+std::unordered_map<uint32_t, uint32_t> *make_map() {
+    return new std::unordered_map<uint32_t, uint32_t>(CAPACITY);
+}
+
+template<class Map>
+static bool contains(const Map &map, uint32_t key) {
+    return map.contains(key);
+}
+
+static bool contains(const std::unordered_map<uint32_t, uint32_t> &map, uint32_t key) {
+    return map.count(key) != 0;
+}
+
+/**
+ * Fills every map to the given load with random odd keys, then looks
+ * up either the inserted keys or the neighbouring even keys.
+ */
+template<class Map>
+static void lookup(bench::BenchState &state, uint8_t load, bool hits) {
+    static uint32_t keys[CAPACITY];
+    uint16_t n = static_cast<uint16_t>(CAPACITY * load / 100);
+    bench::fill_keys(keys, n, bench::RANDOM);
+    for (uint16_t i = 0; i < n; ++i) {
+        keys[i] |= 1;
+    }
+    Map *maps[NUM_MAPS];
+    for (auto &map : maps) {
+        map = make_map<Map>();
+        for (uint16_t i = 0; i < n; ++i) {
+            (*map)[keys[i]] = i;
+        }
+    }
+    if (!hits) {
+        for (uint16_t i = 0; i < n; ++i) {
+            keys[i] &= ~1u;
+        }
+    }
+    uint32_t found = 0;
+    state.start();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint16_t i = 0; i < n; ++i) {
+            for (auto &map : maps) {
+                found += contains(*map, keys[i]);
+            }
+        }
+    }
+    state.stop();
+    bench::do_not_optimize(found);
+    state.add_operations((uint64_t) ROUNDS * NUM_MAPS * n);
+    for (auto &map : maps) {
+        delete map;
+    }
+}
+
+typedef SwissHashMap<uint32_t, uint32_t> swiss_map;
+typedef OpenHashMap<uint32_t, uint32_t> open_map;
+typedef ChainHashMap<uint32_t, uint32_t> chain_map;
+typedef std::unordered_map<uint32_t, uint32_t> std_map;
+
+BENCHMARK(swiss_map, swiss_hit_50) { lookup<swiss_map>(state, 50, true); }
+BENCHMARK(swiss_map, open_hit_50) { lookup<open_map>(state, 50, true); }
+BENCHMARK(swiss_map, chain_hit_50) { lookup<chain_map>(state, 50, true); }
+BENCHMARK(swiss_map, std_hit_50) { lookup<std_map>(state, 50, true); }
+BENCHMARK(swiss_map, swiss_miss_50) { lookup<swiss_map>(state, 50, false); }
+BENCHMARK(swiss_map, open_miss_50) { lookup<open_map>(state, 50, false); }
+BENCHMARK(swiss_map, chain_miss_50) { lookup<chain_map>(state, 50, false); }
+BENCHMARK(swiss_map, std_miss_50) { lookup<std_map>(state, 50, false); }
+BENCHMARK(swiss_map, swiss_hit_85) { lookup<swiss_map>(state, 85, true); }
+BENCHMARK(swiss_map, open_hit_85) { lookup<open_map>(state, 85, true); }
+BENCHMARK(swiss_map, chain_hit_85) { lookup<chain_map>(state, 85, true); }
+BENCHMARK(swiss_map, std_hit_85) { lookup<std_map>(state, 85, true); }
+BENCHMARK(swiss_map, swiss_miss_85) { lookup<swiss_map>(state, 85, false); }
+BENCHMARK(swiss_map, open_miss_85) { lookup<open_map>(state, 85, false); }
+BENCHMARK(swiss_map, chain_miss_85) { lookup<chain_map>(state, 85, false); }
+BENCHMARK(swiss_map, std_miss_85) { lookup<std_map>(state, 85, false); }
@@ -14,10 +14,34 @@
 #include <stdint.h>
 #include "strings/StaticString.h"
 
+/*
+ * WLIB_SIZE_TYPE_BITS selects the width of size_type, the index type of
+ * every container, for the whole build. The default of 16 bits keeps
+ * containers compact on microcontrollers. Builds holding more than
+ * 65,535 elements, such as on a Linux gateway, define it to 32 or 64.
+ */
+#ifndef WLIB_SIZE_TYPE_BITS
+#define WLIB_SIZE_TYPE_BITS 16
+#endif
+
 namespace wlp {
 
-    // size
+    // size, and a type holding a size multiplied by a percentage
+#if WLIB_SIZE_TYPE_BITS == 16
     typedef uint16_t size_type;
+    typedef uint32_t wide_size_type;
+#elif WLIB_SIZE_TYPE_BITS == 32
+    typedef uint32_t size_type;
+    typedef uint64_t wide_size_type;
+#elif WLIB_SIZE_TYPE_BITS == 64
+    typedef uint64_t size_type;
+    typedef uint64_t wide_size_type;
+#else
+#error "WLIB_SIZE_TYPE_BITS must be 16, 32 or 64"
+#endif
+
+    // largest value of size_type
+    static constexpr size_type max_size_type = static_cast<size_type>(~static_cast<size_type>(0));
 
     // Static Strings
     typedef StaticString<8> String8;
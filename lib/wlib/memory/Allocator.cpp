@@ -11,13 +11,14 @@
 #include <math.h>
 
 #include "Allocator.h"
+#include "NoAllocScope.h"
 
 #include "../Types.h"
 
 #include "../stl/Utility.h"
 
 
-wlp::Allocator::Allocator(uint16_t blockSize, uint16_t poolSize, wlp::Allocator::Type allocationType, void *pPool) :
+wlp::Allocator::Allocator(size_type blockSize, size_type poolSize, wlp::Allocator::Type allocationType, void *pPool) :
         m_poolType{allocationType},
         m_blockSize{blockSize},
         m_pHead{nullptr},
@@ -36,7 +37,7 @@ wlp::Allocator::Allocator(uint16_t blockSize, uint16_t poolSize, wlp::Allocator:
         m_poolSize = max(m_blockSize, poolSize);
 
         // find the closest round number that describes the number of blocks
-        m_poolTotalBlockCnt = (uint16_t) roundf(m_poolSize / (float) m_blockSize);
+        m_poolTotalBlockCnt = (size_type) roundf(m_poolSize / (float) m_blockSize);
         m_poolCurrBlockCnt = m_poolTotalBlockCnt;
         m_totalBlockCount = m_poolTotalBlockCnt;
 
@@ -121,10 +122,10 @@ wlp::Allocator &wlp::Allocator::operator=(Allocator &&allocator) {
     return *this;
 }
 
-wlp::Allocator::Allocator(uint16_t blockSize, uint16_t poolSize) :
+wlp::Allocator::Allocator(size_type blockSize, size_type poolSize) :
         wlp::Allocator(blockSize, poolSize, DYNAMIC, nullptr) {}
 
-wlp::Allocator::Allocator(uint16_t blockSize, void *pPool, uint16_t poolSize, Type type) :
+wlp::Allocator::Allocator(size_type blockSize, void *pPool, size_type poolSize, Type type) :
         wlp::Allocator(blockSize, poolSize, type, pPool) {}
 
 wlp::Allocator::~Allocator() {
@@ -159,6 +160,7 @@ void *wlp::Allocator::Allocate() {
         --m_poolCurrBlockCnt;
     } else {
         // Otherwise, get a 'new' one from heap.
+        NoAllocScope::NotifyHeapOverflow();
         pBlock = (wlp::Allocator::Block *) new char[m_blockSize];
         ++m_totalBlockCount;
     }
@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "../Types.h"
 #include "../Wlib.h"
 
 namespace wlp {
@@ -57,7 +58,7 @@ namespace wlp {
          * @param blockSize size of memory blocks that can acquired at a time
          * @param poolSize size of memory pool to be created
          */
-        explicit Allocator(uint16_t blockSize, uint16_t poolSize = 0);
+        explicit Allocator(size_type blockSize, size_type poolSize = 0);
 
         /**
          * Allocator used for allocating memory where memory is provided to the allocator. It uses the given
@@ -74,7 +75,7 @@ namespace wlp {
          * @param poolSize size of the memory pool provided
          * @param type type of memory pool provided (static or dynamic)
          */
-        Allocator(uint16_t blockSize, void *pPool, uint16_t poolSize, Type type);
+        Allocator(size_type blockSize, void *pPool, size_type poolSize, Type type);
 
         /**
          * Deletes memory and returns it back to the system
@@ -115,7 +116,7 @@ namespace wlp {
 
             if (!m_pPool)return false;
             return ((char *) pBlock >= (char *) m_pPool &&
-                    (char *) pBlock <= (char *) m_pPool + m_blockSize * (m_totalBlockCount - 1));
+                    (char *) pBlock <= (char *) m_pPool + m_blockSize * (m_poolTotalBlockCnt - 1));
         }
 
         /**
@@ -141,7 +142,7 @@ namespace wlp {
          *
          * @return number of memory blocks available in the pool
          */
-        inline uint16_t GetNumPoolBlocksAvail() const {
+        inline size_type GetNumPoolBlocksAvail() const {
             return m_poolCurrBlockCnt;
         }
 
@@ -150,7 +151,7 @@ namespace wlp {
          *
          * @return number of memory blocks in total in the pool
          */
-        inline uint16_t GetTotalPoolBlocks() const {
+        inline size_type GetTotalPoolBlocks() const {
             return m_poolTotalBlockCnt;
         }
 
@@ -159,7 +160,7 @@ namespace wlp {
          *
          * @return number of memory blocks in total in Allocator
          */
-        inline uint16_t GetTotalBlocks() const {
+        inline size_type GetTotalBlocks() const {
             return m_totalBlockCount;
         }
 
@@ -168,7 +169,7 @@ namespace wlp {
          *
          * @return the number of allocations
          */
-        inline uint16_t GetNumAllocations() const {
+        inline size_type GetNumAllocations() const {
             return m_allocations;
         }
 
@@ -177,7 +178,7 @@ namespace wlp {
          *
          * @return the number of de-allocations
          */
-        inline uint16_t GetNumDeallocations() const {
+        inline size_type GetNumDeallocations() const {
             return m_deallocations;
         }
 
@@ -185,6 +186,44 @@ namespace wlp {
 
         Allocator &operator=(Allocator &&allocator);
 
+    protected:
+        /**
+         * Free list head and counters of the pool, everything besides the pool
+         * memory itself that is needed to rewind the allocator
+         */
+        struct FreeListState {
+            Block *pHead;                   /*!< first free block */
+            size_type poolCurrBlockCnt;      /*!< number of free pool blocks */
+            size_type allocations;           /*!< allocation counter */
+            size_type deallocations;         /*!< de-allocation counter */
+        };
+
+        /**
+         * Records the free list and counters
+         *
+         * @param state where the free list is recorded
+         */
+        inline void SaveFreeList(FreeListState &state) const {
+            state.pHead = m_pHead;
+            state.poolCurrBlockCnt = m_poolCurrBlockCnt;
+            state.allocations = m_allocations;
+            state.deallocations = m_deallocations;
+        }
+
+        /**
+         * Rewinds the free list and counters to a recorded state
+         *
+         * @pre the pool memory must be restored to the matching contents
+         *
+         * @param state a state previously recorded by SaveFreeList
+         */
+        inline void RestoreFreeList(const FreeListState &state) {
+            m_pHead = state.pHead;
+            m_poolCurrBlockCnt = state.poolCurrBlockCnt;
+            m_allocations = state.allocations;
+            m_deallocations = state.deallocations;
+        }
+
     private:
         /**
          * Private constructor creates Allocator based on the calls made by other constructor. For more
@@ -195,7 +234,7 @@ namespace wlp {
          * @param allocationType type of memory in memory pool
          * @param pPool address to memory provided
          */
-        explicit Allocator(uint16_t blockSize, uint16_t poolSize, Allocator::Type allocationType, void *pPool);
+        explicit Allocator(size_type blockSize, size_type poolSize, Allocator::Type allocationType, void *pPool);
 
 
         Type m_poolType;
@@ -203,11 +242,11 @@ namespace wlp {
         Block *m_pHead;
         Block *m_pPool;
         size_t m_poolSize;
-        uint16_t m_poolTotalBlockCnt;
-        uint16_t m_poolCurrBlockCnt;
-        uint16_t m_totalBlockCount;
-        uint16_t m_allocations;
-        uint16_t m_deallocations;
+        size_type m_poolTotalBlockCnt;
+        size_type m_poolCurrBlockCnt;
+        size_type m_totalBlockCount;
+        size_type m_allocations;
+        size_type m_deallocations;
     };
 }
 
@@ -0,0 +1,439 @@
+/**
+ * @file ComposableAllocator.h
+ * @brief Compile-time building blocks for composing allocation policies
+ *
+ * Every building block exposes the same three functions: @code Allocate(size) @endcode,
+ * @code Deallocate(ptr, size) @endcode and @code Owns(ptr) @endcode. Blocks are combined
+ * by nesting templates, for instance
+ *
+ * @code
+ * typedef StatsAllocator<Segregator<64,
+ *         FallbackAllocator<PoolAllocator<StaticAllocatorPool<64, 32>>, MemoryAllocator>,
+ *         HeapAllocator>> policy;
+ * @endcode
+ *
+ * serves small sizes from a static pool, falls back to @code memory_alloc @endcode when the
+ * pool is exhausted, sends large sizes to the heap and records statistics for all of it. All
+ * dispatch is resolved at compile time so a composed allocator costs no more than the hand
+ * written wrapper it replaces.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_COMPOSABLEALLOCATOR_H
+#define EMBEDDEDCPLUSPLUS_COMPOSABLEALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Allocator.h"
+#include "Memory.h"
+
+namespace wlp {
+
+    /**
+     * Leaf allocator that forwards to @code memory_alloc @endcode and @code memory_free @endcode.
+     * It accepts any size and claims ownership of any block, so it should be the last
+     * allocator in a fallback chain.
+     */
+    class MemoryAllocator {
+    public:
+        inline void *Allocate(size_t size) {
+            return memory_alloc(size);
+        }
+
+        inline void Deallocate(void *pBlock, size_t) {
+            memory_free(pBlock);
+        }
+
+        inline bool Owns(void *) const {
+            return true;
+        }
+    };
+
+    /**
+     * Leaf allocator that takes memory directly from the system heap. Intended for large
+     * sizes that would waste space in the power of two buckets used by @code memory_alloc @endcode.
+     */
+    class HeapAllocator {
+    public:
+        inline void *Allocate(size_t size) {
+            return new char[size];
+        }
+
+        inline void Deallocate(void *pBlock, size_t) {
+            delete[] (char *) pBlock;
+        }
+
+        inline bool Owns(void *) const {
+            return true;
+        }
+    };
+
+    /**
+     * Adapts a fixed size @code Allocator @endcode pool, such as @code StaticAllocatorPool @endcode,
+     * into a building block. Unlike @code Allocator::Allocate @endcode the adapter never overflows
+     * to the heap: it returns nullptr if the size does not fit in a block or the pool is empty so
+     * that an enclosing @code FallbackAllocator @endcode can take over.
+     *
+     * @tparam Pool default constructible @code Allocator @endcode with a memory pool
+     */
+    template<class Pool>
+    class PoolAllocator {
+    public:
+        inline void *Allocate(size_t size) {
+            if (size > m_pool.GetBlockSize() || m_pool.GetNumPoolBlocksAvail() == 0) {
+                return nullptr;
+            }
+            return m_pool.Allocate();
+        }
+
+        inline void Deallocate(void *pBlock, size_t) {
+            m_pool.Deallocate(pBlock);
+        }
+
+        inline bool Owns(void *pBlock) const {
+            return m_pool.IsPoolBlock(pBlock);
+        }
+
+        /**
+         * Gives access to the underlying pool
+         *
+         * @return the adapted pool
+         */
+        inline const Pool &GetPool() const {
+            return m_pool;
+        }
+
+    private:
+        Pool m_pool;
+    };
+
+    /**
+     * Dispatches requests of at most @code tThreshold @endcode bytes to the small allocator and
+     * everything else to the large allocator. Since the size is also passed on de-allocation the
+     * segregator needs no ownership query to route a block back.
+     *
+     * @tparam tThreshold largest size in bytes served by the small allocator
+     * @tparam Small      allocator for sizes up to and including the threshold
+     * @tparam Large      allocator for sizes above the threshold
+     */
+    template<size_t tThreshold, class Small, class Large>
+    class Segregator {
+    public:
+        inline void *Allocate(size_t size) {
+            return size <= tThreshold ? m_small.Allocate(size) : m_large.Allocate(size);
+        }
+
+        inline void Deallocate(void *pBlock, size_t size) {
+            if (size <= tThreshold) {
+                m_small.Deallocate(pBlock, size);
+            } else {
+                m_large.Deallocate(pBlock, size);
+            }
+        }
+
+        inline bool Owns(void *pBlock) const {
+            return m_small.Owns(pBlock) || m_large.Owns(pBlock);
+        }
+
+        inline Small &GetSmall() {
+            return m_small;
+        }
+
+        inline Large &GetLarge() {
+            return m_large;
+        }
+
+    private:
+        Small m_small;
+        Large m_large;
+    };
+
+    /**
+     * Tries the primary allocator first and uses the secondary allocator when the primary
+     * returns nullptr. On de-allocation the primary is asked whether it owns the block.
+     *
+     * @tparam Primary   allocator tried first, must implement a precise @code Owns @endcode
+     * @tparam Secondary allocator used when the primary fails
+     */
+    template<class Primary, class Secondary>
+    class FallbackAllocator {
+    public:
+        inline void *Allocate(size_t size) {
+            void *pBlock = m_primary.Allocate(size);
+            if (!pBlock) {
+                pBlock = m_secondary.Allocate(size);
+            }
+            return pBlock;
+        }
+
+        inline void Deallocate(void *pBlock, size_t size) {
+            if (m_primary.Owns(pBlock)) {
+                m_primary.Deallocate(pBlock, size);
+            } else {
+                m_secondary.Deallocate(pBlock, size);
+            }
+        }
+
+        inline bool Owns(void *pBlock) const {
+            return m_primary.Owns(pBlock) || m_secondary.Owns(pBlock);
+        }
+
+        inline Primary &GetPrimary() {
+            return m_primary;
+        }
+
+        inline Secondary &GetSecondary() {
+            return m_secondary;
+        }
+
+    private:
+        Primary m_primary;
+        Secondary m_secondary;
+    };
+
+    /**
+     * Records allocation statistics of the wrapped allocator.
+     *
+     * @tparam A the allocator to observe
+     */
+    template<class A>
+    class StatsAllocator {
+    public:
+        StatsAllocator() :
+                m_allocations{0},
+                m_deallocations{0},
+                m_failures{0},
+                m_bytesInUse{0},
+                m_peakBytes{0} {}
+
+        inline void *Allocate(size_t size) {
+            void *pBlock = m_allocator.Allocate(size);
+            if (!pBlock) {
+                ++m_failures;
+                return nullptr;
+            }
+            ++m_allocations;
+            m_bytesInUse += size;
+            if (m_bytesInUse > m_peakBytes) {
+                m_peakBytes = m_bytesInUse;
+            }
+            return pBlock;
+        }
+
+        inline void Deallocate(void *pBlock, size_t size) {
+            if (!pBlock) {
+                return;
+            }
+            m_allocator.Deallocate(pBlock, size);
+            ++m_deallocations;
+            m_bytesInUse -= size;
+        }
+
+        inline bool Owns(void *pBlock) const {
+            return m_allocator.Owns(pBlock);
+        }
+
+        /**
+         * Gives access to the number of successful allocations so far
+         *
+         * @return the number of allocations
+         */
+        inline size_t GetNumAllocations() const {
+            return m_allocations;
+        }
+
+        /**
+         * Gives access to the number of de-allocations so far
+         *
+         * @return the number of de-allocations
+         */
+        inline size_t GetNumDeallocations() const {
+            return m_deallocations;
+        }
+
+        /**
+         * Gives access to the number of requests the wrapped allocator could not serve
+         *
+         * @return the number of failed allocations
+         */
+        inline size_t GetNumFailures() const {
+            return m_failures;
+        }
+
+        /**
+         * Gives access to the number of requested bytes currently handed out
+         *
+         * @return bytes in use
+         */
+        inline size_t GetBytesInUse() const {
+            return m_bytesInUse;
+        }
+
+        /**
+         * Gives access to the highest number of bytes in use at any one time
+         *
+         * @return peak bytes in use
+         */
+        inline size_t GetPeakBytes() const {
+            return m_peakBytes;
+        }
+
+        inline A &GetAllocator() {
+            return m_allocator;
+        }
+
+    private:
+        A m_allocator;
+        size_t m_allocations;
+        size_t m_deallocations;
+        size_t m_failures;
+        size_t m_bytesInUse;
+        size_t m_peakBytes;
+    };
+
+    /**
+     * Size of an affix rounded up to pointer alignment, zero for void.
+     *
+     * @tparam T the affix type
+     */
+    template<class T>
+    struct AffixSize {
+        static constexpr size_t value = (sizeof(T) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    };
+
+    template<>
+    struct AffixSize<void> {
+        static constexpr size_t value = 0;
+    };
+
+    /**
+     * Alignment of an affix, one for void.
+     *
+     * @tparam T the affix type
+     */
+    template<class T>
+    struct AffixAlign {
+        static constexpr size_t value = alignof(T);
+    };
+
+    template<>
+    struct AffixAlign<void> {
+        static constexpr size_t value = 1;
+    };
+
+    /**
+     * Initializes an affix in raw memory by copying the bytes of a default
+     * constructed value, so no object of the affix type has to exist in the
+     * raw memory beforehand. Does nothing for void.
+     *
+     * @tparam T the affix type, which must be trivially copyable
+     */
+    template<class T>
+    struct AffixInit {
+        static inline void init(void *pAffix) {
+            T affix = T();
+            memcpy(pAffix, &affix, sizeof(T));
+        }
+    };
+
+    template<>
+    struct AffixInit<void> {
+        static inline void init(void *) {}
+    };
+
+    /**
+     * Surrounds every block with a prefix and an optional suffix object, for instance a
+     * header holding the block size or a canary to catch overruns. The prefix is padded
+     * to pointer alignment so the client's memory keeps the alignment of the wrapped block.
+     * The suffix starts at the end of the client memory rounded up to the alignment of the
+     * suffix type. Affixes are copied from a default constructed value on allocation.
+     *
+     * @tparam A      the allocator providing the underlying memory
+     * @tparam Prefix type stored in front of the client memory
+     * @tparam Suffix type stored after the client memory, or void for none
+     */
+    template<class A, class Prefix, class Suffix = void>
+    class AffixAllocator {
+    public:
+        static constexpr size_t PREFIX_SIZE = AffixSize<Prefix>::value;
+        static constexpr size_t SUFFIX_SIZE = AffixSize<Suffix>::value;
+
+        /**
+         * @param size the size requested by the client
+         * @return the offset of the suffix from the client memory
+         */
+        static constexpr size_t SuffixOffset(size_t size) {
+            return (size + AffixAlign<Suffix>::value - 1) / AffixAlign<Suffix>::value * AffixAlign<Suffix>::value;
+        }
+
+        /**
+         * @param size the size requested by the client
+         * @return the size requested from the wrapped allocator
+         */
+        static constexpr size_t RawSize(size_t size) {
+            return PREFIX_SIZE + SuffixOffset(size) + SUFFIX_SIZE;
+        }
+
+        inline void *Allocate(size_t size) {
+            char *pRaw = (char *) m_allocator.Allocate(RawSize(size));
+            if (!pRaw) {
+                return nullptr;
+            }
+            AffixInit<Prefix>::init(pRaw);
+            AffixInit<Suffix>::init(pRaw + PREFIX_SIZE + SuffixOffset(size));
+            return pRaw + PREFIX_SIZE;
+        }
+
+        inline void Deallocate(void *pBlock, size_t size) {
+            if (!pBlock) {
+                return;
+            }
+            m_allocator.Deallocate((char *) pBlock - PREFIX_SIZE, RawSize(size));
+        }
+
+        inline bool Owns(void *pBlock) const {
+            return m_allocator.Owns((char *) pBlock - PREFIX_SIZE);
+        }
+
+        /**
+         * Gives access to the prefix of a block handed out by this allocator
+         *
+         * @param pBlock client memory returned by Allocate
+         * @return the prefix object of the block
+         */
+        static inline Prefix *GetPrefix(void *pBlock) {
+            return (Prefix *) ((char *) pBlock - PREFIX_SIZE);
+        }
+
+        /**
+         * Gives access to the suffix of a block handed out by this allocator
+         *
+         * @param pBlock client memory returned by Allocate
+         * @param size the size originally requested
+         * @return the suffix object of the block
+         */
+        template<class S = Suffix>
+        static inline S *GetSuffix(void *pBlock, size_t size) {
+            return (S *) ((char *) pBlock + SuffixOffset(size));
+        }
+
+        inline A &GetAllocator() {
+            return m_allocator;
+        }
+
+    private:
+        A m_allocator;
+    };
+
+    template<class A, class Prefix, class Suffix>
+    constexpr size_t AffixAllocator<A, Prefix, Suffix>::PREFIX_SIZE;
+
+    template<class A, class Prefix, class Suffix>
+    constexpr size_t AffixAllocator<A, Prefix, Suffix>::SUFFIX_SIZE;
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_COMPOSABLEALLOCATOR_H
@@ -10,8 +10,8 @@
  * @bug No known bugs
  */
 
-#ifndef FIXED_MEMORY_ALLOCATORPOOL_H
-#define FIXED_MEMORY_ALLOCATORPOOL_H
+#ifndef FIXED_MEMORY_DYNAMICALLOCATORPOOL_H
+#define FIXED_MEMORY_DYNAMICALLOCATORPOOL_H
 
 #include "Allocator.h"
 
@@ -23,4 +23,4 @@ namespace wlp{
     };
 }
 
-#endif //FIXED_MEMORY_ALLOCATORPOOL_H
+#endif //FIXED_MEMORY_DYNAMICALLOCATORPOOL_H
@@ -0,0 +1,319 @@
+/**
+ * @file EpochReclaimer.h
+ * @brief Epoch based memory reclamation for lock-free structures
+ *
+ * Nodes unlinked from a lock-free structure cannot be handed back to an @code Allocator @endcode
+ * while other threads may still be reading them. Threads wrap their accesses in a critical
+ * section (@code Enter @endcode/@code Exit @endcode) tagged with the global epoch. Unlinked
+ * nodes are retired into a per-thread list tagged with the global epoch at retirement, and
+ * the global epoch only advances once every thread inside a critical section has observed it.
+ * A list retired in epoch e is therefore unreachable once the global epoch reaches e + 2, at
+ * which point the whole list is returned to the pool under a single lock acquisition.
+ *
+ * Retired nodes are linked through an @code EpochEntry @endcode that must be the first base of
+ * the node type, in the same spirit as the free list of @code Allocator @endcode. Readers must
+ * never access the entry itself.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_EPOCHRECLAIMER_H
+#define EMBEDDEDCPLUSPLUS_EPOCHRECLAIMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Allocator.h"
+
+namespace wlp {
+
+    /**
+     * Link used to chain retired nodes. Lock-free node types must inherit
+     * from this struct first so that the entry address is the block address.
+     */
+    struct EpochEntry {
+        EpochEntry *pNextRetired;   /*!< next node in the retire list */
+    };
+
+    /**
+     * Epoch based reclaimer returning retired blocks to a pool in bulk.
+     *
+     * @tparam Pool        pool providing @code Allocate() @endcode and @code Deallocate(void *) @endcode
+     * @tparam tMaxThreads maximum number of threads registered at the same time
+     * @tparam tBatchSize  number of retirements by a thread before it tries to advance the epoch
+     */
+    template<class Pool = Allocator, uint16_t tMaxThreads = 8, uint16_t tBatchSize = 64>
+    class EpochReclaimer {
+    public:
+        /**
+         * Per-thread record. Each record sits in its own cache line so that
+         * pinning does not cause false sharing between threads.
+         */
+        struct alignas(64) Participant {
+            uint32_t m_state;               /*!< pinned epoch shifted left once, lowest bit set while pinned */
+            uint8_t m_inUse;                /*!< set while the record is registered to a thread */
+            uint16_t m_sinceAdvance;        /*!< retirements since the last advance attempt */
+            uint32_t m_limboEpoch[3];       /*!< epoch in which each limbo list was retired */
+            EpochEntry *m_pLimbo[3];        /*!< retired nodes indexed by epoch modulo three */
+        };
+
+        /**
+         * Create a reclaimer returning blocks to the given pool. The pool is
+         * not owned and must outlive the reclaimer.
+         *
+         * @param pPool the pool from which nodes are allocated
+         */
+        explicit EpochReclaimer(Pool *pPool) :
+                m_pPool{pPool},
+                m_epoch{0},
+                m_poolLock{0},
+                m_retired{0},
+                m_reclaimed{0} {
+            for (auto &participant : m_participants) {
+                participant.m_state = 0;
+                participant.m_inUse = 0;
+                participant.m_sinceAdvance = 0;
+                for (uint8_t i = 0; i < 3; ++i) {
+                    participant.m_limboEpoch[i] = 0;
+                    participant.m_pLimbo[i] = nullptr;
+                }
+            }
+        }
+
+        EpochReclaimer(const EpochReclaimer &) = delete;
+
+        /**
+         * Returns every retired node to the pool
+         *
+         * @pre No thread may be inside a critical section
+         */
+        ~EpochReclaimer() {
+            for (auto &participant : m_participants) {
+                for (uint8_t i = 0; i < 3; ++i) {
+                    ReclaimList(participant.m_pLimbo[i]);
+                    participant.m_pLimbo[i] = nullptr;
+                }
+            }
+        }
+
+        /**
+         * Claims a participant record for the calling thread. A record left behind
+         * by an unregistered thread is reused together with its pending retirements.
+         *
+         * @return the record or nullptr if all tMaxThreads records are in use
+         */
+        Participant *Register() {
+            for (auto &participant : m_participants) {
+                uint8_t expected = 0;
+                if (__atomic_compare_exchange_n(&participant.m_inUse, &expected, 1, false,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                    return &participant;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * Releases a record. Nodes it retired stay in the record until they can be reclaimed.
+         *
+         * @pre the thread must not be inside a critical section
+         * @param pParticipant the record of the calling thread
+         */
+        void Unregister(Participant *pParticipant) {
+            __atomic_store_n(&pParticipant->m_inUse, 0, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Enters a critical section. Nodes reachable when entering stay valid until Exit.
+         *
+         * @param pParticipant the record of the calling thread
+         */
+        inline void Enter(Participant *pParticipant) {
+            uint32_t epoch = __atomic_load_n(&m_epoch, __ATOMIC_RELAXED);
+            __atomic_store_n(&pParticipant->m_state, (epoch << 1) | 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        }
+
+        /**
+         * Leaves a critical section.
+         *
+         * @param pParticipant the record of the calling thread
+         */
+        inline void Exit(Participant *pParticipant) {
+            __atomic_store_n(&pParticipant->m_state, pParticipant->m_state & ~(uint32_t) 1, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Allocates a node from the pool. Access to the pool is serialized with bulk reclamation.
+         *
+         * @return address of a pool block
+         */
+        void *Allocate() {
+            LockPool();
+            void *pBlock = m_pPool->Allocate();
+            UnlockPool();
+            return pBlock;
+        }
+
+        /**
+         * Retires a node that has been unlinked from the shared structure. The node is returned
+         * to the pool once no thread can hold a reference to it.
+         *
+         * @param pParticipant the record of the calling thread
+         * @param pEntry the unlinked node
+         */
+        void Retire(Participant *pParticipant, EpochEntry *pEntry) {
+            // tag with the global epoch observed after the unlink, a reader may have
+            // pinned a newer epoch than the calling thread before the node was unlinked
+            uint32_t epoch = __atomic_load_n(&m_epoch, __ATOMIC_SEQ_CST);
+            uint8_t i = (uint8_t) (epoch % 3);
+            if (pParticipant->m_pLimbo[i] && pParticipant->m_limboEpoch[i] != epoch) {
+                // an older list in the same slot is at least three epochs behind
+                ReclaimList(pParticipant->m_pLimbo[i]);
+                pParticipant->m_pLimbo[i] = nullptr;
+            }
+            pEntry->pNextRetired = pParticipant->m_pLimbo[i];
+            pParticipant->m_pLimbo[i] = pEntry;
+            pParticipant->m_limboEpoch[i] = epoch;
+            __atomic_add_fetch(&m_retired, 1, __ATOMIC_RELAXED);
+
+            if (++pParticipant->m_sinceAdvance >= tBatchSize) {
+                pParticipant->m_sinceAdvance = 0;
+                TryAdvance();
+                Collect(pParticipant);
+            }
+        }
+
+        /**
+         * Advances the global epoch if every pinned thread has observed the current one.
+         *
+         * @return true if the epoch was advanced by this call
+         */
+        bool TryAdvance() {
+            uint32_t epoch = __atomic_load_n(&m_epoch, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            uint32_t pinned = (epoch << 1) | 1;
+            for (auto &participant : m_participants) {
+                uint32_t state = __atomic_load_n(&participant.m_state, __ATOMIC_RELAXED);
+                if ((state & 1) && state != pinned) {
+                    return false;
+                }
+            }
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            return __atomic_compare_exchange_n(&m_epoch, &epoch, epoch + 1, false,
+                                               __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Returns the calling thread's limbo lists that are at least two epochs old to the pool.
+         *
+         * @param pParticipant the record of the calling thread
+         */
+        void Collect(Participant *pParticipant) {
+            uint32_t epoch = __atomic_load_n(&m_epoch, __ATOMIC_ACQUIRE);
+            for (uint8_t i = 0; i < 3; ++i) {
+                if (pParticipant->m_pLimbo[i] && epoch - pParticipant->m_limboEpoch[i] >= 2) {
+                    ReclaimList(pParticipant->m_pLimbo[i]);
+                    pParticipant->m_pLimbo[i] = nullptr;
+                }
+            }
+        }
+
+        /**
+         * Gives access to the global epoch
+         *
+         * @return the current epoch
+         */
+        inline uint32_t GetEpoch() const {
+            return __atomic_load_n(&m_epoch, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Gives access to the number of nodes retired so far
+         *
+         * @return the number of retirements
+         */
+        inline size_t GetNumRetired() const {
+            return __atomic_load_n(&m_retired, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Gives access to the number of retired nodes returned to the pool so far
+         *
+         * @return the number of reclaimed nodes
+         */
+        inline size_t GetNumReclaimed() const {
+            return __atomic_load_n(&m_reclaimed, __ATOMIC_RELAXED);
+        }
+
+        EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+
+    private:
+        inline void LockPool() {
+            while (__atomic_test_and_set(&m_poolLock, __ATOMIC_ACQUIRE)) {
+                while (__atomic_load_n(&m_poolLock, __ATOMIC_RELAXED));
+            }
+        }
+
+        inline void UnlockPool() {
+            __atomic_clear(&m_poolLock, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Returns a list of retired nodes to the pool under one lock acquisition
+         *
+         * @param pEntry head of the list
+         */
+        void ReclaimList(EpochEntry *pEntry) {
+            if (!pEntry) {
+                return;
+            }
+            size_t count = 0;
+            LockPool();
+            while (pEntry) {
+                EpochEntry *pNext = pEntry->pNextRetired;
+                m_pPool->Deallocate(pEntry);
+                pEntry = pNext;
+                ++count;
+            }
+            UnlockPool();
+            __atomic_add_fetch(&m_reclaimed, count, __ATOMIC_RELAXED);
+        }
+
+        Pool *m_pPool;
+        uint32_t m_epoch;
+        bool m_poolLock;
+        size_t m_retired;
+        size_t m_reclaimed;
+        Participant m_participants[tMaxThreads];
+    };
+
+    /**
+     * Scoped critical section of an @code EpochReclaimer @endcode.
+     *
+     * @tparam Reclaimer the reclaimer type
+     */
+    template<class Reclaimer>
+    class EpochGuard {
+    public:
+        EpochGuard(Reclaimer &reclaimer, typename Reclaimer::Participant *pParticipant) :
+                m_reclaimer(reclaimer),
+                m_pParticipant{pParticipant} {
+            m_reclaimer.Enter(m_pParticipant);
+        }
+
+        EpochGuard(const EpochGuard &) = delete;
+
+        ~EpochGuard() {
+            m_reclaimer.Exit(m_pParticipant);
+        }
+
+        EpochGuard &operator=(const EpochGuard &) = delete;
+
+    private:
+        Reclaimer &m_reclaimer;
+        typename Reclaimer::Participant *m_pParticipant;
+    };
+}
+
+#endif //EMBEDDEDCPLUSPLUS_EPOCHRECLAIMER_H
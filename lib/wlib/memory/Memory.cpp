@@ -10,6 +10,7 @@
 #include <string.h>
 #include "Memory.h"
 #include "Allocator.h"
+#include "NoAllocScope.h"
 
 #ifndef CHAR_BIT
 #define CHAR_BIT    8
@@ -111,9 +112,15 @@ static inline void *set_block_allocator(void *block, Allocator *allocator) {
  * Get an Allocator instance based upon the client's requested block size.
  * If there is no such Allocator available, create a new one
  * @param size client's requested block size
- * @return an allocator instance that handles the block size
+ * @return an allocator instance that handles the block size, or nullptr if
+ * the block size does not fit the size type
  */
 extern "C" Allocator *memory_get_allocator(size_t size) {
+    // Allocators take their block size as a size_type, which would
+    // silently truncate larger blocks
+    if (size > max_size_type - sizeof(Allocator *))
+        return nullptr;
+
     // Based on the size, find the next higher powers of two value.
     // Add sizeof(Allocator*) to the requested block size to hold the size
     // within the block memory region. Most blocks are powers of two,
@@ -127,6 +134,9 @@ extern "C" Allocator *memory_get_allocator(size_t size) {
     else
         blockSize = nextHigher<size_t>(blockSize);
 
+    if (blockSize > max_size_type)
+        return nullptr;
+
     Allocator *allocator = find_allocator(blockSize);
 
     // If there is not an allocator already created to handle this block size
@@ -145,11 +155,16 @@ extern "C" Allocator *memory_get_allocator(size_t size) {
  * Allocates a memory block of the requested size. The blocks are created from
  * the fixed block allocators
  * @param size the client's requested size of the block
- * @return a pointer to the memory block
+ * @return a pointer to the memory block, or nullptr if the block size does
+ * not fit the size type
  */
 extern "C" void *memory_alloc(size_t size) {
+    NoAllocScope::NotifyAllocation();
+
     // Allocate a raw memory block
     Allocator *allocator = memory_get_allocator(size);
+    if (allocator == nullptr)
+        return nullptr;
     void *blockMemoryPtr = allocator->Allocate();
 
     // Set the block Allocator* within the raw memory block region
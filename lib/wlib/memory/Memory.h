@@ -15,6 +15,8 @@
 
 #include <stddef.h>
 
+#include "../Types.h"
+
 /**
  * @brief Helper for initializing and destroying memory management
  *
@@ -56,7 +58,8 @@ void memory_destroy();
  * asked in order to accommodate fixed memory allocations
  *
  * @param size size of the block to allocate
- * @return address to memory allocated
+ * @return address to memory allocated, or nullptr if the block, including its
+ *         allocator header and rounding, is larger than the size type can hold
  */
 void *memory_alloc(size_t size);
 
@@ -89,4 +92,19 @@ void *memory_realloc(void *ptr, size_t size);
 
 };
 
+/**
+ * This allocates memory for an array of n elements of type T. The array size is
+ * checked against the size type before it is multiplied out, so it cannot wrap
+ *
+ * @tparam T type of the elements
+ * @param n number of elements
+ * @return address to memory allocated, or nullptr if the array does not fit
+ */
+template<class T>
+T *memory_alloc_array(size_t n) {
+    if (n > wlp::max_size_type / sizeof(T))
+        return nullptr;
+    return static_cast<T *>(memory_alloc(n * sizeof(T)));
+}
+
 #endif //FIXED_MEMORY_MEMORY_H
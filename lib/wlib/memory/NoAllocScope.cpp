@@ -0,0 +1,56 @@
+/**
+ * @file NoAllocScope.cpp
+ * @brief Implementation of NoAllocScope
+ *
+ * @bug No known bugs
+ */
+
+#include "NoAllocScope.h"
+
+#ifndef NDEBUG
+
+static wlp::NoAllocScope *_activeScope = nullptr;
+
+static void default_trap_handler(const char *) {
+    __builtin_trap();
+}
+
+static wlp::no_alloc_trap_handler _trapHandler = default_trap_handler;
+
+wlp::NoAllocScope::NoAllocScope(Mode mode) :
+        m_mode{mode},
+        m_allocations{0},
+        m_heapOverflows{0},
+        m_pEnclosing{_activeScope} {
+    _activeScope = this;
+}
+
+wlp::NoAllocScope::~NoAllocScope() {
+    _activeScope = m_pEnclosing;
+}
+
+void wlp::NoAllocScope::SetTrapHandler(no_alloc_trap_handler handler) {
+    _trapHandler = handler ? handler : default_trap_handler;
+}
+
+void wlp::NoAllocScope::NotifyAllocation() {
+    for (NoAllocScope *scope = _activeScope; scope; scope = scope->m_pEnclosing) {
+        ++scope->m_allocations;
+        scope->Trap("memory_alloc inside NoAllocScope");
+    }
+}
+
+void wlp::NoAllocScope::NotifyHeapOverflow() {
+    for (NoAllocScope *scope = _activeScope; scope; scope = scope->m_pEnclosing) {
+        ++scope->m_heapOverflows;
+        scope->Trap("Allocator overflow to heap inside NoAllocScope");
+    }
+}
+
+void wlp::NoAllocScope::Trap(const char *what) {
+    if (m_mode == TRAP) {
+        _trapHandler(what);
+    }
+}
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file NoAllocScope.h
+ * @brief Scoped guard that detects allocations inside hot code paths
+ *
+ * While a @code NoAllocScope @endcode is alive every call to @code memory_alloc @endcode and
+ * every @code Allocator::Allocate @endcode that overflows its pool to the heap is recorded. In
+ * @code COUNT @endcode mode the events are only counted so a test can assert on them; in
+ * @code TRAP @endcode mode the trap handler is invoked on every event. The default handler
+ * stops the program, so a debugger points at the first offending call.
+ *
+ * Scopes nest, and an event is recorded by every live scope, so a counting scope opened in a
+ * helper does not turn off a trapping scope around it. The guard is meant for single threaded
+ * control loops: the live scopes are global and not tracked per thread.
+ *
+ * When NDEBUG is defined the guard and the hooks in @code memory_alloc @endcode and
+ * @code Allocator @endcode compile to nothing and the counters always read zero.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_NOALLOCSCOPE_H
+#define EMBEDDEDCPLUSPLUS_NOALLOCSCOPE_H
+
+#include <stddef.h>
+
+namespace wlp {
+
+    /**
+     * Function called by a trapping scope when an allocation happens inside it
+     *
+     * @param what short description of the event
+     */
+    typedef void (*no_alloc_trap_handler)(const char *what);
+
+#ifndef NDEBUG
+
+    class NoAllocScope {
+    public:
+        /**
+         * What a scope does when an allocation happens inside it
+         */
+        enum Mode {
+            COUNT,  /**< record the event */
+            TRAP    /**< record the event and call the trap handler */
+        };
+
+        /**
+         * Opens a scope that becomes the innermost live scope
+         *
+         * @param mode whether to count or trap allocations
+         */
+        explicit NoAllocScope(Mode mode = COUNT);
+
+        NoAllocScope(const NoAllocScope &) = delete;
+
+        /**
+         * Closes the scope and restores the enclosing one
+         */
+        ~NoAllocScope();
+
+        /**
+         * Gives access to the number of memory_alloc calls made inside the scope
+         *
+         * @return the number of memory_alloc calls
+         */
+        inline size_t GetNumAllocations() const {
+            return m_allocations;
+        }
+
+        /**
+         * Gives access to the number of pool allocations that overflowed to the heap
+         *
+         * @return the number of heap overflows
+         */
+        inline size_t GetNumHeapOverflows() const {
+            return m_heapOverflows;
+        }
+
+        /**
+         * Replaces the handler used by trapping scopes. Passing nullptr restores
+         * the default handler, which calls __builtin_trap.
+         *
+         * @param handler the new handler
+         */
+        static void SetTrapHandler(no_alloc_trap_handler handler);
+
+        /**
+         * Records a memory_alloc call in every live scope
+         */
+        static void NotifyAllocation();
+
+        /**
+         * Records a pool overflow to the heap in every live scope
+         */
+        static void NotifyHeapOverflow();
+
+        NoAllocScope &operator=(const NoAllocScope &) = delete;
+
+    private:
+        void Trap(const char *what);
+
+        Mode m_mode;
+        size_t m_allocations;
+        size_t m_heapOverflows;
+        NoAllocScope *m_pEnclosing;
+    };
+
+#else
+
+    class NoAllocScope {
+    public:
+        enum Mode {
+            COUNT,
+            TRAP
+        };
+
+        explicit NoAllocScope(Mode = COUNT) {}
+
+        NoAllocScope(const NoAllocScope &) = delete;
+
+        inline size_t GetNumAllocations() const {
+            return 0;
+        }
+
+        inline size_t GetNumHeapOverflows() const {
+            return 0;
+        }
+
+        static inline void SetTrapHandler(no_alloc_trap_handler) {}
+
+        static inline void NotifyAllocation() {}
+
+        static inline void NotifyHeapOverflow() {}
+
+        NoAllocScope &operator=(const NoAllocScope &) = delete;
+    };
+
+#endif
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_NOALLOCSCOPE_H
@@ -3,15 +3,27 @@
  * @brief Template class to create static memory pools
  *
  * This class is a generalization of the @code Allocator @endcode class and can be used for
- * convenience
+ * convenience. The pool memory is aligned for any scalar type, so blocks are aligned as
+ * long as the block size is a multiple of that alignment.
+ *
+ * A checkpoint captures only the pool memory. Containers whose whole state lives inline,
+ * such as @code StaticOpenHashMap @endcode, are rewound with the pool when they are
+ * created in a pool block with @code Create @endcode. Containers that build their own
+ * @code Allocator @endcode or call @code memory_alloc @endcode, as the dynamic maps do for
+ * their nodes and bucket arrays, keep that memory outside of any pool and are not rewound
+ * by restoring a pool checkpoint.
  *
  * @author Deep Dhillon
  * @date November 11, 2017
  * @bug No known bugs
  */
 
-#ifndef FIXED_MEMORY_ALLOCATORPOOL_H
-#define FIXED_MEMORY_ALLOCATORPOOL_H
+#ifndef FIXED_MEMORY_STATICALLOCATORPOOL_H
+#define FIXED_MEMORY_STATICALLOCATORPOOL_H
+
+#include <new>
+#include <stddef.h>
+#include <string.h>
 
 #include "Allocator.h"
 
@@ -19,11 +31,80 @@ namespace wlp{
     template<uint16_t tblockSize, uint16_t tnumBlocks>
     class StaticAllocatorPool : public Allocator {
     public:
+        /**
+         * Snapshot of the pool memory together with its free list and counters
+         */
+        struct Checkpoint {
+            alignas(max_align_t) char memory[tblockSize * tnumBlocks];   /*!< copy of the pool memory */
+            FreeListState freeList;                 /*!< free list at the time of the snapshot */
+        };
+
         StaticAllocatorPool() : Allocator(tblockSize, m_memory, tblockSize * tnumBlocks, Allocator::STATIC){}
+
+        /**
+         * Records the full state of the pool with a single bulk copy. Every object living in
+         * the pool, for instance the nodes of a map using this pool, is captured with it.
+         *
+         * @param checkpoint where the state is recorded
+         * @return false if the pool has overflowed to the heap, in which case nothing is recorded
+         */
+        bool SaveCheckpoint(Checkpoint &checkpoint) const {
+            if (GetTotalBlocks() != GetTotalPoolBlocks()) {
+                return false;
+            }
+            memcpy(checkpoint.memory, m_memory, sizeof(m_memory));
+            SaveFreeList(checkpoint.freeList);
+            return true;
+        }
+
+        /**
+         * Rewinds the pool to a checkpoint with a single bulk copy. Objects outside of the
+         * pool that point into it, such as container handles, must be rewound by the caller.
+         *
+         * @param checkpoint a checkpoint recorded from this pool
+         * @return false if the pool has overflowed to the heap, in which case nothing is restored
+         */
+        bool RestoreCheckpoint(const Checkpoint &checkpoint) {
+            if (GetTotalBlocks() != GetTotalPoolBlocks()) {
+                return false;
+            }
+            memcpy(m_memory, checkpoint.memory, sizeof(m_memory));
+            RestoreFreeList(checkpoint.freeList);
+            return true;
+        }
+
+        /**
+         * Constructs an object in a pool block, so that it is captured by checkpoints and
+         * rewound by restoring them.
+         *
+         * @tparam T    type of the object, which must fit in a block
+         * @param args  constructor arguments
+         * @return the object, or nullptr if the pool has no free block
+         */
+        template<class T, class... Args>
+        T *Create(Args &&... args) {
+            static_assert(sizeof(T) <= tblockSize, "object does not fit in a pool block");
+            if (GetNumPoolBlocksAvail() == 0) {
+                return nullptr;
+            }
+            return new(Allocate()) T(static_cast<Args &&>(args)...);
+        }
+
+        /**
+         * Destroys an object made with @code Create @endcode and returns its block to the pool.
+         *
+         * @param object the object to destroy
+         */
+        template<class T>
+        void Destroy(T *object) {
+            object->~T();
+            Deallocate(object);
+        }
+
     private:
-        char m_memory[tblockSize * tnumBlocks];
+        alignas(max_align_t) char m_memory[tblockSize * tnumBlocks];
     };
 }
 
 
-#endif //FIXED_MEMORY_ALLOCATORPOOL_H
+#endif //FIXED_MEMORY_STATICALLOCATORPOOL_H
@@ -13,6 +13,8 @@
 #ifndef EMBEDDEDCPLUSPLUS_ARRAYLIST_H
 #define EMBEDDEDCPLUSPLUS_ARRAYLIST_H
 
+#include <assert.h>
+
 #include "Utility.h"
 
 #include "../Types.h"
@@ -650,6 +652,10 @@ namespace wlp {
                 m_capacity = length;
             }
             init_array(m_capacity);
+            if (!m_data) {
+                m_size = 0;
+                return;
+            }
             for (size_type i = 0; i < length; i++) {
                 m_data[i] = values[i];
             }
@@ -683,12 +689,16 @@ namespace wlp {
         /**
          * Initialize the backing array. This function
          * performs no initialization of the contents of
-         * the array itself.
+         * the array itself. If the array cannot be allocated,
+         * the list starts with no backing array.
          *
          * @param initial_size the initial capacity for the backing array
          */
         void init_array(size_type initial_size) {
-            m_data = static_cast<val_type *>(memory_alloc(initial_size * sizeof(val_type)));
+            m_data = memory_alloc_array<val_type>(initial_size);
+            if (!m_data) {
+                m_capacity = 0;
+            }
         }
 
         /**
@@ -710,8 +720,12 @@ namespace wlp {
          * this function will extend the size of the
          * array to twice its capacity and copy
          * the elements of the previous array.
+         *
+         * @return true if there is room for another element, false
+         * if the array is full and cannot grow, in which case
+         * the list is unchanged
          */
-        void ensure_capacity();
+        bool ensure_capacity();
 
         /**
          * Shift elements in the array at position @code i @endcode
@@ -758,16 +772,19 @@ namespace wlp {
          * a new array such that the new array has
          * a size corresponding to the new capacity.
          * If the new capacity is smaller than the current
-         * capacity, nothing happens.
+         * capacity, or the new array cannot be allocated,
+         * nothing happens.
          *
          * @param new_capacity the size of backing array to reserve
+         * @return true if the capacity is at least the new capacity
          */
-        void reserve(size_type new_capacity);
+        bool reserve(size_type new_capacity);
 
         /**
          * Copy the elements of the array into a
          * new array whose capacity is equal to the number
-         * of elements in the array.
+         * of elements in the array. If the new array
+         * cannot be allocated, nothing happens.
          */
         void shrink();
 
@@ -908,10 +925,13 @@ namespace wlp {
          *
          * @param i position to insert
          * @param t element to insert
-         * @return iterator to the inserted element
+         * @return iterator to the inserted element, or @code end @endcode
+         * if the list is full and cannot grow
          */
         iterator insert(size_type i, const val_type &t) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return end();
+            }
             normalize(i);
             shift_right(i);
             m_data[i] = t;
@@ -926,10 +946,13 @@ namespace wlp {
          *
          * @param i position to insert
          * @param t element to insert
-         * @return iterator to the inserted element
+         * @return iterator to the inserted element, or @code end @endcode
+         * if the list is full and cannot grow
          */
         iterator insert(size_type i, val_type &&t) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return end();
+            }
             normalize(i);
             shift_right(i);
             m_data[i] = forward<val_type>(t);
@@ -944,9 +967,13 @@ namespace wlp {
          * @param it iterator to the inserted position
          * @param t element to insert
          * @return iterator to the inserted element
+         * @pre the list is not full or can grow
          */
         iterator &insert(iterator &it, const val_type &t) {
-            ensure_capacity();
+            bool room = ensure_capacity();
+            // there is no past-the-end iterator to return by reference
+            assert(room);
+            (void) room;
             shift_right(it.m_i);
             m_data[it.m_i] = t;
             ++m_size;
@@ -960,9 +987,13 @@ namespace wlp {
          * @param it iterator to the inserted position
          * @param t element to insert
          * @return iterator to the inserted element
+         * @pre the list is not full or can grow
          */
         iterator &insert(iterator &it, val_type &&t) {
-            ensure_capacity();
+            bool room = ensure_capacity();
+            // there is no past-the-end iterator to return by reference
+            assert(room);
+            (void) room;
             shift_right(it.m_i);
             m_data[it.m_i] = t;
             ++m_size;
@@ -1004,22 +1035,32 @@ namespace wlp {
          * Insert an element to the back of the list.
          *
          * @param t element to insert
+         * @return true if the element was inserted, false if
+         * the list is full and cannot grow
          */
-        void push_back(const val_type &t) {
-            ensure_capacity();
+        bool push_back(const val_type &t) {
+            if (!ensure_capacity()) {
+                return false;
+            }
             m_data[m_size] = t;
             ++m_size;
+            return true;
         }
 
         /**
          * Insert an element to the back of the list.
          *
          * @param t element to insert
+         * @return true if the element was inserted, false if
+         * the list is full and cannot grow
          */
-        void push_back(val_type &&t) {
-            ensure_capacity();
+        bool push_back(val_type &&t) {
+            if (!ensure_capacity()) {
+                return false;
+            }
             m_data[m_size] = move(t);
             ++m_size;
+            return true;
         }
 
         /**
@@ -1075,32 +1116,33 @@ namespace wlp {
     };
 
     template<typename T>
-    void ArrayList<T>::ensure_capacity() {
+    bool ArrayList<T>::ensure_capacity() {
         if (m_size < m_capacity) {
-            return;
+            return true;
         }
-        size_type new_capacity = (size_type) (2 * m_capacity);
-        val_type *new_data = static_cast<val_type *>(memory_alloc(new_capacity * sizeof(val_type)));
-        for (size_type i = 0; i < m_size; i++) {
-            new_data[i] = m_data[i];
-        }
-        memory_free(m_data);
-        m_data = new_data;
-        m_capacity = new_capacity;
+        // doubling saturates at the largest size the size type holds
+        wide_size_type doubled = m_capacity ? static_cast<wide_size_type>(m_capacity) * 2 : 1;
+        size_type new_capacity = doubled > max_size_type ? max_size_type : static_cast<size_type>(doubled);
+        return new_capacity > m_capacity && reserve(new_capacity);
     }
 
     template<typename T>
-    void ArrayList<T>::reserve(size_type new_capacity) {
+    bool ArrayList<T>::reserve(size_type new_capacity) {
         if (new_capacity <= m_capacity) {
-            return;
+            return true;
+        }
+        // fails if the array does not fit the size type in bytes
+        val_type *new_data = memory_alloc_array<val_type>(new_capacity);
+        if (!new_data) {
+            return false;
         }
-        val_type *new_data = static_cast<val_type *>(memory_alloc(new_capacity * sizeof(val_type)));
         for (size_type i = 0; i < m_size; i++) {
             new_data[i] = m_data[i];
         }
         memory_free(m_data);
         m_data = new_data;
         m_capacity = new_capacity;
+        return true;
     }
 
     template<typename T>
@@ -1108,7 +1150,10 @@ namespace wlp {
         if (m_size == m_capacity) {
             return;
         }
-        val_type *new_data = static_cast<val_type *>(memory_alloc(m_size * sizeof(val_type)));
+        val_type *new_data = memory_alloc_array<val_type>(m_size);
+        if (!new_data) {
+            return;
+        }
         for (size_type i = 0; i < m_size; i++) {
             new_data[i] = m_data[i];
         }
@@ -0,0 +1,1087 @@
+/**
+ * @file BTreeMap.h
+ * @brief Ordered map implemented as a B+ tree.
+ *
+ * The B-tree map keeps its elements sorted by key, as ordered by a
+ * comparator, so that it answers range queries such as all the events
+ * between two time stamps with @code lower_bound @endcode and
+ * @code upper_bound @endcode followed by iteration.
+ *
+ * Elements live in the leaves, which are linked to their successor so that
+ * iteration walks from leaf to leaf without going back up the tree. Inner
+ * nodes hold only separator keys and child pointers. Each node spans a few
+ * cache lines, sized by a template parameter, and holds as many entries as
+ * fit: a lookup touches one node per level and finds the entry within a
+ * node by binary search over a contiguous key array. Nodes are drawn from
+ * two fixed block allocators, one for leaves and one for inner nodes.
+ *
+ * Splits and merges are done on the way down, so insertion and erasure
+ * never revisit a node. Both may move elements between nodes, which
+ * invalidates iterators and references to elements.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BTREEMAP_H
+#define EMBEDDEDCPLUSPLUS_BTREEMAP_H
+
+#include "Utility.h"
+#include "Comparator.h"
+#include "Pair.h"
+
+#include "../memory/Allocator.h"
+
+namespace wlp {
+
+    // Forward declaration of BTreeMap
+    template<class Key,
+            class Val,
+            class Cmp,
+            uint16_t tNodeSize>
+    class BTreeMap;
+
+    // Forward declaration of BTreeMap iterator
+    template<class Key,
+            class Val,
+            class Cmp = Comparator<Key>,
+            uint16_t tNodeSize = 256>
+    struct BTreeMapIterator;
+
+    // Forward declaration of const BTreeMap iterator
+    template<class Key,
+            class Val,
+            class Cmp = Comparator<Key>,
+            uint16_t tNodeSize = 256>
+    struct BTreeMapConstIterator;
+
+    /**
+     * @param node_size   the target size of a node in bytes
+     * @param header_size the size of the node fields other than the entries,
+     *                    counting the padding after the entry count
+     * @param entry_size  the size of one entry
+     * @return the number of entries of a node, at least four
+     */
+    constexpr uint16_t btree_node_capacity(size_t node_size, size_t header_size, size_t entry_size) {
+        return static_cast<uint16_t>(node_size < header_size + 4 * entry_size
+                                     ? 4 : (node_size - header_size) / entry_size);
+    }
+
+    /**
+     * Leaf of a B-tree map, holding a sorted run of elements. Keys and
+     * values are kept in separate arrays so that searching a leaf only
+     * reads keys.
+     * @tparam Key       key type
+     * @tparam Val       value type
+     * @tparam tNodeSize target size of a node in bytes
+     */
+    template<class Key, class Val, uint16_t tNodeSize>
+    struct BTreeMapLeaf {
+        typedef BTreeMapLeaf<Key, Val, tNodeSize> leaf_type;
+
+        enum : uint16_t {
+            CAPACITY = btree_node_capacity(tNodeSize, 2 * sizeof(leaf_type *), sizeof(Key) + sizeof(Val)),
+            MIN_COUNT = CAPACITY / 2
+        };
+
+        /**
+         * The number of elements in the leaf.
+         */
+        uint16_t m_count;
+        /**
+         * The leaf holding the next larger keys, or null.
+         */
+        leaf_type *m_next;
+        Key m_keys[CAPACITY];
+        Val m_vals[CAPACITY];
+    };
+
+    /**
+     * Inner node of a B-tree map. Child i holds the keys not less than
+     * separator i - 1 and less than separator i.
+     * @tparam Key       key type
+     * @tparam tNodeSize target size of a node in bytes
+     */
+    template<class Key, uint16_t tNodeSize>
+    struct BTreeMapInner {
+        enum : uint16_t {
+            CAPACITY = btree_node_capacity(tNodeSize, 2 * sizeof(void *), sizeof(Key) + sizeof(void *)),
+            MIN_COUNT = (CAPACITY - 1) / 2
+        };
+
+        /**
+         * The number of separator keys, one less than the number of children.
+         */
+        uint16_t m_count;
+        Key m_keys[CAPACITY];
+        /**
+         * Children, which are leaves in the lowest level of inner nodes.
+         */
+        void *m_children[CAPACITY + 1];
+    };
+
+    /**
+     * Iterator over the elements of a BTreeMap in key order.
+     * @tparam Key       key type
+     * @tparam Val       value type
+     * @tparam Cmp       key comparator
+     * @tparam tNodeSize target size of a node in bytes
+     */
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    struct BTreeMapIterator {
+        typedef BTreeMapIterator<Key, Val, Cmp, tNodeSize> iterator;
+        typedef BTreeMapLeaf<Key, Val, tNodeSize> leaf_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        /**
+         * The leaf of the referenced element, null past the end.
+         */
+        leaf_type *m_node;
+        /**
+         * The index of the referenced element in its leaf.
+         */
+        uint16_t m_index;
+
+        BTreeMapIterator()
+                : m_node(nullptr),
+                  m_index(0) {
+        }
+
+        /**
+         * @param node  leaf of the element
+         * @param index index of the element in the leaf
+         */
+        BTreeMapIterator(leaf_type *node, uint16_t index)
+                : m_node(node),
+                  m_index(index) {
+        }
+
+        /**
+         * @return the key of the element
+         */
+        const key_type &key() const {
+            return m_node->m_keys[m_index];
+        }
+
+        /**
+         * @return reference to the value of the element
+         */
+        val_type &operator*() const {
+            return m_node->m_vals[m_index];
+        }
+
+        /**
+         * @return pointer to the value of the element
+         */
+        val_type *operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Advance to the element with the next larger key, or past the end.
+         * @return this iterator
+         */
+        iterator &operator++() {
+            if (++m_index == m_node->m_count) {
+                m_node = m_node->m_next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator &it) const {
+            return m_node == it.m_node && m_index == it.m_index;
+        }
+
+        bool operator!=(const iterator &it) const {
+            return !(*this == it);
+        }
+    };
+
+    /**
+     * Constant iterator over a BTreeMap. Values iterated by
+     * this class cannot be modified.
+     *
+     * @see BTreeMapIterator
+     */
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    struct BTreeMapConstIterator {
+        typedef BTreeMapConstIterator<Key, Val, Cmp, tNodeSize> const_iterator;
+        typedef BTreeMapLeaf<Key, Val, tNodeSize> leaf_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        const leaf_type *m_node;
+        uint16_t m_index;
+
+        BTreeMapConstIterator()
+                : m_node(nullptr),
+                  m_index(0) {
+        }
+
+        BTreeMapConstIterator(const leaf_type *node, uint16_t index)
+                : m_node(node),
+                  m_index(index) {
+        }
+
+        BTreeMapConstIterator(const BTreeMapIterator<Key, Val, Cmp, tNodeSize> &it)
+                : m_node(it.m_node),
+                  m_index(it.m_index) {
+        }
+
+        const key_type &key() const {
+            return m_node->m_keys[m_index];
+        }
+
+        const val_type &operator*() const {
+            return m_node->m_vals[m_index];
+        }
+
+        const val_type *operator->() const {
+            return &(operator*());
+        }
+
+        const_iterator &operator++() {
+            if (++m_index == m_node->m_count) {
+                m_node = m_node->m_next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator &it) const {
+            return m_node == it.m_node && m_index == it.m_index;
+        }
+
+        bool operator!=(const const_iterator &it) const {
+            return !(*this == it);
+        }
+    };
+
+    /**
+     * Ordered map implemented as a B+ tree, in the spirit of std::map.
+     * @tparam Key       key type
+     * @tparam Val       value type
+     * @tparam Cmp       key comparator, of which only @code __lt__ @endcode is used
+     * @tparam tNodeSize target size of a node in bytes, best a multiple of the cache line size
+     */
+    template<class Key,
+            class Val,
+            class Cmp = Comparator<Key>,
+            uint16_t tNodeSize = 256>
+    class BTreeMap {
+    public:
+        typedef BTreeMap<Key, Val, Cmp, tNodeSize> map_type;
+        typedef BTreeMapIterator<Key, Val, Cmp, tNodeSize> iterator;
+        typedef BTreeMapConstIterator<Key, Val, Cmp, tNodeSize> const_iterator;
+        typedef BTreeMapLeaf<Key, Val, tNodeSize> leaf_type;
+        typedef BTreeMapInner<Key, tNodeSize> inner_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+    private:
+        /**
+         * Key comparator instance.
+         */
+        Cmp m_cmp;
+        /**
+         * Allocator of the leaves.
+         */
+        Allocator m_leaf_allocator;
+        /**
+         * Allocator of the inner nodes.
+         */
+        Allocator m_inner_allocator;
+        /**
+         * The root node, a leaf if the height is zero,
+         * or null if the map is empty.
+         */
+        void *m_root;
+        /**
+         * The number of elements in the map.
+         */
+        size_type m_num_elements;
+        /**
+         * The number of levels of inner nodes.
+         */
+        uint8_t m_height;
+
+        /**
+         * @param n the number of elements to reserve leaves for
+         * @return the size of a pool holding enough half full leaves,
+         * clamped to the largest multiple of the leaf size
+         */
+        static size_type leaf_pool_size(size_type n) {
+            wide_size_type leaves = static_cast<wide_size_type>(n / leaf_type::MIN_COUNT + 1);
+            wide_size_type max_leaves = max_size_type / sizeof(leaf_type);
+            return static_cast<size_type>((leaves < max_leaves ? leaves : max_leaves) * sizeof(leaf_type));
+        }
+
+    public:
+        /**
+         * Create an empty B-tree map.
+         *
+         * @param n the number of elements for which the leaf allocator
+         *          reserves a pool up front, as far as the pool size
+         *          fits the size type
+         */
+        explicit BTreeMap(size_type n = 0)
+                : m_cmp(Cmp()),
+                  m_leaf_allocator{sizeof(leaf_type), leaf_pool_size(n)},
+                  m_inner_allocator{sizeof(inner_type)},
+                  m_root(nullptr),
+                  m_num_elements(0),
+                  m_height(0) {
+        }
+
+        /**
+         * Disable copy constructor.
+         */
+        BTreeMap(const map_type &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param map B-tree map to move
+         */
+        BTreeMap(map_type &&map)
+                : m_cmp(move(map.m_cmp)),
+                  m_leaf_allocator(move(map.m_leaf_allocator)),
+                  m_inner_allocator(move(map.m_inner_allocator)),
+                  m_root(map.m_root),
+                  m_num_elements(map.m_num_elements),
+                  m_height(map.m_height) {
+            map.m_root = nullptr;
+            map.m_num_elements = 0;
+            map.m_height = 0;
+        }
+
+        /**
+         * Destroy the map, freeing every node.
+         */
+        ~BTreeMap() {
+            clear();
+        }
+
+    private:
+        /**
+         * @return true if the first key orders before the second
+         */
+        bool less(const key_type &a, const key_type &b) const {
+            return m_cmp.__lt__(a, b);
+        }
+
+        /**
+         * @return the index of the first key not less than the key
+         */
+        uint16_t lower_index(const key_type *keys, uint16_t count, const key_type &key) const;
+
+        /**
+         * @return the index of the first key greater than the key,
+         * which in an inner node is the child holding the key
+         */
+        uint16_t upper_index(const key_type *keys, uint16_t count, const key_type &key) const;
+
+        /**
+         * @param node   a node
+         * @param height the height of the node, zero for leaves
+         * @return the number of keys of the node
+         */
+        static uint16_t node_count(const void *node, uint8_t height) {
+            return height ? static_cast<const inner_type *>(node)->m_count
+                          : static_cast<const leaf_type *>(node)->m_count;
+        }
+
+        /**
+         * @param height the height of a node, zero for leaves
+         * @return the number of keys the node can hold
+         */
+        static uint16_t node_capacity(uint8_t height) {
+            return height ? static_cast<uint16_t>(inner_type::CAPACITY)
+                          : static_cast<uint16_t>(leaf_type::CAPACITY);
+        }
+
+        /**
+         * @param height the height of a node, zero for leaves
+         * @return the least number of keys of a node other than the root
+         */
+        static uint16_t node_min_count(uint8_t height) {
+            return height ? static_cast<uint16_t>(inner_type::MIN_COUNT)
+                          : static_cast<uint16_t>(leaf_type::MIN_COUNT);
+        }
+
+        /**
+         * @param key a key
+         * @return the leaf whose range holds the key
+         */
+        leaf_type *find_leaf(const key_type &key) const;
+
+        /**
+         * @return an iterator to the element with the smallest key
+         */
+        iterator first_element() const;
+
+        /**
+         * @param key the key to find
+         * @return an iterator to the element with the key, or pass-the-end
+         */
+        iterator find_element(const key_type &key) const;
+
+        /**
+         * @param key   a key, which need not be in the map
+         * @param upper whether to skip the elements equal to the key
+         * @return an iterator to the first element whose key is not less
+         * than the key, or greater than it if upper is set
+         */
+        iterator bound_element(const key_type &key, bool upper) const;
+
+        /**
+         * Split a full child in two, moving the upper half of its keys to
+         * a new node and adding the separator to the parent, which is not full.
+         *
+         * @param parent the parent node
+         * @param i      the index of the child
+         * @param height the height of the child
+         */
+        void split_child(inner_type *parent, uint16_t i, uint8_t height);
+
+        /**
+         * Give a child at its minimum count at least one more key, by
+         * taking one from a sibling or by merging it with a sibling.
+         *
+         * @param parent the parent node
+         * @param i      the index of the child
+         * @param height the height of the child
+         */
+        void fill_child(inner_type *parent, uint16_t i, uint8_t height);
+
+        /**
+         * Merge child i + 1 into child i and remove their separator.
+         *
+         * @param parent the parent node
+         * @param i      the index of the left child
+         * @param height the height of the children
+         */
+        void merge_children(inner_type *parent, uint16_t i, uint8_t height);
+
+        /**
+         * Free a node and every node below it.
+         *
+         * @param node   the node
+         * @param height the height of the node
+         */
+        void free_node(void *node, uint8_t height);
+
+        /**
+         * Find the element with a key, or insert one whose value is
+         * left for the caller to assign.
+         *
+         * @param key the key of the element
+         * @return the element and whether it was inserted
+         */
+        Pair<iterator, bool> insert_key(const key_type &key);
+
+    public:
+        /**
+         * @return the number of elements in the map
+         */
+        size_type size() const {
+            return m_num_elements;
+        }
+
+        /**
+         * @return true if the map is empty
+         */
+        bool empty() const {
+            return m_num_elements == 0;
+        }
+
+        /**
+         * @return the number of levels of inner nodes
+         */
+        uint8_t height() const {
+            return m_height;
+        }
+
+        /**
+         * @return the leaf allocator of the map
+         */
+        const Allocator *get_leaf_allocator() const {
+            return &m_leaf_allocator;
+        }
+
+        /**
+         * @return the inner node allocator of the map
+         */
+        const Allocator *get_inner_allocator() const {
+            return &m_inner_allocator;
+        }
+
+        /**
+         * @return an iterator to the element with the smallest key
+         */
+        iterator begin() {
+            return first_element();
+        }
+
+        /**
+         * @return a pass-the-end iterator
+         */
+        iterator end() {
+            return iterator();
+        }
+
+        /**
+         * @see BTreeMap<Key, Val, Cmp, tNodeSize>::begin()
+         * @return a constant iterator to the element with the smallest key
+         */
+        const_iterator begin() const {
+            return first_element();
+        }
+
+        /**
+         * @return a constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator();
+        }
+
+        /**
+         * Erase every element, freeing the nodes.
+         */
+        void clear() noexcept;
+
+        /**
+         * Insert an element if its key is not in the map.
+         *
+         * @param key element key
+         * @param val element value
+         * @return a pair consisting of an iterator to the element with
+         * the key and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert(const key_type &key, const val_type &val);
+
+        /**
+         * Insert an element, or assign the value of the element
+         * with the key if there is one.
+         *
+         * @param key element key
+         * @param val element value
+         * @return a pair consisting of an iterator to the element with
+         * the key and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert_or_assign(const key_type &key, const val_type &val);
+
+        /**
+         * Access the value of a key, inserting a default
+         * constructed value if the key is not in the map.
+         *
+         * @param key the key whose value to access
+         * @return a reference to the mapped value
+         */
+        val_type &operator[](const key_type &key);
+
+        /**
+         * Erase the element with a key.
+         *
+         * @param key the key of the element to erase
+         * @return true if erasure occured
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Erase the element pointed to by an iterator.
+         *
+         * @param pos iterator to the element to erase, set to
+         *            the next element or pass-the-end
+         * @return the iterator to the next element
+         */
+        iterator &erase(iterator &pos);
+
+        /**
+         * @param key the key to find
+         * @return an iterator to the element with the key,
+         * or pass-the-end if there is none
+         */
+        iterator find(const key_type &key) {
+            return find_element(key);
+        }
+
+        /**
+         * @see BTreeMap<Key, Val, Cmp, tNodeSize>::find()
+         */
+        const_iterator find(const key_type &key) const {
+            return find_element(key);
+        }
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        bool contains(const key_type &key) const {
+            return find(key) != end();
+        }
+
+        /**
+         * @param key a key, which need not be in the map
+         * @return an iterator to the first element whose key
+         * is not less than the key, or pass-the-end
+         */
+        iterator lower_bound(const key_type &key) {
+            return bound_element(key, false);
+        }
+
+        /**
+         * @see BTreeMap<Key, Val, Cmp, tNodeSize>::lower_bound()
+         */
+        const_iterator lower_bound(const key_type &key) const {
+            return bound_element(key, false);
+        }
+
+        /**
+         * @param key a key, which need not be in the map
+         * @return an iterator to the first element whose key
+         * is greater than the key, or pass-the-end
+         */
+        iterator upper_bound(const key_type &key) {
+            return bound_element(key, true);
+        }
+
+        /**
+         * @see BTreeMap<Key, Val, Cmp, tNodeSize>::upper_bound()
+         */
+        const_iterator upper_bound(const key_type &key) const {
+            return bound_element(key, true);
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this map
+         */
+        map_type &operator=(const map_type &) = delete;
+
+        /**
+         * Move assignment frees the elements of this map
+         * and takes over those of the other.
+         *
+         * @param map the map to move
+         * @return a reference to this map
+         */
+        map_type &operator=(map_type &&map);
+    };
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    uint16_t BTreeMap<Key, Val, Cmp, tNodeSize>::lower_index(const key_type *keys, uint16_t count, const key_type &key) const {
+        uint16_t lo = 0;
+        uint16_t hi = count;
+        while (lo < hi) {
+            uint16_t mid = static_cast<uint16_t>((lo + hi) / 2);
+            if (less(keys[mid], key)) {
+                lo = static_cast<uint16_t>(mid + 1);
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    uint16_t BTreeMap<Key, Val, Cmp, tNodeSize>::upper_index(const key_type *keys, uint16_t count, const key_type &key) const {
+        uint16_t lo = 0;
+        uint16_t hi = count;
+        while (lo < hi) {
+            uint16_t mid = static_cast<uint16_t>((lo + hi) / 2);
+            if (less(key, keys[mid])) {
+                hi = mid;
+            } else {
+                lo = static_cast<uint16_t>(mid + 1);
+            }
+        }
+        return lo;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::leaf_type *
+    BTreeMap<Key, Val, Cmp, tNodeSize>::find_leaf(const key_type &key) const {
+        void *node = m_root;
+        for (uint8_t h = m_height; h > 0; --h) {
+            inner_type *inner = static_cast<inner_type *>(node);
+            node = inner->m_children[upper_index(inner->m_keys, inner->m_count, key)];
+        }
+        return static_cast<leaf_type *>(node);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    void BTreeMap<Key, Val, Cmp, tNodeSize>::split_child(inner_type *parent, uint16_t i, uint8_t height) {
+        for (uint16_t j = parent->m_count; j > i; --j) {
+            parent->m_keys[j] = move(parent->m_keys[j - 1]);
+            parent->m_children[j + 1] = parent->m_children[j];
+        }
+        ++parent->m_count;
+        if (height == 0) {
+            leaf_type *left = static_cast<leaf_type *>(parent->m_children[i]);
+            leaf_type *right = static_cast<leaf_type *>(m_leaf_allocator.Allocate());
+            uint16_t mid = static_cast<uint16_t>(left->m_count / 2);
+            right->m_count = static_cast<uint16_t>(left->m_count - mid);
+            for (uint16_t j = 0; j < right->m_count; ++j) {
+                right->m_keys[j] = move(left->m_keys[mid + j]);
+                right->m_vals[j] = move(left->m_vals[mid + j]);
+            }
+            left->m_count = mid;
+            right->m_next = left->m_next;
+            left->m_next = right;
+            parent->m_keys[i] = right->m_keys[0];
+            parent->m_children[i + 1] = right;
+        } else {
+            inner_type *left = static_cast<inner_type *>(parent->m_children[i]);
+            inner_type *right = static_cast<inner_type *>(m_inner_allocator.Allocate());
+            uint16_t mid = static_cast<uint16_t>(left->m_count / 2);
+            right->m_count = static_cast<uint16_t>(left->m_count - mid - 1);
+            for (uint16_t j = 0; j < right->m_count; ++j) {
+                right->m_keys[j] = move(left->m_keys[mid + 1 + j]);
+            }
+            for (uint16_t j = 0; j <= right->m_count; ++j) {
+                right->m_children[j] = left->m_children[mid + 1 + j];
+            }
+            left->m_count = mid;
+            parent->m_keys[i] = move(left->m_keys[mid]);
+            parent->m_children[i + 1] = right;
+        }
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    void BTreeMap<Key, Val, Cmp, tNodeSize>::fill_child(inner_type *parent, uint16_t i, uint8_t height) {
+        if (i > 0 && node_count(parent->m_children[i - 1], height) > node_min_count(height)) {
+            // take the largest key of the left sibling
+            if (height == 0) {
+                leaf_type *left = static_cast<leaf_type *>(parent->m_children[i - 1]);
+                leaf_type *node = static_cast<leaf_type *>(parent->m_children[i]);
+                for (uint16_t j = node->m_count; j > 0; --j) {
+                    node->m_keys[j] = move(node->m_keys[j - 1]);
+                    node->m_vals[j] = move(node->m_vals[j - 1]);
+                }
+                --left->m_count;
+                node->m_keys[0] = move(left->m_keys[left->m_count]);
+                node->m_vals[0] = move(left->m_vals[left->m_count]);
+                ++node->m_count;
+                parent->m_keys[i - 1] = node->m_keys[0];
+            } else {
+                inner_type *left = static_cast<inner_type *>(parent->m_children[i - 1]);
+                inner_type *node = static_cast<inner_type *>(parent->m_children[i]);
+                node->m_children[node->m_count + 1] = node->m_children[node->m_count];
+                for (uint16_t j = node->m_count; j > 0; --j) {
+                    node->m_keys[j] = move(node->m_keys[j - 1]);
+                    node->m_children[j] = node->m_children[j - 1];
+                }
+                node->m_keys[0] = move(parent->m_keys[i - 1]);
+                node->m_children[0] = left->m_children[left->m_count];
+                ++node->m_count;
+                --left->m_count;
+                parent->m_keys[i - 1] = move(left->m_keys[left->m_count]);
+            }
+            return;
+        }
+        if (i < parent->m_count && node_count(parent->m_children[i + 1], height) > node_min_count(height)) {
+            // take the smallest key of the right sibling
+            if (height == 0) {
+                leaf_type *node = static_cast<leaf_type *>(parent->m_children[i]);
+                leaf_type *right = static_cast<leaf_type *>(parent->m_children[i + 1]);
+                node->m_keys[node->m_count] = move(right->m_keys[0]);
+                node->m_vals[node->m_count] = move(right->m_vals[0]);
+                ++node->m_count;
+                --right->m_count;
+                for (uint16_t j = 0; j < right->m_count; ++j) {
+                    right->m_keys[j] = move(right->m_keys[j + 1]);
+                    right->m_vals[j] = move(right->m_vals[j + 1]);
+                }
+                parent->m_keys[i] = right->m_keys[0];
+            } else {
+                inner_type *node = static_cast<inner_type *>(parent->m_children[i]);
+                inner_type *right = static_cast<inner_type *>(parent->m_children[i + 1]);
+                node->m_keys[node->m_count] = move(parent->m_keys[i]);
+                node->m_children[node->m_count + 1] = right->m_children[0];
+                ++node->m_count;
+                parent->m_keys[i] = move(right->m_keys[0]);
+                --right->m_count;
+                for (uint16_t j = 0; j < right->m_count; ++j) {
+                    right->m_keys[j] = move(right->m_keys[j + 1]);
+                    right->m_children[j] = right->m_children[j + 1];
+                }
+                right->m_children[right->m_count] = right->m_children[right->m_count + 1];
+            }
+            return;
+        }
+        merge_children(parent, i < parent->m_count ? i : static_cast<uint16_t>(i - 1), height);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    void BTreeMap<Key, Val, Cmp, tNodeSize>::merge_children(inner_type *parent, uint16_t i, uint8_t height) {
+        if (height == 0) {
+            leaf_type *left = static_cast<leaf_type *>(parent->m_children[i]);
+            leaf_type *right = static_cast<leaf_type *>(parent->m_children[i + 1]);
+            for (uint16_t j = 0; j < right->m_count; ++j) {
+                left->m_keys[left->m_count + j] = move(right->m_keys[j]);
+                left->m_vals[left->m_count + j] = move(right->m_vals[j]);
+            }
+            left->m_count = static_cast<uint16_t>(left->m_count + right->m_count);
+            left->m_next = right->m_next;
+            m_leaf_allocator.Deallocate(right);
+        } else {
+            inner_type *left = static_cast<inner_type *>(parent->m_children[i]);
+            inner_type *right = static_cast<inner_type *>(parent->m_children[i + 1]);
+            left->m_keys[left->m_count] = move(parent->m_keys[i]);
+            for (uint16_t j = 0; j < right->m_count; ++j) {
+                left->m_keys[left->m_count + 1 + j] = move(right->m_keys[j]);
+            }
+            for (uint16_t j = 0; j <= right->m_count; ++j) {
+                left->m_children[left->m_count + 1 + j] = right->m_children[j];
+            }
+            left->m_count = static_cast<uint16_t>(left->m_count + 1 + right->m_count);
+            m_inner_allocator.Deallocate(right);
+        }
+        for (uint16_t j = i; j + 1 < parent->m_count; ++j) {
+            parent->m_keys[j] = move(parent->m_keys[j + 1]);
+            parent->m_children[j + 1] = parent->m_children[j + 2];
+        }
+        --parent->m_count;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    void BTreeMap<Key, Val, Cmp, tNodeSize>::free_node(void *node, uint8_t height) {
+        if (height == 0) {
+            m_leaf_allocator.Deallocate(node);
+            return;
+        }
+        inner_type *inner = static_cast<inner_type *>(node);
+        for (uint16_t j = 0; j <= inner->m_count; ++j) {
+            free_node(inner->m_children[j], static_cast<uint8_t>(height - 1));
+        }
+        m_inner_allocator.Deallocate(inner);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    void BTreeMap<Key, Val, Cmp, tNodeSize>::clear() noexcept {
+        if (m_root) {
+            free_node(m_root, m_height);
+        }
+        m_root = nullptr;
+        m_num_elements = 0;
+        m_height = 0;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator
+    BTreeMap<Key, Val, Cmp, tNodeSize>::first_element() const {
+        if (!m_root) {
+            return iterator();
+        }
+        void *node = m_root;
+        for (uint8_t h = m_height; h > 0; --h) {
+            node = static_cast<inner_type *>(node)->m_children[0];
+        }
+        return iterator(static_cast<leaf_type *>(node), 0);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    Pair<typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator, bool>
+    BTreeMap<Key, Val, Cmp, tNodeSize>::insert_key(const key_type &key) {
+        if (!m_root) {
+            leaf_type *leaf = static_cast<leaf_type *>(m_leaf_allocator.Allocate());
+            leaf->m_count = 0;
+            leaf->m_next = nullptr;
+            m_root = leaf;
+        }
+        if (node_count(m_root, m_height) == node_capacity(m_height)) {
+            inner_type *root = static_cast<inner_type *>(m_inner_allocator.Allocate());
+            root->m_count = 0;
+            root->m_children[0] = m_root;
+            m_root = root;
+            ++m_height;
+            split_child(root, 0, static_cast<uint8_t>(m_height - 1));
+        }
+        void *node = m_root;
+        for (uint8_t h = m_height; h > 0; --h) {
+            inner_type *inner = static_cast<inner_type *>(node);
+            uint16_t i = upper_index(inner->m_keys, inner->m_count, key);
+            uint8_t child_height = static_cast<uint8_t>(h - 1);
+            if (node_count(inner->m_children[i], child_height) == node_capacity(child_height)) {
+                split_child(inner, i, child_height);
+                if (!less(key, inner->m_keys[i])) {
+                    ++i;
+                }
+            }
+            node = inner->m_children[i];
+        }
+        leaf_type *leaf = static_cast<leaf_type *>(node);
+        uint16_t i = lower_index(leaf->m_keys, leaf->m_count, key);
+        if (i < leaf->m_count && !less(key, leaf->m_keys[i])) {
+            return Pair<iterator, bool>(iterator(leaf, i), false);
+        }
+        for (uint16_t j = leaf->m_count; j > i; --j) {
+            leaf->m_keys[j] = move(leaf->m_keys[j - 1]);
+            leaf->m_vals[j] = move(leaf->m_vals[j - 1]);
+        }
+        leaf->m_keys[i] = key;
+        ++leaf->m_count;
+        ++m_num_elements;
+        return Pair<iterator, bool>(iterator(leaf, i), true);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    Pair<typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator, bool>
+    BTreeMap<Key, Val, Cmp, tNodeSize>::insert(const key_type &key, const val_type &val) {
+        Pair<iterator, bool> res = insert_key(key);
+        if (res.second()) {
+            *res.first() = val;
+        }
+        return res;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    Pair<typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator, bool>
+    BTreeMap<Key, Val, Cmp, tNodeSize>::insert_or_assign(const key_type &key, const val_type &val) {
+        Pair<iterator, bool> res = insert_key(key);
+        *res.first() = val;
+        return res;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::val_type &
+    BTreeMap<Key, Val, Cmp, tNodeSize>::operator[](const key_type &key) {
+        Pair<iterator, bool> res = insert_key(key);
+        if (res.second()) {
+            *res.first() = val_type();
+        }
+        return *res.first();
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    bool BTreeMap<Key, Val, Cmp, tNodeSize>::erase(const key_type &key) {
+        if (!m_root) {
+            return false;
+        }
+        void *node = m_root;
+        for (uint8_t h = m_height; h > 0; --h) {
+            inner_type *inner = static_cast<inner_type *>(node);
+            uint16_t i = upper_index(inner->m_keys, inner->m_count, key);
+            uint8_t child_height = static_cast<uint8_t>(h - 1);
+            if (node_count(inner->m_children[i], child_height) <= node_min_count(child_height)) {
+                fill_child(inner, i, child_height);
+                if (inner->m_count == 0) {
+                    // only the root may run out of keys, the
+                    // merged child becomes the new root
+                    m_root = inner->m_children[0];
+                    m_inner_allocator.Deallocate(inner);
+                    --m_height;
+                    node = m_root;
+                    continue;
+                }
+                i = upper_index(inner->m_keys, inner->m_count, key);
+            }
+            node = inner->m_children[i];
+        }
+        leaf_type *leaf = static_cast<leaf_type *>(node);
+        uint16_t i = lower_index(leaf->m_keys, leaf->m_count, key);
+        if (i == leaf->m_count || less(key, leaf->m_keys[i])) {
+            return false;
+        }
+        --leaf->m_count;
+        for (uint16_t j = i; j < leaf->m_count; ++j) {
+            leaf->m_keys[j] = move(leaf->m_keys[j + 1]);
+            leaf->m_vals[j] = move(leaf->m_vals[j + 1]);
+        }
+        --m_num_elements;
+        if (leaf->m_count == 0 && m_height == 0) {
+            m_leaf_allocator.Deallocate(leaf);
+            m_root = nullptr;
+        }
+        return true;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator &
+    BTreeMap<Key, Val, Cmp, tNodeSize>::erase(iterator &pos) {
+        if (!pos.m_node) {
+            return pos;
+        }
+        // rebalancing may move the following elements, so find
+        // the next one again by its key
+        key_type key = pos.key();
+        ++pos;
+        if (!pos.m_node) {
+            erase(key);
+            return pos;
+        }
+        key_type next_key = pos.key();
+        erase(key);
+        pos = lower_bound(next_key);
+        return pos;
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator
+    BTreeMap<Key, Val, Cmp, tNodeSize>::find_element(const key_type &key) const {
+        if (!m_root) {
+            return iterator();
+        }
+        leaf_type *leaf = find_leaf(key);
+        uint16_t i = lower_index(leaf->m_keys, leaf->m_count, key);
+        if (i == leaf->m_count || less(key, leaf->m_keys[i])) {
+            return iterator();
+        }
+        return iterator(leaf, i);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    typename BTreeMap<Key, Val, Cmp, tNodeSize>::iterator
+    BTreeMap<Key, Val, Cmp, tNodeSize>::bound_element(const key_type &key, bool upper) const {
+        if (!m_root) {
+            return iterator();
+        }
+        leaf_type *leaf = find_leaf(key);
+        uint16_t i = upper
+                     ? upper_index(leaf->m_keys, leaf->m_count, key)
+                     : lower_index(leaf->m_keys, leaf->m_count, key);
+        if (i == leaf->m_count) {
+            return iterator(leaf->m_next, 0);
+        }
+        return iterator(leaf, i);
+    }
+
+    template<class Key, class Val, class Cmp, uint16_t tNodeSize>
+    BTreeMap<Key, Val, Cmp, tNodeSize> &
+    BTreeMap<Key, Val, Cmp, tNodeSize>::operator=(map_type &&map) {
+        clear();
+        m_cmp = move(map.m_cmp);
+        m_leaf_allocator = move(map.m_leaf_allocator);
+        m_inner_allocator = move(map.m_inner_allocator);
+        m_root = map.m_root;
+        m_num_elements = map.m_num_elements;
+        m_height = map.m_height;
+        map.m_root = nullptr;
+        map.m_num_elements = 0;
+        map.m_height = 0;
+        return *this;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BTREEMAP_H
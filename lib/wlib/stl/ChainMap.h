@@ -13,10 +13,15 @@
 #ifndef EMBEDDEDTESTS_CHAINMAP_H
 #define EMBEDDEDTESTS_CHAINMAP_H
 
+#include <assert.h>
+#include <new>
+
 #include "Utility.h"
 #include "Equal.h"
 #include "Hash.h"
+#include "HashPolicy.h"
 #include "Pair.h"
+#include "TypeTraits.h"
 
 #include "../memory/Allocator.h"
 #include "../memory/Memory.h"
@@ -27,39 +32,111 @@ namespace wlp {
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Cache,
+            class Resize,
+            class Layout>
     class ChainHashMap;
 
     // Forward declaration of ChainHashMap iterator
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index = ModuloIndex,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash,
+            class Layout = PointerNodes>
     struct ChainHashMapIterator;
 
     // Forward declaration of const ChainHashMap iterator
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index = ModuloIndex,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash,
+            class Layout = PointerNodes>
     struct ChainHashMapConstIterator;
 
+    /**
+     * Hash code of the key of a chained map node, kept if the map
+     * stores hash codes.
+     * @tparam HashCode hash code type
+     */
+    template<class HashCode>
+    struct ChainHashMapNodeHash {
+        /**
+         * Hash code of the node element key.
+         */
+        HashCode m_hash;
+
+        /**
+         * @param hash the hash code of a lookup key
+         * @return false if the keys cannot be equal
+         */
+        bool hash_matches(HashCode hash) const {
+            return m_hash == hash;
+        }
+
+        /**
+         * @param hash the hash code of the node element key
+         */
+        void set_hash(HashCode hash) {
+            m_hash = hash;
+        }
+
+        /**
+         * @return the stored hash code of the node element key
+         */
+        template<class Hasher, class Key>
+        HashCode get_hash(const Hasher &, const Key &) const {
+            return m_hash;
+        }
+    };
+
+    /**
+     * Nodes of chained maps that do not store hash codes have no
+     * hash code field. Keys are always compared and hashed again.
+     */
+    template<>
+    struct ChainHashMapNodeHash<void> {
+        template<class HashCode>
+        bool hash_matches(HashCode) const {
+            return true;
+        }
+
+        template<class HashCode>
+        void set_hash(HashCode) {
+        }
+
+        template<class Hasher, class Key>
+        typename hash_code_type<Hasher, Key>::type get_hash(const Hasher &hash, const Key &key) const {
+            return hash(key);
+        }
+    };
+
     /**
      * Hasher map node comprise the elements of a hash map's
      * backing array, containing an element key and corresponding value.
-     * Has pointer to next node in a chain.
-     * @tparam Key key type
-     * @tparam Val value type
+     * Has a link to the next node in a chain.
+     * @tparam Key      key type
+     * @tparam Val      value type
+     * @tparam HashCode type of the stored hash code, void if none
+     * @tparam Layout   node layout policy, which sets the link type
      */
-    template<class Key, class Val>
-    struct ChainHashMapNode {
-        typedef ChainHashMapNode<Key, Val> node_type;
+    template<class Key, class Val, class HashCode = void, class Layout = PointerNodes>
+    struct ChainHashMapNode : public ChainHashMapNodeHash<HashCode> {
+        typedef ChainHashMapNode<Key, Val, HashCode, Layout> node_type;
+        typedef typename Layout::template link<node_type>::type link_type;
         typedef Key key_type;
         typedef Val val_type;
         /**
-         * Pointer to the next node in the chain.
+         * Link to the next node in the chain.
          */
-        node_type *next = nullptr;
+        link_type next = link_type();
         /**
          * Node element key value.
          */
@@ -69,6 +146,19 @@ namespace wlp {
          */
         val_type m_val;
 
+        ChainHashMapNode() = default;
+
+        /**
+         * Build the key and the value in place.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         */
+        template<class K, class... Args>
+        ChainHashMapNode(EmplaceNode, K &&key, Args &&... args)
+                : m_key(forward<K>(key)),
+                  m_val(forward<Args>(args)...) {
+        }
+
         /**
          * Equality operator for const.
          * @param node const node to compare
@@ -88,8 +178,379 @@ namespace wlp {
         bool operator==(node_type &node) const {
             return m_key == node.m_key && m_val == node.m_val;
         }
+
+        /**
+         * @return the node element value
+         */
+        val_type &value() {
+            return m_val;
+        }
+
+        /**
+         * @return the node element value
+         */
+        const val_type &value() const {
+            return m_val;
+        }
+    };
+
+    /**
+     * Nodes of the maps backing hash sets store only the key,
+     * which is also the value of the element.
+     * @tparam Key      the element type
+     * @tparam HashCode type of the stored hash code, void if none
+     * @tparam Layout   node layout policy, which sets the link type
+     */
+    template<class Key, class HashCode, class Layout>
+    struct ChainHashMapNode<Key, SetValue<Key>, HashCode, Layout> : public ChainHashMapNodeHash<HashCode> {
+        typedef ChainHashMapNode<Key, SetValue<Key>, HashCode, Layout> node_type;
+        typedef typename Layout::template link<node_type>::type link_type;
+        typedef Key key_type;
+        typedef const Key val_type;
+        /**
+         * Link to the next node in the chain.
+         */
+        link_type next = link_type();
+        /**
+         * The element.
+         */
+        key_type m_key;
+
+        ChainHashMapNode() = default;
+
+        /**
+         * Build the element in place.
+         * @param key argument from which to build the element
+         */
+        template<class K>
+        ChainHashMapNode(EmplaceNode, K &&key, SetValue<Key>)
+                : m_key(forward<K>(key)) {
+        }
+
+        /**
+         * Two nodes are equal if their elements are equal.
+         * @param node the node compare
+         * @return true if they are equal
+         */
+        bool operator==(const node_type &node) const {
+            return m_key == node.m_key;
+        }
+
+        /**
+         * @return the element
+         */
+        val_type &value() {
+            return m_key;
+        }
+
+        /**
+         * @return the element
+         */
+        const val_type &value() const {
+            return m_key;
+        }
+    };
+
+    /**
+     * Storage of the nodes of a chained map, which depends on
+     * the node layout policy of the map.
+     * @tparam Node   the node type
+     * @tparam Layout node layout policy
+     */
+    template<class Node, class Layout>
+    class ChainHashMapNodes;
+
+    /**
+     * Nodes allocated one at a time from an allocator, linked by pointers.
+     * @tparam Node the node type
+     */
+    template<class Node>
+    class ChainHashMapNodes<Node, PointerNodes> {
+    public:
+        typedef Node node_type;
+        typedef typename node_type::link_type link_type;
+        typedef Allocator allocator_type;
+
+    private:
+        /**
+         * Allocator to create memory for hash map nodes.
+         */
+        Allocator m_allocator;
+
+    public:
+        /**
+         * @param n the number of nodes in the initial pool of the allocator,
+         * or as many as fit the size type in bytes
+         */
+        explicit ChainHashMapNodes(size_type n)
+                : m_allocator{sizeof(node_type), node_pool_size(n, sizeof(node_type))} {
+        }
+
+        ChainHashMapNodes(ChainHashMapNodes &&nodes)
+                : m_allocator(move(nodes.m_allocator)) {
+        }
+
+        ChainHashMapNodes &operator=(ChainHashMapNodes &&nodes) {
+            m_allocator = move(nodes.m_allocator);
+            return *this;
+        }
+
+        /**
+         * @param link a link to a node, or a null link
+         * @return the linked node, or null
+         */
+        node_type *node(link_type link) const {
+            return link;
+        }
+
+        /**
+         * @param node a node, or null
+         * @return a link to the node
+         */
+        link_type link(node_type *node) const {
+            return node;
+        }
+
+        /**
+         * @return memory for a new node
+         */
+        node_type *allocate() {
+            return static_cast<node_type *>(m_allocator.Allocate());
+        }
+
+        /**
+         * @param node the node to release
+         */
+        void deallocate(node_type *node) {
+            m_allocator.Deallocate(node);
+        }
+
+        /**
+         * @return the node allocator
+         */
+        const Allocator *get_allocator() const {
+            return &m_allocator;
+        }
     };
 
+    /**
+     * Nodes kept in a contiguous arena and linked by their index in it.
+     * Slot zero is never handed out, so that index zero is the null link.
+     * Erased nodes are threaded onto a free list through their links and
+     * reused before the arena grows.
+     * @tparam Node the node type
+     */
+    template<class Node>
+    class ChainHashMapNodes<Node, ArenaNodes> {
+    public:
+        typedef Node node_type;
+        typedef typename node_type::link_type link_type;
+        typedef Allocator allocator_type;
+
+    private:
+        /**
+         * The arena of nodes.
+         */
+        node_type *m_arena;
+        /**
+         * The number of slots in the arena, including slot zero.
+         */
+        link_type m_capacity;
+        /**
+         * The number of slots handed out at least once, including slot zero.
+         */
+        link_type m_used;
+        /**
+         * Head of the list of erased nodes.
+         */
+        link_type m_free;
+
+        /**
+         * Double the arena, moving the nodes handed out so far.
+         * @return false if the doubled arena does not fit the size
+         * type in bytes or memory ran out, leaving the arena as it was
+         */
+        bool grow();
+
+    public:
+        /**
+         * @param n the number of nodes the arena initially holds
+         */
+        explicit ChainHashMapNodes(size_type n)
+                : m_capacity(static_cast<link_type>(n + 1 < 2 ? 2 : n + 1)),
+                  m_used(1),
+                  m_free(0) {
+            m_arena = memory_alloc_array<node_type>(m_capacity);
+            assert(m_arena);
+        }
+
+        ChainHashMapNodes(ChainHashMapNodes &&nodes)
+                : m_arena(nodes.m_arena),
+                  m_capacity(nodes.m_capacity),
+                  m_used(nodes.m_used),
+                  m_free(nodes.m_free) {
+            nodes.m_arena = nullptr;
+            nodes.m_capacity = 0;
+            nodes.m_used = 1;
+            nodes.m_free = 0;
+        }
+
+        ChainHashMapNodes &operator=(ChainHashMapNodes &&nodes) {
+            memory_free(m_arena);
+            m_arena = nodes.m_arena;
+            m_capacity = nodes.m_capacity;
+            m_used = nodes.m_used;
+            m_free = nodes.m_free;
+            nodes.m_arena = nullptr;
+            nodes.m_capacity = 0;
+            nodes.m_used = 1;
+            nodes.m_free = 0;
+            return *this;
+        }
+
+        ~ChainHashMapNodes() {
+            memory_free(m_arena);
+        }
+
+        /**
+         * @param link a link to a node, or a null link
+         * @return the linked node, or null
+         */
+        node_type *node(link_type link) const {
+            return link ? m_arena + link : nullptr;
+        }
+
+        /**
+         * @param node a node in the arena, or null
+         * @return a link to the node
+         */
+        link_type link(node_type *node) const {
+            return node ? static_cast<link_type>(node - m_arena) : 0;
+        }
+
+        /**
+         * Take a node from the free list or the unused end of the
+         * arena, which grows if it is full. Growing moves every node.
+         * @return memory for a new node, or null if the arena cannot grow
+         */
+        node_type *allocate() {
+            if (m_free) {
+                node_type *node = m_arena + m_free;
+                m_free = node->next;
+                return node;
+            }
+            if (m_used == m_capacity && !grow()) {
+                return nullptr;
+            }
+            return m_arena + m_used++;
+        }
+
+        /**
+         * @param node the node to release
+         */
+        void deallocate(node_type *node) {
+            node->next = m_free;
+            m_free = link(node);
+        }
+
+        /**
+         * @return null, the nodes do not come from an allocator
+         */
+        const Allocator *get_allocator() const {
+            return nullptr;
+        }
+    };
+
+    /**
+     * Nodes allocated one at a time from a composed allocator held by
+     * the storage, linked by pointers. Allocation returns null once the
+     * allocator runs out of memory.
+     * @tparam Node the node type
+     * @tparam A    the composed allocator
+     */
+    template<class Node, class A>
+    class ChainHashMapNodes<Node, AllocatorNodes<A>> {
+    public:
+        typedef Node node_type;
+        typedef typename node_type::link_type link_type;
+        typedef A allocator_type;
+
+    private:
+        /**
+         * Composed allocator providing the nodes.
+         */
+        A m_allocator;
+
+    public:
+        /**
+         * The composed allocator sizes its own pools, so the
+         * initial number of nodes is not used.
+         */
+        explicit ChainHashMapNodes(size_type) {
+        }
+
+        /**
+         * Disable moving, since the allocator may hold the nodes inline.
+         */
+        ChainHashMapNodes(ChainHashMapNodes &&) = delete;
+
+        ChainHashMapNodes &operator=(ChainHashMapNodes &&) = delete;
+
+        /**
+         * @see ChainHashMapNodes<Node, PointerNodes>::node()
+         */
+        node_type *node(link_type link) const {
+            return link;
+        }
+
+        /**
+         * @see ChainHashMapNodes<Node, PointerNodes>::link()
+         */
+        link_type link(node_type *node) const {
+            return node;
+        }
+
+        /**
+         * @return memory for a new node, or null if the allocator is out of memory
+         */
+        node_type *allocate() {
+            return static_cast<node_type *>(m_allocator.Allocate(sizeof(node_type)));
+        }
+
+        /**
+         * @param node the node to release
+         */
+        void deallocate(node_type *node) {
+            m_allocator.Deallocate(node, sizeof(node_type));
+        }
+
+        /**
+         * @return the composed node allocator
+         */
+        const A *get_allocator() const {
+            return &m_allocator;
+        }
+    };
+
+    template<class Node>
+    bool ChainHashMapNodes<Node, ArenaNodes>::grow() {
+        link_type new_capacity = static_cast<link_type>(2 * m_capacity);
+        node_type *new_arena = memory_alloc_array<node_type>(new_capacity);
+        if (!new_arena) {
+            return false;
+        }
+        // the free list is empty whenever the arena grows, so every
+        // node handed out so far holds an element
+        for (link_type i = 1; i < m_used; ++i) {
+            new(&new_arena[i]) node_type(move(m_arena[i]));
+            m_arena[i].~node_type();
+        }
+        memory_free(m_arena);
+        m_arena = new_arena;
+        m_capacity = new_capacity;
+        return true;
+    }
+
     /**
      * Iterator class over the elements of a ChainHashMap. Specifically,
      * this class iterates through each chain and then the backing array.
@@ -97,17 +558,26 @@ namespace wlp {
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
+     * @tparam Layout node layout policy, e.g. @code ArenaNodes @endcode
      */
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Cache,
+            class Resize,
+            class Layout>
     struct ChainHashMapIterator {
-        typedef ChainHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef ChainHashMapIterator<Key, Val, Hasher, Equals> iterator;
-        typedef ChainHashMapNode<Key, Val> node_type;
+        typedef ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> map_type;
+        typedef ChainHashMapIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> iterator;
+        typedef ChainHashMapNode<Key, Val, typename stored_hash_type<Hasher, Key, Cache>::type, Layout> node_type;
 
-        typedef Val val_type;
+        typedef Key key_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
 
@@ -119,23 +589,31 @@ namespace wlp {
          * Pointer to the iterated ChainHashMap.
          */
         map_type *m_hash_map;
+        /**
+         * Index of the bucket of the referenced node, so that
+         * incrementing needs neither hashing nor probing.
+         */
+        size_type m_index;
 
         /**
          * Default constructor.
          */
         ChainHashMapIterator()
                 : m_current(nullptr),
-                  m_hash_map(nullptr) {
+                  m_hash_map(nullptr),
+                  m_index(0) {
         }
 
         /**
          * Create an iterator to a ChainHashMap node.
-         * @param node hash map node
-         * @param map  parent hash map
+         * @param node  hash map node
+         * @param map   parent hash map
+         * @param index bucket of the node
          */
-        ChainHashMapIterator(node_type *node, map_type *map)
+        ChainHashMapIterator(node_type *node, map_type *map, size_type index = 0)
                 : m_current(node),
-                  m_hash_map(map) {
+                  m_hash_map(map),
+                  m_index(index) {
         }
 
         /**
@@ -144,7 +622,8 @@ namespace wlp {
          */
         ChainHashMapIterator(const iterator &it)
                 : m_current(it.m_current),
-                  m_hash_map(it.m_hash_map) {
+                  m_hash_map(it.m_hash_map),
+                  m_index(it.m_index) {
         }
 
         /**
@@ -153,7 +632,15 @@ namespace wlp {
          */
         ChainHashMapIterator(iterator &&it)
                 : m_current(move(it.m_current)),
-                  m_hash_map(move(it.m_hash_map)) {
+                  m_hash_map(move(it.m_hash_map)),
+                  m_index(move(it.m_index)) {
+        }
+
+        /**
+         * @return the key of the node pointed to by the iterator
+         */
+        const key_type &key() const {
+            return m_current->m_key;
         }
 
         /**
@@ -161,7 +648,7 @@ namespace wlp {
          * pointed to by the iterator
          */
         val_type &operator*() const {
-            return m_current->m_val;
+            return m_current->value();
         }
 
         /**
@@ -176,6 +663,8 @@ namespace wlp {
          * Increment the iterator to the next available element in
          * the ChainHashMap. If no such element exists, returns pass-the-end
          * iterator. This is pre-fix unary operator.
+         * The scan starts from the stored bucket index, so an
+         * iterator does not survive a rehash of the map.
          * @return this iterator
          */
         iterator &operator++();
@@ -233,6 +722,7 @@ namespace wlp {
         iterator &operator=(const iterator &it) {
             m_current = it.m_current;
             m_hash_map = it.m_hash_map;
+            m_index = it.m_index;
             return *this;
         }
 
@@ -245,6 +735,7 @@ namespace wlp {
         iterator &operator=(iterator &&it) {
             m_current = move(it.m_current);
             m_hash_map = move(it.m_hash_map);
+            m_index = move(it.m_index);
             return *this;
         }
 
@@ -260,45 +751,66 @@ namespace wlp {
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
+     * @tparam Layout node layout policy, e.g. @code ArenaNodes @endcode
      */
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Cache,
+            class Resize,
+            class Layout>
     struct ChainHashMapConstIterator {
-        typedef ChainHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef ChainHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
-        typedef ChainHashMapNode<Key, Val> node_type;
+        typedef ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> map_type;
+        typedef ChainHashMapConstIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> const_iterator;
+        typedef ChainHashMapNode<Key, Val, typename stored_hash_type<Hasher, Key, Cache>::type, Layout> node_type;
 
-        typedef Val val_type;
+        typedef Key key_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
 
         const node_type *m_current;
         const map_type *m_hash_map;
+        size_type m_index;
 
         ChainHashMapConstIterator()
                 : m_current(nullptr),
-                  m_hash_map(nullptr) {
+                  m_hash_map(nullptr),
+                  m_index(0) {
         }
 
-        ChainHashMapConstIterator(node_type *node, const map_type *map)
+        ChainHashMapConstIterator(node_type *node, const map_type *map, size_type index = 0)
                 : m_current(node),
-                  m_hash_map(map) {
+                  m_hash_map(map),
+                  m_index(index) {
         }
 
         ChainHashMapConstIterator(const const_iterator &it)
                 : m_current(it.m_current),
-                  m_hash_map(it.m_hash_map) {
+                  m_hash_map(it.m_hash_map),
+                  m_index(it.m_index) {
         }
 
         ChainHashMapConstIterator(const_iterator &&it)
                 : m_current(move(it.m_current)),
-                  m_hash_map(move(it.m_hash_map)) {
+                  m_hash_map(move(it.m_hash_map)),
+                  m_index(move(it.m_index)) {
+        }
+
+        /**
+         * @return the key of the node pointed to by the iterator
+         */
+        const key_type &key() const {
+            return m_current->m_key;
         }
 
         const val_type &operator*() const {
-            return m_current->m_val;
+            return m_current->value();
         }
 
         const val_type *operator->() const {
@@ -328,12 +840,14 @@ namespace wlp {
         const_iterator &operator=(const const_iterator &it) {
             m_current = it.m_current;
             m_hash_map = it.m_hash_map;
+            m_index = it.m_index;
             return *this;
         }
 
         const_iterator &operator=(const_iterator &&it) {
             m_current = move(it.m_current);
             m_hash_map = move(it.m_hash_map);
+            m_index = move(it.m_index);
             return *this;
         }
     };
@@ -345,26 +859,36 @@ namespace wlp {
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
+     * @tparam Layout node layout policy, e.g. @code ArenaNodes @endcode
      */
     template<class Key,
             class Val,
-            class Hasher = Hash<Key, uint16_t>,
-            class Equals = Equal<Key>>
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal<Key>,
+            class Index = ModuloIndex,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash,
+            class Layout = PointerNodes>
     class ChainHashMap {
     public:
-        typedef ChainHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef ChainHashMapIterator<Key, Val, Hasher, Equals> iterator;
-        typedef ChainHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
-        typedef ChainHashMapNode<Key, Val> node_type;
+        typedef ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> map_type;
+        typedef ChainHashMapIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> iterator;
+        typedef ChainHashMapConstIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> const_iterator;
+        typedef ChainHashMapNode<Key, Val, typename stored_hash_type<Hasher, Key, Cache>::type, Layout> node_type;
+        typedef typename node_type::link_type link_type;
 
         typedef Key key_type;
-        typedef Val val_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
         typedef uint8_t percent_type;
+        typedef typename hash_code_type<Hasher, Key>::type hash_code;
 
-        friend struct ChainHashMapIterator<Key, Val, Hasher, Equals>;
-        friend struct ChainHashMapConstIterator<Key, Val, Hasher, Equals>;
+        friend struct ChainHashMapIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout>;
+        friend struct ChainHashMapConstIterator<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout>;
 
     private:
         /**
@@ -379,14 +903,21 @@ namespace wlp {
         Equals m_equal;
 
         /**
-         * Allocator to create memory for hash map nodes.
+         * Storage of the hash map nodes.
          */
-        Allocator m_node_allocator;
+        ChainHashMapNodes<node_type, Layout> m_nodes;
 
         /**
-         * Hasher map backing array.
+         * Hasher map backing array, holding a link to
+         * the first node of each chain.
          */
-        node_type **m_buckets;
+        link_type *m_buckets;
+        /**
+         * The bucket array before the map last grew, while incremental
+         * rehashing is still splitting its buckets into the current
+         * one, and null otherwise.
+         */
+        link_type *m_old_buckets;
 
         /**
          * The number of elements currently
@@ -400,6 +931,18 @@ namespace wlp {
          * array if the load factor is greater than 100.
          */
         size_type m_capacity;
+        /**
+         * The size of the old bucket array, or zero if there is none.
+         */
+        size_type m_old_capacity;
+        /**
+         * The number of buckets of the old capacity already split.
+         */
+        size_type m_num_split;
+        /**
+         * The number of buckets to split per insertion.
+         */
+        size_type m_split_step;
         /**
          * The maximum load factor as an integer percent
          * before the map performs a rehash. This number
@@ -415,7 +958,8 @@ namespace wlp {
          * @pre the hash map requires definition of an initial bucket array size
          *      and a maximum load factor before rehashing
          *
-         * @param n        initial size of the bucket list; each bucket is initialized to nullptr
+         * @param n        initial size of the bucket list, as adjusted by the index policy;
+         *                 each bucket is initialized to nullptr
          * @param max_load an integer value denoting the max percent load factor, e.g. 100 = 1.00
          * @param hash     hash function for the key type, default is {@code wlp::Hasher}
          * @param equal    equality function for the key type, default is {@code wlp::Equals}
@@ -425,11 +969,17 @@ namespace wlp {
                 percent_type max_load = 75)
                 : m_hash(Hasher()),
                   m_equal(Equals()),
-                  m_node_allocator{sizeof(node_type), static_cast<size_type>(n * sizeof(node_type))},
+                  m_nodes(n),
+                  m_old_buckets(nullptr),
                   m_num_elements(0),
-                  m_capacity(n),
+                  m_capacity(Index::capacity(n)),
+                  m_old_capacity(0),
+                  m_num_split(0),
+                  m_split_step(0),
                   m_max_load(max_load) {
-            init_buckets(n);
+            bool allocated = init_buckets(m_capacity);
+            assert(allocated);
+            (void) allocated;
         }
 
         /**
@@ -445,14 +995,20 @@ namespace wlp {
         ChainHashMap(map_type &&map) :
                 m_hash(move(map.m_hash)),
                 m_equal(move(map.m_equal)),
-                m_node_allocator(move(map.m_node_allocator)),
+                m_nodes(move(map.m_nodes)),
                 m_buckets(move(map.m_buckets)),
+                m_old_buckets(move(map.m_old_buckets)),
                 m_num_elements(move(map.m_num_elements)),
                 m_capacity(move(map.m_capacity)),
+                m_old_capacity(move(map.m_old_capacity)),
+                m_num_split(move(map.m_num_split)),
+                m_split_step(move(map.m_split_step)),
                 m_max_load(move(map.m_max_load)) {
             map.m_num_elements = 0;
             map.m_capacity = 0;
+            map.m_old_capacity = 0;
             map.m_buckets = nullptr;
+            map.m_old_buckets = nullptr;
         }
 
         /**
@@ -465,40 +1021,145 @@ namespace wlp {
         /**
          * Function called when creating the hash map. This function
          * will allocate memory for the backing array and initialize each
-         * element to nullptr.
+         * element to nullptr. The current array is kept if the
+         * allocation fails.
          *
          * @param n the size of the backing array
+         * @return false if the array does not fit the size type in
+         * bytes or memory ran out
+         */
+        bool init_buckets(size_type n);
+
+        /**
+         * @param link a link to a node, or a null link
+         * @return the linked node, or null
+         */
+        node_type *node_at(link_type link) const {
+            return m_nodes.node(link);
+        }
+
+        /**
+         * @param node a node in the map, or null
+         * @return a link to the node
+         */
+        link_type link_of(node_type *node) const {
+            return m_nodes.link(node);
+        }
+
+        /**
+         * Buckets are numbered through the current bucket array and
+         * then through the old one, while there is one.
+         *
+         * @return the number of buckets
+         */
+        size_type num_buckets() const {
+            return static_cast<size_type>(m_capacity + m_old_capacity);
+        }
+
+        /**
+         * @param i a bucket index less than the number of buckets
+         * @return the link to the first node of the bucket
+         */
+        link_type &bucket(size_type i) {
+            return i < m_capacity ? m_buckets[i] : m_old_buckets[i - m_capacity];
+        }
+
+        /**
+         * @see ChainHashMap<Key, Value, Hasher, Equals>::bucket()
+         * @param i a bucket index less than the number of buckets
+         * @return the link to the first node of the bucket
+         */
+        link_type bucket(size_type i) const {
+            return i < m_capacity ? m_buckets[i] : m_old_buckets[i - m_capacity];
+        }
+
+        /**
+         * Obtain the bucket holding the elements with a hash code. While
+         * buckets are being split, codes whose old bucket has not been
+         * split yet still belong to that bucket.
+         *
+         * @param code the hash code of a key
+         * @return the bucket index of the key
          */
-        void init_buckets(size_type n);
+        size_type bucket_of(hash_code code) const {
+            if (Resize::INCREMENTAL && m_old_buckets) {
+                size_type i = Index::index(code, m_old_capacity);
+                if (i >= m_num_split) {
+                    return static_cast<size_type>(m_capacity + i);
+                }
+            }
+            return Index::index(code, m_capacity);
+        }
 
         /**
-         * Obtain the bucket index in an array with the specified
-         * number of maximum elements.
+         * Split buckets of the old bucket array, moving each node to its
+         * bucket in the current array. The old array is freed once every
+         * bucket is split.
          *
-         * @param key          the key to hash
-         * @param max_elements the maximum number of buckets
-         * @return an index i such that 0 <= i < max_elements
+         * @param n the maximum number of buckets to split
          */
-        size_type bucket_index(key_type key, size_type max_elements) const {
-            return m_hash(key) % max_elements;
+        void split_buckets(size_type n);
+
+        /**
+         * @param node a node in the map
+         * @param key  the key to look up
+         * @param code the hash code of the key
+         * @return true if the node holds the key
+         */
+        template<class K>
+        bool matches(const node_type *node, const K &key, hash_code code) const {
+            return node->hash_matches(code) && m_equal(key, node->m_key);
         }
 
         /**
-         * Obtain the bucket index of a key in the backing array.
+         * Walk the chain of a bucket looking for a key.
          *
-         * @param key the key to hash
-         * @return an index i such that 0 <= i < m_max_elements
+         * @param key  the key to look up
+         * @param code the hash code of the key
+         * @param i    the bucket of the key
+         * @return the node holding the key, or null
          */
-        size_type hash(key_type key) const {
-            return m_hash(key) % m_capacity;
+        template<class K>
+        node_type *find_node(const K &key, hash_code code, size_type i) const {
+            node_type *cur = node_at(bucket(i));
+            while (cur && !matches(cur, key, code)) {
+                cur = node_at(cur->next);
+            }
+            return cur;
         }
 
+        /**
+         * Unlink and deallocate the node holding a key.
+         *
+         * @param key the key of the element to erase
+         * @return true if erasure occured
+         */
+        template<class K>
+        bool remove_key(const K &key);
+
+        /**
+         * Enables the lookup overloads taking other key-like types,
+         * which requires both the hasher and the equality function
+         * to be marked transparent.
+         *
+         * @tparam K the type of the lookup key
+         */
+        template<class K>
+        struct transparent_key : enable_if<
+                has_is_transparent<Hasher>::value &&
+                has_is_transparent<Equals>::value, K> {
+        };
+
         /**
          * Resize and rehash the hash map if the current load factor
          * exceeds or equals the maximum load factor. This function
          * will double the size of the backing array, allocating a new
          * array, and fully deallocating the previous array.
          *
+         * Under incremental rehashing the buckets of the previous array
+         * are split into the new one a bounded number at a time, on
+         * this and the following calls.
+         *
          * @pre this function will create a new array allocator, however
          *      the same node allocator will be used, which means that
          *      the node allocator will start drawing from heap memory
@@ -506,6 +1167,56 @@ namespace wlp {
          */
         void ensure_capacity();
 
+        /**
+         * Relink every node into a new backing array, finishing
+         * any incremental rehash first. The map keeps its array if
+         * the new one cannot be allocated.
+         * @param new_capacity the capacity of the new array
+         */
+        void rehash_to(size_type new_capacity);
+
+        /**
+         * @param n a number of elements
+         * @return the smallest capacity allowed by the index policy
+         * that holds the elements without growing
+         */
+        size_type capacity_for(size_type n) const;
+
+
+        /**
+         * Insert an element unless its key is in the map, building
+         * the key and the value in the node from the arguments.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return the element with the key and whether it was inserted
+         */
+        template<class K, class... Args>
+        Pair<iterator, bool> emplace_key(K &&key, Args &&... args);
+
+        /**
+         * Build a node in memory from the node storage.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return the new node, or null if the node storage is out of memory
+         */
+        template<class K, class... Args>
+        node_type *create_node(K &&key, Args &&... args) {
+            void *memory = m_nodes.allocate();
+            if (!memory) {
+                return nullptr;
+            }
+            return new(memory) node_type(EmplaceNode(), forward<K>(key), forward<Args>(args)...);
+        }
+
+        /**
+         * Destroy a node and return its memory to the node storage.
+         * @param node the node to destroy
+         */
+        void destroy_node(node_type *node) {
+            node->~node_type();
+            m_nodes.deallocate(node);
+        }
+
     public:
         /**
          * @return the current number of elements that have been
@@ -529,6 +1240,22 @@ namespace wlp {
             return m_max_load;
         }
 
+        /**
+         * @return the number of buckets of the old array still to be
+         * split by incremental rehashing, or zero
+         */
+        size_type unsplit_buckets() const {
+            return static_cast<size_type>(m_old_capacity - m_num_split);
+        }
+
+        /**
+         * @return the most buckets an insertion splits
+         * during the current incremental rehash
+         */
+        size_type split_step() const {
+            return m_split_step;
+        }
+
         /**
          * @return true if the map is empty
          */
@@ -537,10 +1264,11 @@ namespace wlp {
         }
 
         /**
-         * @return the node allocator of the map
+         * @return the node allocator of the map, or null if
+         * the map keeps its nodes in an arena
          */
-        const Allocator *get_node_allocator() const {
-            return &m_node_allocator;
+        const typename ChainHashMapNodes<node_type, Layout>::allocator_type *get_node_allocator() const {
+            return m_nodes.get_allocator();
         }
 
         /**
@@ -554,9 +1282,9 @@ namespace wlp {
             if (m_num_elements == 0) {
                 return end();
             }
-            for (size_type i = 0; i < m_capacity; ++i) {
-                if (m_buckets[i]) {
-                    return iterator(m_buckets[i], this);
+            for (size_type i = 0; i < num_buckets(); ++i) {
+                if (bucket(i)) {
+                    return iterator(node_at(bucket(i)), this, i);
                 }
             }
             return end();
@@ -577,9 +1305,9 @@ namespace wlp {
             if (m_num_elements == 0) {
                 return end();
             }
-            for (size_type i = 0; i < m_capacity; ++i) {
-                if (m_buckets[i]) {
-                    return const_iterator(m_buckets[i], this);
+            for (size_type i = 0; i < num_buckets(); ++i) {
+                if (bucket(i)) {
+                    return const_iterator(node_at(bucket(i)), this, i);
                 }
             }
             return end();
@@ -608,9 +1336,65 @@ namespace wlp {
          * @param val inserted element value
          * @return a pair consisting of an iterator pointing to the
          * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred; the iterator
+         * is end() if the node allocator ran out of memory
+         */
+        Pair<iterator, bool> insert(const key_type &key, const val_type &val);
+
+        /**
+         * Insert an element by moving the key and value into the
+         * node, so that neither is copied more than once.
+         *
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert(key_type &&key, val_type &&val);
+
+        /**
+         * Insert an element whose value is built from the given
+         * arguments, if no element with the key exists. Otherwise the
+         * arguments are left untouched. A single argument is assigned
+         * to the value directly, so that a value such as a large static
+         * string is written once from a character string or moved from
+         * an rvalue.
+         *
+         * @tparam Args types of the value arguments
+         * @param key  inserted element key
+         * @param args arguments from which to build the value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
          * and a bool indicating whether insertion occurred
          */
-        Pair<iterator, bool> insert(key_type key, val_type val);
+        template<class... Args>
+        Pair<iterator, bool> try_emplace(const key_type &key, Args &&... args);
+
+        /**
+         * @see try_emplace()
+         * @param key  inserted element key, moved into the node
+         * @param args arguments from which to build the value
+         */
+        template<class... Args>
+        Pair<iterator, bool> try_emplace(key_type &&key, Args &&... args);
+
+        /**
+         * Insert an element whose key and value are built from the
+         * given arguments, if no element with the key exists. The key
+         * may be any type from which the key type can be constructed,
+         * such as a character string for static string keys.
+         *
+         * @tparam K    type of the key argument
+         * @tparam Args types of the value arguments
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        template<class K, class... Args>
+        Pair<iterator, bool> emplace(K &&key, Args &&... args);
 
         /**
          * Attempt to insert an element into the map.
@@ -623,10 +1407,12 @@ namespace wlp {
          * inserted element or the assigned element, and a bool
          * indicating whether insertion occurred
          */
-        Pair<iterator, bool> insert_or_assign(key_type key, val_type val);
+        Pair<iterator, bool> insert_or_assign(const key_type &key, const val_type &val);
 
         /**
-         * Erase an element pointed to by the provided pointer.
+         * Erase an element pointed to by the provided pointer. The
+         * node is unlinked from its chain, so other elements are not
+         * moved and references to them stay valid.
          *
          * @param pos element to erase
          * @return the iterator to the next element in the map
@@ -689,12 +1475,120 @@ namespace wlp {
          */
         const_iterator find(const key_type &key) const;
 
+        /**
+         * Count the nodes visited when looking up a key, which
+         * is one for the first key of its chain. A miss counts the
+         * whole chain plus one. Intended for measuring the quality
+         * of the hash function and index policy.
+         * @param key the key to look up
+         * @return the probe length of the lookup
+         */
+        size_type probe_length(const key_type &key) const;
+
+        /**
+         * Relink the nodes into a backing array of at least the given
+         * capacity, or of the capacity needed to hold the current
+         * elements if that is larger. Nodes are never reallocated, but
+         * iterators are invalidated.
+         * @param n the minimum capacity
+         */
+        void rehash(size_type n);
+
+        /**
+         * Grow the backing array once so that the given number of
+         * elements fit without any further rehash. Does nothing if the
+         * map is already large enough.
+         * @param n the number of elements to hold
+         */
+        void reserve(size_type n);
+
+        /**
+         * Insert the key-value pairs of a range, growing the backing
+         * array at most once beforehand. Keys already in the map, or
+         * repeated in the range, keep their first value.
+         *
+         * @pre the range can be traversed twice
+         *
+         * @tparam InputIt iterator to pairs of keys and values
+         * @param first the first pair to insert
+         * @param last  pass-the-end of the range
+         */
+        template<class InputIt, class = decltype((*declval<InputIt &>()).first())>
+        void insert(InputIt first, InputIt last);
+
+        /**
+         * Erase every element for which the predicate holds, unlinking
+         * the nodes in a single pass over the chains without hashing any
+         * key. Iterators to erased elements are invalidated.
+         * @tparam Predicate function of a key and a value returning bool
+         * @param pred the predicate selecting elements to erase
+         * @return the number of erased elements
+         */
+        template<class Predicate>
+        size_type erase_if(Predicate pred);
+
+        /**
+         * Erase the element whose key compares equal to a key of
+         * another type, such as a character string in a map keyed by
+         * static strings. These overloads are only available if the
+         * hasher and the equality function are transparent, and the
+         * lookup key is never converted to the key type.
+         *
+         * @param key the key of the element to erase
+         * @return true if erasure occured
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        bool erase(const K &key);
+
+        /**
+         * @see ChainHashMap<Key, Value, Hasher, Equals>::at()
+         * @param key a key of another type
+         * @return an iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        iterator at(const K &key);
+
+        /**
+         * @see ChainHashMap<Key, Value, Hasher, Equals>::at()
+         * @param key a key of another type
+         * @return a const iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        const_iterator at(const K &key) const;
+
+        /**
+         * @param key a key of another type
+         * @return true if the key maps to a value
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        bool contains(const K &key) const;
+
+        /**
+         * @see ChainHashMap<Key, Value, Hasher, Equals>::find()
+         * @param key a key of another type
+         * @return an iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        iterator find(const K &key);
+
+        /**
+         * @see ChainHashMap<Key, Value, Hasher, Equals>::find()
+         * @param key a key of another type
+         * @return a const iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        const_iterator find(const K &key) const;
+
         /**
          * Access an element in the hash map by the given key.
          * If the key does not map to any value in the map,
          * then a new value is created and inserted using the default
          * constructor.
          *
+         * @pre the node allocator does not run out of memory, which
+         * only allocator nodes and an arena that cannot grow can; use
+         * insert to detect it
+         *
          * @param key the key whose value to access
          * @return a reference to the mapped value
          */
@@ -719,35 +1613,100 @@ namespace wlp {
         map_type &operator=(map_type &&map);
     };
 
-    template<class Key, class Value, class Hasher, class Equals>
-    void ChainHashMap<Key, Value, Hasher, Equals>::init_buckets(ChainHashMap<Key, Value, Hasher, Equals>::size_type n) {
-        m_buckets = static_cast<node_type **>(memory_alloc(n * sizeof(node_type *)));
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::init_buckets(ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::size_type n) {
+        link_type *buckets = memory_alloc_array<link_type>(n);
+        if (!buckets) {
+            return false;
+        }
         for (size_type i = 0; i < n; ++i) {
-            m_buckets[i] = nullptr;
+            buckets[i] = link_type();
+        }
+        m_buckets = buckets;
+        return true;
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::split_buckets(size_type n) {
+        size_type end = m_old_capacity - m_num_split < n ? m_old_capacity : static_cast<size_type>(m_num_split + n);
+        for (; m_num_split < end; ++m_num_split) {
+            node_type *cur = node_at(m_old_buckets[m_num_split]);
+            m_old_buckets[m_num_split] = link_type();
+            while (cur) {
+                node_type *next = node_at(cur->next);
+                size_type k = Index::index(cur->get_hash(m_hash, cur->m_key), m_capacity);
+                cur->next = m_buckets[k];
+                m_buckets[k] = link_of(cur);
+                cur = next;
+            }
+        }
+        if (m_num_split == m_old_capacity) {
+            memory_free(m_old_buckets);
+            m_old_buckets = nullptr;
+            m_old_capacity = 0;
+            m_num_split = 0;
+        }
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::ensure_capacity() {
+        if (Resize::INCREMENTAL && m_old_buckets) {
+            // growing again waits for the split to finish, which the
+            // step chosen below ensures before the maximum load
+            split_buckets(m_split_step);
+            return;
+        }
+        if (static_cast<wide_size_type>(m_num_elements) * 100 < static_cast<wide_size_type>(m_max_load) * m_capacity) {
+            return;
+        }
+        size_type new_capacity = grow_capacity(m_capacity);
+        if (new_capacity == m_capacity) {
+            // the size type cannot hold a larger capacity, so the
+            // chains grow longer instead
+            return;
+        }
+        if (Resize::INCREMENTAL) {
+            // both arrays stay live, and the old buckets are split into
+            // the new array a few at a time, starting with this insertion
+            link_type *old_buckets = m_buckets;
+            if (!init_buckets(new_capacity)) {
+                return;
+            }
+            m_old_buckets = old_buckets;
+            m_old_capacity = m_capacity;
+            m_num_split = 0;
+            m_capacity = new_capacity;
+            size_type limit = static_cast<size_type>(static_cast<wide_size_type>(m_max_load) * new_capacity / 100);
+            size_type budget = static_cast<size_type>(limit > m_num_elements ? limit - m_num_elements : 0);
+            m_split_step = IncrementalRehash::step(m_old_capacity, budget);
+            split_buckets(m_split_step);
+            return;
         }
+        rehash_to(new_capacity);
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    void ChainHashMap<Key, Value, Hasher, Equals>::ensure_capacity() {
-        if (m_num_elements * 100 < m_max_load * m_capacity) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::rehash_to(size_type new_capacity) {
+        if (Resize::INCREMENTAL && m_old_capacity) {
+            split_buckets(m_old_capacity);
+        }
+        link_type *new_buckets = memory_alloc_array<link_type>(new_capacity);
+        if (!new_buckets) {
             return;
         }
-        size_type new_capacity = static_cast<size_type>(m_capacity * 2);
-        node_type **new_buckets = static_cast<node_type **>(memory_alloc(new_capacity * sizeof(node_type *)));
         for (size_type i = 0; i < new_capacity; ++i) {
-            new_buckets[i] = nullptr;
+            new_buckets[i] = link_type();
         }
         for (size_type i = 0; i < m_capacity; ++i) {
             if (!m_buckets[i]) {
                 continue;
             }
-            node_type *cur = m_buckets[i];
+            node_type *cur = node_at(m_buckets[i]);
             while (cur) {
-                size_type k = bucket_index(cur->m_key, new_capacity);
-                node_type *first = new_buckets[k];
-                node_type *next = cur->next;
-                cur->next = first;
-                new_buckets[k] = cur;
+                size_type k = Index::index(cur->get_hash(m_hash, cur->m_key), new_capacity);
+                node_type *next = node_at(cur->next);
+                cur->next = new_buckets[k];
+                new_buckets[k] = link_of(cur);
                 cur = next;
             }
         }
@@ -756,345 +1715,440 @@ namespace wlp {
         m_capacity = new_capacity;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    void ChainHashMap<Key, Value, Hasher, Equals>::clear() noexcept {
-        for (size_type i = 0; i < m_capacity; ++i) {
-            node_type *cur = m_buckets[i];
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::clear() noexcept {
+        for (size_type i = 0; i < num_buckets(); ++i) {
+            node_type *cur = node_at(bucket(i));
             node_type *next;
             while (cur) {
-                next = cur->next;
-                m_node_allocator.Deallocate(cur);
+                next = node_at(cur->next);
+                destroy_node(cur);
                 cur = next;
             }
-            m_buckets[i] = nullptr;
+            bucket(i) = link_type();
         }
         m_num_elements = 0;
+        memory_free(m_old_buckets);
+        m_old_buckets = nullptr;
+        m_old_capacity = 0;
+        m_num_split = 0;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    Pair<typename ChainHashMap<Key, Value, Hasher, Equals>::iterator, bool>
-    ChainHashMap<Key, Value, Hasher, Equals>::insert(key_type key, val_type val) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class... Args>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::emplace_key(K &&key, Args &&... args) {
         ensure_capacity();
-        size_type i = hash(key);
-        node_type *first = m_buckets[i];
-        for (node_type *cur = first; cur; cur = cur->next) {
-            if (m_equal(cur->m_key, key)) {
-                return Pair<iterator, bool>(iterator(cur, this), false);
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        for (node_type *cur = node_at(bucket(i)); cur; cur = node_at(cur->next)) {
+            if (matches(cur, key, code)) {
+                return Pair<iterator, bool>(iterator(cur, this, i), false);
             }
         }
-        node_type *tmp = static_cast<node_type *>(m_node_allocator.Allocate());
-        tmp->m_key = key;
-        tmp->m_val = val;
-        tmp->next = first;
-        m_buckets[i] = tmp;
+        node_type *tmp = create_node(forward<K>(key), forward<Args>(args)...);
+        if (!tmp) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        tmp->set_hash(code);
+        tmp->next = bucket(i);
+        bucket(i) = link_of(tmp);
         ++m_num_elements;
-        return Pair<iterator, bool>(iterator(tmp, this), true);
-    };
+        return Pair<iterator, bool>(iterator(tmp, this, i), true);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::insert(const key_type &key, const val_type &val) {
+        return emplace_key(key, val);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::insert(key_type &&key, val_type &&val) {
+        return emplace_key(move(key), move(val));
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class... Args>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::try_emplace(const key_type &key, Args &&... args) {
+        return emplace_key(key, forward<Args>(args)...);
+    }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    Pair<typename ChainHashMap<Key, Value, Hasher, Equals>::iterator, bool>
-    ChainHashMap<Key, Value, Hasher, Equals>::insert_or_assign(key_type key, val_type val) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class... Args>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::try_emplace(key_type &&key, Args &&... args) {
+        return emplace_key(move(key), forward<Args>(args)...);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class... Args>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::emplace(K &&key, Args &&... args) {
+        return emplace_key(key_type(forward<K>(key)), forward<Args>(args)...);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    Pair<typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator, bool>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::insert_or_assign(const key_type &key, const val_type &val) {
         ensure_capacity();
-        size_type i = hash(key);
-        node_type *first = m_buckets[i];
-        for (node_type *cur = first; cur; cur = cur->next) {
-            if (m_equal(cur->m_key, key)) {
-                cur->m_val = val;
-                return Pair<iterator, bool>(iterator(cur, this), false);
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        for (node_type *cur = node_at(bucket(i)); cur; cur = node_at(cur->next)) {
+            if (matches(cur, key, code)) {
+                cur->value() = val;
+                return Pair<iterator, bool>(iterator(cur, this, i), false);
             }
         }
-        node_type *tmp = static_cast<node_type *>(m_node_allocator.Allocate());
-        tmp->m_key = key;
-        tmp->m_val = val;
-        tmp->next = first;
-        m_buckets[i] = tmp;
+        node_type *tmp = create_node(key, val);
+        if (!tmp) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        tmp->set_hash(code);
+        tmp->next = bucket(i);
+        bucket(i) = link_of(tmp);
         ++m_num_elements;
-        return Pair<iterator, bool>(iterator(tmp, this), true);
-    };
+        return Pair<iterator, bool>(iterator(tmp, this, i), true);
+    }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::iterator &
-    ChainHashMap<Key, Value, Hasher, Equals>::erase(iterator &pos) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator &
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::erase(iterator &pos) {
         node_type *p_node = pos.m_current;
-        if (p_node) {
-            node_type *n_node = p_node->next;
-            if (n_node) {
-                p_node->next = n_node->next;
-                p_node->m_key = n_node->m_key;
-                p_node->m_val = n_node->m_val;
-                m_node_allocator.Deallocate(n_node);
-                --m_num_elements;
-                return pos;
-            } else {
-                size_type i = hash(p_node->m_key);
-                node_type *c_node = m_buckets[i];
-                if (c_node == p_node) {
-                    m_node_allocator.Deallocate(c_node);
-                    --m_num_elements;
-                    m_buckets[i] = nullptr;
-                    while (++i < m_capacity && !m_buckets[i]);
-                    if (i == m_capacity) {
-                        pos.m_current = nullptr;
-                        return pos;
-                    } else {
-                        pos.m_current = m_buckets[i];
-                        return pos;
-                    }
-                } else {
-                    while (c_node->next != p_node) {
-                        c_node = c_node->next;
-                    }
-                    m_node_allocator.Deallocate(c_node->next);
-                    --m_num_elements;
-                    c_node->next = nullptr;
-                    while (++i < m_capacity && !m_buckets[i]);
-                    if (i == m_capacity) {
-                        pos.m_current = nullptr;
-                        return pos;
-                    } else {
-                        pos.m_current = m_buckets[i];
-                        return pos;
-                    }
-                }
-            }
-        }
-        pos.m_current = nullptr;
+        if (!p_node) {
+            return pos;
+        }
+        size_type i = pos.m_index;
+        link_type *link = &bucket(i);
+        while (node_at(*link) != p_node) {
+            link = &node_at(*link)->next;
+        }
+        *link = p_node->next;
+        node_type *next = node_at(p_node->next);
+        destroy_node(p_node);
+        --m_num_elements;
+        if (!next) {
+            while (++i < num_buckets() && !bucket(i));
+            next = i < num_buckets() ? node_at(bucket(i)) : nullptr;
+        }
+        pos.m_current = next;
+        pos.m_index = i;
         return pos;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    bool ChainHashMap<Key, Value, Hasher, Equals>::erase(key_type &key) {
-        size_type i = hash(key);
-        node_type *first = m_buckets[i];
-        if (first) {
-            node_type *cur = first;
-            node_type *next = cur->next;
-            if (next) {
-                if (m_equal(key, cur->m_key)) {
-                    cur->m_key = next->m_key;
-                    cur->m_val = next->m_val;
-                    cur->next = next->next;
-                    m_node_allocator.Deallocate(next);
-                    --m_num_elements;
-                    return true;
-                }
-                while (next && !m_equal(key, next->m_key)) {
-                    cur = next;
-                    next = cur->next;
-                }
-                if (next) {
-                    cur->next = next->next;
-                    m_node_allocator.Deallocate(next);
-                    --m_num_elements;
-                    return true;
-                }
-                return false;
-            } else {
-                if (!m_equal(key, cur->m_key)) {
-                    return false;
-                }
-                m_node_allocator.Deallocate(cur);
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::erase(key_type &key) {
+        return remove_key(key);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::remove_key(const K &key) {
+        hash_code code = m_hash(key);
+        link_type *link = &bucket(bucket_of(code));
+        for (node_type *cur = node_at(*link); cur; cur = node_at(*link)) {
+            if (matches(cur, key, code)) {
+                *link = cur->next;
+                destroy_node(cur);
                 --m_num_elements;
-                m_buckets[i] = nullptr;
                 return true;
             }
+            link = &cur->next;
         }
         return false;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::iterator
-    ChainHashMap<Key, Value, Hasher, Equals>::at(const key_type &key) {
-        size_type i = hash(key);
-        node_type *cur = m_buckets[i];
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::at(const key_type &key) {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
-        if (!cur) {
-            return end();
-        }
-        return iterator(cur, this);
+        return iterator(cur, this, i);
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::const_iterator
-    ChainHashMap<Key, Value, Hasher, Equals>::at(const key_type &key) const {
-        size_type i = hash(key);
-        node_type *cur = m_buckets[i];
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::const_iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::at(const key_type &key) const {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
-        if (!cur) {
-            return end();
-        }
-        return const_iterator(cur, this);
+        return const_iterator(cur, this, i);
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    bool ChainHashMap<Key, Value, Hasher, Equals>::contains(const key_type &key) const {
-        size_type i = hash(key);
-        node_type *cur = m_buckets[i];
-        if (!cur) {
-            return false;
-        }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
-        return cur != nullptr;
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::contains(const key_type &key) const {
+        hash_code code = m_hash(key);
+        return find_node(key, code, bucket_of(code)) != nullptr;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::val_type &
-    ChainHashMap<Key, Value, Hasher, Equals>::operator[](const key_type &key) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::val_type &
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::operator[](const key_type &key) {
         ensure_capacity();
-        size_type i = hash(key);
-        node_type *first = m_buckets[i];
-        node_type *cur = first;
-        if (!cur) {
-            node_type *ele = static_cast<node_type *>(m_node_allocator.Allocate());
-            ++m_num_elements;
-            ele->m_key = key;
-            ele->m_val = val_type();
-            ele->next = nullptr;
-            m_buckets[i] = ele;
-            return ele->m_val;
-        }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (cur) {
-            return cur->m_val;
+            return cur->value();
         }
-        cur = static_cast<node_type *>(m_node_allocator.Allocate());
+        cur = create_node(key);
+        // there is no element to return if the node allocator runs out,
+        // which only allocator and arena nodes do; insert reports it instead
+        assert(cur);
         ++m_num_elements;
-        cur->m_key = key;
-        cur->m_val = val_type();
-        cur->next = nullptr;
-        cur->next = first;
-        m_buckets[i] = cur;
-        return cur->m_val;
+        cur->set_hash(code);
+        cur->next = bucket(i);
+        bucket(i) = link_of(cur);
+        return cur->value();
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::iterator
-    ChainHashMap<Key, Value, Hasher, Equals>::find(const key_type &key) {
-        size_type i = hash(key);
-        node_type *cur = m_buckets[i];
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::find(const key_type &key) {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
+        return iterator(cur, this, i);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::const_iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::find(const key_type &key) const {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        return iterator(cur, this);
+        return const_iterator(cur, this, i);
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    typename ChainHashMap<Key, Value, Hasher, Equals>::const_iterator
-    ChainHashMap<Key, Value, Hasher, Equals>::find(const key_type &key) const {
-        size_type i = hash(key);
-        node_type *cur = m_buckets[i];
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::size_type
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::probe_length(const key_type &key) const {
+        hash_code code = m_hash(key);
+        node_type *cur = node_at(bucket(bucket_of(code)));
+        size_type length = 1;
+        while (cur && !matches(cur, key, code)) {
+            cur = node_at(cur->next);
+            ++length;
+        }
+        return length;
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::erase(const K &key) {
+        return remove_key(key);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::at(const K &key) {
+        return find(key);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::const_iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::at(const K &key) const {
+        return find(key);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    bool ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::contains(const K &key) const {
+        hash_code code = m_hash(key);
+        return find_node(key, code, bucket_of(code)) != nullptr;
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::find(const K &key) {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        while (cur && !m_equal(key, cur->m_key)) {
-            cur = cur->next;
-        }
+        return iterator(cur, this, i);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class K, class>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::const_iterator
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::find(const K &key) const {
+        hash_code code = m_hash(key);
+        size_type i = bucket_of(code);
+        node_type *cur = find_node(key, code, i);
         if (!cur) {
             return end();
         }
-        return const_iterator(cur, this);
+        return const_iterator(cur, this, i);
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::size_type
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::capacity_for(size_type n) const {
+        if (n == 0) {
+            return 1;
+        }
+        wide_size_type capacity = static_cast<wide_size_type>(n - 1) * 100 / (m_max_load ? m_max_load : 1) + 1;
+        if (capacity > max_size_type) {
+            capacity = max_size_type;
+        }
+        return Index::capacity(static_cast<size_type>(capacity));
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::rehash(size_type n) {
+        size_type needed = capacity_for(m_num_elements);
+        rehash_to(Index::capacity(n > needed ? n : needed));
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::reserve(size_type n) {
+        size_type needed = capacity_for(n);
+        if (needed > m_capacity) {
+            rehash_to(needed);
+        }
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    ChainHashMap<Key, Value, Hasher, Equals>::~ChainHashMap() {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class InputIt, class>
+    void ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::insert(InputIt first, InputIt last) {
+        size_type n = 0;
+        for (InputIt it = first; it != last; ++it) {
+            ++n;
+        }
+        reserve(static_cast<size_type>(m_num_elements + n));
+        for (; first != last; ++first) {
+            insert((*first).first(), (*first).second());
+        }
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    template<class Predicate>
+    typename ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::size_type
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::erase_if(Predicate pred) {
+        size_type num_erased = 0;
+        for (size_type i = 0; i < num_buckets(); ++i) {
+            link_type *link = &bucket(i);
+            while (*link) {
+                node_type *cur = node_at(*link);
+                if (pred(cur->m_key, cur->value())) {
+                    *link = cur->next;
+                    destroy_node(cur);
+                    ++num_erased;
+                } else {
+                    link = &cur->next;
+                }
+            }
+        }
+        m_num_elements = static_cast<size_type>(m_num_elements - num_erased);
+        return num_erased;
+    }
+
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    ChainHashMap<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::~ChainHashMap() {
         if (!m_buckets) {
             return;
         }
-        for (size_type i = 0; i < m_capacity; ++i) {
-            node_type *cur = m_buckets[i];
-            if (cur) {
-                while (cur) {
-                    node_type *next = cur->next;
-                    m_node_allocator.Deallocate(cur);
-                    cur = next;
-                }
+        for (size_type i = 0; i < num_buckets(); ++i) {
+            node_type *cur = node_at(bucket(i));
+            while (cur) {
+                node_type *next = node_at(cur->next);
+                destroy_node(cur);
+                cur = next;
             }
         }
         memory_free(m_buckets);
+        memory_free(m_old_buckets);
         m_buckets = nullptr;
+        m_old_buckets = nullptr;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    ChainHashMap<Key, Val, Hasher, Equals> &
-    ChainHashMap<Key, Val, Hasher, Equals>::operator=(ChainHashMap<Key, Val, Hasher, Equals> &&map) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> &
+    ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout>::operator=(ChainHashMap<Key, Val, Hasher, Equals, Index, Cache, Resize, Layout> &&map) {
         clear();
         memory_free(m_buckets);
-        m_node_allocator = move(map.m_node_allocator);
+        m_nodes = move(map.m_nodes);
         m_num_elements = move(map.m_num_elements);
         m_capacity = move(map.m_capacity);
+        m_old_capacity = move(map.m_old_capacity);
+        m_num_split = move(map.m_num_split);
+        m_split_step = move(map.m_split_step);
         m_max_load = move(map.m_max_load);
         m_buckets = move(map.m_buckets);
+        m_old_buckets = move(map.m_old_buckets);
         map.m_num_elements = 0;
         map.m_capacity = 0;
+        map.m_old_capacity = 0;
         map.m_buckets = nullptr;
+        map.m_old_buckets = nullptr;
         return *this;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    ChainHashMapIterator<Key, Value, Hasher, Equals> &
-    ChainHashMapIterator<Key, Value, Hasher, Equals>::operator++() {
-        const node_type *old = m_current;
-        m_current = m_current->next;
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    ChainHashMapIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout> &
+    ChainHashMapIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::operator++() {
+        m_current = m_hash_map->node_at(m_current->next);
         if (!m_current) {
-            size_type i = m_hash_map->hash(old->m_key);
-            while (++i < m_hash_map->m_capacity && !m_hash_map->m_buckets[i]);
-            if (i == m_hash_map->m_capacity) {
+            size_type i = m_index;
+            while (++i < m_hash_map->num_buckets() && !m_hash_map->bucket(i));
+            if (i >= m_hash_map->num_buckets()) {
                 m_current = nullptr;
             } else {
-                m_current = m_hash_map->m_buckets[i];
+                m_current = m_hash_map->node_at(m_hash_map->bucket(i));
+                m_index = i;
             }
         }
         return *this;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    inline ChainHashMapIterator<Key, Value, Hasher, Equals>
-    ChainHashMapIterator<Key, Value, Hasher, Equals>::operator++(int) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    inline ChainHashMapIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>
+    ChainHashMapIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::operator++(int) {
         iterator tmp = *this;
         ++*this;
         return tmp;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    ChainHashMapConstIterator<Key, Value, Hasher, Equals> &
-    ChainHashMapConstIterator<Key, Value, Hasher, Equals>::operator++() {
-        const node_type *old = m_current;
-        m_current = m_current->next;
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    ChainHashMapConstIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout> &
+    ChainHashMapConstIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::operator++() {
+        m_current = m_hash_map->node_at(m_current->next);
         if (!m_current) {
-            size_type i = m_hash_map->hash(old->m_key);
-            while (++i < m_hash_map->m_capacity && !m_hash_map->m_buckets[i]);
-            if (i == m_hash_map->m_capacity) {
+            size_type i = m_index;
+            while (++i < m_hash_map->num_buckets() && !m_hash_map->bucket(i));
+            if (i >= m_hash_map->num_buckets()) {
                 m_current = nullptr;
             } else {
-                m_current = m_hash_map->m_buckets[i];
+                m_current = m_hash_map->node_at(m_hash_map->bucket(i));
+                m_index = i;
             }
         }
         return *this;
     }
 
-    template<class Key, class Value, class Hasher, class Equals>
-    inline ChainHashMapConstIterator<Key, Value, Hasher, Equals>
-    ChainHashMapConstIterator<Key, Value, Hasher, Equals>::operator++(int) {
+    template<class Key, class Value, class Hasher, class Equals, class Index, class Cache, class Resize, class Layout>
+    inline ChainHashMapConstIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>
+    ChainHashMapConstIterator<Key, Value, Hasher, Equals, Index, Cache, Resize, Layout>::operator++(int) {
         const_iterator tmp = *this;
         ++*this;
         return tmp;
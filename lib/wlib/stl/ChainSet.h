@@ -3,7 +3,8 @@
  * @brief Hash set implementation.
  *
  * Set implementation using a separately chained
- * hash map as the backing structure.
+ * hash map as the backing structure. The nodes
+ * of the backing map store each element once.
  *
  * @author Jeff Niu
  * @date November 4, 2017
@@ -22,22 +23,24 @@ namespace wlp {
     /**
      * Hash set implementation using separate chaining. This implementation
      * supports removal operations, unlike the open addressed set.
+     * Iterators give constant access to the elements, since changing
+     * an element in place would leave it in the bucket of its old hash.
      * @tparam Key   the element type
      * @tparam Hash  the hash function
      * @tparam Equal the equality function
      */
     template<class Key,
-            class Hash = Hash<Key, uint16_t>,
+            class Hash = Hash<Key, size_type>,
             class Equal = Equal<Key>>
     class ChainHashSet {
     public:
         typedef ChainHashSet<Key, Hash, Equal> set_type;
-        typedef ChainHashMap<Key, Key, Hash, Equal> map_type;
-        typedef ChainHashMapIterator<Key, Key, Hash, Equal> iterator;
-        typedef ChainHashMapConstIterator<Key, Key, Hash, Equal> const_iterator;
-        typedef map_type::size_type size_type;
-        typedef map_type::percent_type percent_type;
-        typedef map_type::key_type key_type;
+        typedef ChainHashMap<Key, SetValue<Key>, Hash, Equal> map_type;
+        typedef ChainHashMapIterator<Key, SetValue<Key>, Hash, Equal> iterator;
+        typedef ChainHashMapConstIterator<Key, SetValue<Key>, Hash, Equal> const_iterator;
+        typedef typename map_type::size_type size_type;
+        typedef typename map_type::percent_type percent_type;
+        typedef typename map_type::key_type key_type;
 
     private:
         map_type m_hash_map;
@@ -164,7 +167,7 @@ namespace wlp {
          * @return a pair of an iterator and boolean
          */
         Pair<iterator, bool> insert(key_type key) {
-            return m_hash_map.insert(key, key);
+            return m_hash_map.try_emplace(move(key), SetValue<Key>());
         };
 
         /**
@@ -0,0 +1,442 @@
+/**
+ * @file ConcurrentMap.h
+ * @brief Hash map shared between threads using lock striping.
+ *
+ * The concurrent hash map splits its elements over a fixed number of
+ * shards, each a @code ChainHashMap @endcode guarded by its own reader
+ * writer spin lock. A key always lives in the shard selected by the high
+ * bits of its hash, so operations on keys of different shards never
+ * contend, and lookups in the same shard only share the lock in read
+ * mode. Inserts and erases lock a single shard for writing.
+ *
+ * Because other threads may modify a shard as soon as its lock is
+ * released, the map hands out copies of values instead of iterators or
+ * references. Values are read with @code find @endcode, changed in
+ * place with @code update @endcode, or visited with @code for_each @endcode.
+ *
+ * The bucket arrays of the shards come from @code memory_alloc @endcode,
+ * which is not thread safe. A shard that is about to grow therefore also
+ * takes a lock shared by every concurrent map for the duration of the
+ * insertion. Other code calling @code memory_alloc @endcode concurrently
+ * with such an insertion must be serialized by the caller. Nodes come
+ * from the allocator of each shard, which is only used under the shard
+ * lock.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_CONCURRENTMAP_H
+#define EMBEDDEDCPLUSPLUS_CONCURRENTMAP_H
+
+#if defined(__unix__)
+#include <sched.h>
+#endif
+
+#include "ChainMap.h"
+
+namespace wlp {
+
+    /**
+     * Spin for a while, then give the processor to another thread
+     * where the platform allows it, since the thread being waited for
+     * may be waiting for the same processor.
+     * @param spins the number of times the caller has spun
+     */
+    inline void spin_back_off(uint16_t &spins) {
+        if (++spins < 64) {
+            return;
+        }
+        spins = 0;
+#if defined(__unix__)
+        sched_yield();
+#endif
+    }
+
+    /**
+     * Reader writer spin lock. Any number of readers may hold the lock
+     * together, or a single writer. A waiting writer sets a pending bit
+     * that holds off new readers, so that writers are not starved by a
+     * steady stream of lookups.
+     */
+    class ReadWriteSpinLock {
+    public:
+        enum : uint32_t {
+            WRITER = 1u,    /**< set while a writer holds the lock */
+            PENDING = 2u,   /**< set while a writer waits for readers to leave */
+            READER = 4u     /**< the count of readers is kept above the flag bits */
+        };
+
+        ReadWriteSpinLock() : m_state(0) {}
+
+        ReadWriteSpinLock(const ReadWriteSpinLock &) = delete;
+
+        /**
+         * Acquire the lock for reading.
+         */
+        void lock_read() {
+            uint16_t spins = 0;
+            while (true) {
+                uint32_t state = __atomic_load_n(&m_state, __ATOMIC_RELAXED);
+                if (!(state & (WRITER | PENDING)) &&
+                    __atomic_compare_exchange_n(&m_state, &state, state + READER, true,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                    return;
+                }
+                spin_back_off(spins);
+            }
+        }
+
+        /**
+         * Release the lock held for reading.
+         */
+        void unlock_read() {
+            __atomic_sub_fetch(&m_state, READER, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Acquire the lock for writing.
+         */
+        void lock_write() {
+            uint16_t spins = 0;
+            while (true) {
+                uint32_t state = __atomic_load_n(&m_state, __ATOMIC_RELAXED);
+                if (!(state & ~static_cast<uint32_t>(PENDING))) {
+                    // clears the pending bit, other waiting writers set it again
+                    if (__atomic_compare_exchange_n(&m_state, &state, static_cast<uint32_t>(WRITER), true,
+                                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                        return;
+                    }
+                } else if (!(state & PENDING)) {
+                    __atomic_or_fetch(&m_state, PENDING, __ATOMIC_RELAXED);
+                }
+                spin_back_off(spins);
+            }
+        }
+
+        /**
+         * Release the lock held for writing.
+         */
+        void unlock_write() {
+            __atomic_and_fetch(&m_state, ~static_cast<uint32_t>(WRITER), __ATOMIC_RELEASE);
+        }
+
+        ReadWriteSpinLock &operator=(const ReadWriteSpinLock &) = delete;
+
+    private:
+        uint32_t m_state;
+    };
+
+    /**
+     * @return the lock serializing shard growth, shared by every
+     * concurrent hash map because @code memory_alloc @endcode is global
+     */
+    inline ReadWriteSpinLock &concurrent_map_memory_lock() {
+        static ReadWriteSpinLock lock;
+        return lock;
+    }
+
+    /**
+     * Hash map safe to use from several threads at once, implemented
+     * as a fixed number of chained hash maps each behind its own lock.
+     * @tparam Key     key type
+     * @tparam Val     value type
+     * @tparam Hasher  hash function
+     * @tparam Equals  key equality function
+     * @tparam tShards number of shards, a power of two up to 256
+     */
+    template<class Key,
+            class Val,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>,
+            uint16_t tShards = 16>
+    class ConcurrentHashMap {
+    public:
+        typedef ConcurrentHashMap<Key, Val, Hasher, Equals, tShards> map_type;
+        typedef ChainHashMap<Key, Val, Hasher, Equals> shard_map_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+        typedef uint8_t percent_type;
+
+        static_assert(tShards > 0 && tShards <= 256 && !(tShards & (tShards - 1)),
+                      "ConcurrentHashMap shard count must be a power of two up to 256");
+
+    private:
+        /**
+         * A chained hash map and its lock, padded to a cache line so that
+         * locking one shard does not invalidate the line of another.
+         */
+        struct alignas(64) Shard {
+            mutable ReadWriteSpinLock m_lock;
+            shard_map_type m_map;
+        };
+
+        /**
+         * Class hash function instance. Used to select
+         * the shard of a key.
+         */
+        Hasher m_hash;
+
+        Shard m_shards[tShards];
+
+        /**
+         * Select the shard of a key from the high bits of a
+         * multiplicative mix of its hash, leaving the low bits,
+         * which the shard maps index with, independent of the shard.
+         * @param key the key to hash
+         * @return the shard holding the key
+         */
+        Shard &shard(const key_type &key) {
+            return m_shards[(static_cast<uint32_t>(m_hash(key)) * 2654435769u) >> 24 & (tShards - 1u)];
+        }
+
+        /**
+         * @see ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::shard()
+         */
+        const Shard &shard(const key_type &key) const {
+            return m_shards[(static_cast<uint32_t>(m_hash(key)) * 2654435769u) >> 24 & (tShards - 1u)];
+        }
+
+        /**
+         * A chained hash map grows, allocating a new bucket array, when an
+         * element is inserted while the load is at its maximum.
+         * @param map a shard map
+         * @return true if inserting into the map may allocate a bucket array
+         */
+        static bool may_grow(const shard_map_type &map) {
+            return static_cast<wide_size_type>(map.size()) * 100 >=
+                   static_cast<wide_size_type>(map.max_load()) * map.capacity();
+        }
+
+        /**
+         * Run a write to a shard under its lock, also holding the memory
+         * lock if the shard may grow.
+         * @param s        the shard to write
+         * @param function the write, called with the shard map
+         * @return the result of the write
+         */
+        template<class Function>
+        static auto write(Shard &s, Function function) -> decltype(function(s.m_map)) {
+            s.m_lock.lock_write();
+            bool grow = may_grow(s.m_map);
+            if (grow) {
+                concurrent_map_memory_lock().lock_write();
+            }
+            auto result = function(s.m_map);
+            if (grow) {
+                concurrent_map_memory_lock().unlock_write();
+            }
+            s.m_lock.unlock_write();
+            return result;
+        }
+
+    public:
+        /**
+         * Create an empty concurrent hash map. Shards are allocated here,
+         * so the map must be constructed before other threads use it.
+         *
+         * @param n        initial number of buckets, spread over the shards
+         * @param max_load an integer value denoting the max percent load factor, e.g. 75 = 0.75
+         */
+        explicit ConcurrentHashMap(
+                size_type n = 12 * tShards,
+                percent_type max_load = 75)
+                : m_hash(Hasher()) {
+            size_type per_shard = static_cast<size_type>((n + tShards - 1u) / tShards);
+            for (Shard &s : m_shards) {
+                s.m_map = shard_map_type(per_shard ? per_shard : static_cast<size_type>(1), max_load);
+            }
+        }
+
+        ConcurrentHashMap(const map_type &) = delete;
+
+        /**
+         * @return the number of shards
+         */
+        static constexpr uint16_t num_shards() {
+            return tShards;
+        }
+
+        /**
+         * Count the elements of every shard. Shards are counted one after
+         * another, so the count may be stale if other threads insert or
+         * erase at the same time.
+         * @return the number of elements
+         */
+        size_type size() const;
+
+        /**
+         * @see ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::size()
+         * @return true if the map holds no elements
+         */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * Erase all elements, one shard at a time.
+         */
+        void clear();
+
+        /**
+         * Attempt to insert an element into the map.
+         * Insertion is prevented if there already exists
+         * an element with the provided key.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return true if the element was inserted
+         */
+        bool insert(const key_type &key, const val_type &val);
+
+        /**
+         * Insert an element, or assign the value of the element
+         * with the provided key if there is one.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return true if the element was inserted rather than assigned
+         */
+        bool insert_or_assign(const key_type &key, const val_type &val);
+
+        /**
+         * Change the value of an element in place while its shard is
+         * locked for writing.
+         * @param key      the key of the element
+         * @param function called with a reference to the value
+         * @return true if the key was found and the value updated
+         */
+        template<class Function>
+        bool update(const key_type &key, Function function);
+
+        /**
+         * Erase the element with the provided key, if such an element exists.
+         * @param key the key whose corresponding element to erase
+         * @return true if an element was erased
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Copy the value mapped by a key.
+         * @param key the key to find
+         * @param val assigned the mapped value if the key is found
+         * @return true if the key maps to a value
+         */
+        bool find(const key_type &key, val_type &val) const;
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        bool contains(const key_type &key) const;
+
+        /**
+         * Visit every element, one shard at a time, each shard locked
+         * for reading while it is visited. The function must not call
+         * back into the map.
+         * @param function called with the key and the value of each element
+         */
+        template<class Function>
+        void for_each(Function function) const;
+
+        map_type &operator=(const map_type &) = delete;
+    };
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    typename ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::size_type
+    ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::size() const {
+        size_type n = 0;
+        for (const Shard &s : m_shards) {
+            s.m_lock.lock_read();
+            n = static_cast<size_type>(n + s.m_map.size());
+            s.m_lock.unlock_read();
+        }
+        return n;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    void ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::clear() {
+        for (Shard &s : m_shards) {
+            s.m_lock.lock_write();
+            s.m_map.clear();
+            s.m_lock.unlock_write();
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::insert(const key_type &key, const val_type &val) {
+        return write(shard(key), [&](shard_map_type &map) {
+            return map.insert(key, val).second();
+        });
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::insert_or_assign(
+            const key_type &key, const val_type &val) {
+        return write(shard(key), [&](shard_map_type &map) {
+            return map.insert_or_assign(key, val).second();
+        });
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    template<class Function>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::update(const key_type &key, Function function) {
+        Shard &s = shard(key);
+        s.m_lock.lock_write();
+        typename shard_map_type::iterator it = s.m_map.find(key);
+        bool found = it != s.m_map.end();
+        if (found) {
+            function(*it);
+        }
+        s.m_lock.unlock_write();
+        return found;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::erase(const key_type &key) {
+        Shard &s = shard(key);
+        // the chained map erases by mutable key
+        key_type erased_key(key);
+        s.m_lock.lock_write();
+        bool erased = s.m_map.erase(erased_key);
+        s.m_lock.unlock_write();
+        return erased;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::find(const key_type &key, val_type &val) const {
+        const Shard &s = shard(key);
+        s.m_lock.lock_read();
+        typename shard_map_type::const_iterator it = s.m_map.find(key);
+        bool found = it != s.m_map.end();
+        if (found) {
+            val = *it;
+        }
+        s.m_lock.unlock_read();
+        return found;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    bool ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::contains(const key_type &key) const {
+        const Shard &s = shard(key);
+        s.m_lock.lock_read();
+        bool found = s.m_map.contains(key);
+        s.m_lock.unlock_read();
+        return found;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tShards>
+    template<class Function>
+    void ConcurrentHashMap<Key, Val, Hasher, Equals, tShards>::for_each(Function function) const {
+        for (const Shard &s : m_shards) {
+            s.m_lock.lock_read();
+            for (typename shard_map_type::const_iterator it = s.m_map.begin(); it != s.m_map.end(); ++it) {
+                function(it.key(), *it);
+            }
+            s.m_lock.unlock_read();
+        }
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_CONCURRENTMAP_H
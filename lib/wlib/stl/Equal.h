@@ -14,6 +14,9 @@
 
 #include "../strings/StaticString.h"
 
+#include "Tmp.h"
+#include "Tuple.h"
+
 namespace wlp {
 
     /**
@@ -23,17 +26,17 @@ namespace wlp {
      */
     template<class Key>
     struct Equal {
-        bool operator()(const Key &key1, const Key &key2) const {
+        constexpr bool operator()(const Key &key1, const Key &key2) const {
             return key1 == key2;
         }
     };
 
-    template<uint16_t tSize>
-    inline bool static_string_equals(const StaticString<tSize> &str1, const StaticString<tSize> &str2) {
+    template<uint16_t tSize1, uint16_t tSize2>
+    inline bool static_string_equals(const StaticString<tSize1> &str1, const StaticString<tSize2> &str2) {
         if (str1.length() != str2.length()) {
             return false;
         }
-        for (size_type i = 0; i < str1.length(); ++i) {
+        for (uint16_t i = 0; i < str1.length(); ++i) {
             if (str1[i] != str2[i]) {
                 return false;
             }
@@ -41,7 +44,18 @@ namespace wlp {
         return true;
     }
 
-    inline bool string_equals(const char *&str1, const char *&str2) {
+    template<uint16_t tSize>
+    inline bool static_string_equals(const StaticString<tSize> &str1, const char *str2) {
+        uint16_t i = 0;
+        for (; i < str1.length() && str2[i]; ++i) {
+            if (str1[i] != str2[i]) {
+                return false;
+            }
+        }
+        return i == str1.length() && !str2[i];
+    }
+
+    constexpr bool string_equals(const char *&str1, const char *&str2) {
         for (; *str1 && *str2; ++str1, ++str2) {
             if (*str1 != *str2) {
                 return false;
@@ -50,11 +64,32 @@ namespace wlp {
         return *str1 == *str2;
     }
 
+    /**
+     * Static strings compare equal to character strings and static
+     * strings of any capacity with the same contents. Together with
+     * @code Hash<StaticString<tSize>, IntType> @endcode this allows
+     * lookups in maps keyed by static strings without a temporary key.
+     */
     template<uint16_t tSize>
     struct Equal<StaticString<tSize>> {
+        typedef true_type is_transparent;
+
         bool operator()(const StaticString<tSize> &key1, const StaticString<tSize> &key2) const {
             return static_string_equals(key1, key2);
         }
+
+        template<uint16_t tOther>
+        bool operator()(const StaticString<tOther> &key1, const StaticString<tSize> &key2) const {
+            return static_string_equals(key1, key2);
+        }
+
+        bool operator()(const char *key1, const StaticString<tSize> &key2) const {
+            return static_string_equals(key2, key1);
+        }
+
+        bool operator()(const StaticString<tSize> &key1, const char *key2) const {
+            return static_string_equals(key1, key2);
+        }
     };
 
     template<uint16_t tSize>
@@ -66,18 +101,46 @@ namespace wlp {
 
     template<>
     struct Equal<char *> {
-        bool operator()(const char *key1, const char *key2) const {
+        constexpr bool operator()(const char *key1, const char *key2) const {
             return string_equals(key1, key2);
         }
     };
 
     template<>
     struct Equal<const char *> {
-        bool operator()(const char *key1, const char *key2) const {
+        constexpr bool operator()(const char *key1, const char *key2) const {
             return string_equals(key1, key2);
         }
     };
 
+    /**
+     * Compare the elements of two tuples in order.
+     * @tparam Indices the indices of the elements
+     * @return true if every element compares equal
+     */
+    template<class... Types, size_type... Indices>
+    inline bool tuple_equals(const Tuple<Types...> &tuple1, const Tuple<Types...> &tuple2,
+                             IndexSequence<Indices...>) {
+        const bool equal[] = {Equal<Types>()(get<Indices>(tuple1), get<Indices>(tuple2))...};
+        for (bool element_equal : equal) {
+            if (!element_equal) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Tuples compare element-wise so that they can be used as
+     * keys together with the tuple hash functions.
+     */
+    template<class... Types>
+    struct Equal<Tuple<Types...>> {
+        bool operator()(const Tuple<Types...> &key1, const Tuple<Types...> &key2) const {
+            return tuple_equals(key1, key2, typename MakeIndexSequence<sizeof...(Types)>::type());
+        }
+    };
+
 }
 
 #endif //CORE_STL_EQUAL_H
@@ -0,0 +1,905 @@
+/**
+ * @file FlatMap.h
+ * @brief Flat open addressing hash map implementation.
+ *
+ * The flat hash map stores key and value slots inline in its
+ * backing array instead of pointers to separately allocated
+ * nodes, so that a probe walks contiguous memory. Next to the
+ * slots a compact array holds one control byte per slot: zero
+ * for an empty slot, or the high bit set together with a seven
+ * bit tag derived from the key's hash for a full slot. Most probes of other
+ * keys are rejected on the control byte without touching the slot.
+ *
+ * Collisions are resolved with linear probing, and erasure uses
+ * backward shift deletion so that no tombstones are needed.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_FLATMAP_H
+#define EMBEDDEDCPLUSPLUS_FLATMAP_H
+
+#include <assert.h>
+
+#include "Utility.h"
+#include "Equal.h"
+#include "Hash.h"
+#include "Pair.h"
+#include "OpenMap.h"
+
+#include "../memory/Memory.h"
+
+namespace wlp {
+
+    // Forward declaration of FlatHashMap
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    class FlatHashMap;
+
+    // Forward declaration of FlatHashMap iterator
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct FlatHashMapIterator;
+
+    // Forward declaration of const FlatHashMap iterator
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct FlatHashMapConstIterator;
+
+    /**
+     * Control byte values of the flat hash map.
+     */
+    struct FlatHashMapControl {
+        enum : uint8_t {
+            EMPTY = 0x00,   /**< control byte of an empty slot */
+            FULL = 0x80     /**< bit set in the control byte of every full slot */
+        };
+
+        /**
+         * The low bits of the hash select the home slot, so the tag is
+         * taken from the top of a multiplicative mix of the whole hash
+         * to stay independent of the slot index.
+         * @param hash the full hash of a key
+         * @return the control byte of a slot holding the key
+         */
+        template<class IntType>
+        static inline uint8_t tag(IntType hash) {
+            return static_cast<uint8_t>(FULL | ((static_cast<uint32_t>(hash) * 2654435769u) >> 25));
+        }
+    };
+
+    /**
+     * Iterator over the elements of a FlatHashMap. The iterator
+     * walks the backing array from start to end, skipping
+     * empty slots, and returns past-the-end afterwards.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct FlatHashMapIterator {
+        typedef FlatHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef FlatHashMapIterator<Key, Val, Hasher, Equals> iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        /**
+         * Pointer to the slot referenced by this iterator.
+         */
+        node_type *m_current;
+        /**
+         * Pointer to the iterated FlatHashMap.
+         */
+        map_type *m_hash_map;
+
+        FlatHashMapIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        FlatHashMapIterator(node_type *node, map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        FlatHashMapIterator(const iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        FlatHashMapIterator(iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        const key_type &key() const {
+            return m_current->m_key;
+        }
+
+        val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        val_type *operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Increment the iterator to the next full slot. The slot
+         * index is recovered from the slot address so no probing
+         * or hashing is needed.
+         * @return this iterator
+         */
+        iterator &operator++();
+
+        iterator operator++(int);
+
+        bool operator==(const iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        iterator &operator=(const iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        iterator &operator=(iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Constant iterator over a FlatHashMap.
+     *
+     * @see FlatHashMapIterator
+     *
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct FlatHashMapConstIterator {
+        typedef FlatHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef FlatHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        const node_type *m_current;
+        const map_type *m_hash_map;
+
+        FlatHashMapConstIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        FlatHashMapConstIterator(const node_type *node, const map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        FlatHashMapConstIterator(const const_iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        FlatHashMapConstIterator(const_iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        const key_type &key() const {
+            return m_current->m_key;
+        }
+
+        const val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        const val_type *operator->() const {
+            return &(operator*());
+        }
+
+        const_iterator &operator++();
+
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        const_iterator &operator=(const const_iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        const_iterator &operator=(const_iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Hash map implemented using open addressing and linear probing
+     * over an array of inline slots, in the spirit of std::unordered_map.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>>
+    class FlatHashMap {
+    public:
+        typedef FlatHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef FlatHashMapIterator<Key, Val, Hasher, Equals> iterator;
+        typedef FlatHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+        typedef uint8_t percent_type;
+
+        friend struct FlatHashMapIterator<Key, Val, Hasher, Equals>;
+        friend struct FlatHashMapConstIterator<Key, Val, Hasher, Equals>;
+
+    private:
+        /**
+         * Class hash function instance. Used to hash
+         * element keys.
+         */
+        Hasher m_hash;
+        /**
+         * Class key equality function. Used to test
+         * equality of element keys.
+         */
+        Equals m_equal;
+
+        /**
+         * Control bytes, one per slot.
+         */
+        uint8_t *m_ctrl;
+        /**
+         * Backing array of inline slots.
+         */
+        node_type *m_slots;
+
+        /**
+         * The current number of elements that have been inserted
+         * into the map.
+         */
+        size_type m_num_elements;
+        /**
+         * The size of the backing array.
+         */
+        size_type m_capacity;
+        /**
+         * The load factor in integer percent
+         * before rehashing occurs. This number
+         * cannot be larger than 100.
+         */
+        percent_type m_max_load;
+
+    public:
+        /**
+         * Create and initialize an empty flat hash map. Slots and
+         * control bytes are allocated with @code memory_alloc @endcode.
+         *
+         * @pre the initial slots fit the size type in bytes
+         *
+         * @param n        initial number of slots
+         * @param max_load an integer value denoting the max percent load factory, e.g. 75 = 0.75
+         */
+        explicit FlatHashMap(
+                size_type n = 12,
+                percent_type max_load = 75)
+                : m_hash(Hasher()),
+                  m_equal(Equals()),
+                  m_ctrl(nullptr),
+                  m_slots(nullptr),
+                  m_num_elements(0),
+                  m_capacity(n),
+                  m_max_load(max_load) {
+            bool allocated = init_slots(n);
+            assert(allocated);
+            (void) allocated;
+            if (max_load > 100) {
+                m_max_load = 100;
+            }
+        }
+
+        FlatHashMap(const map_type &) = delete;
+
+        /**
+         * Move constructor transfers resources from
+         * rvalue hash map into this hash map.
+         * @param map map from which to transfer
+         */
+        FlatHashMap(map_type &&map) :
+                m_hash(move(map.m_hash)),
+                m_equal(move(map.m_equal)),
+                m_ctrl(move(map.m_ctrl)),
+                m_slots(move(map.m_slots)),
+                m_num_elements(move(map.m_num_elements)),
+                m_capacity(move(map.m_capacity)),
+                m_max_load(move(map.m_max_load)) {
+            map.m_num_elements = 0;
+            map.m_capacity = 0;
+            map.m_ctrl = nullptr;
+            map.m_slots = nullptr;
+        }
+
+        /**
+         * Destroy the hash map, freeing the backing arrays.
+         */
+        ~FlatHashMap();
+
+    private:
+        /**
+         * Allocate empty control bytes and slots, keeping the
+         * current ones if either allocation fails.
+         * @param n the number of slots
+         * @return false if the arrays do not fit the size type in
+         * bytes or memory ran out
+         */
+        bool init_slots(size_type n);
+
+        /**
+         * Obtain the home slot of a key in the backing array.
+         * @param key the key to hash
+         * @return an index i such that 0 <= i < m_capacity
+         */
+        size_type hash(const key_type &key) const {
+            return static_cast<size_type>(m_hash(key) % m_capacity);
+        }
+
+        /**
+         * Find the slot holding a key, or the empty slot at
+         * which the probe for the key stops.
+         * @param key the key to find
+         * @return index of the slot
+         */
+        size_type probe(const key_type &key) const;
+
+        /**
+         * Grow and rehash the map if the current load factor
+         * exceeds or equals the maximum load factor. At least one
+         * slot is always kept empty so that probes terminate. If the
+         * size type cannot hold a doubled capacity or its arrays, or
+         * they cannot be allocated, the map keeps its capacity and
+         * fills beyond the maximum load.
+         * @return false if the map is full and cannot take another element
+         */
+        bool ensure_capacity();
+
+        /**
+         * Fill the hole left by an erased slot by shifting back
+         * elements of the following probe sequence.
+         * @param hole index of the erased slot
+         */
+        void shift_back(size_type hole);
+
+    public:
+        /**
+         * @return the current number of elements that have been
+         * inserted into the map
+         */
+        size_type size() const {
+            return m_num_elements;
+        }
+
+        /**
+         * @return the current size of the backing array
+         */
+        size_type capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @return the maximum load before before rehash
+         */
+        percent_type max_load() const {
+            return m_max_load;
+        }
+
+        /**
+         * @return true if the map is empty
+         */
+        bool empty() const {
+            return m_num_elements == 0;
+        }
+
+        /**
+         * Obtain an iterator to the first element in the hash map.
+         * Returns pass-the-end iterator if there are no elements
+         * in the hash map.
+         * @return iterator the first element
+         */
+        iterator begin() {
+            for (size_type i = 0; i < m_capacity && m_num_elements; ++i) {
+                if (m_ctrl[i]) {
+                    return iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @return a pass-the-end iterator for this map
+         */
+        iterator end() {
+            return iterator(nullptr, this);
+        }
+
+        /**
+         * @see FlatHashMap<Key, Val, Hasher, Equals>::begin()
+         * @return a constant iterator to the first element
+         */
+        const_iterator begin() const {
+            for (size_type i = 0; i < m_capacity && m_num_elements; ++i) {
+                if (m_ctrl[i]) {
+                    return const_iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @see FlatHashMap<Key, Val, Hasher, Equals>::end()
+         * @return a constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(nullptr, this);
+        }
+
+        /**
+         * Erase all elements in the map and reset
+         * the element count to zero.
+         */
+        void clear() noexcept;
+
+        /**
+         * Attempt to insert an element into the map.
+         * Insertion is prevented if there already exists
+         * an element with the provided key
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert(key_type key, val_type val);
+
+        /**
+         * Attempt to insert an element into the map.
+         * If an element with the same key already exists,
+         * override the value mapped to by the provided key.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the assigned element, and a bool
+         * indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert_or_assign(key_type key, val_type val);
+
+        /**
+         * Erase the element pointed to by the provided iterator.
+         * Elements after it in the same probe sequence are shifted
+         * back, so other iterators into that sequence are invalidated.
+         * An element shifted across the end of the backing array may
+         * be visited twice by an iteration that erases as it goes.
+         * @param pos iterator pointing to the element to erase
+         * @return iterator to the next element in the map or end
+         */
+        iterator &erase(iterator &pos);
+
+        /**
+         * Erase the element from the map with the provided key, if such
+         * an element exists. No memory is allocated or freed.
+         * @param key the key whose corresponding element to erase
+         * @return true if an element was erased
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Returns the value corresponding to a provided key.
+         * @param key the key for which to find the value
+         * @return iterator to the value or pass-the-end
+         */
+        iterator at(const key_type &key);
+
+        /**
+         * @see FlatHashMap<Key, Val, Hasher, Equals>::at()
+         * @param key key for which to find the value
+         * @return const iterator to the value or pass-the-end
+         */
+        const_iterator at(const key_type &key) const;
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        bool contains(const key_type &key) const;
+
+        /**
+         * Return an iterator to the map element corresponding
+         * to the provided key, or pass-the-end if the key does
+         * not map to any value in the map.
+         * @param key the key to map
+         * @return an iterator to the element mapped by the key
+         */
+        iterator find(const key_type &key);
+
+        /**
+         * @see FlatHashMap<Key, Val, Hasher, Equals>::find()
+         * @param key the key to map
+         * @return a const iterator to the element mapped by the key
+         */
+        const_iterator find(const key_type &key) const;
+
+        /**
+         * Access an element in the hash map by the given key.
+         * If the key does not map to any value in the map,
+         * then a new value is created and inserted using the default
+         * constructor.
+         *
+         * @pre the map is not full, which it only is if it cannot
+         * grow; use insert to detect it
+         *
+         * @param key the key whose value to access
+         * @return a reference to the mapped value
+         */
+        val_type &operator[](const key_type &key);
+
+        map_type &operator=(const map_type &) = delete;
+
+        /**
+         * Move assignment operator. Existing resources
+         * will be released.
+         * @param map map to move
+         * @return reference to this map
+         */
+        map_type &operator=(map_type &&map);
+    };
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool FlatHashMap<Key, Val, Hasher, Equals>::init_slots(size_type n) {
+        uint8_t *ctrl = memory_alloc_array<uint8_t>(n);
+        node_type *slots = memory_alloc_array<node_type>(n);
+        if (!ctrl || !slots) {
+            memory_free(ctrl);
+            memory_free(slots);
+            return false;
+        }
+        m_ctrl = ctrl;
+        m_slots = slots;
+        for (size_type i = 0; i < n; ++i) {
+            m_ctrl[i] = FlatHashMapControl::EMPTY;
+        }
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::size_type
+    FlatHashMap<Key, Val, Hasher, Equals>::probe(const key_type &key) const {
+        auto h = m_hash(key);
+        uint8_t tag = FlatHashMapControl::tag(h);
+        size_type i = static_cast<size_type>(h % m_capacity);
+        while (m_ctrl[i]) {
+            if (m_ctrl[i] == tag && m_equal(key, m_slots[i].m_key)) {
+                return i;
+            }
+            if (++i >= m_capacity) {
+                i = 0;
+            }
+        }
+        return i;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool FlatHashMap<Key, Val, Hasher, Equals>::ensure_capacity() {
+        if (static_cast<wide_size_type>(m_num_elements) * 100 < static_cast<wide_size_type>(m_max_load) * m_capacity &&
+            m_num_elements + 1 < m_capacity) {
+            return true;
+        }
+        size_type old_capacity = m_capacity;
+        uint8_t *old_ctrl = m_ctrl;
+        node_type *old_slots = m_slots;
+        size_type new_capacity = grow_capacity(m_capacity);
+        if (new_capacity == m_capacity || !init_slots(new_capacity)) {
+            // the size type cannot hold a larger table, or there is no
+            // memory for one, so the map fills beyond its maximum load
+            return m_num_elements + 1 < m_capacity;
+        }
+        m_capacity = new_capacity;
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (!old_ctrl[i]) {
+                continue;
+            }
+            size_type k = hash(old_slots[i].m_key);
+            while (m_ctrl[k]) {
+                if (++k >= m_capacity) {
+                    k = 0;
+                }
+            }
+            m_ctrl[k] = old_ctrl[i];
+            m_slots[k] = old_slots[i];
+        }
+        memory_free(old_ctrl);
+        memory_free(old_slots);
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    void FlatHashMap<Key, Val, Hasher, Equals>::shift_back(size_type hole) {
+        size_type i = hole;
+        while (true) {
+            if (++i >= m_capacity) {
+                i = 0;
+            }
+            if (!m_ctrl[i]) {
+                break;
+            }
+            size_type home = hash(m_slots[i].m_key);
+            // distances are taken along the probe direction, modulo capacity
+            size_type to_home = static_cast<size_type>(i >= home ? i - home : i + m_capacity - home);
+            size_type to_hole = static_cast<size_type>(i >= hole ? i - hole : i + m_capacity - hole);
+            if (to_home >= to_hole) {
+                m_ctrl[hole] = m_ctrl[i];
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+        m_ctrl[hole] = FlatHashMapControl::EMPTY;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    void FlatHashMap<Key, Val, Hasher, Equals>::clear() noexcept {
+        for (size_type i = 0; i < m_capacity; ++i) {
+            m_ctrl[i] = FlatHashMapControl::EMPTY;
+        }
+        m_num_elements = 0;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    Pair<typename FlatHashMap<Key, Val, Hasher, Equals>::iterator, bool>
+    FlatHashMap<Key, Val, Hasher, Equals>::insert(key_type key, val_type val) {
+        bool room = ensure_capacity();
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (!room) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        ++m_num_elements;
+        m_ctrl[i] = FlatHashMapControl::tag(m_hash(key));
+        m_slots[i].m_key = key;
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    Pair<typename FlatHashMap<Key, Val, Hasher, Equals>::iterator, bool>
+    FlatHashMap<Key, Val, Hasher, Equals>::insert_or_assign(key_type key, val_type val) {
+        bool room = ensure_capacity();
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            m_slots[i].m_val = val;
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (!room) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        ++m_num_elements;
+        m_ctrl[i] = FlatHashMapControl::tag(m_hash(key));
+        m_slots[i].m_key = key;
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::iterator &
+    FlatHashMap<Key, Val, Hasher, Equals>::erase(iterator &pos) {
+        node_type *cur = pos.m_current;
+        if (!cur || pos.m_hash_map != this || cur < m_slots || cur >= m_slots + m_capacity) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        size_type i = static_cast<size_type>(cur - m_slots);
+        if (!m_ctrl[i]) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        --m_num_elements;
+        shift_back(i);
+        if (!m_ctrl[i]) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool FlatHashMap<Key, Val, Hasher, Equals>::erase(const key_type &key) {
+        size_type i = probe(key);
+        if (!m_ctrl[i]) {
+            return false;
+        }
+        --m_num_elements;
+        shift_back(i);
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::iterator
+    FlatHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::const_iterator
+    FlatHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) const {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool FlatHashMap<Key, Val, Hasher, Equals>::contains(const key_type &key) const {
+        return m_ctrl[probe(key)] != FlatHashMapControl::EMPTY;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::iterator
+    FlatHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::const_iterator
+    FlatHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) const {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return const_iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename FlatHashMap<Key, Val, Hasher, Equals>::val_type &
+    FlatHashMap<Key, Val, Hasher, Equals>::operator[](const key_type &key) {
+        bool room = ensure_capacity();
+        size_type i = probe(key);
+        if (!m_ctrl[i]) {
+            // taking the last empty slot would leave later probes
+            // looping forever; insert reports a full map instead
+            assert(room);
+            ++m_num_elements;
+            m_ctrl[i] = FlatHashMapControl::tag(m_hash(key));
+            m_slots[i].m_key = key;
+            m_slots[i].m_val = val_type();
+        }
+        return m_slots[i].m_val;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    FlatHashMap<Key, Val, Hasher, Equals>::~FlatHashMap() {
+        if (!m_slots) {
+            return;
+        }
+        memory_free(m_ctrl);
+        memory_free(m_slots);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    FlatHashMap<Key, Val, Hasher, Equals> &
+    FlatHashMap<Key, Val, Hasher, Equals>::operator=(FlatHashMap<Key, Val, Hasher, Equals> &&map) {
+        memory_free(m_ctrl);
+        memory_free(m_slots);
+        m_capacity = move(map.m_capacity);
+        m_max_load = move(map.m_max_load);
+        m_num_elements = move(map.m_num_elements);
+        m_ctrl = move(map.m_ctrl);
+        m_slots = move(map.m_slots);
+        map.m_capacity = 0;
+        map.m_num_elements = 0;
+        map.m_ctrl = nullptr;
+        map.m_slots = nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    FlatHashMapIterator<Key, Val, Hasher, Equals> &
+    FlatHashMapIterator<Key, Val, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < m_hash_map->m_capacity && !m_hash_map->m_ctrl[i]);
+        m_current = i < m_hash_map->m_capacity ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    inline FlatHashMapIterator<Key, Val, Hasher, Equals>
+    FlatHashMapIterator<Key, Val, Hasher, Equals>::operator++(int) {
+        iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    FlatHashMapConstIterator<Key, Val, Hasher, Equals> &
+    FlatHashMapConstIterator<Key, Val, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < m_hash_map->m_capacity && !m_hash_map->m_ctrl[i]);
+        m_current = i < m_hash_map->m_capacity ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    inline FlatHashMapConstIterator<Key, Val, Hasher, Equals>
+    FlatHashMapConstIterator<Key, Val, Hasher, Equals>::operator++(int) {
+        const_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_FLATMAP_H
@@ -2,24 +2,42 @@
  * @file hash.h
  * @brief Provides hash functions for basic data types.
  *
+ * Two hash families are provided. @code Hash @endcode is the default of
+ * the containers: small integers hash to themselves and strings use a
+ * multiply by 127 per character, which is cheap on 8-bit targets. These
+ * hashes are not mixed, so their patterns survive a modulo index with a
+ * round capacity. The power-of-two index policy mixes them by taking the
+ * top bits of a Fibonacci product, which depend on every bit of the hash.
+ *
+ * @code MixHash @endcode is a uniform family in the style of wyhash. Integers
+ * go through a 64 by 64 bit multiply whose high and low halves are folded
+ * together, and strings are consumed a word at a time, two words per
+ * multiply. Use it for keys with patterns that identity hashing keeps,
+ * such as strided integers or pointers, with the modulo index policy.
+ *
+ * Both families hash 64-bit integers, pointers, floating point values,
+ * pairs and tuples; those always go through the mixer.
+ *
  * @author Jeff Niu
  * @date November 1, 2017
  * @bug No known bugs
  */
 
-/*
- * TODO: implementation of uniform hash functions
- */
-
 #ifndef CORE_STL_HASH_H
 #define CORE_STL_HASH_H
 
+#include <string.h>
+
 #include "../Types.h"
 #include "../Wlib.h"
 #include "../WlibConfig.h"
 
 #include "../strings/StaticString.h"
 
+#include "Pair.h"
+#include "Tmp.h"
+#include "Tuple.h"
+
 namespace wlp {
 
     /**
@@ -33,17 +51,225 @@ namespace wlp {
     struct Hash {
     };
 
+    /**
+     * Odd 64-bit constants with evenly spread bits used by the
+     * mixing hash family, the secrets of wyhash.
+     */
+    static constexpr uint64_t HASH_SECRET_0 = 0xa0761d6478bd642full;
+    static constexpr uint64_t HASH_SECRET_1 = 0xe7037ed1a0b428dbull;
+    static constexpr uint64_t HASH_SECRET_2 = 0x8ebc6af09c88c6e3ull;
+    static constexpr uint64_t HASH_SECRET_3 = 0x589965cc75374cc3ull;
+
+    /**
+     * Multiply two 64-bit values into 128 bits and fold the high half
+     * into the low half. Every bit of the result depends on every bit
+     * of both operands.
+     * @param a first operand
+     * @param b second operand
+     * @return the folded product
+     */
+    constexpr uint64_t hash_mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = (__uint128_t) a * b;
+        return (uint64_t) product ^ (uint64_t) (product >> 64);
+#else
+        // schoolbook multiply on 32-bit halves for targets without 128-bit integers
+        uint64_t a_hi = a >> 32;
+        uint64_t a_lo = (uint32_t) a;
+        uint64_t b_hi = b >> 32;
+        uint64_t b_lo = (uint32_t) b;
+        uint64_t hi_hi = a_hi * b_hi;
+        uint64_t hi_lo = a_hi * b_lo;
+        uint64_t lo_hi = a_lo * b_hi;
+        uint64_t lo_lo = a_lo * b_lo;
+        uint64_t low = lo_lo + (hi_lo << 32);
+        uint64_t carry = low < lo_lo;
+        uint64_t result_lo = low + (lo_hi << 32);
+        carry += result_lo < low;
+        uint64_t result_hi = hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + carry;
+        return result_lo ^ result_hi;
+#endif
+    }
+
+    /**
+     * Mix an integer so that every bit of the hash code depends on
+     * every bit of the integer.
+     * @param x the integer to mix
+     * @return the hash code
+     */
+    constexpr uint64_t hash_mix(uint64_t x) {
+        return hash_mum(x, 0x9e3779b97f4a7c15ull);
+    }
+
+    /**
+     * Combine the hash code of the next element of a compound key
+     * into the hash code of the preceding elements. The result
+     * depends on the order of the elements.
+     * @param seed the hash code of the preceding elements
+     * @param h    the hash code of the next element
+     * @return the combined hash code
+     */
+    constexpr uint64_t hash_combine(uint64_t seed, uint64_t h) {
+        return hash_mum(seed ^ HASH_SECRET_1, h ^ HASH_SECRET_2);
+    }
+
+    /**
+     * Read eight bytes as a little-endian word. Written as one
+     * expression so that the compiler merges it into a single load.
+     * @param p the bytes
+     * @return the word
+     */
+    constexpr uint64_t hash_read_8(const char *p) {
+        return (uint64_t) (uint8_t) p[0] | (uint64_t) (uint8_t) p[1] << 8 |
+               (uint64_t) (uint8_t) p[2] << 16 | (uint64_t) (uint8_t) p[3] << 24 |
+               (uint64_t) (uint8_t) p[4] << 32 | (uint64_t) (uint8_t) p[5] << 40 |
+               (uint64_t) (uint8_t) p[6] << 48 | (uint64_t) (uint8_t) p[7] << 56;
+    }
+
+    /**
+     * Read four bytes as a little-endian word.
+     * @param p the bytes
+     * @return the word
+     */
+    constexpr uint64_t hash_read_4(const char *p) {
+        return (uint64_t) (uint8_t) p[0] | (uint64_t) (uint8_t) p[1] << 8 |
+               (uint64_t) (uint8_t) p[2] << 16 | (uint64_t) (uint8_t) p[3] << 24;
+    }
+
+    /**
+     * Read one to three bytes into a word without branching on the count.
+     * @param p     the bytes
+     * @param count the number of bytes, between one and three
+     * @return the word
+     */
+    constexpr uint64_t hash_read_small(const char *p, uint32_t count) {
+        return (uint64_t) (uint8_t) p[0] << 16 | (uint64_t) (uint8_t) p[count >> 1] << 8 |
+               (uint64_t) (uint8_t) p[count - 1];
+    }
+
+    /**
+     * Hash a sequence of bytes with one multiply per sixteen bytes.
+     * Inputs of up to sixteen bytes are read with two to four
+     * overlapping word loads; longer inputs are consumed sixteen
+     * bytes at a time and finish with the last sixteen bytes.
+     * @param data the bytes to hash
+     * @param len  the number of bytes
+     * @return the hash code
+     */
+    constexpr uint64_t hash_bytes(const char *data, uint32_t len) {
+        uint64_t seed = HASH_SECRET_0;
+        uint64_t a = 0;
+        uint64_t b = 0;
+        if (len <= 16) {
+            if (len >= 4) {
+                uint32_t shift = (len >> 3) << 2;
+                a = hash_read_4(data) << 32 | hash_read_4(data + shift);
+                b = hash_read_4(data + len - 4) << 32 | hash_read_4(data + len - 4 - shift);
+            } else if (len > 0) {
+                a = hash_read_small(data, len);
+            }
+        } else {
+            const char *p = data;
+            uint32_t rest = len;
+            for (; rest > 16; rest -= 16, p += 16) {
+                seed = hash_mum(hash_read_8(p) ^ HASH_SECRET_1, hash_read_8(p + 8) ^ seed);
+            }
+            a = hash_read_8(p + rest - 16);
+            b = hash_read_8(p + rest - 8);
+        }
+        return hash_mum(HASH_SECRET_1 ^ len, hash_mum(a ^ HASH_SECRET_1, b ^ seed ^ HASH_SECRET_2));
+    }
+
+    /**
+     * Hash a null terminated character string.
+     * @param s the string to hash
+     * @return the hash code
+     */
+    constexpr uint64_t hash_bytes(const char *s) {
+#if defined(__GNUC__)
+        // the builtin is evaluated at compile time for constant strings
+        return hash_bytes(s, (uint32_t) __builtin_strlen(s));
+#else
+        uint32_t len = 0;
+        while (s[len]) {
+            ++len;
+        }
+        return hash_bytes(s, len);
+#endif
+    }
+
+    /**
+     * Obtain the bits of a floating point value for hashing. Positive
+     * and negative zero compare equal and so hash the same.
+     * @tparam Float   floating point type
+     * @tparam Bits    unsigned integer of the same size
+     * @param x the value
+     * @return the bits of the value
+     */
+    template<class Float, class Bits>
+    inline Bits hash_float_bits(Float x) {
+        static_assert(sizeof(Float) == sizeof(Bits), "Bits must be as wide as Float");
+        Bits bits = 0;
+        if (x != 0) {
+            memcpy(&bits, &x, sizeof(Float));
+        }
+        return bits;
+    }
+
+    /**
+     * Hash a pair by combining the hash codes of its elements.
+     * @tparam Family the hash family applied to the elements
+     * @param pair the pair to hash
+     * @return the hash code
+     */
+    template<template<class, class> class Family, class First, class Second>
+    inline uint64_t hash_pair(const Pair<First, Second> &pair) {
+        uint64_t h = hash_combine(HASH_SECRET_3, Family<First, uint64_t>()(pair.m_first));
+        return hash_combine(h, Family<Second, uint64_t>()(pair.m_second));
+    }
+
+    /**
+     * Hash a tuple by combining the hash codes of its elements in order.
+     * @tparam Family  the hash family applied to the elements
+     * @tparam Indices the indices of the elements
+     * @param tuple the tuple to hash
+     * @return the hash code
+     */
+    template<template<class, class> class Family, class... Types, size_type... Indices>
+    inline uint64_t hash_tuple(const Tuple<Types...> &tuple, IndexSequence<Indices...>) {
+        const uint64_t codes[] = {Family<Types, uint64_t>()(get<Indices>(tuple))...};
+        uint64_t h = HASH_SECRET_3;
+        for (uint64_t code : codes) {
+            h = hash_combine(h, code);
+        }
+        return h;
+    }
+
+    /**
+     * Hash the contents of a static string. Hashes the same as
+     * @code hash_string @endcode on the same characters.
+     * @tparam IntType the unsigned integer type to return
+     * @param static_string the string to hash
+     * @return the hash code
+     */
     template<class IntType, uint16_t tSize>
-    inline IntType hash_static_string(StaticString<tSize> &static_string) {
+    constexpr IntType hash_static_string(const StaticString<tSize> &static_string) {
         IntType h = 0;
-        for (size_type pos = 0; pos < static_string.length(); ++pos) {
+        for (uint16_t pos = 0; pos < static_string.length(); ++pos) {
             h = (IntType) (MUL_127(h) + static_string[pos]);
         }
         return h;
     };
 
+    /**
+     * Hash a null terminated character string. The function is
+     * constexpr so that string literals can be hashed at compile time.
+     * @tparam IntType the unsigned integer type to return
+     * @param s the string to hash
+     * @return the hash code
+     */
     template<class IntType>
-    inline IntType hash_string(const char *s) {
+    constexpr IntType hash_string(const char *s) {
         IntType h = 0;
         for (; *s; ++s) {
             h = (IntType) (MUL_127(h) + *s);
@@ -51,76 +277,264 @@ namespace wlp {
         return h;
     }
 
+    /**
+     * Static strings hash the same as character strings and static
+     * strings of any capacity with the same contents, and the hash is
+     * marked transparent so that maps keyed by static strings can be
+     * searched with those types without building a temporary key.
+     */
     template<class IntType, uint16_t tSize>
     struct Hash<StaticString<tSize>, IntType> {
-        IntType operator()(StaticString<tSize> &s) const {
+        typedef true_type is_transparent;
+
+        constexpr IntType operator()(const StaticString<tSize> &s) const {
             return hash_static_string<IntType, tSize>(s);
         }
+
+        template<uint16_t tOther>
+        constexpr IntType operator()(const StaticString<tOther> &s) const {
+            return hash_static_string<IntType, tOther>(s);
+        }
+
+        constexpr IntType operator()(const char *s) const {
+            return hash_string<IntType>(s);
+        }
     };
 
     template<class IntType>
     struct Hash<char *, IntType> {
-        IntType operator()(const char *s) const {
+        constexpr IntType operator()(const char *s) const {
             return hash_string<IntType>(s);
         }
     };
 
     template<class IntType>
     struct Hash<const char *, IntType> {
-        IntType operator()(const char *s) const {
+        constexpr IntType operator()(const char *s) const {
             return hash_string<IntType>(s);
         }
     };
 
     template<class IntType>
     struct Hash<char, IntType> {
-        IntType operator()(char x) const {
+        constexpr IntType operator()(char x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<uint8_t, IntType> {
-        IntType operator()(uint8_t x) const {
+        constexpr IntType operator()(uint8_t x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<uint16_t, IntType> {
-        IntType operator()(uint16_t x) const {
+        constexpr IntType operator()(uint16_t x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<uint32_t, IntType> {
-        IntType operator()(uint32_t x) const {
+        constexpr IntType operator()(uint32_t x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<int8_t, IntType> {
-        IntType operator()(int8_t x) const {
+        constexpr IntType operator()(int8_t x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<int16_t, IntType> {
-        IntType operator()(int16_t x) const {
+        constexpr IntType operator()(int16_t x) const {
             return (IntType) x;
         }
     };
 
     template<class IntType>
     struct Hash<int32_t, IntType> {
-        IntType operator()(int32_t x) const {
+        constexpr IntType operator()(int32_t x) const {
             return (IntType) x;
         }
     };
 
+    template<class IntType>
+    struct Hash<uint64_t, IntType> {
+        constexpr IntType operator()(uint64_t x) const {
+            return (IntType) hash_mix(x);
+        }
+    };
+
+    template<class IntType>
+    struct Hash<int64_t, IntType> {
+        constexpr IntType operator()(int64_t x) const {
+            return (IntType) hash_mix((uint64_t) x);
+        }
+    };
+
+    /**
+     * Pointers are mixed because their low bits are mostly zero.
+     */
+    template<class T, class IntType>
+    struct Hash<T *, IntType> {
+        inline IntType operator()(const T *p) const {
+            return (IntType) hash_mix((uint64_t) (uintptr_t) p);
+        }
+    };
+
+    template<class IntType>
+    struct Hash<float, IntType> {
+        inline IntType operator()(float x) const {
+            return (IntType) hash_mix(hash_float_bits<float, uint32_t>(x));
+        }
+    };
+
+    template<class IntType>
+    struct Hash<double, IntType> {
+        inline IntType operator()(double x) const {
+            return (IntType) hash_mix(hash_float_bits<double, uint64_t>(x));
+        }
+    };
+
+    template<class First, class Second, class IntType>
+    struct Hash<Pair<First, Second>, IntType> {
+        inline IntType operator()(const Pair<First, Second> &pair) const {
+            return (IntType) hash_pair<Hash>(pair);
+        }
+    };
+
+    template<class... Types, class IntType>
+    struct Hash<Tuple<Types...>, IntType> {
+        inline IntType operator()(const Tuple<Types...> &tuple) const {
+            return (IntType) hash_tuple<Hash>(tuple, typename MakeIndexSequence<sizeof...(Types)>::type());
+        }
+    };
+
+    /**
+     * A uniform hash family in the style of wyhash. Every bit of the
+     * hash code depends on every bit of the key.
+     * @tparam Key     key type
+     * @tparam IntType the unsigned integer type to return
+     */
+    template<class Key, class IntType>
+    struct MixHash {
+    };
+
+    /**
+     * Static strings hash the same as character strings of the same
+     * contents, and the hash is transparent as for @code Hash @endcode.
+     */
+    template<class IntType, uint16_t tSize>
+    struct MixHash<StaticString<tSize>, IntType> {
+        typedef true_type is_transparent;
+
+        constexpr IntType operator()(const StaticString<tSize> &s) const {
+            return (IntType) hash_bytes(s.c_str(), s.length());
+        }
+
+        template<uint16_t tOther>
+        constexpr IntType operator()(const StaticString<tOther> &s) const {
+            return (IntType) hash_bytes(s.c_str(), s.length());
+        }
+
+        constexpr IntType operator()(const char *s) const {
+            return (IntType) hash_bytes(s);
+        }
+    };
+
+    template<class IntType>
+    struct MixHash<char *, IntType> {
+        constexpr IntType operator()(const char *s) const {
+            return (IntType) hash_bytes(s);
+        }
+    };
+
+    template<class IntType>
+    struct MixHash<const char *, IntType> {
+        constexpr IntType operator()(const char *s) const {
+            return (IntType) hash_bytes(s);
+        }
+    };
+
+    /**
+     * Integers of every width sign extend or zero extend to 64 bits
+     * and are mixed.
+     */
+    template<class Integer, class IntType>
+    struct MixIntegerHash {
+        constexpr IntType operator()(Integer x) const {
+            return (IntType) hash_mix((uint64_t) x);
+        }
+    };
+
+    template<class IntType>
+    struct MixHash<char, IntType> : public MixIntegerHash<char, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<uint8_t, IntType> : public MixIntegerHash<uint8_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<uint16_t, IntType> : public MixIntegerHash<uint16_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<uint32_t, IntType> : public MixIntegerHash<uint32_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<uint64_t, IntType> : public MixIntegerHash<uint64_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<int8_t, IntType> : public MixIntegerHash<int8_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<int16_t, IntType> : public MixIntegerHash<int16_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<int32_t, IntType> : public MixIntegerHash<int32_t, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<int64_t, IntType> : public MixIntegerHash<int64_t, IntType> {
+    };
+
+    template<class T, class IntType>
+    struct MixHash<T *, IntType> : public Hash<T *, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<float, IntType> : public Hash<float, IntType> {
+    };
+
+    template<class IntType>
+    struct MixHash<double, IntType> : public Hash<double, IntType> {
+    };
+
+    template<class First, class Second, class IntType>
+    struct MixHash<Pair<First, Second>, IntType> {
+        inline IntType operator()(const Pair<First, Second> &pair) const {
+            return (IntType) hash_pair<MixHash>(pair);
+        }
+    };
+
+    template<class... Types, class IntType>
+    struct MixHash<Tuple<Types...>, IntType> {
+        inline IntType operator()(const Tuple<Types...> &tuple) const {
+            return (IntType) hash_tuple<MixHash>(tuple, typename MakeIndexSequence<sizeof...(Types)>::type());
+        }
+    };
+
 }
 
 #endif //CORE_STL_HASH_H
@@ -0,0 +1,427 @@
+/**
+ * @file HashPolicy.h
+ * @brief Policies mapping hash codes to buckets of a hash map.
+ *
+ * Index policies choose the home bucket of a key and probe policies
+ * choose where an open addressed map looks next.
+ *
+ * Hash code policies decide whether a map keeps the hash code of every
+ * element, trading memory for rehashing without hashing keys again and
+ * for skipping key comparisons when hash codes differ.
+ *
+ * Resize policies decide whether growing a map rehashes every element
+ * at once or spreads the work over the following insertions.
+ *
+ * An index policy decides which capacities a hash map may use and
+ * how a hash code is reduced to a bucket index. @code ModuloIndex @endcode
+ * keeps any capacity and reduces with a remainder, as the maps always
+ * did. @code PowerOfTwoIndex @endcode rounds capacities up to a power of
+ * two and uses Fibonacci hashing: the hash code is multiplied by 2^32
+ * divided by the golden ratio and the index is the top bits of the
+ * product, which depend on every bit of the hash code. Identity hashes
+ * of integer keys would otherwise only ever use their low bits. Wider
+ * hash codes are folded to 32 bits first, so the mixed hash code
+ * selects at most 2^31 buckets.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_HASHPOLICY_H
+#define EMBEDDEDCPLUSPLUS_HASHPOLICY_H
+
+#include "../Types.h"
+
+#include "Tmp.h"
+
+namespace wlp {
+
+    /**
+     * Fibonacci hashing multiplication by 2^32 divided by the golden ratio.
+     * The high bits of the product depend on every bit of the hash code,
+     * the low bits only on the bits below them. A 64-bit hash code has
+     * its high word folded into the low word before the multiplication.
+     * @param hash the hash code to mix
+     * @return the mixed hash code
+     */
+    template<class IntType>
+    inline uint32_t fibonacci_mix(IntType hash) {
+        uint64_t wide = static_cast<uint64_t>(hash);
+        return static_cast<uint32_t>(wide ^ (wide >> 32)) * 2654435769u;
+    }
+
+    /**
+     * Reduce a mixed hash code to its top bits.
+     * @param mixed the mixed hash code
+     * @param shift 32 minus the number of bits to keep, from 1 to 32
+     * @return the top 32 - shift bits of the mixed hash code
+     */
+    inline uint32_t top_bits(uint32_t mixed, uint8_t shift) {
+        // shifting in two steps keeps no bits for a shift of 32,
+        // which a single shift by the width leaves undefined
+        return (mixed >> 1) >> (shift - 1u);
+    }
+
+    /**
+     * The capacity a hash map grows to, which is double the current
+     * capacity unless that overflows the size type, in which case the
+     * map cannot grow any further.
+     * @param capacity the current capacity
+     * @return the doubled capacity, or the current one
+     */
+    inline size_type grow_capacity(size_type capacity) {
+        if (capacity > max_size_type / 2) {
+            return capacity;
+        }
+        return static_cast<size_type>(capacity * 2);
+    }
+
+    /**
+     * The size in bytes of the initial node pool of a hash map, which
+     * holds the requested number of nodes unless those do not fit the
+     * size type in bytes, in which case it holds as many as do. Nodes
+     * beyond the pool are allocated one at a time.
+     * @param n         the requested number of nodes
+     * @param node_size the size of a node
+     * @return the pool size, a whole number of nodes
+     */
+    inline size_type node_pool_size(size_type n, size_t node_size) {
+        wide_size_type size = static_cast<wide_size_type>(node_size);
+        wide_size_type max_nodes = max_size_type / size;
+        wide_size_type nodes = n < max_nodes ? n : max_nodes;
+        return static_cast<size_type>(nodes * size);
+    }
+
+    /**
+     * Index policy reducing hash codes modulo the capacity. Any
+     * capacity is allowed.
+     */
+    struct ModuloIndex {
+        enum : bool {
+            POWER_OF_TWO = false
+        };
+
+        /**
+         * @param n the requested capacity
+         * @return the capacity to use
+         */
+        static inline size_type capacity(size_type n) {
+            return n;
+        }
+
+        /**
+         * @param hash     the hash code of a key
+         * @param capacity the number of buckets
+         * @return an index i such that 0 <= i < capacity
+         */
+        template<class IntType>
+        static inline size_type index(IntType hash, size_type capacity) {
+            return static_cast<size_type>(hash % capacity);
+        }
+    };
+
+    /**
+     * Index policy keeping the capacity a power of two and taking the
+     * top bits of Fibonacci-mixed hash codes instead of a division.
+     */
+    struct PowerOfTwoIndex {
+        enum : bool {
+            POWER_OF_TWO = true
+        };
+
+        /**
+         * The top bits of a 32-bit mixed hash code select at most
+         * 2^31 buckets, which bounds wider size types.
+         * @return the largest capacity of the policy
+         */
+        static constexpr size_type max_capacity() {
+            return static_cast<wide_size_type>(max_size_type) / 2 + 1 < 0x80000000u
+                   ? static_cast<size_type>(max_size_type / 2 + 1)
+                   : static_cast<size_type>(0x80000000u);
+        }
+
+        /**
+         * @param n the requested capacity
+         * @return the smallest power of two not less than n, or the
+         * largest capacity of the policy if n is larger
+         */
+        static constexpr size_type capacity(size_type n) {
+            size_type capacity = 1;
+            while (capacity < n && capacity < max_capacity()) {
+                capacity = static_cast<size_type>(capacity << 1);
+            }
+            return capacity;
+        }
+
+        /**
+         * Maps with a fixed capacity keep the shift rather than
+         * computing it for every index.
+         * @param capacity the number of buckets, a power of two
+         * @return the shift reducing a mixed hash code to a bucket
+         */
+        static constexpr uint8_t shift(size_type capacity) {
+            return static_cast<uint8_t>(32 - __builtin_ctzll(capacity));
+        }
+
+        /**
+         * @param hash     the hash code of a key
+         * @param capacity the number of buckets, a power of two
+         * @return an index i such that 0 <= i < capacity
+         */
+        template<class IntType>
+        static inline size_type index(IntType hash, size_type capacity) {
+            return static_cast<size_type>(top_bits(fibonacci_mix(hash), shift(capacity)));
+        }
+    };
+
+    /**
+     * Probe policy visiting the buckets following the home bucket
+     * one after the other. Erasing shifts the rest of the cluster back,
+     * so lookups never pass over deleted buckets.
+     */
+    struct LinearProbe {
+        enum : bool {
+            ROBIN_HOOD = false,
+            TOMBSTONES = false,
+            REQUIRES_POWER_OF_TWO = false
+        };
+
+        /**
+         * @param i        the bucket just inspected
+         * @param step     the number of buckets inspected so far
+         * @param capacity the number of buckets
+         * @return the next bucket to inspect
+         */
+        static inline size_type next(size_type i, size_type step, size_type capacity) {
+            (void) step;
+            return ++i >= capacity ? 0 : i;
+        }
+    };
+
+    /**
+     * Probe policy advancing by triangular numbers, which breaks up the
+     * clusters formed by keys with nearby home buckets. The sequence only
+     * covers every bucket if the capacity is a power of two. Erased
+     * elements leave tombstones behind, which are purged on rehash.
+     */
+    struct QuadraticProbe {
+        enum : bool {
+            ROBIN_HOOD = false,
+            TOMBSTONES = true,
+            REQUIRES_POWER_OF_TWO = true
+        };
+
+        /**
+         * @see LinearProbe::next()
+         */
+        static inline size_type next(size_type i, size_type step, size_type capacity) {
+            return static_cast<size_type>((i + step) & (capacity - 1u));
+        }
+    };
+
+    /**
+     * Linear probing where an inserted element takes the bucket of any
+     * element closer to its own home bucket, keeping the probe lengths of
+     * all elements close to the mean even above 90% load. The map stores
+     * the distance of every element from its home bucket, so that a
+     * lookup for a missing key stops as soon as it passes an element
+     * closer to home than the key would be.
+     */
+    struct RobinHoodProbe {
+        enum : bool {
+            ROBIN_HOOD = true,
+            TOMBSTONES = false,
+            REQUIRES_POWER_OF_TWO = false
+        };
+
+        /**
+         * @see LinearProbe::next()
+         */
+        static inline size_type next(size_type i, size_type step, size_type capacity) {
+            return LinearProbe::next(i, step, capacity);
+        }
+    };
+
+    /**
+     * Hash code policy keeping no hash codes. Rehashing hashes every
+     * key again and every probed key is compared with the lookup key.
+     */
+    struct NoStoredHash {
+        enum : bool {
+            STORE_HASH = false
+        };
+    };
+
+    /**
+     * Hash code policy keeping the full hash code of every element.
+     * Rehashing reads the stored codes, and keys are only compared when
+     * their hash codes match, which pays off for keys that are expensive
+     * to hash or compare, such as strings.
+     */
+    struct StoredHash {
+        enum : bool {
+            STORE_HASH = true
+        };
+    };
+
+    /**
+     * Resize policy rehashing every element as soon as the map grows,
+     * which costs a single insertion time proportional to the map size.
+     */
+    struct FullRehash {
+        enum : bool {
+            INCREMENTAL = false
+        };
+    };
+
+    /**
+     * Resize policy bounding the work of any single insertion. Growing
+     * only allocates the new bucket array, and the elements are moved over
+     * a few buckets per insertion, at a rate that finishes before the map
+     * needs to grow again. Lookups find elements wherever they are in the
+     * meantime.
+     */
+    struct IncrementalRehash {
+        enum : bool {
+            INCREMENTAL = true
+        };
+
+        /**
+         * @param old_capacity the number of buckets left to move
+         * @param budget       the number of insertions before the map
+         *                     grows again
+         * @return the number of buckets to move per insertion
+         */
+        static inline size_type step(size_type old_capacity, size_type budget) {
+            if (budget == 0) {
+                return old_capacity;
+            }
+            return static_cast<size_type>((static_cast<wide_size_type>(old_capacity) + budget - 1) / budget);
+        }
+    };
+
+    /**
+     * Node layout policy of chained maps allocating every node from the
+     * node allocator and linking the nodes of a chain with pointers. Nodes
+     * never move, so references to elements stay valid until they are erased.
+     */
+    struct PointerNodes {
+        enum : bool {
+            ARENA = false
+        };
+
+        /**
+         * @tparam Node the node type
+         */
+        template<class Node>
+        struct link {
+            typedef Node *type;
+        };
+    };
+
+    /**
+     * Node layout policy of chained maps keeping every node in one
+     * contiguous arena and linking the nodes of a chain with 32-bit indices
+     * into it. Links take half the space of pointers on 64-bit targets and
+     * chains are walked within a single block of memory. The arena doubles
+     * when it runs out of nodes, which moves the elements, so an insertion
+     * invalidates references to elements as well as iterators. An insertion
+     * fails if the doubled arena does not fit the size type or memory.
+     */
+    struct ArenaNodes {
+        enum : bool {
+            ARENA = true
+        };
+
+        /**
+         * @tparam Node the node type
+         */
+        template<class Node>
+        struct link {
+            typedef uint32_t type;
+        };
+    };
+
+    /**
+     * Node layout policy of chained maps allocating every node from a
+     * composed allocator of @code ComposableAllocator.h @endcode, such as a
+     * pool with a fallback or an allocator recording statistics. Nodes are
+     * linked by pointers and never move. The allocator is held inside the
+     * map, which therefore cannot be moved, and an insertion fails if the
+     * allocator runs out of memory.
+     * @tparam A the allocator, providing Allocate(size) and Deallocate(ptr, size)
+     */
+    template<class A>
+    struct AllocatorNodes {
+        enum : bool {
+            ARENA = false
+        };
+
+        typedef A allocator_type;
+
+        /**
+         * @tparam Node the node type
+         */
+        template<class Node>
+        struct link {
+            typedef Node *type;
+        };
+    };
+
+    /**
+     * The type of the hash codes returned by a hash function.
+     * @tparam Hasher hash function
+     * @tparam Key    key type
+     */
+    template<class Hasher, class Key>
+    struct hash_code_type {
+        typedef decltype(declval<const Hasher &>()(declval<const Key &>())) type;
+    };
+
+    /**
+     * The type of the hash code kept with each element, which is void
+     * if the hash code policy keeps none.
+     * @tparam Hasher hash function
+     * @tparam Key    key type
+     * @tparam Cache  hash code policy
+     */
+    template<class Hasher, class Key, class Cache>
+    struct stored_hash_type {
+        typedef typename conditional<Cache::STORE_HASH, typename hash_code_type<Hasher, Key>::type, void>::type type;
+    };
+
+    /**
+     * Value type of the maps backing hash sets. Nodes of a map whose
+     * value type is @code SetValue<Key> @endcode store the element only
+     * once, as the key, which also serves as the value.
+     * @tparam Key the element type
+     */
+    template<class Key>
+    struct SetValue {
+    };
+
+    /**
+     * Tag selecting the constructor of a map node that builds the
+     * key and the value in place from their arguments.
+     */
+    struct EmplaceNode {
+    };
+
+    /**
+     * The type of the values of a map. For maps backing sets it is the
+     * constant key type, since changing the element in place would
+     * leave it in the bucket of its old hash.
+     * @tparam Val value type parameter of the map
+     */
+    template<class Val>
+    struct map_value_type {
+        typedef Val type;
+    };
+
+    template<class Key>
+    struct map_value_type<SetValue<Key>> {
+        typedef const Key type;
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_HASHPOLICY_H
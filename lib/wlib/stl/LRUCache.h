@@ -0,0 +1,462 @@
+/**
+ * @file LRUCache.h
+ * @brief Fixed capacity cache evicting the least recently used element.
+ *
+ * The cache holds at most N elements in an array of entries inside the
+ * cache object. The entries are linked by slot indices into a list
+ * ordered from the most to the least recently used element, and a
+ * chained hash map indexes the slot of every key. Looking up, inserting
+ * and evicting an element each take one hash map operation and a
+ * constant number of list updates.
+ *
+ * The index map is created with a node pool and bucket array for N
+ * elements at a load of at most one, so it never grows. After
+ * construction, the cache does not allocate.
+ *
+ * The cache counts hits, misses, insertions and evictions, from which
+ * the hit rate follows.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_LRUCACHE_H
+#define EMBEDDEDCPLUSPLUS_LRUCACHE_H
+
+#include "Utility.h"
+#include "Equal.h"
+#include "Hash.h"
+#include "ChainMap.h"
+
+namespace wlp {
+
+    /**
+     * Entry of an LRU cache, linked to its neighbours in
+     * the recency list by slot index.
+     * @tparam Key key type
+     * @tparam Val value type
+     */
+    template<class Key, class Val>
+    struct LRUCacheEntry {
+        /**
+         * Entry element key.
+         */
+        Key m_key;
+        /**
+         * Entry element value.
+         */
+        Val m_val;
+        /**
+         * Slot of the next more recently used entry.
+         */
+        size_type m_prev;
+        /**
+         * Slot of the next less recently used entry.
+         */
+        size_type m_next;
+    };
+
+    /**
+     * Cache of at most N elements, evicting the least recently used
+     * element to make room for a new one. Keys and values must be
+     * default constructible, since every entry holds one of each.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam N      maximum number of elements
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>>
+    class LRUCache {
+    public:
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        typedef LRUCache<Key, Val, N, Hasher, Equals> cache_type;
+        typedef LRUCacheEntry<Key, Val> entry_type;
+        typedef ChainHashMap<Key, size_type, Hasher, Equals> index_type;
+
+        static_assert(N > 0, "LRUCache must hold at least one element");
+        static_assert(N < max_size_type, "LRUCache capacity overflows the size type");
+        static_assert(static_cast<wide_size_type>(N) * sizeof(typename index_type::node_type) <= max_size_type,
+                      "LRUCache index node pool overflows the size type");
+
+        /**
+         * Slot index marking the ends of the recency list.
+         */
+        static constexpr size_type NONE = max_size_type;
+
+    private:
+        /**
+         * The entries, of which the first m_num_elements are in use.
+         */
+        entry_type m_entries[N];
+        /**
+         * Maps every cached key to the slot of its entry.
+         */
+        index_type m_index;
+        /**
+         * Slot of the most recently used entry.
+         */
+        size_type m_head;
+        /**
+         * Slot of the least recently used entry.
+         */
+        size_type m_tail;
+        /**
+         * The number of cached elements.
+         */
+        size_type m_num_elements;
+
+        /**
+         * The number of lookups that found their key.
+         */
+        uint32_t m_hits;
+        /**
+         * The number of lookups that did not find their key.
+         */
+        uint32_t m_misses;
+        /**
+         * The number of elements inserted.
+         */
+        uint32_t m_insertions;
+        /**
+         * The number of elements evicted to make room.
+         */
+        uint32_t m_evictions;
+
+    public:
+        /**
+         * Create an empty cache. The index map allocates its
+         * buckets and node pool here, and nowhere else.
+         */
+        LRUCache()
+                : m_index(N, 100),
+                  m_head(NONE),
+                  m_tail(NONE),
+                  m_num_elements(0),
+                  m_hits(0),
+                  m_misses(0),
+                  m_insertions(0),
+                  m_evictions(0) {
+        }
+
+        /**
+         * Disable copy constructor.
+         */
+        LRUCache(const cache_type &) = delete;
+
+        /**
+         * Disable copy assignment.
+         */
+        cache_type &operator=(const cache_type &) = delete;
+
+        /**
+         * @return the number of cached elements
+         */
+        size_type size() const {
+            return m_num_elements;
+        }
+
+        /**
+         * @return the maximum number of cached elements
+         */
+        static constexpr size_type capacity() {
+            return N;
+        }
+
+        /**
+         * @return true if no element is cached
+         */
+        bool empty() const {
+            return m_num_elements == 0;
+        }
+
+        /**
+         * @return true if inserting a new key evicts an element
+         */
+        bool full() const {
+            return m_num_elements == N;
+        }
+
+        /**
+         * Look up the value of a key and mark it the most recently
+         * used element. Counts a hit or a miss.
+         * @param key the key to look up
+         * @return a pointer to the cached value, valid until the element
+         * is evicted or any element is erased, or nullptr if the key
+         * is not cached
+         */
+        val_type *get(const key_type &key);
+
+        /**
+         * Look up the value of a key without marking it used or
+         * counting the lookup.
+         * @param key the key to look up
+         * @return a pointer to the cached value or nullptr
+         */
+        const val_type *peek(const key_type &key) const;
+
+        /**
+         * @param key the key to look up
+         * @return true if the key is cached, without marking it used
+         */
+        bool contains(const key_type &key) const;
+
+        /**
+         * Cache a value for a key, replacing the value of a cached key,
+         * and mark it the most recently used element. If the cache is full
+         * and the key is new, the least recently used element is evicted.
+         * @param key the key to cache
+         * @param val the value to cache
+         * @return true if the key was not cached before
+         */
+        bool put(const key_type &key, const val_type &val);
+
+        /**
+         * Remove a key from the cache. This is not counted as an eviction.
+         * @param key the key to remove
+         * @return true if the key was cached
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Remove every element. The counters are kept.
+         */
+        void clear();
+
+        /**
+         * @return the least recently used key, which is evicted next
+         * @pre the cache is not empty
+         */
+        const key_type &lru_key() const {
+            return m_entries[m_tail].m_key;
+        }
+
+        /**
+         * @return the most recently used key
+         * @pre the cache is not empty
+         */
+        const key_type &mru_key() const {
+            return m_entries[m_head].m_key;
+        }
+
+        /**
+         * @return the number of lookups that found their key
+         */
+        uint32_t hits() const {
+            return m_hits;
+        }
+
+        /**
+         * @return the number of lookups that did not find their key
+         */
+        uint32_t misses() const {
+            return m_misses;
+        }
+
+        /**
+         * @return the number of counted lookups, hits and misses
+         */
+        uint32_t lookups() const {
+            return m_hits + m_misses;
+        }
+
+        /**
+         * @return the number of elements inserted
+         */
+        uint32_t insertions() const {
+            return m_insertions;
+        }
+
+        /**
+         * @return the number of elements evicted to make room
+         */
+        uint32_t evictions() const {
+            return m_evictions;
+        }
+
+        /**
+         * @return the percentage of counted lookups that were hits,
+         * or zero if there were none
+         */
+        uint8_t hit_rate() const {
+            uint32_t n = lookups();
+            return static_cast<uint8_t>(n ? static_cast<uint64_t>(m_hits) * 100 / n : 0);
+        }
+
+        /**
+         * Reset every counter to zero.
+         */
+        void reset_counters() {
+            m_hits = 0;
+            m_misses = 0;
+            m_insertions = 0;
+            m_evictions = 0;
+        }
+
+        /**
+         * @return the map indexing the slots of the cached keys
+         */
+        const index_type &get_index() const {
+            return m_index;
+        }
+
+    private:
+        /**
+         * Remove an entry from the recency list.
+         * @param slot the slot of the entry
+         */
+        void unlink(size_type slot);
+
+        /**
+         * Insert an entry at the front of the recency list.
+         * @param slot the slot of the entry
+         */
+        void push_front(size_type slot);
+
+        /**
+         * Mark an entry the most recently used one.
+         * @param slot the slot of the entry
+         */
+        void touch(size_type slot);
+    };
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    constexpr size_type LRUCache<Key, Val, N, Hasher, Equals>::NONE;
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void LRUCache<Key, Val, N, Hasher, Equals>::unlink(size_type slot) {
+        entry_type &entry = m_entries[slot];
+        if (entry.m_prev == NONE) {
+            m_head = entry.m_next;
+        } else {
+            m_entries[entry.m_prev].m_next = entry.m_next;
+        }
+        if (entry.m_next == NONE) {
+            m_tail = entry.m_prev;
+        } else {
+            m_entries[entry.m_next].m_prev = entry.m_prev;
+        }
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void LRUCache<Key, Val, N, Hasher, Equals>::push_front(size_type slot) {
+        entry_type &entry = m_entries[slot];
+        entry.m_prev = NONE;
+        entry.m_next = m_head;
+        if (m_head == NONE) {
+            m_tail = slot;
+        } else {
+            m_entries[m_head].m_prev = slot;
+        }
+        m_head = slot;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void LRUCache<Key, Val, N, Hasher, Equals>::touch(size_type slot) {
+        if (slot != m_head) {
+            unlink(slot);
+            push_front(slot);
+        }
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    Val *LRUCache<Key, Val, N, Hasher, Equals>::get(const key_type &key) {
+        typename index_type::iterator it = m_index.find(key);
+        if (it == m_index.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        touch(*it);
+        return &m_entries[*it].m_val;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    const Val *LRUCache<Key, Val, N, Hasher, Equals>::peek(const key_type &key) const {
+        typename index_type::const_iterator it = m_index.find(key);
+        if (it == m_index.end()) {
+            return nullptr;
+        }
+        return &m_entries[*it].m_val;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    bool LRUCache<Key, Val, N, Hasher, Equals>::contains(const key_type &key) const {
+        return m_index.contains(key);
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    bool LRUCache<Key, Val, N, Hasher, Equals>::put(const key_type &key, const val_type &val) {
+        typename index_type::iterator it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_entries[*it].m_val = val;
+            touch(*it);
+            return false;
+        }
+        size_type slot;
+        if (m_num_elements < N) {
+            slot = m_num_elements++;
+        } else {
+            // reuse the slot of the least recently used entry
+            slot = m_tail;
+            typename index_type::iterator victim = m_index.find(m_entries[slot].m_key);
+            m_index.erase(victim);
+            unlink(slot);
+            ++m_evictions;
+        }
+        m_entries[slot].m_key = key;
+        m_entries[slot].m_val = val;
+        m_index.insert(key, slot);
+        push_front(slot);
+        ++m_insertions;
+        return true;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    bool LRUCache<Key, Val, N, Hasher, Equals>::erase(const key_type &key) {
+        typename index_type::iterator it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+        size_type slot = *it;
+        m_index.erase(it);
+        unlink(slot);
+        // keep the slots in use contiguous by moving the
+        // entry of the last slot into the freed one
+        size_type last = --m_num_elements;
+        if (slot != last) {
+            entry_type &moved = m_entries[slot];
+            moved = move(m_entries[last]);
+            *m_index.find(moved.m_key) = slot;
+            if (moved.m_prev == NONE) {
+                m_head = slot;
+            } else {
+                m_entries[moved.m_prev].m_next = slot;
+            }
+            if (moved.m_next == NONE) {
+                m_tail = slot;
+            } else {
+                m_entries[moved.m_next].m_prev = slot;
+            }
+        }
+        return true;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void LRUCache<Key, Val, N, Hasher, Equals>::clear() {
+        m_index.clear();
+        m_head = NONE;
+        m_tail = NONE;
+        m_num_elements = 0;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_LRUCACHE_H
@@ -15,10 +15,15 @@
 #ifndef CORE_STL_MAP_H
 #define CORE_STL_MAP_H
 
+#include <assert.h>
+#include <new>
+
 #include "Utility.h"
 #include "Equal.h"
 #include "Hash.h"
+#include "HashPolicy.h"
 #include "Pair.h"
+#include "TypeTraits.h"
 
 #include "../memory/Allocator.h"
 #include "../memory/Memory.h"
@@ -29,21 +34,33 @@ namespace wlp {
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Probe,
+            class Cache,
+            class Resize>
     class OpenHashMap;
 
     // Forward declaration of OpenHashMap iterator
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index = ModuloIndex,
+            class Probe = LinearProbe,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash>
     struct OpenHashMapIterator;
 
     // Forward declaration of const OpenHashMap iterator
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index = ModuloIndex,
+            class Probe = LinearProbe,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash>
     struct OpenHashMapConstIterator;
 
     /**
@@ -66,6 +83,19 @@ namespace wlp {
          */
         val_type m_val;
 
+        OpenHashMapNode() = default;
+
+        /**
+         * Build the key and the value in place.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         */
+        template<class K, class... Args>
+        OpenHashMapNode(EmplaceNode, K &&key, Args &&... args)
+                : m_key(forward<K>(key)),
+                  m_val(forward<Args>(args)...) {
+        }
+
         /**
          * Nodes are equal if the keys and values are equal.
          * @param node node to compare
@@ -83,6 +113,70 @@ namespace wlp {
         bool operator==(node_type &node) const {
             return m_key == node.m_key && m_val == node.m_val;
         }
+
+        /**
+         * @return the value of the node element
+         */
+        val_type &value() {
+            return m_val;
+        }
+
+        /**
+         * @return the value of the node element
+         */
+        const val_type &value() const {
+            return m_val;
+        }
+    };
+
+    /**
+     * Nodes of the maps backing hash sets store only the key,
+     * which is also the value of the element.
+     * @tparam Key the element type
+     */
+    template<class Key>
+    struct OpenHashMapNode<Key, SetValue<Key>> {
+        typedef OpenHashMapNode<Key, SetValue<Key>> node_type;
+        typedef Key key_type;
+        typedef const Key val_type;
+        /**
+         * The element.
+         */
+        key_type m_key;
+
+        OpenHashMapNode() = default;
+
+        /**
+         * Build the element in place.
+         * @param key argument from which to build the element
+         */
+        template<class K>
+        OpenHashMapNode(EmplaceNode, K &&key, SetValue<Key>)
+                : m_key(forward<K>(key)) {
+        }
+
+        /**
+         * Nodes are equal if the elements are equal.
+         * @param node node to compare
+         * @return true if the elements are equal
+         */
+        bool operator==(const node_type &node) const {
+            return m_key == node.m_key;
+        }
+
+        /**
+         * @return the element
+         */
+        val_type &value() {
+            return m_key;
+        }
+
+        /**
+         * @return the element
+         */
+        const val_type &value() const {
+            return m_key;
+        }
     };
 
     /**
@@ -93,17 +187,26 @@ namespace wlp {
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Probe  probe policy, e.g. @code RobinHoodProbe @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
      */
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Probe,
+            class Cache,
+            class Resize>
     struct OpenHashMapIterator {
-        typedef OpenHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef OpenHashMapIterator<Key, Val, Hasher, Equals> iterator;
+        typedef OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> map_type;
+        typedef OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> iterator;
         typedef OpenHashMapNode<Key, Val> node_type;
 
-        typedef Val val_type;
+        typedef Key key_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
 
@@ -115,23 +218,31 @@ namespace wlp {
          * Pointer to the iterated OpenHashMap.
          */
         map_type *m_hash_map;
+        /**
+         * Index of the bucket of the referenced node, so that
+         * incrementing needs neither hashing nor probing.
+         */
+        size_type m_index;
 
         /**
          * Default constructor.
          */
         OpenHashMapIterator()
                 : m_current(nullptr),
-                  m_hash_map(nullptr) {
+                  m_hash_map(nullptr),
+                  m_index(0) {
         }
 
         /**
          * Create an iterator to a OpenHashMap node.
-         * @param node hash map node
-         * @param map  parent hash map
+         * @param node  hash map node
+         * @param map   parent hash map
+         * @param index bucket of the node
          */
-        OpenHashMapIterator(node_type *node, map_type *map)
+        OpenHashMapIterator(node_type *node, map_type *map, size_type index = 0)
                 : m_current(node),
-                  m_hash_map(map) {
+                  m_hash_map(map),
+                  m_index(index) {
         }
 
         /**
@@ -140,7 +251,8 @@ namespace wlp {
          */
         OpenHashMapIterator(const iterator &it)
                 : m_current(it.m_current),
-                  m_hash_map(it.m_hash_map) {
+                  m_hash_map(it.m_hash_map),
+                  m_index(it.m_index) {
         }
 
         /**
@@ -149,7 +261,15 @@ namespace wlp {
          */
         OpenHashMapIterator(iterator &&it)
                 : m_current(move(it.m_current)),
-                  m_hash_map(move(it.m_hash_map)) {
+                  m_hash_map(move(it.m_hash_map)),
+                  m_index(move(it.m_index)) {
+        }
+
+        /**
+         * @return the key of the node pointed to by the iterator
+         */
+        const key_type &key() const {
+            return m_current->m_key;
         }
 
         /**
@@ -157,7 +277,7 @@ namespace wlp {
          * pointed to by the iterator
          */
         val_type &operator*() const {
-            return m_current->m_val;
+            return m_current->value();
         }
 
         /**
@@ -172,6 +292,8 @@ namespace wlp {
          * Increment the iterator to the next available element in
          * the OpenHashMap. If no such element exists, returns pass-the-end
          * iterator. This is pre-fix unary operator.
+         * The scan starts from the stored bucket index; only if the
+         * element has since been shifted is its bucket probed again.
          * @return this iterator
          */
         iterator &operator++();
@@ -229,6 +351,7 @@ namespace wlp {
         iterator &operator=(const iterator &it) {
             m_current = it.m_current;
             m_hash_map = it.m_hash_map;
+            m_index = it.m_index;
             return *this;
         }
 
@@ -240,6 +363,7 @@ namespace wlp {
         iterator &operator=(iterator &&it) {
             m_current = move(it.m_current);
             m_hash_map = move(it.m_hash_map);
+            m_index = move(it.m_index);
             return *this;
         }
     };
@@ -254,45 +378,66 @@ namespace wlp {
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Probe  probe policy, e.g. @code RobinHoodProbe @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
      */
     template<class Key,
             class Val,
             class Hasher,
-            class Equals>
+            class Equals,
+            class Index,
+            class Probe,
+            class Cache,
+            class Resize>
     struct OpenHashMapConstIterator {
-        typedef OpenHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef OpenHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> map_type;
+        typedef OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> const_iterator;
         typedef OpenHashMapNode<Key, Val> node_type;
 
-        typedef Val val_type;
+        typedef Key key_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
 
         const node_type *m_current;
         const map_type *m_hash_map;
+        size_type m_index;
 
         OpenHashMapConstIterator()
                 : m_current(nullptr),
-                  m_hash_map(nullptr) {
+                  m_hash_map(nullptr),
+                  m_index(0) {
         }
 
-        OpenHashMapConstIterator(node_type *node, const map_type *map)
+        OpenHashMapConstIterator(node_type *node, const map_type *map, size_type index = 0)
                 : m_current(node),
-                  m_hash_map(map) {
+                  m_hash_map(map),
+                  m_index(index) {
         }
 
         OpenHashMapConstIterator(const const_iterator &it)
                 : m_current(it.m_current),
-                  m_hash_map(it.m_hash_map) {
+                  m_hash_map(it.m_hash_map),
+                  m_index(it.m_index) {
         }
 
         OpenHashMapConstIterator(const_iterator &&it)
                 : m_current(move(it.m_current)),
-                  m_hash_map(move(it.m_hash_map)) {
+                  m_hash_map(move(it.m_hash_map)),
+                  m_index(move(it.m_index)) {
+        }
+
+        /**
+         * @return the key of the node pointed to by the iterator
+         */
+        const key_type &key() const {
+            return m_current->m_key;
         }
 
         const val_type &operator*() const {
-            return m_current->m_val;
+            return m_current->value();
         }
 
         const val_type *operator->() const {
@@ -322,43 +467,58 @@ namespace wlp {
         const_iterator &operator=(const const_iterator &it) {
             m_current = it.m_current;
             m_hash_map = it.m_hash_map;
+            m_index = it.m_index;
             return *this;
         }
 
         const_iterator &operator=(const_iterator &&it) {
             m_current = move(it.m_current);
             m_hash_map = move(it.m_hash_map);
+            m_index = move(it.m_index);
             return *this;
         }
     };
 
     /**
-     * Hasher map implemented using open addressing and linear probing,
-     * in the spirit of std::unordered_map.
+     * Hasher map implemented using open addressing, in the spirit of
+     * std::unordered_map. Probing is linear unless another probe
+     * policy is selected.
      * @tparam Key   key type
      * @tparam Val   value type
      * @tparam Hasher  hash function
      * @tparam Equals key equality function
+     * @tparam Index  bucket index policy, e.g. @code PowerOfTwoIndex @endcode
+     * @tparam Probe  probe policy, e.g. @code RobinHoodProbe @endcode
+     * @tparam Cache  hash code policy, e.g. @code StoredHash @endcode
+     * @tparam Resize resize policy, e.g. @code IncrementalRehash @endcode
      */
     template<class Key,
             class Val,
-            class Hasher = Hash <Key, uint16_t>,
-            class Equals = Equal <Key>>
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>,
+            class Index = ModuloIndex,
+            class Probe = LinearProbe,
+            class Cache = NoStoredHash,
+            class Resize = FullRehash>
     class OpenHashMap {
     public:
-        typedef OpenHashMap<Key, Val, Hasher, Equals> map_type;
-        typedef OpenHashMapIterator<Key, Val, Hasher, Equals> iterator;
-        typedef OpenHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> map_type;
+        typedef OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> iterator;
+        typedef OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> const_iterator;
         typedef OpenHashMapNode<Key, Val> node_type;
 
         typedef Key key_type;
-        typedef Val val_type;
+        typedef typename map_value_type<Val>::type val_type;
 
         typedef wlp::size_type size_type;
         typedef uint8_t percent_type;
+        typedef typename hash_code_type<Hasher, Key>::type hash_code;
+
+        static_assert(Index::POWER_OF_TWO || !Probe::REQUIRES_POWER_OF_TWO,
+                      "Probe policy requires a power of two index policy");
 
-        friend struct OpenHashMapIterator<Key, Val, Hasher, Equals>;
-        friend struct OpenHashMapConstIterator<Key, Val, Hasher, Equals>;
+        friend struct OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>;
+        friend struct OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>;
 
     private:
         /**
@@ -381,12 +541,53 @@ namespace wlp {
          * Hasher map backing array.
          */
         node_type **m_buckets;
+        /**
+         * Distance of each element from its home bucket, allocated
+         * only for Robin Hood probing.
+         */
+        size_type *m_distances;
+        /**
+         * Hash code of the element in each bucket, allocated
+         * only if the hash code policy stores them.
+         */
+        hash_code *m_hashes;
+        /**
+         * Backing array before the map last grew, while incremental
+         * rehashing is still moving its elements, and null otherwise.
+         * Moved elements leave tombstones behind.
+         */
+        node_type **m_old_buckets;
+        /**
+         * Robin Hood distances of the old backing array.
+         */
+        size_type *m_old_distances;
+        /**
+         * Stored hash codes of the old backing array.
+         */
+        hash_code *m_old_hashes;
+        /**
+         * The size of the old backing array, zero if there is none.
+         */
+        size_type m_old_capacity;
+        /**
+         * The number of buckets of the old backing array already moved.
+         */
+        size_type m_num_moved;
+        /**
+         * The number of old buckets to move per insertion.
+         */
+        size_type m_move_step;
 
         /**
          * The current number of elements that have been inserted
          * into the map.
          */
         size_type m_num_elements;
+        /**
+         * The number of buckets holding a tombstone, which is
+         * always zero unless the probe policy uses tombstones.
+         */
+        size_type m_num_tombstones;
         /**
          * The size of the backing array.
          */
@@ -407,7 +608,10 @@ namespace wlp {
          * @pre the hash map requires definition of an initial bucket array size
          *      and a maximum load factor before rehashing
          *
-         * @param n        initial size of the bucket list; each bucket is initialized to nullptr
+         * @pre the initial bucket arrays fit the size type in bytes
+         *
+         * @param n        initial size of the bucket list, as adjusted by the index policy;
+         *                 each bucket is initialized to nullptr
          * @param max_load an integer value denoting the max percent load factory, e.g. 75 = 0.75
          * @param hash     hash function for the key type, default is @code wlp::Hasher @endcode
          * @param equal    equality function for the key type, default is @code wlp::Equals @endcode
@@ -417,11 +621,18 @@ namespace wlp {
                 percent_type max_load = 75)
                 : m_hash(Hasher()),
                   m_equal(Equals()),
-                  m_node_allocator{sizeof(node_type), static_cast<size_type>(n * sizeof(node_type))},
+                  m_node_allocator{sizeof(node_type), node_pool_size(n, sizeof(node_type))},
+                  m_buckets(nullptr),
+                  m_distances(nullptr),
+                  m_hashes(nullptr),
                   m_num_elements(0),
-                  m_capacity(n),
+                  m_num_tombstones(0),
+                  m_capacity(Index::capacity(n)),
                   m_max_load(max_load) {
-            init_buckets(n);
+            bool allocated = init_buckets(m_capacity);
+            assert(allocated);
+            (void) allocated;
+            init_old_buckets();
             if (max_load > 100) {
                 m_max_load = 100;
             }
@@ -443,12 +654,25 @@ namespace wlp {
                 m_equal(move(map.m_equal)),
                 m_node_allocator(move(map.m_node_allocator)),
                 m_buckets(move(map.m_buckets)),
+                m_distances(move(map.m_distances)),
+                m_hashes(move(map.m_hashes)),
+                m_old_buckets(move(map.m_old_buckets)),
+                m_old_distances(move(map.m_old_distances)),
+                m_old_hashes(move(map.m_old_hashes)),
+                m_old_capacity(move(map.m_old_capacity)),
+                m_num_moved(move(map.m_num_moved)),
+                m_move_step(move(map.m_move_step)),
                 m_num_elements(move(map.m_num_elements)),
+                m_num_tombstones(move(map.m_num_tombstones)),
                 m_capacity(move(map.m_capacity)),
                 m_max_load(move(map.m_max_load)) {
             map.m_num_elements = 0;
+            map.m_num_tombstones = 0;
             map.m_capacity = 0;
             map.m_buckets = nullptr;
+            map.m_distances = nullptr;
+            map.m_hashes = nullptr;
+            map.init_old_buckets();
         }
 
         /**
@@ -461,10 +685,162 @@ namespace wlp {
         /**
          * Function called when creating the hash map. This function
          * will allocate memory for the backing array and initialize each
-         * element to nullptr.
+         * element to nullptr. The current arrays are kept if any
+         * allocation fails.
          * @param n the size of the backing array
+         * @return false if the arrays do not fit the size type in
+         * bytes or memory ran out
+         */
+        bool init_buckets(size_type n);
+
+        /**
+         * Mark the map as having no old backing array.
+         */
+        void init_old_buckets() {
+            m_old_buckets = nullptr;
+            m_old_distances = nullptr;
+            m_old_hashes = nullptr;
+            m_old_capacity = 0;
+            m_num_moved = 0;
+            m_move_step = 0;
+        }
+
+        /**
+         * Free the old backing array, which must hold no elements.
+         */
+        void free_old_buckets();
+
+        /**
+         * Move elements from the old backing array into the current one.
+         * @param n the maximum number of old buckets to move
+         */
+        void move_buckets(size_type n);
+
+        /**
+         * Buckets are numbered across both backing arrays, with
+         * the buckets of the old array following the current ones.
+         * @return the number of buckets in both backing arrays
+         */
+        size_type num_slots() const {
+            return static_cast<size_type>(m_capacity + m_old_capacity);
+        }
+
+        /**
+         * @param i a bucket number across both backing arrays
+         * @return the content of the bucket
+         */
+        node_type *&slot(size_type i) const {
+            return i < m_capacity ? m_buckets[i] : m_old_buckets[i - m_capacity];
+        }
+
+        /**
+         * Marker left in the bucket of an erased element by probe
+         * policies that cannot move elements back on erase.
+         * @return the tombstone marker, never a valid node address
+         */
+        static node_type *tombstone() {
+            return reinterpret_cast<node_type *>(1);
+        }
+
+        /**
+         * @param node the content of a bucket
+         * @return true if the bucket holds an element
+         */
+        static bool occupied(const node_type *node) {
+            return node && (!(Probe::TOMBSTONES || Resize::INCREMENTAL) || node != tombstone());
+        }
+
+        /**
+         * Walk the probe sequence of a key.
+         * @param key    the key to look up
+         * @param length set to the number of buckets inspected
+         * @return the bucket holding the key, or the capacity
+         * if the key is not in the map
+         */
+        template<class K>
+        size_type probe(const K &key, size_type &length) const;
+
+        /**
+         * @param key the key to look up
+         * @return the bucket number holding the key across both
+         * backing arrays, or the number of buckets if the key is
+         * not in the map
+         */
+        template<class K>
+        size_type find_index(const K &key) const {
+            size_type length;
+            size_type i = probe(key, length);
+            if (Resize::INCREMENTAL && i == m_capacity && m_old_capacity) {
+                return static_cast<size_type>(m_capacity + find_old_index(key, m_hash(key)));
+            }
+            return i == m_capacity ? num_slots() : i;
+        }
+
+        /**
+         * Walk the probe sequence of a key in the old backing array,
+         * passing over the tombstones of moved elements.
+         * @param key  the key to look up
+         * @param code the hash code of the key
+         * @return the old bucket holding the key, or the old capacity
+         * if the key is not in the old array
+         */
+        template<class K>
+        size_type find_old_index(const K &key, hash_code code) const;
+
+        /**
+         * Find the bucket holding a key in either backing array or, if
+         * the key is not in the map, empty a bucket of the current array
+         * in which the key belongs.
+         * @param key the key to look up
+         * @return the bucket number holding the key, or an empty bucket
+         */
+        size_type insert_slot(const key_type &key);
+
+        /**
+         * Find the bucket holding a key or, if the key is not in the map,
+         * empty the bucket in which the key belongs. Robin Hood probing
+         * moves the elements in the way one bucket further.
+         *
+         * @pre the map has at least one empty bucket
+         *
+         * @param key  the key to look up
+         * @param code the hash code of the key
+         * @return the bucket holding the key, or an empty bucket
+         */
+        size_type insert_index(const key_type &key, hash_code code);
+
+        /**
+         * @param i a bucket holding an element
+         * @return the home bucket of the element
          */
-        void init_buckets(size_type n);
+        size_type home_index(size_type i) const {
+            return Index::index(Cache::STORE_HASH ? m_hashes[i] : m_hash(m_buckets[i]->m_key), m_capacity);
+        }
+
+        /**
+         * Move an element to another bucket along with its hash code.
+         * @param to   the bucket to fill
+         * @param from the bucket holding the element
+         */
+        void move_bucket(size_type to, size_type from) {
+            m_buckets[to] = m_buckets[from];
+            if (Cache::STORE_HASH) {
+                m_hashes[to] = m_hashes[from];
+            }
+        }
+
+        /**
+         * Move the elements from the given bucket up to the next
+         * empty bucket one bucket further along the probe sequence.
+         * @param i the bucket to empty
+         */
+        void shift_forward(size_type i);
+
+        /**
+         * Remove the element in a bucket and deallocate it.
+         * @param i the bucket number of the element across both arrays
+         */
+        void remove_at(size_type i);
 
         /**
          * Obtain the bucket index in an array with the specified
@@ -473,8 +849,8 @@ namespace wlp {
          * @param max_elements the maximum number of buckets
          * @return an index i such that 0 <= i < max_elements
          */
-        size_type bucket_index(key_type key, size_type max_elements) const {
-            return m_hash(key) % max_elements;
+        size_type bucket_index(const key_type &key, size_type max_elements) const {
+            return Index::index(m_hash(key), max_elements);
         }
 
         /**
@@ -482,22 +858,112 @@ namespace wlp {
          * @param key the key to hash
          * @return an index i such that 0 <= i < m_max_elements
          */
-        size_type hash(key_type key) const {
-            return m_hash(key) % m_capacity;
+        template<class K>
+        size_type hash(const K &key) const {
+            return Index::index(m_hash(key), m_capacity);
         }
 
+        /**
+         * Enables the lookup overloads taking other key-like types,
+         * which requires both the hasher and the equality function
+         * to be marked transparent.
+         * @tparam K the type of the lookup key
+         */
+        template<class K>
+        struct transparent_key : enable_if<
+                has_is_transparent<Hasher>::value &&
+                has_is_transparent<Equals>::value, K> {
+        };
+
         /**
          * Resize and rehash the hash map if the current load factor
-         * exceeds or equals the maximum load factor. This function
-         * will double the size of the backing array, allocating a new
-         * array, and fully deallocating the previous array.
+         * exceeds or equals the maximum load factor, or if the map is
+         * about to run out of empty buckets. This function will double
+         * the size of the backing array, allocating a new array, and
+         * fully deallocating the previous array. If mostly tombstones
+         * fill the map, the array is rehashed without growing.
+         *
+         * Under incremental rehashing the previous array is kept as the
+         * old array and this function instead moves a bounded number of
+         * its buckets on every call.
+         *
+         * If the size type cannot hold a doubled capacity, the map keeps
+         * its capacity and fills beyond the maximum load, always keeping
+         * one bucket empty so that probing terminates.
          *
          * @pre this function will create a new array allocator, however
          *      the same node allocator will be used, which means that
          *      the node allocator will start drawing from heap memory
          *      if the number of elements exceeds the initial max elements
+         *
+         * @return false if the map is full and cannot take another element
+         */
+        bool ensure_capacity();
+
+        /**
+         * Fill the hole left by an erased element by shifting back
+         * elements of the following probe sequence, so that no element
+         * becomes unreachable from its home bucket. No memory is
+         * allocated and no element other than the shifted ones is touched.
+         * @param hole index of the emptied bucket
+         */
+        void shift_back(size_type hole);
+
+        /**
+         * Rehash every element into a new backing array, finishing
+         * any incremental rehash first and dropping all tombstones.
+         * @param new_capacity the capacity of the new array
+         * @return false if the new array could not be allocated,
+         * in which case the map is left as it was
+         */
+        bool rehash_to(size_type new_capacity);
+
+        /**
+         * @param n a number of elements
+         * @return the smallest capacity allowed by the index policy
+         * that holds the elements without growing
+         */
+        size_type capacity_for(size_type n) const;
+
+        /**
+         * Move the elements left behind after emptying buckets back
+         * towards their home buckets, in a single pass over the backing
+         * array. Only used by probe policies that shift elements back.
+         * @param start a bucket that was empty before the buckets
+         *              were emptied, where no probe sequence wraps
+         */
+        void compact(size_type start);
+
+
+        /**
+         * Insert an element unless its key is in the map, building
+         * the key and the value in the node from the arguments.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return the element with the key and whether it was inserted
+         */
+        template<class K, class... Args>
+        Pair<iterator, bool> emplace_key(K &&key, Args &&... args);
+
+        /**
+         * Build a node in memory from the node allocator.
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return the new node
+         */
+        template<class K, class... Args>
+        node_type *create_node(K &&key, Args &&... args) {
+            return new(m_node_allocator.Allocate()) node_type(EmplaceNode(), forward<K>(key), forward<Args>(args)...);
+        }
+
+        /**
+         * Destroy a node and return its memory to the node allocator.
+         * @param node the node to destroy
          */
-        void ensure_capacity();
+        void destroy_node(node_type *node) {
+            node->~node_type();
+            m_node_allocator.Deallocate(node);
+        }
 
     public:
         /**
@@ -546,9 +1012,9 @@ namespace wlp {
             if (m_num_elements == 0) {
                 return end();
             }
-            for (size_type i = 0; i < m_capacity; ++i) {
-                if (m_buckets[i]) {
-                    return iterator(m_buckets[i], this);
+            for (size_type i = 0; i < num_slots(); ++i) {
+                if (occupied(slot(i))) {
+                    return iterator(slot(i), this, i);
                 }
             }
             return end();
@@ -569,9 +1035,9 @@ namespace wlp {
             if (m_num_elements == 0) {
                 return end();
             }
-            for (size_type i = 0; i < m_capacity; ++i) {
-                if (m_buckets[i]) {
-                    return const_iterator(m_buckets[i], this);
+            for (size_type i = 0; i < num_slots(); ++i) {
+                if (occupied(slot(i))) {
+                    return const_iterator(slot(i), this, i);
                 }
             }
             return end();
@@ -594,14 +1060,67 @@ namespace wlp {
         /**
          * Attempt to insert an element into the map.
          * Insertion is prevented if there already exists
-         * an element with the provided key
+         * an element with the provided key, or if the map is full
+         * and cannot grow, in which case the iterator is end.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert(const key_type &key, const val_type &val);
+
+        /**
+         * Insert an element by moving the key and value into the
+         * node, so that neither is copied more than once.
          * @param key inserted element key
          * @param val inserted element value
          * @return a pair consisting of an iterator pointing to the
          * inserted element or the element that prevented insertion
          * and a bool indicating whether insertion occurred
          */
-        Pair<iterator, bool> insert(key_type key, val_type val);
+        Pair<iterator, bool> insert(key_type &&key, val_type &&val);
+
+        /**
+         * Insert an element whose value is built from the given
+         * arguments, if no element with the key exists. Otherwise the
+         * arguments are left untouched. A single argument is assigned
+         * to the value directly, so that a value such as a large static
+         * string is written once from a character string or moved from
+         * an rvalue.
+         * @tparam Args types of the value arguments
+         * @param key  inserted element key
+         * @param args arguments from which to build the value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        template<class... Args>
+        Pair<iterator, bool> try_emplace(const key_type &key, Args &&... args);
+
+        /**
+         * @see try_emplace()
+         * @param key  inserted element key, moved into the node
+         * @param args arguments from which to build the value
+         */
+        template<class... Args>
+        Pair<iterator, bool> try_emplace(key_type &&key, Args &&... args);
+
+        /**
+         * Insert an element whose key and value are built from the
+         * given arguments, if no element with the key exists. The key
+         * may be any type from which the key type can be constructed,
+         * such as a character string for static string keys.
+         * @tparam K    type of the key argument
+         * @tparam Args types of the value arguments
+         * @param key  argument from which to build the key
+         * @param args arguments from which to build the value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        template<class K, class... Args>
+        Pair<iterator, bool> emplace(K &&key, Args &&... args);
 
         /**
          * Attempt to insert an element into the map.
@@ -613,13 +1132,14 @@ namespace wlp {
          * inserted element or the assigned element, and a bool
          * indicating whether insertion occurred
          */
-        Pair<iterator, bool> insert_or_assign(key_type key, val_type val);
+        Pair<iterator, bool> insert_or_assign(const key_type &key, const val_type &val);
 
         /**
          * Erase the element from the map pointed to by the provided
-         * iterator. Be aware that erasure operations on an openly
-         * addressed hash map will trigger a rehash and invalidate
-         * all iterators other than the return value.
+         * iterator. Elements after it in the same probe sequence are
+         * shifted back into the freed bucket, which invalidates iterators
+         * to them. An element shifted across the end of the backing array
+         * may be visited twice by an iteration that erases as it goes.
          * @param pos iterator pointing to the element to erase
          * @return iterator to the next element in the map or end
          */
@@ -627,9 +1147,10 @@ namespace wlp {
 
         /**
          * Erase the element from the map pointed to by the provided
-         * const iterator. Be aware that erasure operations on an openly
-         * addressed hash map will trigger a rehash and invalidate
-         * all iterators other than the return value.
+         * const iterator. Elements after it in the same probe sequence are
+         * shifted back into the freed bucket, which invalidates iterators
+         * to them. An element shifted across the end of the backing array
+         * may be visited twice by an iteration that erases as it goes.
          * @param pos const iterator pointing to the element to erase
          * @return const iterator to the next element in the map or end
          */
@@ -637,12 +1158,8 @@ namespace wlp {
 
         /**
          * Erase the element from the map with the provided key, if such
-         * an element exists. Be aware that if erasure if performed, the
-         * hash map will undergo a rehash.
-         *
-         * @pre If frequency use of erase operations is needed, one is
-         *      recommended to use @code ChainHashMap @encode or a
-         *      tree-based implementation.
+         * an element exists. Erasure uses backward shift deletion, so its
+         * cost is bounded by the probe length and it never allocates.
          *
          * @param key the key whose corresponding element to erase
          * @return true if an element was erased
@@ -687,11 +1204,120 @@ namespace wlp {
          */
         const_iterator find(const key_type &key) const;
 
+        /**
+         * Count the buckets inspected when looking up a key, which
+         * is one for a key found in its home bucket. A miss counts the
+         * buckets up to and including the one showing that the key is
+         * absent. Intended for measuring the quality of the hash function
+         * and of the index and probe policies.
+         * @param key the key to look up
+         * @return the probe length of the lookup
+         */
+        size_type probe_length(const key_type &key) const;
+
+        /**
+         * Rehash the map into a backing array of at least the given
+         * capacity, or of the capacity needed to hold the current
+         * elements if that is larger. The map is always rehashed, which
+         * drops tombstones and finishes an incremental rehash.
+         * Invalidates all iterators.
+         * @param n the minimum capacity
+         */
+        void rehash(size_type n);
+
+        /**
+         * Grow the backing array once so that the given number of
+         * elements fit without any further rehash. Does nothing if the
+         * map is already large enough.
+         * @param n the number of elements to hold
+         */
+        void reserve(size_type n);
+
+        /**
+         * Insert the key-value pairs of a range, growing the backing
+         * array at most once beforehand. Keys already in the map, or
+         * repeated in the range, keep their first value.
+         *
+         * @pre the range can be traversed twice
+         *
+         * @tparam InputIt iterator to pairs of keys and values
+         * @param first the first pair to insert
+         * @param last  pass-the-end of the range
+         */
+        template<class InputIt, class = decltype((*declval<InputIt &>()).first())>
+        void insert(InputIt first, InputIt last);
+
+        /**
+         * Erase every element for which the predicate holds, in a
+         * single pass over the backing array that never hashes a key
+         * again and never allocates. Invalidates all iterators.
+         * @tparam Predicate function of a key and a value returning bool
+         * @param pred the predicate selecting elements to erase
+         * @return the number of erased elements
+         */
+        template<class Predicate>
+        size_type erase_if(Predicate pred);
+
+        /**
+         * Erase the element whose key compares equal to a key of
+         * another type, such as a character string in a map keyed by
+         * static strings. These overloads are only available if the
+         * hasher and the equality function are transparent, and the
+         * lookup key is never converted to the key type.
+         * @param key the key whose corresponding element to erase
+         * @return true if an element was erased
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        bool erase(const K &key);
+
+        /**
+         * @see OpenHashMap<Key, Val, Hasher, Equals>::at()
+         * @param key a key of another type
+         * @return an iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        iterator at(const K &key);
+
+        /**
+         * @see OpenHashMap<Key, Val, Hasher, Equals>::at()
+         * @param key a key of another type
+         * @return a const iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        const_iterator at(const K &key) const;
+
+        /**
+         * @param key a key of another type
+         * @return true if the key maps to a value
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        bool contains(const K &key) const;
+
+        /**
+         * @see OpenHashMap<Key, Val, Hasher, Equals>::find()
+         * @param key a key of another type
+         * @return an iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        iterator find(const K &key);
+
+        /**
+         * @see OpenHashMap<Key, Val, Hasher, Equals>::find()
+         * @param key a key of another type
+         * @return a const iterator to the element mapped by the key
+         */
+        template<class K, class = typename transparent_key<K>::type>
+        const_iterator find(const K &key) const;
+
         /**
          * Access an element in the hash map by the given key.
          * If the key does not map to any value in the map,
          * then a new value is created and inserted using the default
          * constructor.
+         *
+         * @pre the map holds the key or can take another element, which
+         *      only fails once the map cannot grow; use insert to detect it
+         *
          * @param key the key whose value to access
          * @return a reference to the mapped value
          */
@@ -713,358 +1339,756 @@ namespace wlp {
         map_type &operator=(map_type &&map);
     };
 
-    template<class Key, class Val, class Hasher, class Equals>
-    void OpenHashMap<Key, Val, Hasher, Equals>::init_buckets(OpenHashMap<Key, Val, Hasher, Equals>::size_type n) {
-        m_buckets = static_cast<node_type **>(memory_alloc(n * sizeof(node_type *)));
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::init_buckets(OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type n) {
+        node_type **buckets = memory_alloc_array<node_type *>(n);
+        size_type *distances = Probe::ROBIN_HOOD ? memory_alloc_array<size_type>(n) : nullptr;
+        hash_code *hashes = Cache::STORE_HASH ? memory_alloc_array<hash_code>(n) : nullptr;
+        if (!buckets || (Probe::ROBIN_HOOD && !distances) || (Cache::STORE_HASH && !hashes)) {
+            memory_free(buckets);
+            memory_free(distances);
+            memory_free(hashes);
+            return false;
+        }
         for (size_type i = 0; i < n; ++i) {
-            m_buckets[i] = nullptr;
+            buckets[i] = nullptr;
         }
+        m_buckets = buckets;
+        m_distances = distances;
+        m_hashes = hashes;
+        return true;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    void OpenHashMap<Key, Val, Hasher, Equals>::ensure_capacity() {
-        if (m_num_elements * 100 < m_max_load * m_capacity) {
-            return;
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::probe(const K &key, size_type &length) const {
+        hash_code code = m_hash(key);
+        size_type i = Index::index(code, m_capacity);
+        length = 1;
+        while (m_buckets[i]) {
+            // an element closer to its home than the key would be
+            // proves that the key is not further along
+            if (Probe::ROBIN_HOOD && m_distances[i] < length - 1) {
+                break;
+            }
+            if (occupied(m_buckets[i]) &&
+                (!Cache::STORE_HASH || m_hashes[i] == code) &&
+                m_equal(key, m_buckets[i]->m_key)) {
+                return i;
+            }
+            i = Probe::next(i, length, m_capacity);
+            ++length;
         }
-        size_type new_capacity = static_cast<size_type>(m_capacity * 2);
-        node_type **new_buckets = static_cast<node_type **>(memory_alloc(new_capacity * sizeof(node_type *)));
-        for (size_type i = 0; i < new_capacity; ++i) {
-            new_buckets[i] = nullptr;
+        return m_capacity;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::find_old_index(const K &key, hash_code code) const {
+        size_type i = Index::index(code, m_old_capacity);
+        size_type length = 1;
+        while (m_old_buckets[i]) {
+            if (Probe::ROBIN_HOOD && m_old_distances[i] < length - 1) {
+                break;
+            }
+            if (occupied(m_old_buckets[i]) &&
+                (!Cache::STORE_HASH || m_old_hashes[i] == code) &&
+                m_equal(key, m_old_buckets[i]->m_key)) {
+                return i;
+            }
+            i = Probe::next(i, length, m_old_capacity);
+            ++length;
         }
-        for (size_type i = 0; i < m_capacity; ++i) {
-            if (!m_buckets[i]) {
-                continue;
+        return m_old_capacity;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert_slot(const key_type &key) {
+        hash_code code = m_hash(key);
+        if (Resize::INCREMENTAL && m_old_capacity) {
+            size_type i = find_old_index(key, code);
+            if (i != m_old_capacity) {
+                return static_cast<size_type>(m_capacity + i);
             }
-            node_type *node = m_buckets[i];
-            size_type k = bucket_index(node->m_key, new_capacity);
-            while (new_buckets[k]) {
-                if (++k >= new_capacity) {
-                    k = 0;
+        }
+        return insert_index(key, code);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert_index(const key_type &key, hash_code code) {
+        size_type i = Index::index(code, m_capacity);
+        size_type step = 0;
+        size_type first_tombstone = m_capacity;
+        while (m_buckets[i]) {
+            if (!occupied(m_buckets[i])) {
+                if (first_tombstone == m_capacity) {
+                    first_tombstone = i;
                 }
+            } else if ((!Cache::STORE_HASH || m_hashes[i] == code) && m_equal(key, m_buckets[i]->m_key)) {
+                return i;
+            } else if (Probe::ROBIN_HOOD && m_distances[i] < step) {
+                shift_forward(i);
+                m_distances[i] = step;
+                break;
             }
-            new_buckets[k] = node;
+            i = Probe::next(i, ++step, m_capacity);
+        }
+        if (first_tombstone != m_capacity) {
+            m_buckets[first_tombstone] = nullptr;
+            --m_num_tombstones;
+            i = first_tombstone;
+        } else if (Probe::ROBIN_HOOD) {
+            m_distances[i] = step;
+        }
+        if (Cache::STORE_HASH) {
+            m_hashes[i] = code;
+        }
+        return i;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::shift_forward(size_type i) {
+        size_type j = i;
+        do {
+            if (++j >= m_capacity) {
+                j = 0;
+            }
+        } while (m_buckets[j]);
+        while (j != i) {
+            size_type prev = static_cast<size_type>((j == 0 ? m_capacity : j) - 1);
+            move_bucket(j, prev);
+            m_distances[j] = static_cast<size_type>(m_distances[prev] + 1);
+            j = prev;
+        }
+        m_buckets[i] = nullptr;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::remove_at(size_type i) {
+        --m_num_elements;
+        destroy_node(slot(i));
+        if (i >= m_capacity) {
+            // the old array only ever loses elements, so tombstones suffice
+            slot(i) = tombstone();
+            return;
+        }
+        if (Probe::TOMBSTONES) {
+            m_buckets[i] = tombstone();
+            ++m_num_tombstones;
+        } else {
+            shift_back(i);
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::free_old_buckets() {
+        memory_free(m_old_buckets);
+        if (m_old_distances) {
+            memory_free(m_old_distances);
+        }
+        if (m_old_hashes) {
+            memory_free(m_old_hashes);
+        }
+        init_old_buckets();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::move_buckets(size_type n) {
+        size_type end = m_old_capacity - m_num_moved < n ? m_old_capacity : static_cast<size_type>(m_num_moved + n);
+        for (; m_num_moved < end; ++m_num_moved) {
+            node_type *node = m_old_buckets[m_num_moved];
+            if (occupied(node)) {
+                hash_code code = Cache::STORE_HASH ? m_old_hashes[m_num_moved] : m_hash(node->m_key);
+                m_buckets[insert_index(node->m_key, code)] = node;
+                m_old_buckets[m_num_moved] = tombstone();
+            }
+        }
+        if (m_num_moved == m_old_capacity) {
+            free_old_buckets();
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::ensure_capacity() {
+        if (Resize::INCREMENTAL && m_old_capacity) {
+            move_buckets(m_move_step);
+        }
+        size_type num_used = static_cast<size_type>(m_num_elements + m_num_tombstones);
+        wide_size_type max_used = static_cast<wide_size_type>(m_max_load) * m_capacity;
+        if (static_cast<wide_size_type>(num_used) * 100 < max_used && num_used + 1 < m_capacity) {
+            return true;
+        }
+        size_type new_capacity = grow_capacity(m_capacity);
+        if (m_num_tombstones > 0 && static_cast<wide_size_type>(m_num_elements) * 200 < max_used) {
+            new_capacity = m_capacity;
+        }
+        if (new_capacity == m_capacity && m_num_tombstones == 0) {
+            // the size type cannot hold a larger capacity, so the map
+            // fills up beyond its maximum load but keeps an empty bucket
+            return num_used + 1 < m_capacity;
+        }
+        if (Resize::INCREMENTAL) {
+            // finishes at once only if the step was too small, which
+            // the step chosen below prevents
+            if (m_old_capacity) {
+                move_buckets(m_old_capacity);
+            }
+            node_type **old_buckets = m_buckets;
+            size_type *old_distances = m_distances;
+            hash_code *old_hashes = m_hashes;
+            size_type old_capacity = m_capacity;
+            if (!init_buckets(new_capacity)) {
+                // the size type cannot hold the larger arrays, or there is
+                // no memory for them, so the map fills beyond its maximum load
+                return num_used + 1 < m_capacity;
+            }
+            m_capacity = new_capacity;
+            m_num_tombstones = 0;
+            m_old_buckets = old_buckets;
+            m_old_distances = old_distances;
+            m_old_hashes = old_hashes;
+            m_old_capacity = old_capacity;
+            m_num_moved = 0;
+            size_type limit = static_cast<size_type>(static_cast<wide_size_type>(m_max_load) * new_capacity / 100);
+            if (limit >= new_capacity) {
+                limit = static_cast<size_type>(new_capacity - 1);
+            }
+            size_type budget = static_cast<size_type>(limit > m_num_elements ? limit - m_num_elements : 0);
+            m_move_step = IncrementalRehash::step(old_capacity, budget);
+            move_buckets(m_move_step);
+            return true;
+        }
+        if (!rehash_to(new_capacity)) {
+            return num_used + 1 < m_capacity;
+        }
+        return m_num_elements + 1 < m_capacity;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::rehash_to(size_type new_capacity) {
+        if (Resize::INCREMENTAL && m_old_capacity) {
+            move_buckets(m_old_capacity);
+        }
+        node_type **old_buckets = m_buckets;
+        size_type *old_distances = m_distances;
+        hash_code *old_hashes = m_hashes;
+        size_type old_capacity = m_capacity;
+        if (!init_buckets(new_capacity)) {
+            return false;
         }
-        memory_free(m_buckets);
-        m_buckets = new_buckets;
         m_capacity = new_capacity;
+        m_num_tombstones = 0;
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (occupied(old_buckets[i])) {
+                const key_type &key = old_buckets[i]->m_key;
+                hash_code code = Cache::STORE_HASH ? old_hashes[i] : m_hash(key);
+                m_buckets[insert_index(key, code)] = old_buckets[i];
+            }
+        }
+        memory_free(old_buckets);
+        if (old_distances) {
+            memory_free(old_distances);
+        }
+        if (old_hashes) {
+            memory_free(old_hashes);
+        }
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::capacity_for(size_type n) const {
+        if (n == 0) {
+            return 1;
+        }
+        wide_size_type capacity = static_cast<wide_size_type>(n - 1) * 100 / (m_max_load ? m_max_load : 1) + 1;
+        if (capacity <= n) {
+            capacity = static_cast<wide_size_type>(n) + 1;
+        }
+        if (capacity > max_size_type) {
+            capacity = max_size_type;
+        }
+        return Index::capacity(static_cast<size_type>(capacity));
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    void OpenHashMap<Key, Val, Hasher, Equals>::clear() noexcept {
-        for (size_type i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i]) {
-                m_node_allocator.Deallocate(m_buckets[i]);
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::compact(size_type start) {
+        size_type i = start;
+        for (size_type n = 1; n < m_capacity; ++n) {
+            if (++i >= m_capacity) {
+                i = 0;
+            }
+            if (!m_buckets[i]) {
+                continue;
+            }
+            size_type home = Probe::ROBIN_HOOD
+                             ? static_cast<size_type>(i >= m_distances[i] ? i - m_distances[i] : i + m_capacity - m_distances[i])
+                             : home_index(i);
+            // every element before this one is already in place, so the
+            // first empty bucket from the home bucket is where it belongs
+            size_type j = home;
+            size_type distance = 0;
+            while (j != i && m_buckets[j]) {
+                j = LinearProbe::next(j, ++distance, m_capacity);
+            }
+            if (j != i) {
+                move_bucket(j, i);
                 m_buckets[i] = nullptr;
+                if (Probe::ROBIN_HOOD) {
+                    m_distances[j] = distance;
+                }
             }
         }
-        m_num_elements = 0;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    Pair<typename OpenHashMap<Key, Val, Hasher, Equals>::iterator, bool>
-    OpenHashMap<Key, Val, Hasher, Equals>::insert(key_type key, val_type val) {
-        ensure_capacity();
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::shift_back(size_type hole) {
+        size_type i = hole;
+        while (true) {
             if (++i >= m_capacity) {
                 i = 0;
             }
+            if (!m_buckets[i]) {
+                break;
+            }
+            if (Probe::ROBIN_HOOD) {
+                // elements in their home bucket start a new cluster
+                if (m_distances[i] == 0) {
+                    break;
+                }
+                move_bucket(hole, i);
+                m_distances[hole] = static_cast<size_type>(m_distances[i] - 1);
+                hole = i;
+                continue;
+            }
+            size_type home = home_index(i);
+            // the element may fill the hole only if the hole lies between
+            // its home bucket and its current bucket along the probe direction
+            size_type to_home = static_cast<size_type>(i >= home ? i - home : i + m_capacity - home);
+            size_type to_hole = static_cast<size_type>(i >= hole ? i - hole : i + m_capacity - hole);
+            if (to_home >= to_hole) {
+                move_bucket(hole, i);
+                hole = i;
+            }
         }
-        if (m_buckets[i]) {
-            return Pair<iterator, bool>(iterator(m_buckets[i], this), false);
+        m_buckets[hole] = nullptr;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::clear() noexcept {
+        for (size_type i = 0; i < num_slots(); ++i) {
+            if (occupied(slot(i))) {
+                destroy_node(slot(i));
+            }
+            slot(i) = nullptr;
+        }
+        if (m_old_buckets) {
+            free_old_buckets();
+        }
+        m_num_elements = 0;
+        m_num_tombstones = 0;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class... Args>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::emplace_key(K &&key, Args &&... args) {
+        if (!ensure_capacity()) {
+            // no bucket may be filled, but the element may exist
+            size_type i = find_index(key);
+            return Pair<iterator, bool>(i == num_slots() ? end() : iterator(slot(i), this, i), false);
+        }
+        size_type i = insert_slot(key);
+        if (slot(i)) {
+            return Pair<iterator, bool>(iterator(slot(i), this, i), false);
         } else {
             ++m_num_elements;
-            node_type *node = static_cast<node_type *>(m_node_allocator.Allocate());
-            node->m_key = key;
-            node->m_val = val;
+            node_type *node = create_node(forward<K>(key), forward<Args>(args)...);
             m_buckets[i] = node;
-            return Pair<iterator, bool>(iterator(node, this), true);
+            return Pair<iterator, bool>(iterator(node, this, i), true);
         }
-    };
+    }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    Pair<typename OpenHashMap<Key, Val, Hasher, Equals>::iterator, bool>
-    OpenHashMap<Key, Val, Hasher, Equals>::insert_or_assign(key_type key, val_type val) {
-        ensure_capacity();
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert(const key_type &key, const val_type &val) {
+        return emplace_key(key, val);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert(key_type &&key, val_type &&val) {
+        return emplace_key(move(key), move(val));
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class... Args>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::try_emplace(const key_type &key, Args &&... args) {
+        return emplace_key(key, forward<Args>(args)...);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class... Args>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::try_emplace(key_type &&key, Args &&... args) {
+        return emplace_key(move(key), forward<Args>(args)...);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class... Args>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::emplace(K &&key, Args &&... args) {
+        return emplace_key(key_type(forward<K>(key)), forward<Args>(args)...);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    Pair<typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator, bool>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert_or_assign(const key_type &key, const val_type &val) {
+        if (!ensure_capacity()) {
+            size_type i = find_index(key);
+            if (i == num_slots()) {
+                return Pair<iterator, bool>(end(), false);
             }
+            slot(i)->value() = val;
+            return Pair<iterator, bool>(iterator(slot(i), this, i), false);
         }
-        if (m_buckets[i]) {
-            m_buckets[i]->m_val = val;
-            return Pair<iterator, bool>(iterator(m_buckets[i], this), false);
+        size_type i = insert_slot(key);
+        if (slot(i)) {
+            slot(i)->value() = val;
+            return Pair<iterator, bool>(iterator(slot(i), this, i), false);
         } else {
             ++m_num_elements;
-            node_type *node = static_cast<node_type *>(m_node_allocator.Allocate());
-            node->m_key = key;
-            node->m_val = val;
+            node_type *node = create_node(key, val);
             m_buckets[i] = node;
-            return Pair<iterator, bool>(iterator(node, this), true);
+            return Pair<iterator, bool>(iterator(node, this, i), true);
         }
-    };
+    }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::iterator &
-    OpenHashMap<Key, Val, Hasher, Equals>::erase(iterator &pos) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator &
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::erase(iterator &pos) {
         const node_type *cur_node = pos.m_current;
         if (!cur_node || pos.m_hash_map != this) {
             pos.m_current = nullptr;
             return pos;
         }
-        size_type i = hash(cur_node->m_key);
-        while (m_buckets[i] && !m_equal(cur_node->m_key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
-        }
-        if (!m_buckets[i]) {
+        size_type i = pos.m_index;
+        if (i >= num_slots() || slot(i) != cur_node) {
             pos.m_current = nullptr;
             return pos;
         }
-        --m_num_elements;
-        m_node_allocator.Deallocate(m_buckets[i]);
-        m_buckets[i] = nullptr;
-        while (++i < m_capacity && !m_buckets[i]);
-        node_type *next_node = i >= m_capacity ? nullptr : m_buckets[i];
-        node_type **new_buckets = static_cast<node_type **>(memory_alloc(m_capacity * sizeof(node_type *)));
-        for (size_type k = 0; k < m_capacity; k++) {
-            new_buckets[k] = nullptr;
-        }
-        for (size_type k = 0; k < m_capacity; k++) {
-            if (!m_buckets[k]) {
-                continue;
-            }
-            node_type *node = m_buckets[k];
-            size_type j = hash(node->m_key);
-            while (new_buckets[j]) {
-                if (++j >= m_capacity) {
-                    j = 0;
-                }
-            }
-            new_buckets[j] = node;
-        }
-        memory_free(m_buckets);
-        m_buckets = new_buckets;
-        pos.m_current = next_node;
+        remove_at(i);
+        // an element shifted into the freed bucket is the next one
+        while (!occupied(slot(i)) && ++i < num_slots());
+        pos.m_current = i >= num_slots() ? nullptr : slot(i);
+        pos.m_index = i;
         return pos;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    bool OpenHashMap<Key, Val, Hasher, Equals>::erase(key_type &key) {
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
-        }
-        if (!m_buckets[i]) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::erase(key_type &key) {
+        size_type i = find_index(key);
+        if (i == num_slots()) {
             return false;
         }
-        --m_num_elements;
-        m_node_allocator.Deallocate(m_buckets[i]);
-        m_buckets[i] = nullptr;
-        node_type **new_buckets = static_cast<node_type **>(memory_alloc(m_capacity * sizeof(node_type *)));
-        for (size_type k = 0; k < m_capacity; k++) {
-            new_buckets[k] = nullptr;
-        }
-        for (size_type k = 0; k < m_capacity; k++) {
-            if (!m_buckets[k]) {
-                continue;
-            }
-            node_type *node = m_buckets[k];
-            size_type j = hash(node->m_key);
-            while (new_buckets[j]) {
-                if (++j >= m_capacity) {
-                    j = 0;
-                }
-            }
-            new_buckets[j] = node;
-        }
-        memory_free(m_buckets);
-        m_buckets = new_buckets;
+        remove_at(i);
         return true;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::iterator
-    OpenHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) {
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
-        }
-        if (m_buckets[i]) {
-            return iterator(m_buckets[i], this);
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::at(const key_type &key) {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return iterator(slot(i), this, i);
         } else {
             return end();
         }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::const_iterator
-    OpenHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) const {
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
-        }
-        if (m_buckets[i]) {
-            return const_iterator(m_buckets[i], this);
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::const_iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::at(const key_type &key) const {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return const_iterator(slot(i), this, i);
         } else {
             return end();
         }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    bool OpenHashMap<Key, Val, Hasher, Equals>::contains(const key_type &key) const {
-        size_type i = hash(key);
-        while (m_buckets[i]) {
-            if (m_equal(key, m_buckets[i]->m_key)) {
-                return true;
-            }
-            if (++i > +m_capacity) {
-                i = 0;
-            }
-        }
-        return false;
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::contains(const key_type &key) const {
+        return find_index(key) != num_slots();
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::val_type &
-    OpenHashMap<Key, Val, Hasher, Equals>::operator[](const key_type &key) {
-        ensure_capacity();
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
-        }
-        if (m_buckets[i]) {
-            return m_buckets[i]->m_val;
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::val_type &
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator[](const key_type &key) {
+        bool room = ensure_capacity();
+        size_type i = insert_slot(key);
+        if (slot(i)) {
+            return slot(i)->value();
         } else {
+            // taking the last empty bucket would leave later probes
+            // looping forever; insert reports a full map instead
+            assert(room);
             ++m_num_elements;
-            node_type *node = static_cast<node_type *>(m_node_allocator.Allocate());
-            node->m_key = key;
-            node->m_val = val_type();
+            node_type *node = create_node(key);
             m_buckets[i] = node;
-            return node->m_val;
+            return node->value();
         }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::iterator
-    OpenHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) {
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::find(const key_type &key) {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return iterator(slot(i), this, i);
+        } else {
+            return end();
         }
-        if (m_buckets[i]) {
-            return iterator(m_buckets[i], this);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::const_iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::find(const key_type &key) const {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return const_iterator(slot(i), this, i);
         } else {
             return end();
         }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    typename OpenHashMap<Key, Val, Hasher, Equals>::const_iterator
-    OpenHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) const {
-        size_type i = hash(key);
-        while (m_buckets[i] && !m_equal(key, m_buckets[i]->m_key)) {
-            if (++i >= m_capacity) {
-                i = 0;
-            }
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::probe_length(const key_type &key) const {
+        size_type length;
+        probe(key, length);
+        return length;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::erase(const K &key) {
+        size_type i = find_index(key);
+        if (i == num_slots()) {
+            return false;
         }
-        if (m_buckets[i]) {
-            return const_iterator(m_buckets[i], this);
+        remove_at(i);
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::at(const K &key) {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::const_iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::at(const K &key) const {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    bool OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::contains(const K &key) const {
+        return find_index(key) != num_slots();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::find(const K &key) {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return iterator(slot(i), this, i);
         } else {
             return end();
         }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    OpenHashMap<Key, Val, Hasher, Equals>::~OpenHashMap() {
-        if (!m_buckets) {
-            return;
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class K, class>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::const_iterator
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::find(const K &key) const {
+        size_type i = find_index(key);
+        if (i != num_slots()) {
+            return const_iterator(slot(i), this, i);
+        } else {
+            return end();
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::rehash(size_type n) {
+        size_type needed = capacity_for(m_num_elements);
+        rehash_to(Index::capacity(n > needed ? n : needed));
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::reserve(size_type n) {
+        size_type needed = capacity_for(n);
+        if (needed > m_capacity) {
+            rehash_to(needed);
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class InputIt, class>
+    void OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::insert(InputIt first, InputIt last) {
+        size_type n = 0;
+        for (InputIt it = first; it != last; ++it) {
+            ++n;
+        }
+        reserve(static_cast<size_type>(m_num_elements + n));
+        for (; first != last; ++first) {
+            insert((*first).first(), (*first).second());
         }
-        for (size_type i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i]) {
-                m_node_allocator.Deallocate(m_buckets[i]);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    template<class Predicate>
+    typename OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::size_type
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::erase_if(Predicate pred) {
+        size_type start = 0;
+        while (start < m_capacity && m_buckets[start]) {
+            ++start;
+        }
+        size_type num_erased = 0;
+        for (size_type i = 0; i < num_slots(); ++i) {
+            node_type *node = slot(i);
+            if (!occupied(node) || !pred(node->m_key, node->value())) {
+                continue;
+            }
+            destroy_node(node);
+            ++num_erased;
+            if (i >= m_capacity || Probe::TOMBSTONES) {
+                slot(i) = tombstone();
+                if (i < m_capacity) {
+                    ++m_num_tombstones;
+                }
+            } else {
                 m_buckets[i] = nullptr;
             }
         }
+        m_num_elements = static_cast<size_type>(m_num_elements - num_erased);
+        if (!Probe::TOMBSTONES && num_erased > 0) {
+            compact(start);
+        }
+        return num_erased;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::~OpenHashMap() {
+        if (!m_buckets) {
+            return;
+        }
+        clear();
         memory_free(m_buckets);
         m_buckets = nullptr;
+        if (m_distances) {
+            memory_free(m_distances);
+            m_distances = nullptr;
+        }
+        if (m_hashes) {
+            memory_free(m_hashes);
+            m_hashes = nullptr;
+        }
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    OpenHashMap<Key, Val, Hasher, Equals> &
-    OpenHashMap<Key, Val, Hasher, Equals>::operator=(OpenHashMap<Key, Val, Hasher, Equals> &&map) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> &
+    OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator=(OpenHashMap<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> &&map) {
         clear();
         memory_free(m_buckets);
+        if (m_distances) {
+            memory_free(m_distances);
+        }
+        if (m_hashes) {
+            memory_free(m_hashes);
+        }
         m_node_allocator = move(map.m_node_allocator);
         m_capacity = move(map.m_capacity);
         m_max_load = move(map.m_max_load);
         m_num_elements = move(map.m_num_elements);
+        m_num_tombstones = move(map.m_num_tombstones);
         m_buckets = move(map.m_buckets);
+        m_distances = move(map.m_distances);
+        m_hashes = move(map.m_hashes);
+        m_old_buckets = move(map.m_old_buckets);
+        m_old_distances = move(map.m_old_distances);
+        m_old_hashes = move(map.m_old_hashes);
+        m_old_capacity = move(map.m_old_capacity);
+        m_num_moved = move(map.m_num_moved);
+        m_move_step = move(map.m_move_step);
+        map.init_old_buckets();
         map.m_capacity = 0;
         map.m_num_elements = 0;
+        map.m_num_tombstones = 0;
         map.m_buckets = nullptr;
+        map.m_distances = nullptr;
+        map.m_hashes = nullptr;
         return *this;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    OpenHashMapIterator<Key, Val, Hasher, Equals> &
-    OpenHashMapIterator<Key, Val, Hasher, Equals>::operator++() {
-        size_type i = m_hash_map->hash(m_current->m_key);
-        while (m_hash_map->m_buckets[i] && !m_hash_map->m_equal(m_current->m_key, m_hash_map->m_buckets[i]->m_key)) {
-            if (++i >= m_hash_map->m_capacity) {
-                i = 0;
-            }
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> &
+    OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator++() {
+        size_type i = m_index;
+        // elements shifted back by an erase are found again by key
+        if (i >= m_hash_map->num_slots() || m_hash_map->slot(i) != m_current) {
+            i = m_hash_map->find_index(m_current->m_key);
         }
-        while (++i < m_hash_map->m_capacity && !m_hash_map->m_buckets[i]);
-        if (i == m_hash_map->m_capacity) {
+        while (++i < m_hash_map->num_slots() && !map_type::occupied(m_hash_map->slot(i)));
+        if (i >= m_hash_map->num_slots()) {
             m_current = nullptr;
         } else {
-            m_current = m_hash_map->m_buckets[i];
+            m_current = m_hash_map->slot(i);
+            m_index = i;
         }
         return *this;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    inline OpenHashMapIterator<Key, Val, Hasher, Equals>
-    OpenHashMapIterator<Key, Val, Hasher, Equals>::operator++(int) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    inline OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>
+    OpenHashMapIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator++(int) {
         iterator tmp = *this;
         ++*this;
         return tmp;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    OpenHashMapConstIterator<Key, Val, Hasher, Equals> &
-    OpenHashMapConstIterator<Key, Val, Hasher, Equals>::operator++() {
-        size_type i = m_hash_map->hash(m_current->m_key);
-        while (m_hash_map->m_buckets[i] && !m_hash_map->m_equal(m_current->m_key, m_hash_map->m_buckets[i]->m_key)) {
-            if (++i >= m_hash_map->m_capacity) {
-                i = 0;
-            }
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize> &
+    OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator++() {
+        size_type i = m_index;
+        // elements shifted back by an erase are found again by key
+        if (i >= m_hash_map->num_slots() || m_hash_map->slot(i) != m_current) {
+            i = m_hash_map->find_index(m_current->m_key);
         }
-        while (++i < m_hash_map->m_capacity && !m_hash_map->m_buckets[i]);
-        if (i == m_hash_map->m_capacity) {
+        while (++i < m_hash_map->num_slots() && !map_type::occupied(m_hash_map->slot(i)));
+        if (i >= m_hash_map->num_slots()) {
             m_current = nullptr;
         } else {
-            m_current = m_hash_map->m_buckets[i];
+            m_current = m_hash_map->slot(i);
+            m_index = i;
         }
         return *this;
     }
 
-    template<class Key, class Val, class Hasher, class Equals>
-    inline OpenHashMapConstIterator<Key, Val, Hasher, Equals>
-    OpenHashMapConstIterator<Key, Val, Hasher, Equals>::operator++(int) {
+    template<class Key, class Val, class Hasher, class Equals, class Index, class Probe, class Cache, class Resize>
+    inline OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>
+    OpenHashMapConstIterator<Key, Val, Hasher, Equals, Index, Probe, Cache, Resize>::operator++(int) {
         const_iterator tmp = *this;
         ++*this;
         return tmp;
@@ -3,7 +3,8 @@
  * @brief Hash set implementation.
  *
  * Set implementation using an open addressed
- * hash map as the backing structure.
+ * hash map as the backing structure. The nodes
+ * of the backing map store each element once.
  *
  * @author Jeff Niu
  * @date November 4, 2017
@@ -23,22 +24,24 @@ namespace wlp {
      * An open hash set is created using a backing hash map,
      * and all available functions are a subset of the functions
      * of the hash map. The set contains unique elements.
+     * Iterators give constant access to the elements, since changing
+     * an element in place would leave it in the bucket of its old hash.
      * @tparam Key   the unique element type
      * @tparam Hash  the hash function of the stored elements
      * @tparam Equal test for equality function of the stored elements
      */
     template<class Key,
-            class Hash = Hash<Key, uint16_t>,
+            class Hash = Hash<Key, size_type>,
             class Equal = Equal<Key>>
     class OpenHashSet {
     public:
         typedef OpenHashSet<Key, Hash, Equal> hash_set;
-        typedef OpenHashMap<Key, Key, Hash, Equal> map_type;
-        typedef OpenHashMapIterator<Key, Key, Hash, Equal> iterator;
-        typedef OpenHashMapConstIterator<Key, Key, Hash, Equal> const_iterator;
-        typedef map_type::size_type size_type;
-        typedef map_type::percent_type percent_type;
-        typedef map_type::key_type key_type;
+        typedef OpenHashMap<Key, SetValue<Key>, Hash, Equal> map_type;
+        typedef OpenHashMapIterator<Key, SetValue<Key>, Hash, Equal> iterator;
+        typedef OpenHashMapConstIterator<Key, SetValue<Key>, Hash, Equal> const_iterator;
+        typedef typename map_type::size_type size_type;
+        typedef typename map_type::percent_type percent_type;
+        typedef typename map_type::key_type key_type;
 
     private:
         /**
@@ -170,7 +173,7 @@ namespace wlp {
          * @return a pair of an iterator and boolean
          */
         Pair<iterator, bool> insert(key_type key) {
-            return m_hash_map.insert(key, key);
+            return m_hash_map.try_emplace(move(key), SetValue<Key>());
         };
 
         /**
@@ -124,7 +124,7 @@ namespace wlp {
          * @param p the pair to compare
          * @return true if the pairs are equal
          */
-        bool operator==(const pair &p) {
+        bool operator==(const pair &p) const {
             return m_first == p.m_first && m_second == p.m_second;
         }
 
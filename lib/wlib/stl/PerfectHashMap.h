@@ -0,0 +1,332 @@
+/**
+ * @file PerfectHashMap.h
+ * @brief Compile-time perfect hash map over a fixed set of keys.
+ *
+ * The perfect hash map is built from a list of key and value entries
+ * that is known when the program is compiled, such as a command or
+ * parameter table. Its constructor is constexpr, so a map declared
+ * constexpr is computed entirely by the compiler, placed in read-only
+ * memory, and costs nothing at startup.
+ *
+ * Construction uses hash and displace. Every key is hashed into one
+ * of N buckets. Buckets holding several keys are placed first, the
+ * largest first: for each one a displacement is searched for that
+ * sends all of its keys to distinct free slots under a rehash seeded
+ * by the displacement. Buckets holding a single key are then given
+ * the remaining free slots directly. The N entries fill exactly N
+ * slots, so there is no empty slot and no collision.
+ *
+ * A lookup hashes the key once, reads the displacement of its bucket,
+ * and compares the key with the single slot it selects.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_PERFECTHASHMAP_H
+#define EMBEDDEDCPLUSPLUS_PERFECTHASHMAP_H
+
+#include "Equal.h"
+#include "Hash.h"
+
+namespace wlp {
+
+    /**
+     * Key and value pair of a perfect hash map. The entry is an
+     * aggregate so that entry lists can be written as constant
+     * brace initializers.
+     * @tparam Key key type
+     * @tparam Val value type
+     */
+    template<class Key, class Val>
+    struct PerfectHashEntry {
+        typedef Key key_type;
+        typedef Val val_type;
+        /**
+         * The key of the entry.
+         */
+        key_type m_key;
+        /**
+         * The value of the entry.
+         */
+        val_type m_val;
+    };
+
+    /**
+     * Seeded finalizer of a 32-bit hash code. Different seeds give
+     * independent looking reductions of the same hash code.
+     * @param hash the hash code of a key
+     * @param seed the seed
+     * @return the mixed hash code
+     */
+    constexpr uint32_t perfect_hash_mix(uint32_t hash, uint32_t seed) {
+        uint32_t h = hash ^ (seed * 0x9e3779b9u);
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /**
+     * Reduce a mixed hash code to the range [0, n) with a multiply and
+     * shift instead of a division.
+     * @param hash the mixed hash code
+     * @param n    the size of the range
+     * @return an index i such that 0 <= i < n
+     */
+    constexpr size_type perfect_hash_reduce(uint32_t hash, size_type n) {
+        return static_cast<size_type>((static_cast<uint64_t>(hash) * n) >> 32);
+    }
+
+    /**
+     * Hash map over a fixed set of N keys with no collisions. Keys and
+     * values must be literal types for the map to be built at compile
+     * time; character strings, integers and function pointers are.
+     * Every key must hash to a different 32-bit hash code, otherwise
+     * the map is not valid.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam N      number of entries
+     * @tparam Hasher hash function, must be constexpr
+     * @tparam Equals key equality function, must be constexpr
+     */
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher = Hash<Key, uint32_t>,
+            class Equals = Equal <Key>>
+    class PerfectHashMap {
+    public:
+        typedef PerfectHashMap<Key, Val, N, Hasher, Equals> map_type;
+        typedef PerfectHashEntry<Key, Val> entry_type;
+        typedef const entry_type *const_iterator;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        static_assert(N > 0, "PerfectHashMap must hold at least one entry");
+
+        enum : uint32_t {
+            /**
+             * Bit set in the displacement of a bucket holding a
+             * single key, whose slot index is stored directly.
+             */
+            DIRECT = 0x80000000u,
+            /**
+             * Number of displacements tried for a bucket before
+             * the key set is given up as invalid.
+             */
+            MAX_DISPLACEMENT = 0x10000u
+        };
+
+    private:
+        /**
+         * Class hash function instance. Used to hash
+         * element keys.
+         */
+        Hasher m_hash;
+        /**
+         * Class key equality function. Used to test
+         * equality of element keys.
+         */
+        Equals m_equal;
+
+        /**
+         * Displacement of each bucket, or the slot index
+         * together with DIRECT for single key buckets.
+         */
+        uint32_t m_displace[N];
+        /**
+         * The entries, one per slot.
+         */
+        entry_type m_slots[N];
+
+        /**
+         * Whether a collision-free placement was found.
+         */
+        bool m_valid;
+
+        /**
+         * @param hash the hash code of a key
+         * @return the bucket of the key
+         */
+        static constexpr size_type bucket(uint32_t hash) {
+            return perfect_hash_reduce(perfect_hash_mix(hash, 0), N);
+        }
+
+        /**
+         * @param hash         the hash code of a key
+         * @param displacement the displacement of the key's bucket
+         * @return the slot of the key
+         */
+        static constexpr size_type slot(uint32_t hash, uint32_t displacement) {
+            return (displacement & DIRECT)
+                   ? static_cast<size_type>(displacement & ~static_cast<uint32_t>(DIRECT))
+                   : perfect_hash_reduce(perfect_hash_mix(hash, displacement), N);
+        }
+
+    public:
+        /**
+         * Build the map from a list of entries. Declaring the map
+         * constexpr performs the construction at compile time.
+         * @param entries the entries, whose keys must be distinct
+         */
+        constexpr explicit PerfectHashMap(const entry_type (&entries)[N]);
+
+        /**
+         * @return true if every key was placed without a collision,
+         * false if two keys share a hash code
+         */
+        constexpr bool valid() const {
+            return m_valid;
+        }
+
+        /**
+         * @return the number of entries
+         */
+        constexpr size_type size() const {
+            return N;
+        }
+
+        /**
+         * @return an iterator to the first entry, in slot order
+         */
+        constexpr const_iterator begin() const {
+            return m_slots;
+        }
+
+        /**
+         * @return a pass-the-end iterator
+         */
+        constexpr const_iterator end() const {
+            return m_slots + N;
+        }
+
+        /**
+         * Look up the value of a key with a single probe.
+         * @param key the key to find
+         * @return a pointer to the mapped value, or null if
+         * the key is not in the map
+         */
+        constexpr const val_type *find(const key_type &key) const;
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        constexpr bool contains(const key_type &key) const {
+            return find(key) != nullptr;
+        }
+    };
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    constexpr PerfectHashMap<Key, Val, N, Hasher, Equals>::PerfectHashMap(const entry_type (&entries)[N])
+            : m_hash(),
+              m_equal(),
+              m_displace(),
+              m_slots(),
+              m_valid(true) {
+        uint32_t hashes[N] = {};
+        size_type buckets[N] = {};
+        size_type bucket_sizes[N] = {};
+        bool taken[N] = {};
+        size_type largest = 0;
+        for (size_type i = 0; i < N; ++i) {
+            hashes[i] = m_hash(entries[i].m_key);
+            buckets[i] = bucket(hashes[i]);
+            if (++bucket_sizes[buckets[i]] > largest) {
+                largest = bucket_sizes[buckets[i]];
+            }
+        }
+        // place buckets with several keys, largest first, at the
+        // first displacement that sends all of their keys to free slots
+        size_type slots[N] = {};
+        for (size_type count = largest; count > 1; --count) {
+            for (size_type b = 0; b < N; ++b) {
+                if (bucket_sizes[b] != count) {
+                    continue;
+                }
+                uint32_t displacement = 1;
+                for (; displacement < MAX_DISPLACEMENT; ++displacement) {
+                    size_type placed = 0;
+                    for (size_type i = 0; i < N && placed < count; ++i) {
+                        if (buckets[i] != b) {
+                            continue;
+                        }
+                        size_type s = slot(hashes[i], displacement);
+                        bool available = !taken[s];
+                        for (size_type k = 0; k < placed && available; ++k) {
+                            available = slots[k] != s;
+                        }
+                        if (!available) {
+                            break;
+                        }
+                        slots[placed++] = s;
+                    }
+                    if (placed == count) {
+                        break;
+                    }
+                }
+                if (displacement == MAX_DISPLACEMENT) {
+                    m_valid = false;
+                    return;
+                }
+                m_displace[b] = displacement;
+                for (size_type i = 0; i < N; ++i) {
+                    if (buckets[i] == b) {
+                        size_type s = slot(hashes[i], displacement);
+                        taken[s] = true;
+                        m_slots[s] = entries[i];
+                    }
+                }
+            }
+        }
+        // single key buckets take the remaining slots in order
+        size_type next = 0;
+        for (size_type i = 0; i < N; ++i) {
+            if (bucket_sizes[buckets[i]] != 1) {
+                continue;
+            }
+            while (taken[next]) {
+                ++next;
+            }
+            taken[next] = true;
+            m_displace[buckets[i]] = DIRECT | static_cast<uint32_t>(next);
+            m_slots[next] = entries[i];
+        }
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    constexpr const typename PerfectHashMap<Key, Val, N, Hasher, Equals>::val_type *
+    PerfectHashMap<Key, Val, N, Hasher, Equals>::find(const key_type &key) const {
+        uint32_t hash = m_hash(key);
+        const entry_type &entry = m_slots[slot(hash, m_displace[bucket(hash)])];
+        return m_valid && m_equal(key, entry.m_key) ? &entry.m_val : nullptr;
+    }
+
+    /**
+     * Build a perfect hash map from a list of entries, deducing the
+     * number of entries. For instance
+     *
+     * @code
+     * constexpr auto commands = make_perfect_hash_map<const char *, handler>({
+     *         {"start", &start},
+     *         {"stop", &stop}});
+     * @endcode
+     *
+     * @tparam Key key type
+     * @tparam Val value type
+     * @param entries the entries, whose keys must be distinct
+     * @return the perfect hash map
+     */
+    template<class Key, class Val, size_type N>
+    constexpr PerfectHashMap<Key, Val, N> make_perfect_hash_map(const PerfectHashEntry<Key, Val> (&entries)[N]) {
+        return PerfectHashMap<Key, Val, N>(entries);
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_PERFECTHASHMAP_H
@@ -0,0 +1,319 @@
+/**
+ * @file SnapshotMap.h
+ * @brief Read-mostly hash map with read-copy-update snapshots.
+ *
+ * The snapshot hash map is meant for tables that are read far more often
+ * than they change, such as configuration and calibration tables. Readers
+ * look keys up in an immutable version of the table, a @code FlatHashMap @endcode,
+ * reached through a single pointer. A lookup is one pointer load followed by
+ * an ordinary flat map probe: there is no lock, no atomic read-modify-write
+ * and no fence on the read path, so lookups are wait-free.
+ *
+ * A writer copies the current version, applies its changes to the copy and
+ * publishes it with a single pointer store. The previous version is
+ * reclaimed once every reader has passed through a quiescent state, a point
+ * at which it holds no reference into any version; this is quiescent state
+ * based reclamation as used by read-copy-update. Reader threads register
+ * once, then announce quiescent states with @code quiescent @endcode, for
+ * instance once per iteration of their main loop, and go offline while
+ * they block for long periods. Pointers returned by lookups stay valid
+ * until the reader's next quiescent state.
+ *
+ * Two versions are kept, so a writer waits for the grace period of its own
+ * publication before returning; updates are expected to be rare.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SNAPSHOTMAP_H
+#define EMBEDDEDCPLUSPLUS_SNAPSHOTMAP_H
+
+#include "ConcurrentMap.h"
+#include "FlatMap.h"
+
+namespace wlp {
+
+    /**
+     * Record of a reader thread of a snapshot hash map. Each record sits in
+     * its own cache line so that announcing quiescent states does not cause
+     * false sharing between readers.
+     */
+    struct alignas(64) SnapshotReader {
+        /**
+         * The latest version the reader has announced a quiescent state in,
+         * or zero while the reader is offline.
+         */
+        uint32_t m_seen;
+        /**
+         * Set while the record is registered to a thread.
+         */
+        uint8_t m_in_use;
+    };
+
+    /**
+     * Hash map whose readers access immutable snapshots and whose
+     * writers publish new versions.
+     * @tparam Key         key type
+     * @tparam Val         value type
+     * @tparam Hasher      hash function
+     * @tparam Equals      key equality function
+     * @tparam tMaxReaders maximum number of registered reader threads
+     */
+    template<class Key,
+            class Val,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>,
+            uint16_t tMaxReaders = 8>
+    class SnapshotHashMap {
+    public:
+        typedef SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders> map_type;
+        typedef FlatHashMap<Key, Val, Hasher, Equals> version_type;
+        typedef SnapshotReader reader_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+        typedef uint8_t percent_type;
+
+    private:
+        /**
+         * The two versions of the table. The one not published is
+         * either empty or being built by a writer.
+         */
+        version_type m_versions[2];
+        /**
+         * The published version.
+         */
+        version_type *m_current;
+        /**
+         * Number of publications so far, starting at one.
+         */
+        uint32_t m_version;
+        /**
+         * Serializes writers.
+         */
+        ReadWriteSpinLock m_writer_lock;
+        /**
+         * Maximum load of new versions.
+         */
+        percent_type m_max_load;
+
+        reader_type m_readers[tMaxReaders];
+
+        /**
+         * Wait until every online reader has announced a quiescent state
+         * in the given version or later.
+         * @param version the version to wait for
+         */
+        void synchronize(uint32_t version);
+
+    public:
+        /**
+         * Create an empty snapshot hash map. The map must be constructed
+         * before other threads use it.
+         *
+         * @param n        initial number of slots of the first version
+         * @param max_load an integer value denoting the max percent load factor, e.g. 75 = 0.75
+         */
+        explicit SnapshotHashMap(
+                size_type n = 12,
+                percent_type max_load = 75)
+                : m_current(&m_versions[0]),
+                  m_version(1),
+                  m_max_load(max_load) {
+            m_versions[0] = version_type(n, max_load);
+            m_versions[1] = version_type(1, max_load);
+            for (reader_type &reader : m_readers) {
+                reader.m_seen = 0;
+                reader.m_in_use = 0;
+            }
+        }
+
+        SnapshotHashMap(const map_type &) = delete;
+
+        /**
+         * Claim a reader record for the calling thread. The reader
+         * starts online.
+         * @return the record or nullptr if all tMaxReaders records are in use
+         */
+        reader_type *register_reader();
+
+        /**
+         * Release a reader record.
+         * @param reader the record of the calling thread
+         */
+        void unregister_reader(reader_type *reader) {
+            offline(reader);
+            __atomic_store_n(&reader->m_in_use, 0, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Announce that the calling reader holds no reference into the map.
+         * Values found before this call may be reclaimed afterwards.
+         * @param reader the record of the calling thread
+         */
+        inline void quiescent(reader_type *reader) {
+            __atomic_store_n(&reader->m_seen, __atomic_load_n(&m_version, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Take the calling reader offline, for instance before it blocks.
+         * Writers do not wait for offline readers, which must not look up
+         * keys until they are online again.
+         * @param reader the record of the calling thread
+         */
+        inline void offline(reader_type *reader) {
+            __atomic_store_n(&reader->m_seen, 0u, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Bring the calling reader back online.
+         * @param reader the record of the calling thread
+         */
+        inline void online(reader_type *reader) {
+            __atomic_store_n(&reader->m_seen, __atomic_load_n(&m_version, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+            // the announcement must be visible before the reader loads the
+            // published version, otherwise a writer could miss it
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        }
+
+        /**
+         * Obtain the published version for lookups and iteration. The
+         * reference stays valid until the reader's next quiescent state.
+         * @return the current snapshot
+         */
+        inline const version_type &snapshot() const {
+            return *__atomic_load_n(&m_current, __ATOMIC_ACQUIRE);
+        }
+
+        /**
+         * @return the number of elements in the current snapshot
+         */
+        size_type size() const {
+            return snapshot().size();
+        }
+
+        /**
+         * Look up a key in the current snapshot.
+         * @param key the key to find
+         * @return a pointer to the mapped value, valid until the reader's
+         * next quiescent state, or null if the key is not in the map
+         */
+        const val_type *find(const key_type &key) const {
+            const version_type &version = snapshot();
+            typename version_type::const_iterator it = version.find(key);
+            return it == version.end() ? nullptr : &*it;
+        }
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value in the current snapshot
+         */
+        bool contains(const key_type &key) const {
+            return snapshot().contains(key);
+        }
+
+        /**
+         * Publish a new version of the table. The function edits a copy of
+         * the current version; once it returns, the copy is published and
+         * the call waits until no reader can still see the old version,
+         * whose memory is then released. A thread that is also a reader
+         * must be quiescent or offline when it calls this function. The
+         * copy and the release of the old version hold the memory lock
+         * shared with concurrent hash maps, so the function must not
+         * write to a concurrent hash map.
+         * @param function called with the new version to edit
+         */
+        template<class Function>
+        void update(Function function);
+
+        /**
+         * Publish a version in which the key maps to the value.
+         * @see SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::update()
+         * @param key element key
+         * @param val element value
+         */
+        void insert_or_assign(const key_type &key, const val_type &val) {
+            update([&](version_type &version) {
+                version.insert_or_assign(key, val);
+            });
+        }
+
+        /**
+         * Publish a version without the key.
+         * @see SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::update()
+         * @param key the key to erase
+         */
+        void erase(const key_type &key) {
+            update([&](version_type &version) {
+                version.erase(key);
+            });
+        }
+
+        map_type &operator=(const map_type &) = delete;
+    };
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tMaxReaders>
+    typename SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::reader_type *
+    SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::register_reader() {
+        for (reader_type &reader : m_readers) {
+            uint8_t expected = 0;
+            if (__atomic_compare_exchange_n(&reader.m_in_use, &expected, 1, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                online(&reader);
+                return &reader;
+            }
+        }
+        return nullptr;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tMaxReaders>
+    void SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::synchronize(uint32_t version) {
+        for (reader_type &reader : m_readers) {
+            uint16_t spins = 0;
+            while (true) {
+                uint32_t seen = __atomic_load_n(&reader.m_seen, __ATOMIC_ACQUIRE);
+                if (!seen || seen >= version) {
+                    break;
+                }
+                spin_back_off(spins);
+            }
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals, uint16_t tMaxReaders>
+    template<class Function>
+    void SnapshotHashMap<Key, Val, Hasher, Equals, tMaxReaders>::update(Function function) {
+        m_writer_lock.lock_write();
+        version_type *old = m_current;
+        version_type *next = old == &m_versions[0] ? &m_versions[1] : &m_versions[0];
+        const version_type &current = *old;
+        // building the copy allocates, which must not race the shard growth
+        // of a concurrent hash map; the lock is not held while waiting for
+        // readers, which may themselves be waiting for it
+        concurrent_map_memory_lock().lock_write();
+        {
+            version_type copy(current.capacity(), m_max_load);
+            for (typename version_type::const_iterator it = current.begin(); it != current.end(); ++it) {
+                copy.insert(it.key(), *it);
+            }
+            function(copy);
+            *next = move(copy);
+        }
+        concurrent_map_memory_lock().unlock_write();
+        __atomic_store_n(&m_current, next, __ATOMIC_RELEASE);
+        uint32_t version = m_version + 1;
+        __atomic_store_n(&m_version, version, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        synchronize(version);
+        // no reader can reach the old version any more
+        concurrent_map_memory_lock().lock_write();
+        *old = version_type(1, m_max_load);
+        concurrent_map_memory_lock().unlock_write();
+        m_writer_lock.unlock_write();
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SNAPSHOTMAP_H
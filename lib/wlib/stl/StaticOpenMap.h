@@ -0,0 +1,766 @@
+/**
+ * @file StaticOpenMap.h
+ * @brief Fixed capacity open addressing hash map implementation.
+ *
+ * The static open hash map holds at most N elements. Its slots and
+ * control bytes are arrays inside the map object, sized at compile
+ * time, so the map never calls @code memory_alloc @endcode and needs
+ * no @code Allocator @endcode. It can be declared as a global or on
+ * the stack and is ready to use without any startup allocation.
+ *
+ * The number of slots is the smallest power of two keeping the load
+ * at or below three quarters when the map holds N elements, so at
+ * least one slot is always empty and every probe terminates. Slots
+ * are found with linear probing from the top bits of a mixed hash
+ * and carry the same control bytes as the flat hash map. Erasure uses
+ * backward shift deletion, so no tombstones accumulate.
+ *
+ * Once the map holds N elements, inserting a new key fails
+ * immediately instead of growing.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_STATICOPENMAP_H
+#define EMBEDDEDCPLUSPLUS_STATICOPENMAP_H
+
+#include "Utility.h"
+#include "Equal.h"
+#include "Hash.h"
+#include "HashPolicy.h"
+#include "Pair.h"
+#include "FlatMap.h"
+
+namespace wlp {
+
+    // Forward declaration of StaticOpenHashMap
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher,
+            class Equals>
+    class StaticOpenHashMap;
+
+    // Forward declaration of StaticOpenHashMap iterator
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher,
+            class Equals>
+    struct StaticOpenHashMapIterator;
+
+    // Forward declaration of const StaticOpenHashMap iterator
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher,
+            class Equals>
+    struct StaticOpenHashMapConstIterator;
+
+    /**
+     * Iterator over the elements of a StaticOpenHashMap. The
+     * iterator walks the slots from start to end, skipping
+     * empty slots, and returns past-the-end afterwards.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam N      maximum number of elements
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher,
+            class Equals>
+    struct StaticOpenHashMapIterator {
+        typedef StaticOpenHashMap<Key, Val, N, Hasher, Equals> map_type;
+        typedef StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals> iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        /**
+         * Pointer to the slot referenced by this iterator.
+         */
+        node_type *m_current;
+        /**
+         * Pointer to the iterated StaticOpenHashMap.
+         */
+        map_type *m_hash_map;
+
+        StaticOpenHashMapIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        StaticOpenHashMapIterator(node_type *node, map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        StaticOpenHashMapIterator(const iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        StaticOpenHashMapIterator(iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        val_type *operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Increment the iterator to the next full slot.
+         * @return this iterator
+         */
+        iterator &operator++();
+
+        iterator operator++(int);
+
+        bool operator==(const iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        iterator &operator=(const iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        iterator &operator=(iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Constant iterator over a StaticOpenHashMap.
+     *
+     * @see StaticOpenHashMapIterator
+     *
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam N      maximum number of elements
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher,
+            class Equals>
+    struct StaticOpenHashMapConstIterator {
+        typedef StaticOpenHashMap<Key, Val, N, Hasher, Equals> map_type;
+        typedef StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        const node_type *m_current;
+        const map_type *m_hash_map;
+
+        StaticOpenHashMapConstIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        StaticOpenHashMapConstIterator(const node_type *node, const map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        StaticOpenHashMapConstIterator(const const_iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        StaticOpenHashMapConstIterator(const_iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        const val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        const val_type *operator->() const {
+            return &(operator*());
+        }
+
+        const_iterator &operator++();
+
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        const_iterator &operator=(const const_iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        const_iterator &operator=(const_iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Hash map of fixed capacity implemented using open addressing
+     * and linear probing over inline slots. Keys and values must be
+     * default constructible, since every slot holds one of each.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam N      maximum number of elements
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            size_type N,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>>
+    class StaticOpenHashMap {
+    public:
+        typedef StaticOpenHashMap<Key, Val, N, Hasher, Equals> map_type;
+        typedef StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals> iterator;
+        typedef StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        friend struct StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals>;
+        friend struct StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals>;
+
+        static_assert(N > 0, "StaticOpenHashMap must hold at least one element");
+        static_assert(N <= max_size_type / 2, "StaticOpenHashMap capacity overflows the size type");
+
+        /**
+         * The number of slots, the smallest power of two
+         * for which N elements are at most a 75% load.
+         */
+        static constexpr size_type CAPACITY =
+                PowerOfTwoIndex::capacity(static_cast<size_type>((static_cast<wide_size_type>(N) * 4 + 2) / 3));
+
+    private:
+        /**
+         * The shift reducing a mixed hash code to a slot index.
+         */
+        static constexpr uint8_t SHIFT = PowerOfTwoIndex::shift(CAPACITY);
+
+        /**
+         * Class hash function instance. Used to hash
+         * element keys.
+         */
+        Hasher m_hash;
+        /**
+         * Class key equality function. Used to test
+         * equality of element keys.
+         */
+        Equals m_equal;
+
+        /**
+         * Control bytes, one per slot.
+         */
+        uint8_t m_ctrl[CAPACITY];
+        /**
+         * Inline slots.
+         */
+        node_type m_slots[CAPACITY];
+
+        /**
+         * The current number of elements that have been inserted
+         * into the map.
+         */
+        size_type m_num_elements;
+
+    public:
+        /**
+         * Create an empty static hash map. No memory is allocated.
+         */
+        StaticOpenHashMap()
+                : m_hash(Hasher()),
+                  m_equal(Equals()),
+                  m_ctrl(),
+                  m_num_elements(0) {
+        }
+
+        /**
+         * Copy constructor copies every slot of the other map.
+         * @param map map to copy
+         */
+        StaticOpenHashMap(const map_type &map) = default;
+
+        /**
+         * Copy assignment copies every slot of the other map.
+         * @param map map to copy
+         * @return reference to this map
+         */
+        map_type &operator=(const map_type &map) = default;
+
+    private:
+        /**
+         * Obtain the home slot of a hash code.
+         * @param hash the hash code of a key
+         * @return an index i such that 0 <= i < CAPACITY
+         */
+        template<class IntType>
+        static size_type home(IntType hash) {
+            return static_cast<size_type>(top_bits(fibonacci_mix(hash), SHIFT));
+        }
+
+        /**
+         * The top bits of the mixed hash select the home slot, so
+         * the tag is taken from the bits below them.
+         * @param hash the hash code of a key
+         * @return the control byte of a slot holding the key
+         */
+        template<class IntType>
+        static uint8_t tag_of(IntType hash) {
+            uint32_t mixed = fibonacci_mix(hash);
+            return static_cast<uint8_t>(FlatHashMapControl::FULL | ((mixed << (32u - SHIFT)) >> 25));
+        }
+
+        /**
+         * Find the slot holding a key, or the empty slot at
+         * which the probe for the key stops.
+         * @param key the key to find
+         * @return index of the slot
+         */
+        size_type probe(const key_type &key) const;
+
+        /**
+         * Fill the hole left by an erased slot by shifting back
+         * elements of the following probe sequence.
+         * @param hole index of the erased slot
+         */
+        void shift_back(size_type hole);
+
+    public:
+        /**
+         * @return the current number of elements that have been
+         * inserted into the map
+         */
+        size_type size() const {
+            return m_num_elements;
+        }
+
+        /**
+         * @return the maximum number of elements, N
+         */
+        static constexpr size_type max_size() {
+            return N;
+        }
+
+        /**
+         * @return the number of slots
+         */
+        static constexpr size_type capacity() {
+            return CAPACITY;
+        }
+
+        /**
+         * @return true if the map is empty
+         */
+        bool empty() const {
+            return m_num_elements == 0;
+        }
+
+        /**
+         * @return true if the map holds N elements and
+         * no new key can be inserted
+         */
+        bool full() const {
+            return m_num_elements == N;
+        }
+
+        /**
+         * Obtain an iterator to the first element in the hash map.
+         * Returns pass-the-end iterator if there are no elements
+         * in the hash map.
+         * @return iterator the first element
+         */
+        iterator begin() {
+            for (size_type i = 0; i < CAPACITY && m_num_elements; ++i) {
+                if (m_ctrl[i]) {
+                    return iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @return a pass-the-end iterator for this map
+         */
+        iterator end() {
+            return iterator(nullptr, this);
+        }
+
+        /**
+         * @see StaticOpenHashMap<Key, Val, N, Hasher, Equals>::begin()
+         * @return a constant iterator to the first element
+         */
+        const_iterator begin() const {
+            for (size_type i = 0; i < CAPACITY && m_num_elements; ++i) {
+                if (m_ctrl[i]) {
+                    return const_iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @see StaticOpenHashMap<Key, Val, N, Hasher, Equals>::end()
+         * @return a constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(nullptr, this);
+        }
+
+        /**
+         * Erase all elements in the map and reset
+         * the element count to zero.
+         */
+        void clear() noexcept;
+
+        /**
+         * Attempt to insert an element into the map.
+         * Insertion is prevented if there already exists
+         * an element with the provided key, or if the map is full.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred; the
+         * iterator is pass-the-end if the map is full
+         */
+        Pair<iterator, bool> insert(const key_type &key, const val_type &val);
+
+        /**
+         * Attempt to insert an element into the map.
+         * If an element with the same key already exists,
+         * override the value mapped to by the provided key.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the assigned element, and a bool
+         * indicating whether insertion occurred; the iterator is
+         * pass-the-end if the key is new and the map is full
+         */
+        Pair<iterator, bool> insert_or_assign(const key_type &key, const val_type &val);
+
+        /**
+         * Erase the element pointed to by the provided iterator.
+         * Elements after it in the same probe sequence are shifted
+         * back, so other iterators into that sequence are invalidated.
+         * @param pos iterator pointing to the element to erase
+         * @return iterator to the next element in the map or end
+         */
+        iterator &erase(iterator &pos);
+
+        /**
+         * Erase the element from the map with the provided key, if such
+         * an element exists.
+         * @param key the key whose corresponding element to erase
+         * @return true if an element was erased
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Returns the value corresponding to a provided key.
+         * @param key the key for which to find the value
+         * @return iterator to the value or pass-the-end
+         */
+        iterator at(const key_type &key);
+
+        /**
+         * @see StaticOpenHashMap<Key, Val, N, Hasher, Equals>::at()
+         * @param key key for which to find the value
+         * @return const iterator to the value or pass-the-end
+         */
+        const_iterator at(const key_type &key) const;
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        bool contains(const key_type &key) const;
+
+        /**
+         * Return an iterator to the map element corresponding
+         * to the provided key, or pass-the-end if the key does
+         * not map to any value in the map.
+         * @param key the key to map
+         * @return an iterator to the element mapped by the key
+         */
+        iterator find(const key_type &key);
+
+        /**
+         * @see StaticOpenHashMap<Key, Val, N, Hasher, Equals>::find()
+         * @param key the key to map
+         * @return a const iterator to the element mapped by the key
+         */
+        const_iterator find(const key_type &key) const;
+
+        /**
+         * Access an element in the hash map by the given key.
+         * If the key does not map to any value in the map,
+         * then a new value is created and inserted using the default
+         * constructor.
+         * @pre the key is in the map or the map is not full; otherwise
+         * nothing is inserted and the reference is to an empty slot
+         * whose contents are discarded
+         * @param key the key whose value to access
+         * @return a reference to the mapped value
+         */
+        val_type &operator[](const key_type &key);
+    };
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    constexpr size_type StaticOpenHashMap<Key, Val, N, Hasher, Equals>::CAPACITY;
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    constexpr uint8_t StaticOpenHashMap<Key, Val, N, Hasher, Equals>::SHIFT;
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    size_type StaticOpenHashMap<Key, Val, N, Hasher, Equals>::probe(const key_type &key) const {
+        auto h = m_hash(key);
+        uint8_t tag = tag_of(h);
+        size_type i = home(h);
+        while (m_ctrl[i]) {
+            if (m_ctrl[i] == tag && m_equal(key, m_slots[i].m_key)) {
+                return i;
+            }
+            i = static_cast<size_type>((i + 1u) & (CAPACITY - 1u));
+        }
+        return i;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void StaticOpenHashMap<Key, Val, N, Hasher, Equals>::shift_back(size_type hole) {
+        size_type i = hole;
+        while (true) {
+            i = static_cast<size_type>((i + 1u) & (CAPACITY - 1u));
+            if (!m_ctrl[i]) {
+                break;
+            }
+            size_type h = home(m_hash(m_slots[i].m_key));
+            // distances are taken along the probe direction, modulo capacity
+            size_type to_home = static_cast<size_type>((i - h) & (CAPACITY - 1u));
+            size_type to_hole = static_cast<size_type>((i - hole) & (CAPACITY - 1u));
+            if (to_home >= to_hole) {
+                m_ctrl[hole] = m_ctrl[i];
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+        m_ctrl[hole] = FlatHashMapControl::EMPTY;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    void StaticOpenHashMap<Key, Val, N, Hasher, Equals>::clear() noexcept {
+        for (size_type i = 0; i < CAPACITY; ++i) {
+            m_ctrl[i] = FlatHashMapControl::EMPTY;
+        }
+        m_num_elements = 0;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    Pair<typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::iterator, bool>
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::insert(const key_type &key, const val_type &val) {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (full()) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        ++m_num_elements;
+        m_ctrl[i] = tag_of(m_hash(key));
+        m_slots[i].m_key = key;
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    Pair<typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::iterator, bool>
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::insert_or_assign(const key_type &key, const val_type &val) {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            m_slots[i].m_val = val;
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (full()) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        ++m_num_elements;
+        m_ctrl[i] = tag_of(m_hash(key));
+        m_slots[i].m_key = key;
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::iterator &
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::erase(iterator &pos) {
+        node_type *cur = pos.m_current;
+        if (!cur || pos.m_hash_map != this || cur < m_slots || cur >= m_slots + CAPACITY) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        size_type i = static_cast<size_type>(cur - m_slots);
+        if (!m_ctrl[i]) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        --m_num_elements;
+        shift_back(i);
+        if (!m_ctrl[i]) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    bool StaticOpenHashMap<Key, Val, N, Hasher, Equals>::erase(const key_type &key) {
+        size_type i = probe(key);
+        if (!m_ctrl[i]) {
+            return false;
+        }
+        --m_num_elements;
+        shift_back(i);
+        return true;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::iterator
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::at(const key_type &key) {
+        return find(key);
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::const_iterator
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::at(const key_type &key) const {
+        return find(key);
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    bool StaticOpenHashMap<Key, Val, N, Hasher, Equals>::contains(const key_type &key) const {
+        return m_ctrl[probe(key)] != FlatHashMapControl::EMPTY;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::iterator
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::find(const key_type &key) {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::const_iterator
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::find(const key_type &key) const {
+        size_type i = probe(key);
+        if (m_ctrl[i]) {
+            return const_iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    typename StaticOpenHashMap<Key, Val, N, Hasher, Equals>::val_type &
+    StaticOpenHashMap<Key, Val, N, Hasher, Equals>::operator[](const key_type &key) {
+        size_type i = probe(key);
+        if (!m_ctrl[i]) {
+            m_slots[i].m_val = val_type();
+            if (full()) {
+                return m_slots[i].m_val;
+            }
+            ++m_num_elements;
+            m_ctrl[i] = tag_of(m_hash(key));
+            m_slots[i].m_key = key;
+        }
+        return m_slots[i].m_val;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals> &
+    StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < map_type::CAPACITY && !m_hash_map->m_ctrl[i]);
+        m_current = i < map_type::CAPACITY ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    inline StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals>
+    StaticOpenHashMapIterator<Key, Val, N, Hasher, Equals>::operator++(int) {
+        iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals> &
+    StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < map_type::CAPACITY && !m_hash_map->m_ctrl[i]);
+        m_current = i < map_type::CAPACITY ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, size_type N, class Hasher, class Equals>
+    inline StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals>
+    StaticOpenHashMapConstIterator<Key, Val, N, Hasher, Equals>::operator++(int) {
+        const_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_STATICOPENMAP_H
@@ -0,0 +1,1111 @@
+/**
+ * @file SwissMap.h
+ * @brief Group probing hash map implementation.
+ *
+ * The swiss hash map stores key and value slots inline, next to an
+ * array of one control byte per slot. Slots are probed in aligned
+ * groups of sixteen: the control bytes of a group are compared against
+ * the seven bit tag of a key all at once, with SSE2 where available
+ * and with 64 bit word arithmetic otherwise, so that a lookup usually
+ * compares a single key. AVX2 is not used, as wider groups would
+ * only pay off for tables much larger than the 16 bit size type
+ * allows. Groups are visited in triangular order, which
+ * reaches every group because the number of groups is a power of two.
+ *
+ * Erasing leaves a tombstone only if the group of the erased slot has
+ * no empty slot, since no probe continues past a group with one.
+ * Tombstones are purged on rehash.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SWISSMAP_H
+#define EMBEDDEDCPLUSPLUS_SWISSMAP_H
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <assert.h>
+
+#include "Utility.h"
+#include "Equal.h"
+#include "Hash.h"
+#include "HashPolicy.h"
+#include "Pair.h"
+#include "OpenMap.h"
+
+#include "../memory/Memory.h"
+
+namespace wlp {
+
+    // Forward declaration of SwissHashMap
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    class SwissHashMap;
+
+    // Forward declaration of SwissHashMap iterator
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct SwissHashMapIterator;
+
+    // Forward declaration of const SwissHashMap iterator
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct SwissHashMapConstIterator;
+
+    /**
+     * Control byte values of the swiss hash map. A full slot holds
+     * the seven bit tag of its key, with the high bit clear.
+     */
+    struct SwissHashMapControl {
+        enum : uint8_t {
+            EMPTY = 0x80,   /**< control byte of an empty slot */
+            DELETED = 0xfe  /**< control byte of an erased slot */
+        };
+
+        /**
+         * @param ctrl a control byte
+         * @return true if the control byte is that of a full slot
+         */
+        static inline bool full(uint8_t ctrl) {
+            return !(ctrl & 0x80);
+        }
+
+        /**
+         * The top bits of the mixed hash select the group, so the
+         * tag is taken from the bits below them.
+         * @param mixed the mixed hash of a key
+         * @param shift the shift reducing the mixed hash to a group
+         * @return the control byte of a slot holding the key
+         */
+        static inline uint8_t tag(uint32_t mixed, uint8_t shift) {
+            return static_cast<uint8_t>((mixed << (32u - shift)) >> 25);
+        }
+    };
+
+    /**
+     * The control bytes of a group of slots, loaded for comparison
+     * against a single byte with 64 bit word arithmetic. Every match
+     * function returns a mask with bit i set if the byte of slot i of
+     * the group matches.
+     */
+    class SwissGroupPortable {
+    public:
+        enum : uint8_t {
+            WIDTH = 16
+        };
+
+        explicit SwissGroupPortable(const uint8_t *ctrl)
+                : m_lo(load(ctrl)),
+                  m_hi(load(ctrl + 8)) {
+        }
+
+        /**
+         * May report a slot following a matching slot as a false
+         * match, so the control byte of every match is checked again.
+         * @param tag the tag of a key
+         * @return mask of the slots holding the tag
+         */
+        uint32_t match(uint8_t tag) const {
+            uint64_t pattern = LSBS * tag;
+            return gather(zero_bytes(m_lo ^ pattern)) | gather(zero_bytes(m_hi ^ pattern)) << 8;
+        }
+
+        /**
+         * @return mask of the empty slots
+         */
+        uint32_t match_empty() const {
+            // only the empty byte has the high bit set and bit 1 clear
+            return gather(m_lo & ~(m_lo << 6) & MSBS) | gather(m_hi & ~(m_hi << 6) & MSBS) << 8;
+        }
+
+        /**
+         * @return mask of the empty and erased slots
+         */
+        uint32_t match_empty_or_deleted() const {
+            return gather(m_lo & MSBS) | gather(m_hi & MSBS) << 8;
+        }
+
+    private:
+        enum : uint64_t {
+            LSBS = 0x0101010101010101ull,
+            MSBS = 0x8080808080808080ull
+        };
+
+        static inline uint64_t load(const uint8_t *bytes) {
+            uint64_t word = 0;
+            for (uint8_t i = 8; i-- > 0;) {
+                word = word << 8 | bytes[i];
+            }
+            return word;
+        }
+
+        /**
+         * @return the high bit of every byte that may be zero
+         */
+        static inline uint64_t zero_bytes(uint64_t word) {
+            return (word - LSBS) & ~word & MSBS;
+        }
+
+        /**
+         * @return the high bits of the bytes packed into the low byte
+         */
+        static inline uint32_t gather(uint64_t high_bits) {
+            return static_cast<uint32_t>(((high_bits >> 7) * 0x0102040810204080ull) >> 56);
+        }
+
+        uint64_t m_lo;
+        uint64_t m_hi;
+    };
+
+#if defined(__SSE2__)
+
+    /**
+     * The control bytes of a group of slots in an SSE2 register.
+     *
+     * @see SwissGroupPortable
+     */
+    class SwissGroupSse2 {
+    public:
+        enum : uint8_t {
+            WIDTH = 16
+        };
+
+        explicit SwissGroupSse2(const uint8_t *ctrl)
+                : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {
+        }
+
+        /**
+         * @param tag the tag of a key
+         * @return mask of the slots holding the tag
+         */
+        uint32_t match(uint8_t tag) const {
+            return movemask(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), m_ctrl));
+        }
+
+        /**
+         * @return mask of the empty slots
+         */
+        uint32_t match_empty() const {
+            return match(SwissHashMapControl::EMPTY);
+        }
+
+        /**
+         * @return mask of the empty and erased slots
+         */
+        uint32_t match_empty_or_deleted() const {
+            return movemask(m_ctrl);
+        }
+
+    private:
+        static inline uint32_t movemask(__m128i bytes) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+        }
+
+        __m128i m_ctrl;
+    };
+
+    typedef SwissGroupSse2 SwissGroup;
+
+#else
+
+    typedef SwissGroupPortable SwissGroup;
+
+#endif
+
+    /**
+     * Iterator over the elements of a SwissHashMap. The iterator
+     * walks the backing array from start to end, skipping
+     * empty and erased slots, and returns past-the-end afterwards.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct SwissHashMapIterator {
+        typedef SwissHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef SwissHashMapIterator<Key, Val, Hasher, Equals> iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        /**
+         * Pointer to the slot referenced by this iterator.
+         */
+        node_type *m_current;
+        /**
+         * Pointer to the iterated SwissHashMap.
+         */
+        map_type *m_hash_map;
+
+        SwissHashMapIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        SwissHashMapIterator(node_type *node, map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        SwissHashMapIterator(const iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        SwissHashMapIterator(iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        val_type *operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Increment the iterator to the next full slot. The slot
+         * index is recovered from the slot address.
+         * @return this iterator
+         */
+        iterator &operator++();
+
+        iterator operator++(int);
+
+        bool operator==(const iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        iterator &operator=(const iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        iterator &operator=(iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Constant iterator over a SwissHashMap.
+     *
+     * @see SwissHashMapIterator
+     *
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher,
+            class Equals>
+    struct SwissHashMapConstIterator {
+        typedef SwissHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef SwissHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+
+        const node_type *m_current;
+        const map_type *m_hash_map;
+
+        SwissHashMapConstIterator()
+                : m_current(nullptr),
+                  m_hash_map(nullptr) {
+        }
+
+        SwissHashMapConstIterator(const node_type *node, const map_type *map)
+                : m_current(node),
+                  m_hash_map(map) {
+        }
+
+        SwissHashMapConstIterator(const const_iterator &it)
+                : m_current(it.m_current),
+                  m_hash_map(it.m_hash_map) {
+        }
+
+        SwissHashMapConstIterator(const_iterator &&it)
+                : m_current(move(it.m_current)),
+                  m_hash_map(move(it.m_hash_map)) {
+        }
+
+        const val_type &operator*() const {
+            return m_current->m_val;
+        }
+
+        const val_type *operator->() const {
+            return &(operator*());
+        }
+
+        const_iterator &operator++();
+
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator==(const_iterator &it) const {
+            return m_current == it.m_current;
+        }
+
+        bool operator!=(const const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        bool operator!=(const_iterator &it) const {
+            return m_current != it.m_current;
+        }
+
+        const_iterator &operator=(const const_iterator &it) {
+            m_current = it.m_current;
+            m_hash_map = it.m_hash_map;
+            return *this;
+        }
+
+        const_iterator &operator=(const_iterator &&it) {
+            m_current = move(it.m_current);
+            m_hash_map = move(it.m_hash_map);
+            return *this;
+        }
+    };
+
+    /**
+     * Hash map implemented using open addressing over groups of inline
+     * slots, in the spirit of std::unordered_map.
+     * @tparam Key    key type
+     * @tparam Val    value type
+     * @tparam Hasher hash function
+     * @tparam Equals key equality function
+     */
+    template<class Key,
+            class Val,
+            class Hasher = Hash<Key, size_type>,
+            class Equals = Equal <Key>>
+    class SwissHashMap {
+    public:
+        typedef SwissHashMap<Key, Val, Hasher, Equals> map_type;
+        typedef SwissHashMapIterator<Key, Val, Hasher, Equals> iterator;
+        typedef SwissHashMapConstIterator<Key, Val, Hasher, Equals> const_iterator;
+        typedef OpenHashMapNode<Key, Val> node_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+        typedef wlp::size_type size_type;
+        typedef uint8_t percent_type;
+
+        friend struct SwissHashMapIterator<Key, Val, Hasher, Equals>;
+        friend struct SwissHashMapConstIterator<Key, Val, Hasher, Equals>;
+
+    private:
+        /**
+         * Class hash function instance. Used to hash
+         * element keys.
+         */
+        Hasher m_hash;
+        /**
+         * Class key equality function. Used to test
+         * equality of element keys.
+         */
+        Equals m_equal;
+
+        /**
+         * Control bytes, one per slot.
+         */
+        uint8_t *m_ctrl;
+        /**
+         * Backing array of inline slots.
+         */
+        node_type *m_slots;
+
+        /**
+         * The current number of elements that have been inserted
+         * into the map.
+         */
+        size_type m_num_elements;
+        /**
+         * The number of slots holding a tombstone.
+         */
+        size_type m_num_deleted;
+        /**
+         * The size of the backing array, a power of two
+         * and a multiple of the group width.
+         */
+        size_type m_capacity;
+        /**
+         * The shift reducing a mixed hash to the index of a group.
+         */
+        uint8_t m_group_shift;
+        /**
+         * The load factor in integer percent
+         * before rehashing occurs. This number
+         * cannot be larger than 100.
+         */
+        percent_type m_max_load;
+
+    public:
+        /**
+         * Create and initialize an empty swiss hash map. Slots and
+         * control bytes are allocated with @code memory_alloc @endcode.
+         *
+         * @pre the initial slots fit the size type in bytes
+         *
+         * @param n        initial number of slots, rounded up to a power
+         *                 of two of at least the group width
+         * @param max_load an integer value denoting the max percent load factory, e.g. 87 = 0.87
+         */
+        explicit SwissHashMap(
+                size_type n = 16,
+                percent_type max_load = 87)
+                : m_hash(Hasher()),
+                  m_equal(Equals()),
+                  m_ctrl(nullptr),
+                  m_slots(nullptr),
+                  m_num_elements(0),
+                  m_num_deleted(0),
+                  m_capacity(PowerOfTwoIndex::capacity(max(n, static_cast<size_type>(SwissGroup::WIDTH)))),
+                  m_group_shift(PowerOfTwoIndex::shift(static_cast<size_type>(m_capacity / SwissGroup::WIDTH))),
+                  m_max_load(max_load) {
+            bool allocated = init_slots(m_capacity);
+            assert(allocated);
+            (void) allocated;
+            if (max_load > 100) {
+                m_max_load = 100;
+            }
+        }
+
+        SwissHashMap(const map_type &) = delete;
+
+        /**
+         * Move constructor transfers resources from
+         * rvalue hash map into this hash map.
+         * @param map map from which to transfer
+         */
+        SwissHashMap(map_type &&map) :
+                m_hash(move(map.m_hash)),
+                m_equal(move(map.m_equal)),
+                m_ctrl(move(map.m_ctrl)),
+                m_slots(move(map.m_slots)),
+                m_num_elements(move(map.m_num_elements)),
+                m_num_deleted(move(map.m_num_deleted)),
+                m_capacity(move(map.m_capacity)),
+                m_group_shift(move(map.m_group_shift)),
+                m_max_load(move(map.m_max_load)) {
+            map.m_num_elements = 0;
+            map.m_num_deleted = 0;
+            map.m_capacity = 0;
+            map.m_ctrl = nullptr;
+            map.m_slots = nullptr;
+        }
+
+        /**
+         * Destroy the hash map, freeing the backing arrays.
+         */
+        ~SwissHashMap();
+
+    private:
+        /**
+         * Allocate empty control bytes and slots, keeping the
+         * current ones if either allocation fails.
+         * @param n the number of slots
+         * @return false if the arrays do not fit the size type in
+         * bytes or memory ran out
+         */
+        bool init_slots(size_type n);
+
+        /**
+         * @param key the key to hash
+         * @return the mixed hash of the key
+         */
+        uint32_t hash(const key_type &key) const {
+            return fibonacci_mix(m_hash(key));
+        }
+
+        /**
+         * @param mixed the mixed hash of a key
+         * @return index of the first group in the probe sequence
+         */
+        size_type first_group(uint32_t mixed) const {
+            return static_cast<size_type>(top_bits(mixed, m_group_shift));
+        }
+
+        /**
+         * @param group the group just probed
+         * @param step  the number of groups probed so far
+         * @return index of the next group in the probe sequence
+         */
+        size_type next_group(size_type group, size_type step) const {
+            return static_cast<size_type>((group + step) & (m_capacity / SwissGroup::WIDTH - 1u));
+        }
+
+        /**
+         * Find the slot holding a key.
+         * @param key   the key to find
+         * @param mixed the mixed hash of the key
+         * @return index of the slot, or the capacity if the key
+         * is not in the map
+         */
+        size_type find_index(const key_type &key, uint32_t mixed) const;
+
+        /**
+         * Find the first empty or erased slot in the probe
+         * sequence of a hash.
+         * @param mixed the mixed hash of a key
+         * @return index of the slot
+         */
+        size_type find_free(uint32_t mixed) const;
+
+        /**
+         * Claim a free slot for a key that is not in the map.
+         * @param key   the key to insert
+         * @param mixed the mixed hash of the key
+         * @return index of the slot, whose value is uninitialized
+         */
+        size_type insert_index(const key_type &key, uint32_t mixed);
+
+        /**
+         * Grow and rehash the map if the full and erased slots exceed
+         * or equal the maximum load factor. At least one slot is always
+         * kept empty so that probes terminate. If mostly tombstones fill
+         * the map, the array is rehashed without growing. If the size
+         * type cannot hold a doubled capacity or its arrays, or they
+         * cannot be allocated, the map keeps its capacity and fills
+         * beyond the maximum load.
+         * @return false if the map is full and cannot take another element
+         */
+        bool ensure_capacity();
+
+        /**
+         * Empty a full slot, leaving a tombstone if needed.
+         * @param i index of the slot
+         */
+        void remove_at(size_type i);
+
+    public:
+        /**
+         * @return the current number of elements that have been
+         * inserted into the map
+         */
+        size_type size() const {
+            return m_num_elements;
+        }
+
+        /**
+         * @return the current size of the backing array
+         */
+        size_type capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @return the maximum load before before rehash
+         */
+        percent_type max_load() const {
+            return m_max_load;
+        }
+
+        /**
+         * @return true if the map is empty
+         */
+        bool empty() const {
+            return m_num_elements == 0;
+        }
+
+        /**
+         * Obtain an iterator to the first element in the hash map.
+         * Returns pass-the-end iterator if there are no elements
+         * in the hash map.
+         * @return iterator the first element
+         */
+        iterator begin() {
+            for (size_type i = 0; i < m_capacity && m_num_elements; ++i) {
+                if (SwissHashMapControl::full(m_ctrl[i])) {
+                    return iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @return a pass-the-end iterator for this map
+         */
+        iterator end() {
+            return iterator(nullptr, this);
+        }
+
+        /**
+         * @see SwissHashMap<Key, Val, Hasher, Equals>::begin()
+         * @return a constant iterator to the first element
+         */
+        const_iterator begin() const {
+            for (size_type i = 0; i < m_capacity && m_num_elements; ++i) {
+                if (SwissHashMapControl::full(m_ctrl[i])) {
+                    return const_iterator(&m_slots[i], this);
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @see SwissHashMap<Key, Val, Hasher, Equals>::end()
+         * @return a constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(nullptr, this);
+        }
+
+        /**
+         * Erase all elements in the map and reset
+         * the element count to zero.
+         */
+        void clear() noexcept;
+
+        /**
+         * Attempt to insert an element into the map.
+         * Insertion is prevented if there already exists
+         * an element with the provided key
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the element that prevented insertion
+         * and a bool indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert(key_type key, val_type val);
+
+        /**
+         * Attempt to insert an element into the map.
+         * If an element with the same key already exists,
+         * override the value mapped to by the provided key.
+         * @param key inserted element key
+         * @param val inserted element value
+         * @return a pair consisting of an iterator pointing to the
+         * inserted element or the assigned element, and a bool
+         * indicating whether insertion occurred
+         */
+        Pair<iterator, bool> insert_or_assign(key_type key, val_type val);
+
+        /**
+         * Erase the element pointed to by the provided iterator.
+         * No other element moves, so other iterators stay valid.
+         * @param pos iterator pointing to the element to erase
+         * @return iterator to the next element in the map or end
+         */
+        iterator &erase(iterator &pos);
+
+        /**
+         * Erase the element from the map with the provided key, if such
+         * an element exists. No memory is allocated or freed.
+         * @param key the key whose corresponding element to erase
+         * @return true if an element was erased
+         */
+        bool erase(const key_type &key);
+
+        /**
+         * Returns the value corresponding to a provided key.
+         * @param key the key for which to find the value
+         * @return iterator to the value or pass-the-end
+         */
+        iterator at(const key_type &key);
+
+        /**
+         * @see SwissHashMap<Key, Val, Hasher, Equals>::at()
+         * @param key key for which to find the value
+         * @return const iterator to the value or pass-the-end
+         */
+        const_iterator at(const key_type &key) const;
+
+        /**
+         * @param key key for which to check existence of a value
+         * @return true if the key maps to a value
+         */
+        bool contains(const key_type &key) const;
+
+        /**
+         * Return an iterator to the map element corresponding
+         * to the provided key, or pass-the-end if the key does
+         * not map to any value in the map.
+         * @param key the key to map
+         * @return an iterator to the element mapped by the key
+         */
+        iterator find(const key_type &key);
+
+        /**
+         * @see SwissHashMap<Key, Val, Hasher, Equals>::find()
+         * @param key the key to map
+         * @return a const iterator to the element mapped by the key
+         */
+        const_iterator find(const key_type &key) const;
+
+        /**
+         * Access an element in the hash map by the given key.
+         * If the key does not map to any value in the map,
+         * then a new value is created and inserted using the default
+         * constructor.
+         *
+         * @pre the map is not full, which it only is if it cannot
+         * grow; use insert to detect it
+         *
+         * @param key the key whose value to access
+         * @return a reference to the mapped value
+         */
+        val_type &operator[](const key_type &key);
+
+        map_type &operator=(const map_type &) = delete;
+
+        /**
+         * Move assignment operator. Existing resources
+         * will be released.
+         * @param map map to move
+         * @return reference to this map
+         */
+        map_type &operator=(map_type &&map);
+    };
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool SwissHashMap<Key, Val, Hasher, Equals>::init_slots(size_type n) {
+        uint8_t *ctrl = memory_alloc_array<uint8_t>(n);
+        node_type *slots = memory_alloc_array<node_type>(n);
+        if (!ctrl || !slots) {
+            memory_free(ctrl);
+            memory_free(slots);
+            return false;
+        }
+        m_ctrl = ctrl;
+        m_slots = slots;
+        for (size_type i = 0; i < n; ++i) {
+            m_ctrl[i] = SwissHashMapControl::EMPTY;
+        }
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::size_type
+    SwissHashMap<Key, Val, Hasher, Equals>::find_index(const key_type &key, uint32_t mixed) const {
+        uint8_t tag = SwissHashMapControl::tag(mixed, m_group_shift);
+        size_type group = first_group(mixed);
+        for (size_type step = 1;; ++step) {
+            size_type base = static_cast<size_type>(group * SwissGroup::WIDTH);
+            SwissGroup ctrl(m_ctrl + base);
+            for (uint32_t match = ctrl.match(tag); match; match &= match - 1) {
+                size_type i = static_cast<size_type>(base + __builtin_ctz(match));
+                if (m_ctrl[i] == tag && m_equal(key, m_slots[i].m_key)) {
+                    return i;
+                }
+            }
+            if (ctrl.match_empty()) {
+                return m_capacity;
+            }
+            group = next_group(group, step);
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::size_type
+    SwissHashMap<Key, Val, Hasher, Equals>::find_free(uint32_t mixed) const {
+        size_type group = first_group(mixed);
+        for (size_type step = 1;; ++step) {
+            size_type base = static_cast<size_type>(group * SwissGroup::WIDTH);
+            uint32_t free = SwissGroup(m_ctrl + base).match_empty_or_deleted();
+            if (free) {
+                return static_cast<size_type>(base + __builtin_ctz(free));
+            }
+            group = next_group(group, step);
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::size_type
+    SwissHashMap<Key, Val, Hasher, Equals>::insert_index(const key_type &key, uint32_t mixed) {
+        size_type i = find_free(mixed);
+        if (m_ctrl[i] == SwissHashMapControl::DELETED) {
+            --m_num_deleted;
+        }
+        ++m_num_elements;
+        m_ctrl[i] = SwissHashMapControl::tag(mixed, m_group_shift);
+        m_slots[i].m_key = key;
+        return i;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool SwissHashMap<Key, Val, Hasher, Equals>::ensure_capacity() {
+        size_type num_used = static_cast<size_type>(m_num_elements + m_num_deleted);
+        wide_size_type max_used = static_cast<wide_size_type>(m_max_load) * m_capacity;
+        if (static_cast<wide_size_type>(num_used) * 100 < max_used && num_used + 1 < m_capacity) {
+            return true;
+        }
+        size_type new_capacity = grow_capacity(m_capacity);
+        if (m_num_deleted > 0 && static_cast<wide_size_type>(m_num_elements) * 200 < max_used) {
+            new_capacity = m_capacity;
+        }
+        if (new_capacity == m_capacity && m_num_deleted == 0) {
+            return num_used + 1 < m_capacity;
+        }
+        size_type old_capacity = m_capacity;
+        uint8_t *old_ctrl = m_ctrl;
+        node_type *old_slots = m_slots;
+        if (!init_slots(new_capacity)) {
+            // the size type cannot hold the larger arrays, or there is
+            // no memory for them, so the map fills beyond its maximum load
+            return num_used + 1 < m_capacity;
+        }
+        m_capacity = new_capacity;
+        m_group_shift = PowerOfTwoIndex::shift(static_cast<size_type>(m_capacity / SwissGroup::WIDTH));
+        m_num_deleted = 0;
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (!SwissHashMapControl::full(old_ctrl[i])) {
+                continue;
+            }
+            // the tag comes from the bits below the group,
+            // which move with the capacity
+            uint32_t mixed = hash(old_slots[i].m_key);
+            size_type k = find_free(mixed);
+            m_ctrl[k] = SwissHashMapControl::tag(mixed, m_group_shift);
+            m_slots[k] = old_slots[i];
+        }
+        memory_free(old_ctrl);
+        memory_free(old_slots);
+        return m_num_elements + 1 < m_capacity;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    void SwissHashMap<Key, Val, Hasher, Equals>::remove_at(size_type i) {
+        --m_num_elements;
+        size_type base = static_cast<size_type>(i & ~(SwissGroup::WIDTH - 1u));
+        // probes stop at a group with an empty slot, so none
+        // can depend on the erased slot having been full
+        if (SwissGroup(m_ctrl + base).match_empty()) {
+            m_ctrl[i] = SwissHashMapControl::EMPTY;
+        } else {
+            m_ctrl[i] = SwissHashMapControl::DELETED;
+            ++m_num_deleted;
+        }
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    void SwissHashMap<Key, Val, Hasher, Equals>::clear() noexcept {
+        for (size_type i = 0; i < m_capacity; ++i) {
+            m_ctrl[i] = SwissHashMapControl::EMPTY;
+        }
+        m_num_elements = 0;
+        m_num_deleted = 0;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    Pair<typename SwissHashMap<Key, Val, Hasher, Equals>::iterator, bool>
+    SwissHashMap<Key, Val, Hasher, Equals>::insert(key_type key, val_type val) {
+        uint32_t mixed = hash(key);
+        size_type i = find_index(key, mixed);
+        if (i != m_capacity) {
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (!ensure_capacity()) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        i = insert_index(key, mixed);
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    Pair<typename SwissHashMap<Key, Val, Hasher, Equals>::iterator, bool>
+    SwissHashMap<Key, Val, Hasher, Equals>::insert_or_assign(key_type key, val_type val) {
+        uint32_t mixed = hash(key);
+        size_type i = find_index(key, mixed);
+        if (i != m_capacity) {
+            m_slots[i].m_val = val;
+            return Pair<iterator, bool>(iterator(&m_slots[i], this), false);
+        }
+        if (!ensure_capacity()) {
+            return Pair<iterator, bool>(end(), false);
+        }
+        i = insert_index(key, mixed);
+        m_slots[i].m_val = val;
+        return Pair<iterator, bool>(iterator(&m_slots[i], this), true);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::iterator &
+    SwissHashMap<Key, Val, Hasher, Equals>::erase(iterator &pos) {
+        node_type *cur = pos.m_current;
+        if (!cur || pos.m_hash_map != this || cur < m_slots || cur >= m_slots + m_capacity) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        size_type i = static_cast<size_type>(cur - m_slots);
+        if (!SwissHashMapControl::full(m_ctrl[i])) {
+            pos.m_current = nullptr;
+            return pos;
+        }
+        remove_at(i);
+        return ++pos;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool SwissHashMap<Key, Val, Hasher, Equals>::erase(const key_type &key) {
+        size_type i = find_index(key, hash(key));
+        if (i == m_capacity) {
+            return false;
+        }
+        remove_at(i);
+        return true;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::iterator
+    SwissHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::const_iterator
+    SwissHashMap<Key, Val, Hasher, Equals>::at(const key_type &key) const {
+        return find(key);
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    bool SwissHashMap<Key, Val, Hasher, Equals>::contains(const key_type &key) const {
+        return find_index(key, hash(key)) != m_capacity;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::iterator
+    SwissHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) {
+        size_type i = find_index(key, hash(key));
+        if (i != m_capacity) {
+            return iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::const_iterator
+    SwissHashMap<Key, Val, Hasher, Equals>::find(const key_type &key) const {
+        size_type i = find_index(key, hash(key));
+        if (i != m_capacity) {
+            return const_iterator(&m_slots[i], this);
+        }
+        return end();
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    typename SwissHashMap<Key, Val, Hasher, Equals>::val_type &
+    SwissHashMap<Key, Val, Hasher, Equals>::operator[](const key_type &key) {
+        uint32_t mixed = hash(key);
+        size_type i = find_index(key, mixed);
+        if (i == m_capacity) {
+            // taking the last empty slot would leave later probes
+            // looping forever; insert reports a full map instead
+            bool room = ensure_capacity();
+            assert(room);
+            (void) room;
+            i = insert_index(key, mixed);
+            m_slots[i].m_val = val_type();
+        }
+        return m_slots[i].m_val;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    SwissHashMap<Key, Val, Hasher, Equals>::~SwissHashMap() {
+        if (!m_slots) {
+            return;
+        }
+        memory_free(m_ctrl);
+        memory_free(m_slots);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    SwissHashMap<Key, Val, Hasher, Equals> &
+    SwissHashMap<Key, Val, Hasher, Equals>::operator=(SwissHashMap<Key, Val, Hasher, Equals> &&map) {
+        if (m_slots) {
+            memory_free(m_ctrl);
+            memory_free(m_slots);
+        }
+        m_capacity = move(map.m_capacity);
+        m_group_shift = move(map.m_group_shift);
+        m_max_load = move(map.m_max_load);
+        m_num_elements = move(map.m_num_elements);
+        m_num_deleted = move(map.m_num_deleted);
+        m_ctrl = move(map.m_ctrl);
+        m_slots = move(map.m_slots);
+        map.m_capacity = 0;
+        map.m_num_elements = 0;
+        map.m_num_deleted = 0;
+        map.m_ctrl = nullptr;
+        map.m_slots = nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    SwissHashMapIterator<Key, Val, Hasher, Equals> &
+    SwissHashMapIterator<Key, Val, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < m_hash_map->m_capacity && !SwissHashMapControl::full(m_hash_map->m_ctrl[i]));
+        m_current = i < m_hash_map->m_capacity ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    inline SwissHashMapIterator<Key, Val, Hasher, Equals>
+    SwissHashMapIterator<Key, Val, Hasher, Equals>::operator++(int) {
+        iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    SwissHashMapConstIterator<Key, Val, Hasher, Equals> &
+    SwissHashMapConstIterator<Key, Val, Hasher, Equals>::operator++() {
+        size_type i = static_cast<size_type>(m_current - m_hash_map->m_slots);
+        while (++i < m_hash_map->m_capacity && !SwissHashMapControl::full(m_hash_map->m_ctrl[i]));
+        m_current = i < m_hash_map->m_capacity ? &m_hash_map->m_slots[i] : nullptr;
+        return *this;
+    }
+
+    template<class Key, class Val, class Hasher, class Equals>
+    inline SwissHashMapConstIterator<Key, Val, Hasher, Equals>
+    SwissHashMapConstIterator<Key, Val, Hasher, Equals>::operator++(int) {
+        const_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SWISSMAP_H
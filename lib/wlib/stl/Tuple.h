@@ -552,14 +552,18 @@ namespace wlp {
     /**
      * Ignore universal type is used during
      * tuple assignment to tie to ignore a
-     * particular tuple value.
+     * particular tuple value. The instance is a
+     * constant so that every translation unit
+     * including the header has its own copy.
      */
     struct ignore_type {
         template<typename U>
-        ignore_type &operator=(U &&) {
+        const ignore_type &operator=(U &&) const {
             return *this;
         }
-    } ignore;
+    };
+
+    static constexpr ignore_type ignore{};
 
     /**
      * Tie creates a tuple of lvalues that can be
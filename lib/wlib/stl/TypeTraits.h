@@ -54,6 +54,7 @@ namespace wlp {
     __WLIB_HAS_TYPE(const_iterator)
     __WLIB_HAS_TYPE(map_type)
     __WLIB_HAS_TYPE(node_type)
+    __WLIB_HAS_TYPE(is_transparent)
 
     __WLIB_OBTAIN_TYPE(size_type)
     __WLIB_OBTAIN_TYPE(val_type)
@@ -85,7 +85,7 @@ namespace wlp {
          *
          * @return string length
          */
-        uint16_t length() const {
+        constexpr uint16_t length() const {
             return m_len;
         }
 
@@ -103,7 +103,7 @@ namespace wlp {
          *
          * @return if string is empty or not
          */
-        bool empty() const {
+        constexpr bool empty() const {
             return m_len == 0;
         }
 
@@ -132,7 +132,7 @@ namespace wlp {
          * @param pos the position of the character
          * @return character at @p pos
          */
-        const char &operator[](uint16_t pos) const {
+        constexpr const char &operator[](uint16_t pos) const {
             return at(pos);
         }
 
@@ -157,7 +157,7 @@ namespace wlp {
          * @param pos the position of the character
          * @return character at @p pos
          */
-        const char &at(uint16_t pos) const {
+        constexpr const char &at(uint16_t pos) const {
             if (pos >= m_len) return back();
 
             return m_buffer[pos];
@@ -178,7 +178,7 @@ namespace wlp {
          *
          * @return the last character
          */
-        const char &back() const {
+        constexpr const char &back() const {
             if (empty()) return m_buffer[0];
             return m_buffer[m_len - 1];
         }
@@ -313,7 +313,7 @@ namespace wlp {
          *
          * @return character array
          */
-        const char *c_str() const {
+        constexpr const char *c_str() const {
             return m_buffer;
         }
 
@@ -0,0 +1,38 @@
+#include "gtest/gtest.h"
+#include "memory/Allocator.h"
+#include "memory/Memory.h"
+
+using namespace wlp;
+
+static constexpr size_type BLOCK_SIZE = 16;
+
+TEST(allocator_test, test_heap_blocks_are_not_pool_blocks) {
+    // room for four blocks, of which only the first two form the pool
+    static char memory[4 * BLOCK_SIZE];
+    Allocator allocator(BLOCK_SIZE, memory, 2 * BLOCK_SIZE, Allocator::STATIC);
+    void *blocks[4];
+    for (int i = 0; i < 4; ++i) {
+        blocks[i] = allocator.Allocate();
+    }
+    ASSERT_EQ(2u, allocator.GetTotalPoolBlocks());
+    ASSERT_EQ(4u, allocator.GetTotalBlocks());
+    ASSERT_TRUE(allocator.IsPoolBlock(memory));
+    ASSERT_TRUE(allocator.IsPoolBlock(memory + BLOCK_SIZE));
+    // the pool bounds do not grow with the blocks taken from the heap
+    ASSERT_FALSE(allocator.IsPoolBlock(memory + 2 * BLOCK_SIZE));
+    ASSERT_FALSE(allocator.IsPoolBlock(memory + 3 * BLOCK_SIZE));
+    for (int i = 0; i < 4; ++i) {
+        allocator.Deallocate(blocks[i]);
+    }
+    ASSERT_EQ(2u, allocator.GetNumPoolBlocksAvail());
+}
+
+TEST(memory_test, test_alloc_rejects_blocks_over_the_size_type) {
+    // allocators would truncate the block size to the size type
+    ASSERT_EQ(nullptr, memory_alloc(max_size_type));
+    ASSERT_EQ(nullptr, memory_alloc(static_cast<size_t>(max_size_type) - sizeof(void *) + 1));
+    ASSERT_EQ(nullptr, memory_alloc_array<uint32_t>(max_size_type / 2));
+    void *block = memory_alloc_array<uint32_t>(16);
+    ASSERT_NE(nullptr, block);
+    memory_free(block);
+}
@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+#include "memory/ComposableAllocator.h"
+#include "memory/StaticAllocatorPool.h"
+
+using namespace wlp;
+
+typedef PoolAllocator<StaticAllocatorPool<32, 4>> small_pool;
+typedef FallbackAllocator<small_pool, MemoryAllocator> pool_or_memory;
+typedef Segregator<32, pool_or_memory, HeapAllocator> segregated;
+typedef StatsAllocator<segregated> policy;
+
+struct Header {
+    uint32_t magic = 0xFEEDBEEF;
+};
+
+struct Canary {
+    uint16_t value = 0xABCD;
+};
+
+struct WideCanary {
+    uint32_t value = 0xCAFEF00D;
+};
+
+TEST(composable_allocator_test, test_pool_allocator_does_not_overflow) {
+    small_pool pool;
+    void *blocks[4];
+    for (auto &block : blocks) {
+        block = pool.Allocate(32);
+        ASSERT_NE(nullptr, block);
+        ASSERT_TRUE(pool.Owns(block));
+    }
+    ASSERT_EQ(nullptr, pool.Allocate(32));
+    ASSERT_EQ(nullptr, pool.Allocate(33));
+    ASSERT_EQ(4u, pool.GetPool().GetTotalBlocks());
+    for (auto &block : blocks) {
+        pool.Deallocate(block, 32);
+    }
+    ASSERT_EQ(4u, pool.GetPool().GetNumPoolBlocksAvail());
+}
+
+TEST(composable_allocator_test, test_fallback_uses_secondary_when_primary_full) {
+    pool_or_memory alloc;
+    void *blocks[6];
+    for (auto &block : blocks) {
+        block = alloc.Allocate(16);
+        ASSERT_NE(nullptr, block);
+    }
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(alloc.GetPrimary().Owns(blocks[i]));
+    }
+    ASSERT_FALSE(alloc.GetPrimary().Owns(blocks[4]));
+    ASSERT_FALSE(alloc.GetPrimary().Owns(blocks[5]));
+    for (auto &block : blocks) {
+        alloc.Deallocate(block, 16);
+    }
+    ASSERT_EQ(4u, alloc.GetPrimary().GetPool().GetNumPoolBlocksAvail());
+}
+
+TEST(composable_allocator_test, test_segregator_routes_by_size) {
+    segregated alloc;
+    void *small = alloc.Allocate(32);
+    void *large = alloc.Allocate(500);
+    ASSERT_TRUE(alloc.GetSmall().GetPrimary().Owns(small));
+    ASSERT_FALSE(alloc.GetSmall().GetPrimary().Owns(large));
+    ASSERT_EQ(3u, alloc.GetSmall().GetPrimary().GetPool().GetNumPoolBlocksAvail());
+    alloc.Deallocate(small, 32);
+    alloc.Deallocate(large, 500);
+    ASSERT_EQ(4u, alloc.GetSmall().GetPrimary().GetPool().GetNumPoolBlocksAvail());
+}
+
+TEST(composable_allocator_test, test_stats_allocator_counts) {
+    policy alloc;
+    void *a = alloc.Allocate(10);
+    void *b = alloc.Allocate(20);
+    void *c = alloc.Allocate(1000);
+    ASSERT_EQ(3u, alloc.GetNumAllocations());
+    ASSERT_EQ(1030u, alloc.GetBytesInUse());
+    alloc.Deallocate(c, 1000);
+    alloc.Deallocate(a, 10);
+    ASSERT_EQ(2u, alloc.GetNumDeallocations());
+    ASSERT_EQ(20u, alloc.GetBytesInUse());
+    ASSERT_EQ(1030u, alloc.GetPeakBytes());
+    alloc.Deallocate(b, 20);
+    ASSERT_EQ(0u, alloc.GetBytesInUse());
+    ASSERT_EQ(0u, alloc.GetNumFailures());
+}
+
+TEST(composable_allocator_test, test_stats_allocator_counts_failures) {
+    StatsAllocator<small_pool> alloc;
+    ASSERT_EQ(nullptr, alloc.Allocate(64));
+    ASSERT_EQ(1u, alloc.GetNumFailures());
+    ASSERT_EQ(0u, alloc.GetNumAllocations());
+    ASSERT_EQ(0u, alloc.GetBytesInUse());
+}
+
+TEST(composable_allocator_test, test_affix_allocator_prefix_and_suffix) {
+    typedef AffixAllocator<MemoryAllocator, Header, Canary> affixed;
+    affixed alloc;
+    ASSERT_EQ(0u, affixed::PREFIX_SIZE % sizeof(void *));
+    auto *data = static_cast<char *>(alloc.Allocate(12));
+    ASSERT_NE(nullptr, data);
+    ASSERT_EQ(0u, (uintptr_t) data % sizeof(void *));
+    ASSERT_EQ(0xFEEDBEEF, affixed::GetPrefix(data)->magic);
+    ASSERT_EQ(0xABCD, affixed::GetSuffix(data, 12)->value);
+    for (int i = 0; i < 12; ++i) {
+        data[i] = (char) i;
+    }
+    ASSERT_EQ(0xFEEDBEEF, affixed::GetPrefix(data)->magic);
+    ASSERT_EQ(0xABCD, affixed::GetSuffix(data, 12)->value);
+    ASSERT_TRUE(alloc.Owns(data));
+    alloc.Deallocate(data, 12);
+}
+
+TEST(composable_allocator_test, test_affix_allocator_aligns_suffix) {
+    typedef AffixAllocator<MemoryAllocator, Header, WideCanary> affixed;
+    affixed alloc;
+    for (size_t size = 1; size <= 9; ++size) {
+        auto *data = static_cast<char *>(alloc.Allocate(size));
+        ASSERT_NE(nullptr, data);
+        WideCanary *suffix = affixed::GetSuffix(data, size);
+        ASSERT_EQ(0u, (uintptr_t) suffix % alignof(WideCanary));
+        ASSERT_LE(data + size, (char *) suffix);
+        memset(data, 0xFF, size);
+        ASSERT_EQ(0xCAFEF00D, suffix->value);
+        alloc.Deallocate(data, size);
+    }
+}
+
+TEST(composable_allocator_test, test_affix_allocator_in_pool) {
+    typedef AffixAllocator<small_pool, Header> affixed;
+    affixed alloc;
+    ASSERT_EQ(0u, affixed::SUFFIX_SIZE);
+    void *fits = alloc.Allocate(32 - affixed::PREFIX_SIZE);
+    ASSERT_NE(nullptr, fits);
+    ASSERT_TRUE(alloc.Owns(fits));
+    ASSERT_EQ(nullptr, alloc.Allocate(32));
+    alloc.Deallocate(fits, 32 - affixed::PREFIX_SIZE);
+    ASSERT_EQ(4u, alloc.GetAllocator().GetPool().GetNumPoolBlocksAvail());
+}
@@ -0,0 +1,169 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "memory/EpochReclaimer.h"
+
+using namespace wlp;
+
+static constexpr uint64_t CHECK_KEY = 0x5A5A5A5A5A5A5A5Aull;
+static constexpr uint64_t POISON = 0xDEADDEADDEADDEADull;
+
+struct Node : EpochEntry {
+    uint64_t value;
+    uint64_t check;
+};
+
+/**
+ * Pool that poisons blocks on de-allocation so that a reader
+ * touching a reclaimed node observes an inconsistent node.
+ */
+struct PoisonPool {
+    Allocator m_allocator;
+
+    PoisonPool() : m_allocator(sizeof(Node), sizeof(Node) * 512) {}
+
+    void *Allocate() {
+        return m_allocator.Allocate();
+    }
+
+    void Deallocate(void *pBlock) {
+        auto *node = static_cast<Node *>(pBlock);
+        node->value = POISON;
+        node->check = POISON;
+        m_allocator.Deallocate(pBlock);
+    }
+};
+
+typedef EpochReclaimer<PoisonPool, 8, 16> reclaimer_type;
+
+static Node *make_node(reclaimer_type &reclaimer, uint64_t value) {
+    auto *node = static_cast<Node *>(reclaimer.Allocate());
+    node->value = value;
+    node->check = value ^ CHECK_KEY;
+    return node;
+}
+
+TEST(epoch_reclaimer_test, test_register_unregister) {
+    PoisonPool pool;
+    EpochReclaimer<PoisonPool, 2, 16> reclaimer(&pool);
+    auto *p1 = reclaimer.Register();
+    auto *p2 = reclaimer.Register();
+    ASSERT_NE(nullptr, p1);
+    ASSERT_NE(nullptr, p2);
+    ASSERT_NE(p1, p2);
+    ASSERT_EQ(nullptr, reclaimer.Register());
+    reclaimer.Unregister(p1);
+    ASSERT_EQ(p1, reclaimer.Register());
+}
+
+TEST(epoch_reclaimer_test, test_reclaims_without_readers) {
+    PoisonPool pool;
+    {
+        reclaimer_type reclaimer(&pool);
+        auto *p = reclaimer.Register();
+        for (uint64_t i = 0; i < 200; ++i) {
+            reclaimer.Retire(p, make_node(reclaimer, i));
+        }
+        ASSERT_EQ(200u, reclaimer.GetNumRetired());
+        ASSERT_GT(reclaimer.GetNumReclaimed(), 100u);
+        ASSERT_GT(reclaimer.GetEpoch(), 2u);
+    }
+    ASSERT_EQ(pool.m_allocator.GetNumAllocations(), pool.m_allocator.GetNumDeallocations());
+}
+
+TEST(epoch_reclaimer_test, test_pinned_reader_blocks_reclamation) {
+    PoisonPool pool;
+    reclaimer_type reclaimer(&pool);
+    auto *reader = reclaimer.Register();
+    auto *writer = reclaimer.Register();
+    reclaimer.Enter(reader);
+    Node *held = make_node(reclaimer, 42);
+    reclaimer.Retire(writer, held);
+    for (uint64_t i = 0; i < 100; ++i) {
+        reclaimer.Retire(writer, make_node(reclaimer, i));
+    }
+    ASSERT_EQ(0u, reclaimer.GetNumReclaimed());
+    ASSERT_EQ(42u, held->value);
+    ASSERT_EQ(42 ^ CHECK_KEY, held->check);
+    reclaimer.Exit(reader);
+    for (uint64_t i = 0; i < 100; ++i) {
+        reclaimer.Retire(writer, make_node(reclaimer, i));
+    }
+    ASSERT_GT(reclaimer.GetNumReclaimed(), 0u);
+}
+
+TEST(epoch_reclaimer_test, test_guard_pins_epoch) {
+    PoisonPool pool;
+    reclaimer_type reclaimer(&pool);
+    auto *p = reclaimer.Register();
+    {
+        EpochGuard<reclaimer_type> guard(reclaimer, p);
+        ASSERT_TRUE(reclaimer.TryAdvance());
+        ASSERT_FALSE(reclaimer.TryAdvance());
+    }
+    ASSERT_TRUE(reclaimer.TryAdvance());
+}
+
+TEST(epoch_reclaimer_test, test_stress_concurrent_readers_and_writers) {
+    const int num_readers = 4;
+    const int num_writers = 2;
+    const uint64_t writes_per_writer = 20000;
+    PoisonPool pool;
+    uint64_t failures = 0;
+    {
+        reclaimer_type reclaimer(&pool);
+        Node *shared = make_node(reclaimer, 0);
+        bool done = false;
+        std::vector<std::thread> threads;
+        for (int r = 0; r < num_readers; ++r) {
+            threads.emplace_back([&]() {
+                auto *p = reclaimer.Register();
+                uint64_t local_failures = 0;
+                while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                    {
+                        EpochGuard<reclaimer_type> guard(reclaimer, p);
+                        Node *node = __atomic_load_n(&shared, __ATOMIC_ACQUIRE);
+                        uint64_t value = __atomic_load_n(&node->value, __ATOMIC_RELAXED);
+                        uint64_t check = __atomic_load_n(&node->check, __ATOMIC_RELAXED);
+                        if ((value ^ CHECK_KEY) != check) {
+                            ++local_failures;
+                        }
+                    }
+                    // give writers a chance to run outside of a critical section on few cores
+                    std::this_thread::yield();
+                }
+                reclaimer.Unregister(p);
+                __atomic_add_fetch(&failures, local_failures, __ATOMIC_RELAXED);
+            });
+        }
+        std::vector<std::thread> writers;
+        for (int w = 0; w < num_writers; ++w) {
+            writers.emplace_back([&, w]() {
+                auto *p = reclaimer.Register();
+                for (uint64_t i = 1; i <= writes_per_writer; ++i) {
+                    Node *node = make_node(reclaimer, i * num_writers + (uint64_t) w);
+                    Node *old = __atomic_exchange_n(&shared, node, __ATOMIC_ACQ_REL);
+                    reclaimer.Retire(p, old);
+                    if (i % 64 == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+                reclaimer.Unregister(p);
+            });
+        }
+        for (auto &writer : writers) {
+            writer.join();
+        }
+        __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(num_writers * writes_per_writer, reclaimer.GetNumRetired());
+        ASSERT_GT(reclaimer.GetNumReclaimed(), 0u);
+        auto *p = reclaimer.Register();
+        reclaimer.Retire(p, shared);
+    }
+    ASSERT_EQ(0u, failures);
+    ASSERT_EQ(pool.m_allocator.GetNumAllocations(), pool.m_allocator.GetNumDeallocations());
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "memory/Allocator.h"
+#include "memory/Memory.h"
+#include "memory/NoAllocScope.h"
+#include "stl/ArrayList.h"
+
+#include "../no_alloc_fixture.h"
+
+using namespace wlp;
+
+static const char *trapped = nullptr;
+
+static void record_trap(const char *what) {
+    trapped = what;
+}
+
+TEST_F(no_alloc_test, test_counts_memory_alloc) {
+    void *block = nullptr;
+    ASSERT_EQ(1u, count_allocations([&]() { block = memory_alloc(16); }));
+    ASSERT_EQ(0u, count_allocations([&]() { memory_free(block); }));
+}
+
+TEST_F(no_alloc_test, test_array_list_growth_allocates) {
+    ArrayList<int> list(4);
+    ASSERT_NO_ALLOC(for (int i = 0; i < 4; ++i) list.push_back(i));
+    ASSERT_EQ(1u, count_allocations([&]() { list.push_back(4); }));
+}
+
+TEST_F(no_alloc_test, test_counts_heap_overflow) {
+    Allocator allocator(16, 32);
+    void *blocks[3];
+    ASSERT_NO_ALLOC(blocks[0] = allocator.Allocate(); blocks[1] = allocator.Allocate());
+    NoAllocScope scope;
+    blocks[2] = allocator.Allocate();
+    ASSERT_EQ(1u, scope.GetNumHeapOverflows());
+    ASSERT_EQ(0u, scope.GetNumAllocations());
+    for (auto &block : blocks) {
+        allocator.Deallocate(block);
+    }
+}
+
+TEST(no_alloc_scope_test, test_nested_scopes) {
+    NoAllocScope outer;
+    void *a = memory_alloc(8);
+    {
+        NoAllocScope inner;
+        void *b = memory_alloc(8);
+        ASSERT_EQ(1u, inner.GetNumAllocations());
+        memory_free(b);
+    }
+    void *c = memory_alloc(8);
+    // the enclosing scope also records the event of the inner scope
+    ASSERT_EQ(3u, outer.GetNumAllocations());
+    memory_free(a);
+    memory_free(c);
+}
+
+TEST(no_alloc_scope_test, test_inner_count_scope_keeps_outer_trap) {
+    NoAllocScope::SetTrapHandler(record_trap);
+    trapped = nullptr;
+    {
+        NoAllocScope outer(NoAllocScope::TRAP);
+        NoAllocScope inner;
+        void *block = memory_alloc(8);
+        ASSERT_NE(nullptr, trapped);
+        ASSERT_EQ(1u, inner.GetNumAllocations());
+        ASSERT_EQ(1u, outer.GetNumAllocations());
+        memory_free(block);
+    }
+    NoAllocScope::SetTrapHandler(nullptr);
+}
+
+TEST(no_alloc_scope_test, test_trap_mode_calls_handler) {
+    NoAllocScope::SetTrapHandler(record_trap);
+    trapped = nullptr;
+    {
+        NoAllocScope scope(NoAllocScope::TRAP);
+        void *block = memory_alloc(8);
+        ASSERT_NE(nullptr, trapped);
+        ASSERT_EQ(1u, scope.GetNumAllocations());
+        memory_free(block);
+    }
+    trapped = nullptr;
+    void *block = memory_alloc(8);
+    ASSERT_EQ(nullptr, trapped);
+    memory_free(block);
+    NoAllocScope::SetTrapHandler(nullptr);
+}
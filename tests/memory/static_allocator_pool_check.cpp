@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "memory/StaticAllocatorPool.h"
+#include "stl/StaticOpenMap.h"
+
+using namespace wlp;
+
+struct Link {
+    Link *next;
+    uint32_t value;
+};
+
+typedef StaticAllocatorPool<sizeof(Link), 8> link_pool;
+
+static Link *push(link_pool &pool, Link *head, uint32_t value) {
+    auto *link = static_cast<Link *>(pool.Allocate());
+    link->next = head;
+    link->value = value;
+    return link;
+}
+
+TEST(static_allocator_pool_test, test_restore_rewinds_pool_contents) {
+    link_pool pool;
+    Link *head = nullptr;
+    for (uint32_t i = 0; i < 3; ++i) {
+        head = push(pool, head, i);
+    }
+    link_pool::Checkpoint checkpoint;
+    Link *saved_head = head;
+    ASSERT_TRUE(pool.SaveCheckpoint(checkpoint));
+
+    head->value = 100;
+    Link *removed = head->next;
+    head->next = removed->next;
+    pool.Deallocate(removed);
+    for (uint32_t i = 10; i < 14; ++i) {
+        head = push(pool, head, i);
+    }
+    ASSERT_EQ(2u, pool.GetNumPoolBlocksAvail());
+
+    ASSERT_TRUE(pool.RestoreCheckpoint(checkpoint));
+    head = saved_head;
+    ASSERT_EQ(5u, pool.GetNumPoolBlocksAvail());
+    ASSERT_EQ(3u, pool.GetNumAllocations());
+    ASSERT_EQ(0u, pool.GetNumDeallocations());
+    uint32_t expected = 2;
+    for (Link *link = head; link; link = link->next) {
+        ASSERT_EQ(expected--, link->value);
+    }
+
+    // the free list is rewound too so the same blocks are handed out again
+    Link *a = push(pool, head, 20);
+    ASSERT_TRUE(pool.RestoreCheckpoint(checkpoint));
+    ASSERT_EQ(a, push(pool, head, 21));
+}
+
+TEST(static_allocator_pool_test, test_checkpoint_fails_after_heap_overflow) {
+    link_pool pool;
+    link_pool::Checkpoint checkpoint;
+    ASSERT_TRUE(pool.SaveCheckpoint(checkpoint));
+    void *blocks[9];
+    for (auto &block : blocks) {
+        block = pool.Allocate();
+    }
+    ASSERT_FALSE(pool.IsPoolBlock(blocks[8]));
+    ASSERT_FALSE(pool.SaveCheckpoint(checkpoint));
+    ASSERT_FALSE(pool.RestoreCheckpoint(checkpoint));
+    ASSERT_EQ(9u, pool.GetNumAllocations());
+    for (auto &block : blocks) {
+        pool.Deallocate(block);
+    }
+}
+
+TEST(static_allocator_pool_test, test_pool_blocks_are_aligned) {
+    StaticAllocatorPool<sizeof(max_align_t), 4> pool;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(0u, (uintptr_t) pool.Allocate() % alignof(max_align_t));
+    }
+}
+
+typedef StaticOpenHashMap<uint16_t, uint16_t, 12> inline_map;
+static constexpr uint16_t MAP_BLOCK_SIZE =
+        (sizeof(inline_map) + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+typedef StaticAllocatorPool<MAP_BLOCK_SIZE, 2> map_pool;
+
+TEST(static_allocator_pool_test, test_restore_rewinds_containers_created_in_pool) {
+    map_pool pool;
+    inline_map *map = pool.Create<inline_map>();
+    ASSERT_NE(nullptr, map);
+    for (uint16_t i = 0; i < 8; ++i) {
+        (*map)[i] = static_cast<uint16_t>(i * 10);
+    }
+    map_pool::Checkpoint checkpoint;
+    ASSERT_TRUE(pool.SaveCheckpoint(checkpoint));
+
+    map->erase(3);
+    (*map)[5] = 500;
+    for (uint16_t i = 20; i < 24; ++i) {
+        map->insert(i, i);
+    }
+    inline_map *other = pool.Create<inline_map>();
+    ASSERT_NE(nullptr, other);
+    ASSERT_EQ(nullptr, pool.Create<inline_map>());
+    ASSERT_EQ(11u, map->size());
+
+    ASSERT_TRUE(pool.RestoreCheckpoint(checkpoint));
+    ASSERT_EQ(8u, map->size());
+    for (uint16_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(i * 10, *map->find(i));
+    }
+    ASSERT_FALSE(map->contains(20));
+    // the second map was created after the checkpoint, so its block is free again
+    ASSERT_EQ(1u, pool.GetNumPoolBlocksAvail());
+    pool.Destroy(map);
+    ASSERT_EQ(2u, pool.GetNumPoolBlocksAvail());
+}
@@ -0,0 +1,48 @@
+#ifndef NO_ALLOC_FIXTURE_H
+#define NO_ALLOC_FIXTURE_H
+
+#include "gtest/gtest.h"
+
+#include "memory/NoAllocScope.h"
+
+/**
+ * Test fixture for asserting that a code path does not allocate. Tests
+ * pass the code under test as a lambda, for instance
+ *
+ * @code
+ * TEST_F(no_alloc_test, test_push_back_within_capacity) {
+ *     ArrayList<int> list(8);
+ *     ASSERT_EQ(0, count_allocations([&]() { list.push_back(1); }));
+ * }
+ * @endcode
+ *
+ * With NDEBUG defined every count reads zero.
+ */
+class no_alloc_test : public ::testing::Test {
+protected:
+    /**
+     * Runs the code path and counts memory_alloc calls and pool overflows to the heap
+     *
+     * @param function the code path under test
+     * @return the number of allocation events
+     */
+    template<typename Function>
+    size_t count_allocations(Function function) {
+        wlp::NoAllocScope scope;
+        function();
+        return scope.GetNumAllocations() + scope.GetNumHeapOverflows();
+    }
+};
+
+/**
+ * Asserts that a statement performs no allocation
+ */
+#define ASSERT_NO_ALLOC(statement) \
+    do { \
+        wlp::NoAllocScope no_alloc_scope_; \
+        statement; \
+        ASSERT_EQ((size_t) 0, no_alloc_scope_.GetNumAllocations()); \
+        ASSERT_EQ((size_t) 0, no_alloc_scope_.GetNumHeapOverflows()); \
+    } while (false)
+
+#endif //NO_ALLOC_FIXTURE_H
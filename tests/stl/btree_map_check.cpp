@@ -0,0 +1,248 @@
+#include <map>
+
+#include "gtest/gtest.h"
+#include "stl/BTreeMap.h"
+
+#include "Types.h"
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef uint16_t ui16;
+typedef StaticString<16> String16;
+typedef BTreeMap<ui16, ui16> int_map;
+// few entries per node, so that small maps have several levels
+typedef BTreeMap<ui16, ui16, Comparator<ui16>, 32> small_map;
+
+static constexpr ui16 NUM_KEYS = 2000;
+
+/**
+ * Pseudo-random permutation of the keys below NUM_KEYS.
+ */
+static ui16 shuffled(ui16 i) {
+    return static_cast<ui16>((i * 1237u + 11u) % NUM_KEYS);
+}
+
+template<class Map>
+static void check_matches(const Map &map, const std::map<ui16, ui16> &expected) {
+    ASSERT_EQ(expected.size(), map.size());
+    typename Map::const_iterator it = map.begin();
+    for (auto &element : expected) {
+        ASSERT_NE(map.end(), it);
+        ASSERT_EQ(element.first, it.key());
+        ASSERT_EQ(element.second, *it);
+        ASSERT_EQ(it, map.find(element.first));
+        ++it;
+    }
+    ASSERT_EQ(map.end(), it);
+}
+
+TEST(btree_map_test, test_node_capacity) {
+    ASSERT_GE(256u, sizeof(int_map::leaf_type));
+    ASSERT_GE(256u, sizeof(int_map::inner_type));
+    ASSERT_LT(32, int_map::leaf_type::CAPACITY);
+    ASSERT_EQ(4, small_map::inner_type::CAPACITY);
+    ASSERT_EQ(4, small_map::leaf_type::CAPACITY);
+}
+
+TEST(btree_map_test, test_empty_map) {
+    int_map map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.end(), map.begin());
+    ASSERT_EQ(map.end(), map.find(1));
+    ASSERT_EQ(map.end(), map.lower_bound(1));
+    ASSERT_EQ(map.end(), map.upper_bound(1));
+    ASSERT_FALSE(map.contains(1));
+    ASSERT_FALSE(map.erase(1));
+    ASSERT_EQ(0, map.height());
+}
+
+TEST(btree_map_test, test_insert_and_find) {
+    small_map map;
+    std::map<ui16, ui16> expected;
+    for (ui16 i = 0; i < NUM_KEYS; ++i) {
+        ui16 key = shuffled(i);
+        Pair<small_map::iterator, bool> res = map.insert(key, i);
+        ASSERT_TRUE(res.second());
+        ASSERT_EQ(key, res.first().key());
+        ASSERT_EQ(i, *res.first());
+        expected[key] = i;
+    }
+    ASSERT_LE(4, map.height());
+    check_matches(map, expected);
+    Pair<small_map::iterator, bool> res = map.insert(shuffled(5), 0);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(5, *res.first());
+    for (ui16 key = 0; key < NUM_KEYS; ++key) {
+        ASSERT_EQ(expected[key], *map.find(key));
+    }
+    ASSERT_EQ(map.end(), map.find(NUM_KEYS));
+}
+
+TEST(btree_map_test, test_sequential_insert) {
+    small_map ascending;
+    small_map descending;
+    std::map<ui16, ui16> expected;
+    for (ui16 i = 0; i < NUM_KEYS; ++i) {
+        ascending[i] = i;
+        descending[static_cast<ui16>(NUM_KEYS - 1 - i)] = static_cast<ui16>(NUM_KEYS - 1 - i);
+        expected[i] = i;
+    }
+    check_matches(ascending, expected);
+    check_matches(descending, expected);
+}
+
+TEST(btree_map_test, test_assign) {
+    int_map map;
+    map[4] = 40;
+    ASSERT_EQ(40, map[4]);
+    ASSERT_EQ(0, map[5]);
+    Pair<int_map::iterator, bool> res = map.insert_or_assign(4, 41);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(41, *map.find(4));
+    res = map.insert_or_assign(6, 60);
+    ASSERT_TRUE(res.second());
+    ASSERT_EQ(3u, map.size());
+}
+
+TEST(btree_map_test, test_bounds) {
+    small_map map;
+    // even keys only
+    for (ui16 i = 0; i < NUM_KEYS; ++i) {
+        map[static_cast<ui16>(2 * shuffled(i))] = shuffled(i);
+    }
+    ASSERT_EQ(10, map.lower_bound(10).key());
+    ASSERT_EQ(12, map.upper_bound(10).key());
+    ASSERT_EQ(12, map.lower_bound(11).key());
+    ASSERT_EQ(12, map.upper_bound(11).key());
+    ASSERT_EQ(0, map.lower_bound(0).key());
+    ASSERT_EQ(map.end(), map.lower_bound(2 * NUM_KEYS));
+    ASSERT_EQ(map.end(), map.upper_bound(2 * NUM_KEYS - 2));
+    // every range query visits exactly the keys in the range
+    for (ui16 lo = 0; lo < 2 * NUM_KEYS; lo = static_cast<ui16>(lo + 97)) {
+        ui16 hi = static_cast<ui16>(lo + 301);
+        ui16 expected = static_cast<ui16>((lo + 1) / 2 * 2);
+        small_map::iterator last = map.upper_bound(hi);
+        for (small_map::iterator it = map.lower_bound(lo); it != last; ++it) {
+            ASSERT_EQ(expected, it.key());
+            ASSERT_EQ(expected / 2, *it);
+            expected = static_cast<ui16>(expected + 2);
+        }
+        ui16 end = static_cast<ui16>(hi < 2 * NUM_KEYS ? hi / 2 * 2 + 2 : 2 * NUM_KEYS);
+        ASSERT_EQ(end, expected);
+    }
+    const small_map &cmap = map;
+    ASSERT_EQ(20, cmap.lower_bound(19).key());
+    ASSERT_EQ(22, cmap.upper_bound(20).key());
+    ASSERT_EQ(10, *cmap.find(20));
+}
+
+TEST(btree_map_test, test_erase) {
+    small_map map;
+    std::map<ui16, ui16> expected;
+    for (ui16 i = 0; i < NUM_KEYS; ++i) {
+        map[shuffled(i)] = i;
+        expected[shuffled(i)] = i;
+    }
+    for (ui16 i = 0; i < NUM_KEYS; i = static_cast<ui16>(i + 3)) {
+        ui16 key = shuffled(static_cast<ui16>(i * 7 % NUM_KEYS));
+        ASSERT_EQ(expected.erase(key) == 1, map.erase(key));
+    }
+    ASSERT_FALSE(map.erase(NUM_KEYS));
+    check_matches(map, expected);
+    for (ui16 i = 0; i < NUM_KEYS; ++i) {
+        ui16 key = shuffled(i);
+        ASSERT_EQ(expected.erase(key) == 1, map.erase(key));
+        if (i % 100 == 0) {
+            check_matches(map, expected);
+        }
+    }
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(0, map.height());
+    ASSERT_EQ(map.end(), map.begin());
+    map[3] = 3;
+    ASSERT_EQ(3, *map.begin());
+}
+
+TEST(btree_map_test, test_erase_iterator) {
+    small_map map;
+    for (ui16 i = 0; i < 500; ++i) {
+        map[i] = i;
+    }
+    ui16 expected = 0;
+    for (small_map::iterator it = map.begin(); it != map.end();) {
+        ASSERT_EQ(expected, it.key());
+        if (it.key() % 3 == 0) {
+            map.erase(it);
+        } else {
+            ++it;
+        }
+        ++expected;
+    }
+    ASSERT_EQ(500, expected);
+    ASSERT_EQ(333u, map.size());
+    for (ui16 i = 0; i < 500; ++i) {
+        ASSERT_EQ(i % 3 != 0, map.contains(i));
+    }
+    small_map::iterator last = map.find(499);
+    map.erase(last);
+    ASSERT_EQ(map.end(), last);
+}
+
+TEST(btree_map_test, test_reverse_comparator) {
+    BTreeMap<ui16, ui16, ReverseComparator<ui16>, 32> map;
+    for (ui16 i = 0; i < 100; ++i) {
+        map[shuffled(i)] = i;
+    }
+    ui16 prev = map.begin().key();
+    for (auto it = ++map.begin(); it != map.end(); ++it) {
+        ASSERT_GT(prev, it.key());
+        prev = it.key();
+    }
+    // bounds follow the comparator order
+    ui16 key = map.begin().key();
+    ASSERT_EQ(key, map.lower_bound(key).key());
+    ASSERT_GT(key, map.upper_bound(key).key());
+}
+
+TEST(btree_map_test, test_string_keys) {
+    BTreeMap<String16, ui16> map;
+    const char *words[] = {"pear", "apple", "fig", "banana", "cherry"};
+    for (ui16 i = 0; i < 5; ++i) {
+        map[String16(words[i])] = i;
+    }
+    const char *sorted[] = {"apple", "banana", "cherry", "fig", "pear"};
+    ui16 i = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ASSERT_STREQ(sorted[i++], it.key().c_str());
+    }
+    ASSERT_STREQ("cherry", map.lower_bound(String16("c")).key().c_str());
+    ASSERT_TRUE(map.erase(String16("fig")));
+    ASSERT_STREQ("pear", map.upper_bound(String16("cherry")).key().c_str());
+}
+
+TEST(btree_map_test, test_move) {
+    small_map map;
+    for (ui16 i = 0; i < 300; ++i) {
+        map[i] = static_cast<ui16>(i + 1);
+    }
+    small_map moved(move(map));
+    ASSERT_EQ(300u, moved.size());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(map.end(), map.begin());
+    ASSERT_EQ(51, *moved.find(50));
+    small_map assigned;
+    assigned[1] = 1;
+    assigned = move(moved);
+    ASSERT_EQ(300u, assigned.size());
+    ASSERT_EQ(2, *assigned.find(1));
+    assigned.clear();
+    ASSERT_TRUE(assigned.empty());
+    ASSERT_EQ(assigned.end(), assigned.find(1));
+}
+
+TEST(btree_map_test, test_nodes_come_from_allocators) {
+    int_map map(64);
+    ASSERT_EQ(sizeof(int_map::leaf_type), map.get_leaf_allocator()->GetBlockSize());
+    ASSERT_EQ(sizeof(int_map::inner_type), map.get_inner_allocator()->GetBlockSize());
+}
@@ -1,8 +1,11 @@
 #include "gtest/gtest.h"
 #include "stl/ChainMap.h"
+#include "memory/ComposableAllocator.h"
+#include "memory/StaticAllocatorPool.h"
 
 #include "Types.h"
 #include "../template_defs.h"
+#include "../tracked_value.h"
 
 using namespace wlp;
 
@@ -87,7 +90,7 @@ TEST(chain_map_test, test_ensure_capacity_holes) {
     map[16] = 16;
     map[21] = 21;
     map[26] = 26;
-    ASSERT_EQ(20, map.capacity());
+    ASSERT_EQ(20u, map.capacity());
     ui16 expected_values_traverse[] = {1, 21, 26, 6, 11, 16};
     imi it = map.begin();
     for (ui16 i = 0; i < 6; i++) {
@@ -97,8 +100,8 @@ TEST(chain_map_test, test_ensure_capacity_holes) {
     ASSERT_EQ(map.end(), it);
     map.clear();
     ASSERT_EQ(map.end(), map.begin());
-    ASSERT_EQ(0, map.size());
-    ASSERT_EQ(20, map.capacity());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(20u, map.capacity());
 }
 
 TEST(chain_map_test, test_erase_cases) {
@@ -117,9 +120,9 @@ TEST(chain_map_test, test_erase_cases) {
 
 TEST(chain_map_test, test_constructor_params) {
     int_map map(10, 150);
-    ASSERT_EQ(10, map.capacity());
+    ASSERT_EQ(10u, map.capacity());
     ASSERT_EQ(150, map.max_load());
-    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(0u, map.size());
     ASSERT_TRUE(map.empty());
 }
 
@@ -130,6 +133,19 @@ TEST(chain_map_test, test_constructor_allocator) {
     ASSERT_EQ(expected * 10, map.get_node_allocator()->GetPoolSize());
 }
 
+TEST(chain_map_test, test_node_pool_fits_the_size_type) {
+    // the pool holds the requested nodes only as far as they fit the size type
+    string_map map(2000, 75);
+    uint64_t node_size = sizeof(string_map::node_type);
+    uint64_t requested = 2000 * node_size;
+    uint64_t fitting = max_size_type / node_size * node_size;
+    ASSERT_EQ(requested < fitting ? requested : fitting, map.get_node_allocator()->GetPoolSize());
+    for (uint16_t i = 0; i < 100; ++i) {
+        map[String16{"key"} + static_cast<char>('a' + i % 26) + static_cast<char>('a' + i / 26)] = String16{"val"};
+    }
+    ASSERT_EQ(100u, map.size());
+}
+
 TEST(chain_map_test, test_begin_returns_end_when_empty) {
     string_map map(10, 100);
     ASSERT_EQ(map.begin(), map.end());
@@ -151,7 +167,7 @@ TEST(chain_map_test, test_insert_at_iterator_no_collision) {
             map.insert(3, 30),
             map.insert(4, 40)
     };
-    ASSERT_EQ(5, map.size());
+    ASSERT_EQ(5u, map.size());
     for (ui16 i = 0; i < 5; i++) {
         ASSERT_TRUE(r[i].second());
         ASSERT_EQ(values[i], *r[i].first());
@@ -200,7 +216,7 @@ TEST(chain_map_test, test_insert_at_iterator_collision_resolution) {
     for (ui16 i = 0; i < 15; i++) {
         ASSERT_EQ(values[i], *r[i].first());
     }
-    ASSERT_EQ(15, map.size());
+    ASSERT_EQ(15u, map.size());
     imi it = r[14].first();
     ASSERT_EQ(it, map.begin());
     ui16 expected_values_traverse[] = {
@@ -231,13 +247,13 @@ TEST(chain_map_test, test_insert_or_assign) {
     String16 v3{"value3"};
     P_smi_b r1 = map.insert_or_assign(a1, v1);
     P_smi_b r2 = map.insert_or_assign(a2, v2);
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
     ASSERT_TRUE(r1.second());
     ASSERT_TRUE(r2.second());
     ASSERT_EQ(v1, *map.at(a1));
     ASSERT_EQ(v2, *map.at(a2));
     P_smi_b r3 = map.insert_or_assign(a1, v3);
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
     ASSERT_FALSE(r3.second());
     ASSERT_EQ(v3, *r3.first());
     ASSERT_EQ(v3, *map.at(a1));
@@ -247,7 +263,7 @@ TEST(chain_map_test, test_erase_key_nothing) {
     string_map map(15, 255);
     String16 a{"key"};
     ASSERT_FALSE(map.erase(a));
-    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(0u, map.size());
 }
 
 TEST(chain_map_test, test_erase_key) {
@@ -255,9 +271,9 @@ TEST(chain_map_test, test_erase_key) {
     String16 a{"key"};
     String16 b{"val"};
     map.insert(a, b);
-    ASSERT_EQ(1, map.size());
+    ASSERT_EQ(1u, map.size());
     ASSERT_TRUE(map.erase(a));
-    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(0u, map.size());
 }
 
 TEST(chain_map_test, test_erase_iterator) {
@@ -268,23 +284,23 @@ TEST(chain_map_test, test_erase_iterator) {
     P_imi_b r0 = map.insert(0, 0);
     P_imi_b r1 = map.insert(1, 1);
     P_imi_b r3 = map.insert(3, 3);
-    ASSERT_EQ(3, map.size());
+    ASSERT_EQ(3u, map.size());
     P_imi_b r20 = map.insert(20, 20);
     P_imi_b r33 = map.insert(33, 33);
     map.insert(40, 40);
-    ASSERT_EQ(6, map.size());
+    ASSERT_EQ(6u, map.size());
     imi it = r1.first();
     map.erase(it);
-    ASSERT_EQ(5, map.size());
+    ASSERT_EQ(5u, map.size());
     ASSERT_EQ(33, *it);
     ASSERT_EQ(it, r33.first());
     map.erase(it);
-    ASSERT_EQ(4, map.size());
+    ASSERT_EQ(4u, map.size());
     ASSERT_EQ(3, *it);
-    ASSERT_NE(it, r3.first()); // iterator invalidated by erase
+    ASSERT_EQ(it, r3.first()); // erase relinks, the next node stays in place
     ASSERT_EQ(*it, *r3.first());
     map.erase(it);
-    ASSERT_EQ(3, map.size());
+    ASSERT_EQ(3u, map.size());
     ASSERT_EQ(map.end(), it);
     ASSERT_EQ(40, *map.at(40));
     ASSERT_EQ(20, *map.at(20));
@@ -294,13 +310,13 @@ TEST(chain_map_test, test_erase_iterator) {
     ASSERT_EQ(map.end(), map.at(33));
     it = r20.first();
     map.erase(it);
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
     ASSERT_EQ(0, *it);
-    ASSERT_NE(it, r0.first());
+    ASSERT_EQ(it, r0.first());
     ASSERT_EQ(0, *r0.first());
     map.erase(it);
     ASSERT_EQ(map.end(), it);
-    ASSERT_EQ(1, map.size());
+    ASSERT_EQ(1u, map.size());
     ASSERT_EQ(40, *map.begin());
 }
 
@@ -311,12 +327,12 @@ TEST(chain_map_test, test_contains_access_operator) {
     map[0] = 0;
     map[20] = 200;
     map[25] = 250;
-    ASSERT_EQ(5, map.size());
+    ASSERT_EQ(5u, map.size());
     map.insert(3, 30);
-    ASSERT_EQ(6, map.size());
+    ASSERT_EQ(6u, map.size());
     ASSERT_EQ(30, *map.at(3));
     map[3] = 33;
-    ASSERT_EQ(6, map.size());
+    ASSERT_EQ(6u, map.size());
     ASSERT_EQ(33, *map.at(3));
     ASSERT_EQ(50, map[5]);
     ASSERT_EQ(150, map[15]);
@@ -330,10 +346,10 @@ TEST(chain_map_test, test_contains_access_operator) {
     ASSERT_FALSE(map.contains(4));
     map[24] = 24;
     ASSERT_FALSE(map.contains(4));
-    ASSERT_EQ(8, map.size());
+    ASSERT_EQ(8u, map.size());
     map[4] = 4;
     ASSERT_TRUE(map.contains(4));
-    ASSERT_EQ(9, map.size());
+    ASSERT_EQ(9u, map.size());
 }
 
 TEST(chain_map_test, test_find) {
@@ -418,8 +434,473 @@ TEST(chain_map_test, test_move_assignment_op) {
     map.insert(3, 15);
     int_map map1(10, 255);
     map1 = move(map);
-    ASSERT_EQ(3, map1.size());
+    ASSERT_EQ(3u, map1.size());
     ASSERT_EQ(5, map1[1]);
     ASSERT_EQ(10, map1[2]);
     ASSERT_EQ(15, map1[3]);
 }
+
+TEST(chain_map_test, test_power_of_two_capacity) {
+    typedef ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, PowerOfTwoIndex> pow2_map;
+    pow2_map map(12, 75);
+    ASSERT_EQ(16u, map.capacity());
+    for (ui16 i = 0; i < 100; ++i) {
+        map[static_cast<ui16>(i * 16)] = i;
+    }
+    ASSERT_EQ(100u, map.size());
+    ASSERT_EQ(256u, map.capacity());
+    for (ui16 i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, *map.find(static_cast<ui16>(i * 16)));
+    }
+    for (ui16 i = 0; i < 100; i = static_cast<ui16>(i + 2)) {
+        ui16 k = static_cast<ui16>(i * 16);
+        ASSERT_TRUE(map.erase(k));
+    }
+    ASSERT_EQ(50u, map.size());
+    ui16 count = 0;
+    for (pow2_map::iterator it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(1, *it % 2);
+        ++count;
+    }
+    ASSERT_EQ(50, count);
+}
+
+TEST(chain_map_test, test_probe_length) {
+    int_map map(10, 200);
+    map[8] = 80;
+    map[18] = 180;
+    map[28] = 280;
+    // chains are prepended to
+    ASSERT_EQ(1u, map.probe_length(28));
+    ASSERT_EQ(2u, map.probe_length(18));
+    ASSERT_EQ(3u, map.probe_length(8));
+    ASSERT_EQ(4u, map.probe_length(38));
+    ASSERT_EQ(1u, map.probe_length(5));
+}
+
+struct chain_counting_hash {
+    static ui16 calls;
+
+    ui16 operator()(ui16 key) const {
+        ++calls;
+        return key;
+    }
+};
+
+ui16 chain_counting_hash::calls = 0;
+
+TEST(chain_map_test, test_iteration_does_not_hash) {
+    ChainHashMap<ui16, ui16, chain_counting_hash, Equal<ui16>> map(16, 200);
+    for (ui16 i = 0; i < 20; ++i) {
+        map[static_cast<ui16>(i * 3)] = i;
+    }
+    chain_counting_hash::calls = 0;
+    ui16 count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    const auto &const_map = map;
+    for (auto it = const_map.begin(); it != const_map.end(); it++) {
+        ++count;
+    }
+    ASSERT_EQ(40, count);
+    ASSERT_EQ(0, chain_counting_hash::calls);
+}
+
+TEST(chain_map_test, test_iterator_key) {
+    int_map map(16, 75);
+    for (ui16 i = 0; i < 20; ++i) {
+        map[static_cast<ui16>(i * 3)] = static_cast<ui16>(i * 30);
+    }
+    ui16 count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(it.key() * 10, *it);
+        ++count;
+    }
+    const auto &const_map = map;
+    for (auto it = const_map.begin(); it != const_map.end(); ++it) {
+        ASSERT_EQ(it.key() * 10, *it);
+        ++count;
+    }
+    ASSERT_EQ(40, count);
+}
+
+TEST(chain_map_test, test_erase_iterator_does_not_hash) {
+    ChainHashMap<ui16, ui16, chain_counting_hash, Equal<ui16>> map(16, 200);
+    for (ui16 i = 0; i < 20; ++i) {
+        map[static_cast<ui16>(i * 3)] = i;
+    }
+    chain_counting_hash::calls = 0;
+    auto it = map.begin();
+    while (it != map.end()) {
+        map.erase(it);
+    }
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(0, chain_counting_hash::calls);
+}
+
+TEST(chain_map_test, test_heterogeneous_lookup) {
+    string_map map(16, 75);
+    map[String16("alpha")] = String16("one");
+    map[String16("beta")] = String16("two");
+    map[String16("gamma")] = String16("three");
+    const char *key = "beta";
+    ASSERT_TRUE(map.contains(key));
+    ASSERT_TRUE(map.contains("alpha"));
+    ASSERT_FALSE(map.contains("alph"));
+    ASSERT_FALSE(map.contains("alphabet"));
+    ASSERT_EQ(String16("two"), *map.find(key));
+    ASSERT_EQ(String16("one"), *map.at(String8("alpha")));
+    ASSERT_EQ(map.end(), map.find(String32("delta")));
+    const string_map &const_map = map;
+    ASSERT_EQ(String16("three"), *const_map.find("gamma"));
+    ASSERT_EQ(String16("one"), *const_map.at("alpha"));
+    ASSERT_FALSE(map.erase("delta"));
+    ASSERT_TRUE(map.erase(key));
+    ASSERT_FALSE(map.contains(key));
+    ASSERT_TRUE(map.erase(String8("alpha")));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST(chain_map_test, test_stored_hash_rehash_does_not_hash) {
+    ChainHashMap<ui16, ui16, chain_counting_hash, Equal<ui16>, ModuloIndex, StoredHash> map(4, 75);
+    for (ui16 i = 0; i < 3; ++i) {
+        map[i] = i;
+    }
+    ASSERT_EQ(4u, map.capacity());
+    chain_counting_hash::calls = 0;
+    map[3] = 3;
+    ASSERT_EQ(8u, map.capacity());
+    ASSERT_EQ(1, chain_counting_hash::calls);
+    for (ui16 i = 0; i < 4; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+struct chain_counting_equal {
+    static ui16 calls;
+
+    bool operator()(ui16 key1, ui16 key2) const {
+        ++calls;
+        return key1 == key2;
+    }
+};
+
+ui16 chain_counting_equal::calls = 0;
+
+TEST(chain_map_test, test_stored_hash_skips_unequal_keys) {
+    typedef ChainHashMap<ui16, ui16, Hash<ui16, ui16>, chain_counting_equal, ModuloIndex, StoredHash> stored_map;
+    stored_map map(16, 100);
+    // all keys share bucket 1
+    for (ui16 i = 0; i < 5; ++i) {
+        map[static_cast<ui16>(1 + i * 16)] = i;
+    }
+    chain_counting_equal::calls = 0;
+    ASSERT_EQ(0, *map.find(1));
+    ASSERT_EQ(1, chain_counting_equal::calls);
+    ASSERT_FALSE(map.contains(81));
+    ASSERT_EQ(1, chain_counting_equal::calls);
+    // erasing the head of the chain moves the next node into it
+    ui16 head = 65;
+    ASSERT_TRUE(map.erase(head));
+    for (ui16 i = 0; i < 4; ++i) {
+        ASSERT_EQ(i, *map.find(static_cast<ui16>(1 + i * 16)));
+    }
+    stored_map::iterator it = map.find(49);
+    map.erase(it);
+    ASSERT_EQ(2, *it);
+    ASSERT_EQ(3u, map.size());
+}
+
+template<class Map>
+static void check_incremental_growth() {
+    Map map(4, 75);
+    for (ui16 i = 0; i < 300; ++i) {
+        map[static_cast<ui16>(i * 7)] = i;
+        // every key is found while buckets are being split
+        for (ui16 j = 0; j <= i; ++j) {
+            ASSERT_EQ(j, *map.find(static_cast<ui16>(j * 7)));
+        }
+        ASSERT_FALSE(map.contains(static_cast<ui16>(i * 7 + 1)));
+        ui16 count = 0;
+        for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+            ++count;
+        }
+        ASSERT_EQ(i + 1, count);
+    }
+    ASSERT_EQ(512u, map.capacity());
+    for (ui16 i = 0; i < 300; i = static_cast<ui16>(i + 3)) {
+        ui16 k = static_cast<ui16>(i * 7);
+        ASSERT_TRUE(map.erase(k));
+    }
+    ASSERT_EQ(200u, map.size());
+    for (typename Map::iterator it = map.begin(); it != map.end(); it = map.erase(it));
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(chain_map_test, test_incremental_rehash_growth) {
+    check_incremental_growth<ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, ModuloIndex, NoStoredHash, IncrementalRehash>>();
+    check_incremental_growth<ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, PowerOfTwoIndex, StoredHash, IncrementalRehash>>();
+}
+
+TEST(chain_map_test, test_incremental_rehash_bounds_insert_work) {
+    typedef ChainHashMap<ui16, ui16, chain_counting_hash, Equal<ui16>, ModuloIndex, NoStoredHash, IncrementalRehash> incremental_map;
+    incremental_map map(8, 75);
+    ui16 max_calls = 0;
+    for (ui16 i = 0; i < 1000; ++i) {
+        size_type capacity = map.capacity();
+        size_type unsplit = map.unsplit_buckets();
+        chain_counting_hash::calls = 0;
+        map[i] = i;
+        if (chain_counting_hash::calls > max_calls) {
+            max_calls = chain_counting_hash::calls;
+        }
+        // growing splits buckets of the array it replaces, and any other
+        // insertion splits buckets left over from the last growth
+        size_type split = map.capacity() != capacity
+                          ? static_cast<size_type>(capacity - map.unsplit_buckets())
+                          : static_cast<size_type>(unsplit - map.unsplit_buckets());
+        ASSERT_LE(split, map.split_step());
+    }
+    // the key itself and the elements of a few split buckets
+    ASSERT_GE(8, max_calls);
+    ASSERT_EQ(2048u, map.capacity());
+    for (ui16 i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i, map[i]);
+    }
+}
+
+TEST(chain_map_test, test_reserve) {
+    int_map map(8, 75);
+    map.reserve(100);
+    size_type capacity = map.capacity();
+    ASSERT_LE(133u, capacity);
+    for (ui16 i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    ASSERT_EQ(capacity, map.capacity());
+    map.reserve(10);
+    ASSERT_EQ(capacity, map.capacity());
+}
+
+TEST(chain_map_test, test_explicit_rehash) {
+    int_map map(8, 75);
+    for (ui16 i = 0; i < 6; ++i) {
+        map[i] = i;
+    }
+    map.rehash(40);
+    ASSERT_EQ(40u, map.capacity());
+    map.rehash(2);
+    ASSERT_EQ(7u, map.capacity());
+    for (ui16 i = 0; i < 6; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+TEST(chain_map_test, test_range_insert) {
+    typedef Pair<ui16, ui16> entry;
+    entry entries[50];
+    for (ui16 i = 0; i < 50; ++i) {
+        entries[i] = entry(static_cast<ui16>(i % 40), i);
+    }
+    int_map map(4, 75);
+    map[3] = 300;
+    map.insert(entries, entries + 50);
+    ASSERT_EQ(40u, map.size());
+    ASSERT_EQ(300, map[3]);
+    ASSERT_EQ(39, map[39]);
+}
+
+TEST(chain_map_test, test_erase_if) {
+    ChainHashMap<ui16, ui16, chain_counting_hash> map(16, 75);
+    for (ui16 i = 0; i < 400; ++i) {
+        map[static_cast<ui16>(i * 13)] = i;
+    }
+    chain_counting_hash::calls = 0;
+    ASSERT_EQ(267u, map.erase_if([](ui16, ui16 val) { return val % 3 != 1; }));
+    ASSERT_EQ(0, chain_counting_hash::calls);
+    ASSERT_EQ(133u, map.size());
+    for (ui16 i = 0; i < 400; ++i) {
+        ASSERT_EQ(i % 3 == 1, map.contains(static_cast<ui16>(i * 13)));
+    }
+    ASSERT_EQ(133u, map.erase_if([](ui16, ui16) { return true; }));
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.end(), map.begin());
+}
+
+TEST(chain_map_test, test_emplace_does_not_copy) {
+    typedef ChainHashMap<ui16, tracked_value> tracked_map;
+    tracked_map map(16, 75);
+    tracked_value value(1, 2);
+    ui16 one = 1;
+    ui16 four = 4;
+    ui16 seven = 7;
+    ui16 eight = 8;
+    tracked_value::reset();
+    ASSERT_TRUE(map.insert(one, value).second());
+    ASSERT_EQ(1, tracked_value::copies);
+    ASSERT_TRUE(map.insert(2, tracked_value(3, 4)).second());
+    ASSERT_TRUE(map.try_emplace(3, tracked_value(5, 6)).second());
+    ASSERT_EQ(2, tracked_value::moves);
+    // the value is built in the node from the arguments
+    ASSERT_TRUE(map.emplace(four, seven, eight).second());
+    ASSERT_EQ(1, tracked_value::copies);
+    ASSERT_EQ(2, tracked_value::moves);
+    tracked_value other(9, 9);
+    ASSERT_FALSE(map.try_emplace(3, move(other)).second());
+    ASSERT_EQ(9, other.a);
+    ASSERT_EQ(7, map[4].a);
+    ASSERT_EQ(4u, map.size());
+}
+
+TEST(chain_map_test, test_emplace_string) {
+    string_map map(16, 75);
+    ASSERT_TRUE(map.emplace("alpha", "one").second());
+    ASSERT_FALSE(map.emplace("alpha", "two").second());
+    ASSERT_EQ(String16("one"), map[String16("alpha")]);
+}
+
+TEST(chain_map_test, test_erase_keeps_neighbor_references) {
+    typedef ChainHashMap<ui16, String16> chain_string_map;
+    chain_string_map map(5, 255);
+    // 3, 8, 13 and 18 share one chain
+    map.insert(3, String16("three"));
+    map.insert(8, String16("eight"));
+    map.insert(13, String16("thirteen"));
+    map.insert(18, String16("eighteen"));
+    // erasing other elements of the chain moves no element
+    String16 *eight = &*map.find(8);
+    chain_string_map::iterator it = map.find(13);
+    map.erase(it);
+    ASSERT_EQ(eight, &*it);
+    ui16 key = 18;
+    ASSERT_TRUE(map.erase(key));
+    key = 3;
+    ASSERT_TRUE(map.erase(key));
+    ASSERT_EQ(eight, &*map.find(8));
+    ASSERT_STREQ("eight", eight->c_str());
+    ASSERT_EQ(1u, map.size());
+}
+
+typedef ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, ModuloIndex, NoStoredHash, FullRehash, ArenaNodes> arena_map;
+
+TEST(chain_map_test, test_arena_nodes) {
+    ASSERT_EQ(sizeof(uint32_t), sizeof(arena_map::link_type));
+    ASSERT_GE(sizeof(int_map::node_type), sizeof(arena_map::node_type));
+    arena_map map(4, 75);
+    ASSERT_EQ(nullptr, map.get_node_allocator());
+    for (ui16 i = 0; i < 500; ++i) {
+        ASSERT_TRUE(map.insert(i, static_cast<ui16>(i * 2)).second());
+    }
+    ASSERT_EQ(500u, map.size());
+    for (ui16 i = 0; i < 500; ++i) {
+        ASSERT_EQ(i * 2, *map.find(i));
+    }
+    ASSERT_EQ(250u, map.erase_if([](const ui16 &key, ui16 &) { return key % 2 == 0; }));
+    // erase the keys one past a multiple of four
+    for (arena_map::iterator it = map.begin(); it != map.end();) {
+        if (*it % 8 == 2) {
+            map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ASSERT_EQ(125u, map.size());
+    // erased nodes are reused
+    for (ui16 i = 0; i < 500; i = static_cast<ui16>(i + 2)) {
+        map[i] = i;
+    }
+    ASSERT_EQ(375u, map.size());
+    for (ui16 i = 0; i < 500; ++i) {
+        bool expected = i % 2 == 0 || i % 4 == 3;
+        ASSERT_EQ(expected, map.contains(i));
+    }
+    arena_map moved(move(map));
+    ASSERT_EQ(375u, moved.size());
+    ASSERT_EQ(3 * 2, *moved.find(3));
+    moved.clear();
+    ASSERT_TRUE(moved.empty());
+    moved[7] = 7;
+    ASSERT_EQ(7, *moved.find(7));
+}
+
+TEST(chain_map_test, test_arena_nodes_incremental_rehash) {
+    check_incremental_growth<ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, ModuloIndex, NoStoredHash, IncrementalRehash, ArenaNodes>>();
+    check_incremental_growth<ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, PowerOfTwoIndex, StoredHash, IncrementalRehash, ArenaNodes>>();
+}
+
+TEST(chain_map_test, test_arena_growth_stops_at_the_size_type) {
+    // with a 16-bit size type the arena for these keys does not fit in
+    // one block, so insertions fail once it cannot grow any further
+    arena_map map(8, 75);
+    uint32_t num_inserted = 0;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        if (map.insert(static_cast<ui16>(i), static_cast<ui16>(i)).second()) {
+            ++num_inserted;
+        }
+    }
+    ASSERT_EQ(num_inserted, map.size());
+    for (uint32_t i = 0; i < num_inserted; ++i) {
+        ASSERT_EQ(static_cast<ui16>(i), *map.find(static_cast<ui16>(i)));
+    }
+}
+
+TEST(chain_map_test, test_arena_nodes_string_keys) {
+    ChainHashMap<String16, String16, Hash<String16, ui16>, Equal<String16>, ModuloIndex, StoredHash, FullRehash, ArenaNodes> map(2, 75);
+    map.insert(String16("one"), String16("1"));
+    map.insert(String16("two"), String16("2"));
+    map.insert(String16("three"), String16("3"));
+    map.insert(String16("four"), String16("4"));
+    String16 key("two");
+    ASSERT_TRUE(map.erase(key));
+    ASSERT_FALSE(map.contains(key));
+    map[String16("five")] = String16("5");
+    ASSERT_EQ(4u, map.size());
+    ASSERT_STREQ("1", map.at(String16("one"))->c_str());
+    ASSERT_STREQ("3", map.at(String16("three"))->c_str());
+    ASSERT_STREQ("4", map.at(String16("four"))->c_str());
+    ASSERT_STREQ("5", map.at(String16("five"))->c_str());
+}
+
+typedef PoolAllocator<StaticAllocatorPool<sizeof(int_map::node_type), 8>> node_pool;
+
+TEST(chain_map_test, test_allocator_nodes) {
+    typedef ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, ModuloIndex, NoStoredHash, FullRehash,
+            AllocatorNodes<StatsAllocator<node_pool>>> pool_map;
+    pool_map map(4, 75);
+    for (ui16 i = 0; i < 8; ++i) {
+        ASSERT_TRUE(map.insert(i, i).second());
+    }
+    ASSERT_EQ(8u, map.get_node_allocator()->GetNumAllocations());
+    // the pool is exhausted, so the insertion fails without changing the map
+    Pair<pool_map::iterator, bool> res = map.insert(8, 8);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(map.end(), res.first());
+    ASSERT_FALSE(map.insert_or_assign(9, 9).second());
+    ASSERT_EQ(8u, map.size());
+    ASSERT_FALSE(map.contains(8));
+    ASSERT_EQ(2u, map.get_node_allocator()->GetNumFailures());
+    // existing keys are still found and assigned
+    ASSERT_FALSE(map.insert_or_assign(3, 30).second());
+    ASSERT_EQ(30, *map.find(3));
+    ui16 key = 5;
+    ASSERT_TRUE(map.erase(key));
+    ASSERT_TRUE(map.insert(8, 8).second());
+    map.clear();
+    ASSERT_EQ(0u, map.get_node_allocator()->GetBytesInUse());
+}
+
+TEST(chain_map_test, test_allocator_nodes_with_fallback) {
+    typedef FallbackAllocator<node_pool, MemoryAllocator> pool_or_memory;
+    ChainHashMap<ui16, ui16, Hash<ui16, ui16>, Equal<ui16>, ModuloIndex, NoStoredHash, FullRehash,
+            AllocatorNodes<StatsAllocator<pool_or_memory>>> map;
+    for (ui16 i = 0; i < 100; ++i) {
+        map[i] = static_cast<ui16>(i + 1);
+    }
+    ASSERT_EQ(100u, map.size());
+    for (ui16 i = 0; i < 100; ++i) {
+        ASSERT_EQ(i + 1, *map.find(i));
+    }
+    ASSERT_EQ(100u, map.get_node_allocator()->GetNumAllocations());
+    ASSERT_EQ(0u, map.get_node_allocator()->GetNumFailures());
+}
@@ -1,5 +1,5 @@
-#include <stl/OpenMap.h>
 #include "gtest/gtest.h"
+#include "stl/OpenMap.h"
 
 #include "stl/Concept.h"
 #include "stl/Comparator.h"
@@ -0,0 +1,137 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stl/ConcurrentMap.h"
+
+using namespace wlp;
+
+typedef ConcurrentHashMap<uint32_t, uint32_t> int_map;
+
+static constexpr uint32_t NUM_THREADS = 4;
+static constexpr uint32_t KEYS_PER_THREAD = 2000;
+
+TEST(concurrent_map_test, test_insert_find_erase) {
+    int_map map(32, 75);
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.insert(1, 10));
+    ASSERT_TRUE(map.insert(2, 20));
+    ASSERT_FALSE(map.insert(1, 11));
+    uint32_t val = 0;
+    ASSERT_TRUE(map.find(1, val));
+    ASSERT_EQ(10u, val);
+    ASSERT_FALSE(map.find(3, val));
+    ASSERT_EQ(10u, val);
+    ASSERT_FALSE(map.insert_or_assign(1, 12));
+    ASSERT_TRUE(map.insert_or_assign(3, 30));
+    ASSERT_TRUE(map.find(1, val));
+    ASSERT_EQ(12u, val);
+    ASSERT_EQ(3u, map.size());
+    ASSERT_TRUE(map.erase(2));
+    ASSERT_FALSE(map.erase(2));
+    ASSERT_FALSE(map.contains(2));
+    ASSERT_TRUE(map.contains(3));
+    map.clear();
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(concurrent_map_test, test_update_and_for_each) {
+    int_map map;
+    for (uint32_t i = 0; i < 100; ++i) {
+        map.insert(i, i);
+    }
+    ASSERT_TRUE(map.update(5, [](uint32_t &v) { v += 100; }));
+    ASSERT_FALSE(map.update(500, [](uint32_t &v) { v += 100; }));
+    uint32_t val = 0;
+    ASSERT_TRUE(map.find(5, val));
+    ASSERT_EQ(105u, val);
+    uint32_t key_sum = 0;
+    uint32_t val_sum = 0;
+    map.for_each([&](const uint32_t &k, const uint32_t &v) {
+        key_sum += k;
+        val_sum += v;
+    });
+    ASSERT_EQ(4950u, key_sum);
+    ASSERT_EQ(5050u, val_sum);
+}
+
+TEST(concurrent_map_test, test_concurrent_inserts_and_reads) {
+    int_map map;
+    std::vector<std::thread> threads;
+    uint32_t found[NUM_THREADS] = {0};
+    for (uint32_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+                uint32_t key = i * NUM_THREADS + t;
+                map.insert(key, key * 2);
+                uint32_t other = i * NUM_THREADS + (t + 1) % NUM_THREADS;
+                uint32_t val = 0;
+                if (map.find(other, val)) {
+                    found[t] += val == other * 2;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(NUM_THREADS * KEYS_PER_THREAD, map.size());
+    for (uint32_t key = 0; key < NUM_THREADS * KEYS_PER_THREAD; ++key) {
+        uint32_t val = 0;
+        ASSERT_TRUE(map.find(key, val));
+        ASSERT_EQ(key * 2, val);
+    }
+    for (uint32_t t = 0; t < NUM_THREADS; ++t) {
+        ASSERT_LE(found[t], KEYS_PER_THREAD);
+    }
+}
+
+TEST(concurrent_map_test, test_concurrent_updates_are_not_lost) {
+    int_map map;
+    for (uint32_t i = 0; i < 64; ++i) {
+        map.insert(i, 0);
+    }
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&]() {
+            for (uint32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+                map.update(i % 64, [](uint32_t &v) { ++v; });
+                if (i % 8 == 0) {
+                    // churn a private key range so shards also see inserts and erases
+                    map.insert(1000 + i, i);
+                    map.erase(1000 + i);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    uint32_t total = 0;
+    map.for_each([&](const uint32_t &, const uint32_t &v) { total += v; });
+    ASSERT_EQ(NUM_THREADS * KEYS_PER_THREAD, total);
+    ASSERT_EQ(64u, map.size());
+}
+
+TEST(concurrent_map_test, test_read_write_lock_excludes_writers) {
+    ReadWriteSpinLock lock;
+    uint32_t value = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&]() {
+            for (uint32_t i = 0; i < KEYS_PER_THREAD; ++i) {
+                lock.lock_write();
+                uint32_t v = value;
+                value = v + 1;
+                lock.unlock_write();
+                lock.lock_read();
+                (void) value;
+                lock.unlock_read();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(NUM_THREADS * KEYS_PER_THREAD, value);
+}
@@ -45,4 +45,14 @@ TEST(equals_test, test_integer_equal) {
     ASSERT_TRUE(comparator(15, 15));
     ASSERT_FALSE(comparator(1, 14));
     ASSERT_FALSE(comparator(14, 1));
-}
\ No newline at end of file
+}
+TEST(equals_test, test_static_string_equals_transparent) {
+    Equal<String8> comparator = Equal<String8>();
+    String8 str{"darwin"};
+    ASSERT_TRUE(comparator("darwin", str));
+    ASSERT_TRUE(comparator(str, "darwin"));
+    ASSERT_FALSE(comparator("darwi", str));
+    ASSERT_FALSE(comparator(str, "darwins"));
+    ASSERT_TRUE(comparator(String16{"darwin"}, str));
+    ASSERT_FALSE(comparator(String16{"darwinism"}, str));
+}
@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include "stl/FlatMap.h"
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef StaticString<16> string16;
+typedef FlatHashMap<string16, string16> string_map;
+typedef FlatHashMap<uint16_t, uint16_t> int_map;
+typedef int_map::iterator fmi;
+typedef Pair<fmi, bool> P_fmi_b;
+
+TEST(flat_map_test, test_constructor_parameters) {
+    int_map map(15, 61);
+    ASSERT_EQ(15u, map.capacity());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(61, map.max_load());
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(flat_map_test, test_insert_find_iterate_integer) {
+    int_map map(10, 61);
+    P_fmi_b res1 = map.insert(0, 15);
+    P_fmi_b res2 = map.insert(1, 20);
+    P_fmi_b res3 = map.insert(0, 35);
+    P_fmi_b res4 = map.insert(9, 90);
+    P_fmi_b res5 = map.insert(20, 100);
+    ASSERT_TRUE(res1.second());
+    ASSERT_TRUE(res2.second());
+    ASSERT_FALSE(res3.second());
+    ASSERT_TRUE(res4.second());
+    ASSERT_TRUE(res5.second());
+    ASSERT_EQ(res1.first(), res3.first());
+    ASSERT_EQ(15, *map.find(0));
+    ASSERT_EQ(100, *map.at(20));
+    ASSERT_EQ(map.end(), map.find(30));
+    fmi it = map.begin();
+    ASSERT_EQ(15, *it);
+    ASSERT_EQ(0, it.key());
+    ASSERT_EQ(20, *++it);
+    ASSERT_EQ(1, it.key());
+    ASSERT_EQ(100, *++it);
+    ASSERT_EQ(20, it.key());
+    ASSERT_EQ(90, *++it);
+    ASSERT_EQ(9, it.key());
+    ASSERT_EQ(map.end(), ++it);
+    ASSERT_EQ(4u, map.size());
+}
+
+TEST(flat_map_test, test_access_operator_and_assign) {
+    int_map map(10, 75);
+    map.insert(5, 100);
+    map[5] = 19;
+    map[10] = 14;
+    map[556] = 9901;
+    ASSERT_EQ(19, map[5]);
+    ASSERT_EQ(14, map[10]);
+    ASSERT_EQ(9901, map[556]);
+    ASSERT_FALSE(map.insert_or_assign(10, 15).second());
+    ASSERT_TRUE(map.insert_or_assign(11, 16).second());
+    ASSERT_EQ(15, map[10]);
+    ASSERT_EQ(4u, map.size());
+}
+
+TEST(flat_map_test, test_rehash_keeps_elements) {
+    int_map map(2, 50);
+    uint16_t keys[] = {0, 1, 2, 3, 4, 115, 226, 337, 448};
+    for (uint16_t key : keys) {
+        map[key] = static_cast<uint16_t>(key + 1);
+    }
+    ASSERT_EQ(9u, map.size());
+    ASSERT_EQ(32u, map.capacity());
+    for (uint16_t key : keys) {
+        ASSERT_TRUE(map.contains(key));
+        ASSERT_EQ(key + 1, *map.find(key));
+    }
+}
+
+TEST(flat_map_test, test_full_load_keeps_an_empty_slot) {
+    int_map map(4, 100);
+    map[1] = 1;
+    map[2] = 2;
+    map[3] = 3;
+    ASSERT_EQ(4u, map.capacity());
+    map[4] = 4;
+    ASSERT_EQ(8u, map.capacity());
+    ASSERT_FALSE(map.contains(5));
+}
+
+TEST(flat_map_test, test_growth_stops_at_the_size_type) {
+    // with a 16-bit size type the slots for these keys do not fit in one
+    // block, so the map stops growing and reports itself full instead
+    FlatHashMap<uint32_t, uint32_t> map;
+    uint32_t num_inserted = 0;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        if (map.insert(i, i).second()) {
+            ++num_inserted;
+        }
+    }
+    ASSERT_EQ(num_inserted, map.size());
+    if (num_inserted < 5000) {
+        ASSERT_EQ(map.size() + 1u, map.capacity());
+    }
+    for (uint32_t i = 0; i < num_inserted; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+TEST(flat_map_test, test_erase_shifts_back_collisions) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[88] = 880;
+    map[28] = 280;
+    map[38] = 380;
+    map[48] = 480;
+    uint16_t k = 88;
+    ASSERT_TRUE(map.erase(k));
+    ASSERT_FALSE(map.erase(k));
+    ASSERT_EQ(4u, map.size());
+    ASSERT_EQ(10u, map.capacity());
+    ASSERT_EQ(80, *map.find(8));
+    ASSERT_EQ(280, *map.find(28));
+    ASSERT_EQ(380, *map.find(38));
+    ASSERT_EQ(480, *map.find(48));
+    ASSERT_EQ(map.end(), map.find(88));
+}
+
+TEST(flat_map_test, test_erase_iterator) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[88] = 880;
+    map[28] = 280;
+    map[38] = 380;
+    map[48] = 480;
+    fmi it = map.begin();
+    ASSERT_EQ(280, *it);
+    it = map.erase(it);
+    ASSERT_EQ(380, *it);
+    ASSERT_EQ(4u, map.size());
+    int_map::iterator invalid;
+    ASSERT_EQ(map.end(), map.erase(invalid));
+    uint16_t seen = 0;
+    for (fmi cur = map.begin(); cur != map.end(); cur = map.erase(cur)) {
+        ++seen;
+    }
+    ASSERT_EQ(4, seen);
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(flat_map_test, test_string_keys) {
+    string_map map(10, 75);
+    string16 key1{"moshi"};
+    string16 key2{"welcome"};
+    string16 val1{"someval"};
+    string16 val2{"anotherval"};
+    ASSERT_TRUE(map.insert(key1, val1).second());
+    ASSERT_TRUE(map.insert(key2, val2).second());
+    ASSERT_TRUE(map.contains(key1));
+    ASSERT_EQ(val2, *map.at(key2));
+    ASSERT_TRUE(map.erase(key1));
+    ASSERT_FALSE(map.contains(key1));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST(flat_map_test, test_move_and_clear) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[18] = 180;
+    int_map map1(12, 91);
+    map1 = move(map);
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(0u, map.capacity());
+    ASSERT_EQ(2u, map1.size());
+    const int_map map2(move(map1));
+    ASSERT_EQ(180, *map2.find(18));
+    int_map::const_iterator it = map2.begin();
+    ASSERT_EQ(80, *it++);
+    ASSERT_EQ(180, *it);
+    ASSERT_EQ(map2.end(), ++it);
+    int_map map3(move(const_cast<int_map &>(map2)));
+    map3.clear();
+    ASSERT_EQ(0u, map3.size());
+    ASSERT_EQ(10u, map3.capacity());
+    ASSERT_EQ(map3.begin(), map3.end());
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "strings/StaticString.h"
+#include "stl/ChainMap.h"
 #include "stl/Hash.h"
+#include "stl/OpenMap.h"
 
 #include "../template_defs.h"
 
@@ -31,4 +33,111 @@ TEST(hash_test, test_hash_integer) {
     ASSERT_EQ(4, hasher(4));
     ASSERT_EQ(hasher(10), hasher(10));
     ASSERT_EQ(1556, hasher(1556));
-}
\ No newline at end of file
+}
+TEST(hash_test, test_hash_static_string_transparent) {
+    Hash<String16, uint16_t> hasher = Hash<String16, uint16_t>();
+    String16 str{"darwin"};
+    ASSERT_EQ(hasher(str), hasher("darwin"));
+    ASSERT_EQ(hasher(str), hasher(String8{"darwin"}));
+    Hash<const char *, uint16_t> string_hasher = Hash<const char *, uint16_t>();
+    ASSERT_EQ(hasher(str), string_hasher("darwin"));
+}
+
+TEST(hash_test, test_hash_mum) {
+    ASSERT_EQ(1u, hash_mum(1ull << 32, 1ull << 32));
+    ASSERT_EQ(~0ull, hash_mum(~0ull, ~0ull));
+    ASSERT_EQ(0u, hash_mum(0, 12345));
+}
+
+TEST(hash_test, test_mix_hash_integer_spreads_low_bits) {
+    MixHash<uint32_t, uint32_t> hasher;
+    // keys differing only in their high bits land in different buckets
+    bool buckets[16] = {false};
+    uint16_t used = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t bucket = hasher(i << 20) & 15;
+        used = static_cast<uint16_t>(used + !buckets[bucket]);
+        buckets[bucket] = true;
+    }
+    ASSERT_GE(used, 8);
+    typedef MixHash<uint64_t, uint32_t> wide_hash;
+    ASSERT_EQ(hasher(77), wide_hash()(77));
+    ASSERT_NE(hasher(1), hasher(2));
+}
+
+TEST(hash_test, test_mix_hash_string) {
+    static_assert(MixHash<const char *, uint32_t>()("levitate") == MixHash<String16, uint32_t>()("levitate"),
+                  "string hashes are usable at compile time");
+    MixHash<String32, uint32_t> hasher;
+    String32 str{"magnetic levitation pod"};
+    ASSERT_EQ(hasher(str), hasher("magnetic levitation pod"));
+    typedef MixHash<char *, uint32_t> string_hash;
+    ASSERT_EQ(hasher(str), string_hash()(str.c_str()));
+    ASSERT_EQ(hasher(str), hasher(String64{"magnetic levitation pod"}));
+    // every prefix across the word and block boundaries hashes differently
+    char prefix[40] = {0};
+    uint32_t codes[40];
+    for (uint16_t len = 0; len < 40; ++len) {
+        codes[len] = string_hash()(prefix);
+        prefix[len] = 'a';
+        for (uint16_t other = 0; other < len; ++other) {
+            ASSERT_NE(codes[other], codes[len]);
+        }
+    }
+}
+
+TEST(hash_test, test_hash_wide_integers_pointers_floats) {
+    Hash<uint64_t, uint32_t> wide_hasher;
+    ASSERT_NE(wide_hasher(1ull << 40), wide_hasher(0));
+    Hash<int64_t, uint32_t> signed_hasher;
+    ASSERT_EQ(wide_hasher(5), signed_hasher(5));
+    int values[2] = {0, 0};
+    Hash<int *, size_type> pointer_hasher;
+    ASSERT_EQ(pointer_hasher(&values[0]), pointer_hasher(&values[0]));
+    ASSERT_NE(pointer_hasher(&values[0]), pointer_hasher(&values[1]));
+    Hash<double, uint32_t> double_hasher;
+    ASSERT_EQ(double_hasher(0.0), double_hasher(-0.0));
+    ASSERT_NE(double_hasher(1.0), double_hasher(-1.0));
+    Hash<float, uint32_t> float_hasher;
+    MixHash<float, uint32_t> float_mix_hasher;
+    ASSERT_EQ(float_hasher(-0.0f), float_mix_hasher(0.0f));
+}
+
+TEST(hash_test, test_hash_pair_tuple) {
+    typedef Pair<uint16_t, uint16_t> pair_type;
+    Hash<pair_type, uint32_t> pair_hasher;
+    ASSERT_EQ(pair_hasher(pair_type(1, 2)), pair_hasher(pair_type(1, 2)));
+    ASSERT_NE(pair_hasher(pair_type(1, 2)), pair_hasher(pair_type(2, 1)));
+    MixHash<pair_type, uint32_t> pair_mix_hasher;
+    ASSERT_NE(pair_hasher(pair_type(1, 2)), pair_mix_hasher(pair_type(1, 2)));
+    typedef Tuple<uint16_t, String8, uint32_t> tuple_type;
+    Hash<tuple_type, uint32_t> tuple_hasher;
+    tuple_type a(uint16_t(1), String8{"x"}, 2u);
+    tuple_type b(uint16_t(1), String8{"x"}, 2u);
+    tuple_type c(uint16_t(1), String8{"y"}, 2u);
+    ASSERT_EQ(tuple_hasher(a), tuple_hasher(b));
+    ASSERT_NE(tuple_hasher(a), tuple_hasher(c));
+    ASSERT_TRUE(Equal<tuple_type>()(a, b));
+    ASSERT_FALSE(Equal<tuple_type>()(a, c));
+    MixHash<tuple_type, uint32_t> tuple_mix_hasher;
+    ASSERT_EQ(tuple_mix_hasher(a), tuple_mix_hasher(b));
+}
+
+TEST(hash_test, test_maps_with_compound_keys) {
+    typedef Pair<uint16_t, uint16_t> pair_type;
+    OpenHashMap<pair_type, uint32_t, MixHash<pair_type, size_type>> grid;
+    for (uint16_t x = 0; x < 8; ++x) {
+        for (uint16_t y = 0; y < 8; ++y) {
+            grid[pair_type(x, y)] = static_cast<uint32_t>(x * 8 + y);
+        }
+    }
+    ASSERT_EQ(64u, grid.size());
+    ASSERT_EQ(43u, *grid.find(pair_type(5, 3)));
+    ASSERT_EQ(grid.end(), grid.find(pair_type(8, 0)));
+    typedef Tuple<uint16_t, uint16_t, uint16_t> tuple_type;
+    ChainHashMap<tuple_type, uint32_t, Hash<tuple_type, size_type>> cells;
+    cells[tuple_type(uint16_t(1), uint16_t(2), uint16_t(3))] = 6;
+    cells[tuple_type(uint16_t(3), uint16_t(2), uint16_t(1))] = 7;
+    ASSERT_EQ(2u, cells.size());
+    ASSERT_EQ(6u, *cells.find(tuple_type(uint16_t(1), uint16_t(2), uint16_t(3))));
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "stl/HashPolicy.h"
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+TEST(hash_policy_test, test_modulo_index) {
+    ASSERT_EQ(15u, ModuloIndex::capacity(15));
+    ASSERT_EQ(2u, ModuloIndex::index(17u, 15));
+    ASSERT_EQ(0u, ModuloIndex::index(30u, 15));
+}
+
+TEST(hash_policy_test, test_power_of_two_capacity) {
+    ASSERT_EQ(1u, PowerOfTwoIndex::capacity(0));
+    ASSERT_EQ(1u, PowerOfTwoIndex::capacity(1));
+    ASSERT_EQ(16u, PowerOfTwoIndex::capacity(12));
+    ASSERT_EQ(16u, PowerOfTwoIndex::capacity(16));
+    ASSERT_EQ(32u, PowerOfTwoIndex::capacity(17));
+}
+
+TEST(hash_policy_test, test_power_of_two_index_in_range) {
+    for (uint32_t h = 0; h < 1000; ++h) {
+        ASSERT_LT(PowerOfTwoIndex::index(h, 64), 64u);
+    }
+}
+
+TEST(hash_policy_test, test_power_of_two_index_spreads_strided_keys) {
+    // identity hashes with a stride of the capacity would all
+    // land in one bucket if the hash code were only masked
+    bool used[64] = {false};
+    size_type num_used = 0;
+    for (uint32_t i = 0; i < 64; ++i) {
+        size_type bucket = PowerOfTwoIndex::index(i * 64, 64);
+        if (!used[bucket]) {
+            used[bucket] = true;
+            ++num_used;
+        }
+    }
+    ASSERT_GT(num_used, 32u);
+}
+
+static size_type count_buckets(uint8_t key_shift, uint32_t num_keys, size_type capacity) {
+    static bool used[2048];
+    size_type num_used = 0;
+    for (size_type i = 0; i < capacity; ++i) {
+        used[i] = false;
+    }
+    for (uint32_t i = 0; i < num_keys; ++i) {
+        size_type bucket = PowerOfTwoIndex::index(i << key_shift, capacity);
+        if (!used[bucket]) {
+            used[bucket] = true;
+            ++num_used;
+        }
+    }
+    return num_used;
+}
+
+TEST(hash_policy_test, test_power_of_two_index_uses_high_hash_bits) {
+    // keys differing only above the low bits of the capacity and
+    // the next sixteen still reach different buckets
+    ASSERT_GT(count_buckets(24, 256, 2048), 200u);
+    ASSERT_GT(count_buckets(20, 1024, 2048), 600u);
+    ASSERT_EQ(0u, PowerOfTwoIndex::index(0xffffffffu, 1));
+    ASSERT_EQ(2u, PowerOfTwoIndex::index(0x80000000u, 4));
+}
+
+TEST(hash_policy_test, test_quadratic_probe_visits_every_bucket) {
+    bool visited[32] = {false};
+    size_type i = 5;
+    visited[i] = true;
+    for (size_type step = 1; step < 32; ++step) {
+        i = QuadraticProbe::next(i, step, 32);
+        ASSERT_FALSE(visited[i]);
+        visited[i] = true;
+    }
+}
+
+TEST(hash_policy_test, test_linear_probe_wraps) {
+    ASSERT_EQ(4u, LinearProbe::next(3, 1, 8));
+    ASSERT_EQ(0u, LinearProbe::next(7, 5, 8));
+    ASSERT_EQ(0u, RobinHoodProbe::next(7, 5, 8));
+}
+
+TEST(hash_policy_test, test_grow_capacity_saturates) {
+    ASSERT_EQ(16u, grow_capacity(8));
+    ASSERT_EQ(max_size_type - 1, grow_capacity(static_cast<size_type>(max_size_type / 2)));
+    ASSERT_EQ(max_size_type, grow_capacity(max_size_type));
+}
+
+TEST(hash_policy_test, test_power_of_two_capacity_near_max) {
+    size_type top = PowerOfTwoIndex::max_capacity();
+    ASSERT_EQ(top, PowerOfTwoIndex::capacity(top));
+    ASSERT_EQ(top, PowerOfTwoIndex::capacity(max_size_type));
+    ASSERT_GE(PowerOfTwoIndex::shift(top), 1u);
+}
+
+TEST(hash_policy_test, test_power_of_two_index_uses_wide_hash_bits) {
+    // 64-bit hash codes differing only in their high word
+    // still reach different buckets
+    bool used[256] = {false};
+    size_type num_used = 0;
+    for (uint64_t i = 0; i < 256; ++i) {
+        size_type bucket = PowerOfTwoIndex::index(i << 32, 256);
+        if (!used[bucket]) {
+            used[bucket] = true;
+            ++num_used;
+        }
+    }
+    ASSERT_GT(num_used, 128u);
+    ASSERT_NE(fibonacci_mix(static_cast<uint64_t>(1) << 40), fibonacci_mix(static_cast<uint64_t>(0)));
+}
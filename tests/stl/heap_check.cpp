@@ -13,21 +13,21 @@ TEST(heap_test, test_heap_push_pop) {
     heap.push(-1);
     heap.push(3);
     heap.push(-5);
-    ASSERT_EQ(6, heap.size());
+    ASSERT_EQ(6u, heap.size());
     ASSERT_EQ(10, heap.top());
     heap.pop();
     ASSERT_EQ(5, heap.top());
     heap.pop();
     ASSERT_EQ(3, heap.top());
     heap.pop();
-    ASSERT_EQ(3, heap.size());
+    ASSERT_EQ(3u, heap.size());
     ASSERT_EQ(1, heap.top());
     heap.pop();
     ASSERT_EQ(-1, heap.top());
     heap.pop();
     ASSERT_EQ(-5, heap.top());
     heap.pop();
-    ASSERT_EQ(0, heap.size());
+    ASSERT_EQ(0u, heap.size());
 }
 
 TEST(heap_test, test_heap_sort) {
@@ -90,7 +90,7 @@ TEST(heap_test, test_make_heap_single) {
     ASSERT_EQ(5, heap.back());
     ASSERT_EQ(5, heap.front());
     heap.clear();
-    ASSERT_EQ(0, heap.size());
+    ASSERT_EQ(0u, heap.size());
     heap.push_back(10);
     Comparator<int> comparator;
     make_heap(heap.begin(), heap.end(), comparator);
@@ -103,12 +103,12 @@ TEST(heap_test, test_heap_push) {
     heap.push(5);
     const int v = 7;
     heap.push(v);
-    ASSERT_EQ(2, heap.size());
+    ASSERT_EQ(2u, heap.size());
     ASSERT_EQ(7, heap.top());
     heap.pop();
     ASSERT_EQ(5, heap.top());
     heap.pop();
-    ASSERT_EQ(0, heap.size());
+    ASSERT_EQ(0u, heap.size());
 }
 
 TEST(heap_test, test_move_constructor) {
@@ -118,10 +118,10 @@ TEST(heap_test, test_move_constructor) {
     heap.push(5);
     heap.push(-5);
     ArrayHeap<int> heap0(move(heap));
-    ASSERT_EQ(4, heap0.size());
-    ASSERT_EQ(0, heap.size());
-    ASSERT_EQ(5, heap0.capacity());
-    ASSERT_EQ(0, heap.capacity());
+    ASSERT_EQ(4u, heap0.size());
+    ASSERT_EQ(0u, heap.size());
+    ASSERT_EQ(5u, heap0.capacity());
+    ASSERT_EQ(0u, heap.capacity());
     ASSERT_EQ(5, heap0.top());
     heap0.pop();
     ASSERT_EQ(1, heap0.top());
@@ -130,7 +130,7 @@ TEST(heap_test, test_move_constructor) {
     heap0.pop();
     ASSERT_EQ(-5, heap0.top());
     heap0.pop();
-    ASSERT_EQ(0, heap0.size());
+    ASSERT_EQ(0u, heap0.size());
     ASSERT_TRUE(heap.empty());
     ASSERT_TRUE(heap0.empty());
     ASSERT_EQ(nullptr, heap.get_array_list()->data());
@@ -145,16 +145,16 @@ TEST(heap_test, test_move_assignment_operator) {
     heap0.push(1);
     heap0.push(10);
     heap0 = move(heap);
-    ASSERT_EQ(0, heap.size());
-    ASSERT_EQ(0, heap.capacity());
+    ASSERT_EQ(0u, heap.size());
+    ASSERT_EQ(0u, heap.capacity());
     ASSERT_EQ(nullptr, heap.get_array_list()->data());
-    ASSERT_EQ(3, heap0.size());
-    ASSERT_EQ(5, heap0.capacity());
+    ASSERT_EQ(3u, heap0.size());
+    ASSERT_EQ(5u, heap0.capacity());
     ASSERT_EQ(11, heap0.top());
     heap0.pop();
     ASSERT_EQ(5, heap0.top());
     heap0.pop();
     ASSERT_EQ(2, heap0.top());
     heap0.pop();
-    ASSERT_EQ(0, heap0.size());
+    ASSERT_EQ(0u, heap0.size());
 }
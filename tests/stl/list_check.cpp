@@ -11,11 +11,11 @@ typedef ArrayList<int>::const_iterator cit;
 TEST(list_test, test_constructors) {
     int values[] = {1, 2, 3, 4, 5};
     ArrayList<int> list(values, 5, 2);
-    ASSERT_EQ(5, list.capacity());
-    ASSERT_EQ(5, list.size());
+    ASSERT_EQ(5u, list.capacity());
+    ASSERT_EQ(5u, list.size());
     ArrayList<int> list0(values, 5);
-    ASSERT_EQ(5, list0.capacity());
-    ASSERT_EQ(5, list.size());
+    ASSERT_EQ(5u, list0.capacity());
+    ASSERT_EQ(5u, list.size());
     for (size_type i = 0; i < 5; i++) {
         ASSERT_EQ(values[i], list[i]);
         ASSERT_EQ(values[i], list0[i]);
@@ -46,7 +46,7 @@ TEST(list_test, test_const_list_back_front_when_empty) {
     ArrayList<int> list(values, 3);
     list.clear();
     const ArrayList<int> const_list(move(list));
-    ASSERT_EQ(0, const_list.size());
+    ASSERT_EQ(0u, const_list.size());
     ASSERT_EQ(1, const_list.back());
     ASSERT_EQ(1, const_list.front());
 }
@@ -55,8 +55,8 @@ TEST(list_test, test_clear) {
     int values[] = {2, 3, 5, 7};
     ArrayList<int> list(values, 4);
     list.clear();
-    ASSERT_EQ(0, list.size());
-    ASSERT_EQ(4, list.capacity());
+    ASSERT_EQ(0u, list.size());
+    ASSERT_EQ(4u, list.capacity());
     list.clear();
     ASSERT_EQ(2, list.front());
     ASSERT_EQ(2, list.back());
@@ -94,12 +94,12 @@ TEST(list_test, test_const_list_begin_end) {
 TEST(list_test, test_insert_index_lvalue) {
     int values[] = {1, 2, 3, 4};
     ArrayList<int> list(values, 4, 5);
-    ASSERT_EQ(4, list.size());
+    ASSERT_EQ(4u, list.size());
     const int v = 100;
     ArrayList<int>::iterator it = list.insert(2, v);
     ASSERT_EQ(100, *it);
     int expected[] = {1, 2, 100, 3, 4};
-    ASSERT_EQ(5, list.size());
+    ASSERT_EQ(5u, list.size());
     for (size_type i = 0; i < list.size(); i++) {
         ASSERT_EQ(expected[i], list[i]);
     }
@@ -108,11 +108,11 @@ TEST(list_test, test_insert_index_lvalue) {
 TEST(list_test, test_insert_index_rvalue) {
     int values[] = {1, 10};
     ArrayList<int> list(values, 2, 3);
-    ASSERT_EQ(2, list.size());
+    ASSERT_EQ(2u, list.size());
     ArrayList<int>::iterator it = list.insert(1, 100);
     ASSERT_EQ(100, *it);
     int expected[] = {1, 100, 10};
-    ASSERT_EQ(3, list.size());
+    ASSERT_EQ(3u, list.size());
     for (size_type i = 0; i < list.size(); i++) {
         ASSERT_EQ(expected[i], list[i]);
     }
@@ -124,7 +124,7 @@ TEST(list_test, test_insert_iterator_lvalue) {
     ArrayList<int>::iterator it = list.end();
     const int v = 100;
     it = list.insert(it, v);
-    ASSERT_EQ(3, list.size());
+    ASSERT_EQ(3u, list.size());
     ASSERT_EQ(100, *it);
     ++it;
     ASSERT_EQ(it, list.end());
@@ -135,7 +135,7 @@ TEST(list_test, test_insert_iterator_rvalue) {
     ArrayList<int> list(values, 2, 2);
     ArrayList<int>::iterator it = list.begin();
     it = list.insert(it, 100);
-    ASSERT_EQ(3, list.size());
+    ASSERT_EQ(3u, list.size());
     ASSERT_EQ(100, *it);
     ++it;
     ASSERT_EQ(1, *it);
@@ -149,8 +149,8 @@ TEST(list_test, test_insert_when_full) {
     int values[] = {1, 10};
     ArrayList<int> list(values, 2);
     list.insert(1, 15);
-    ASSERT_EQ(3, list.size());
-    ASSERT_EQ(4, list.capacity());
+    ASSERT_EQ(3u, list.size());
+    ASSERT_EQ(4u, list.capacity());
     ASSERT_EQ(1, *list.begin());
     ASSERT_EQ(15, list.at(1));
     ASSERT_EQ(10, list.at(2));
@@ -159,8 +159,8 @@ TEST(list_test, test_insert_when_full) {
 TEST(list_test, test_insert_when_empty) {
     ArrayList<int> list(5);
     list.insert(0, 10);
-    ASSERT_EQ(1, list.size());
-    ASSERT_EQ(5, list.capacity());
+    ASSERT_EQ(1u, list.size());
+    ASSERT_EQ(5u, list.capacity());
     ASSERT_EQ(10, list.at(0));
 }
 
@@ -168,13 +168,13 @@ TEST(list_test, test_insert_iterator_when_empty) {
     ArrayList<int> list1(5);
     ArrayList<int>::iterator it1 = list1.begin();
     it1 = list1.insert(it1, 10);
-    ASSERT_EQ(1, list1.size());
+    ASSERT_EQ(1u, list1.size());
     ASSERT_EQ(10, list1[0]);
     ASSERT_EQ(10, *it1);
     ArrayList<int> list2(5);
     ArrayList<int>::iterator it2 = list2.end();
     it2 = list2.insert(it2, 10);
-    ASSERT_EQ(1, list2.size());
+    ASSERT_EQ(1u, list2.size());
     ASSERT_EQ(10, list2[0]);
     ASSERT_EQ(10, *it2);
 }
@@ -182,26 +182,46 @@ TEST(list_test, test_insert_iterator_when_empty) {
 TEST(list_test, test_push_back_when_full) {
     int values[] = {1, 2};
     ArrayList<int> list(values, 2);
-    ASSERT_EQ(2, list.size());
-    ASSERT_EQ(2, list.capacity());
+    ASSERT_EQ(2u, list.size());
+    ASSERT_EQ(2u, list.capacity());
     list.push_back(3);
-    ASSERT_EQ(3, list.size());
-    ASSERT_EQ(4, list.capacity());
+    ASSERT_EQ(3u, list.size());
+    ASSERT_EQ(4u, list.capacity());
     ASSERT_EQ(3, list.at(2));
 }
 
+TEST(list_test, test_growth_stops_at_the_size_type) {
+    // the backing array stops growing once its bytes no longer fit the size type
+    ArrayList<uint32_t> list(1);
+    uint32_t num_inserted = 0;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        num_inserted += list.push_back(i);
+    }
+    ASSERT_EQ(num_inserted, list.size());
+    ASSERT_LE(list.capacity(), max_size_type / sizeof(uint32_t));
+    if (num_inserted < 20000u) {
+        ASSERT_EQ(list.size(), list.capacity());
+        ASSERT_EQ(list.end(), list.insert(0, 7u));
+        ASSERT_FALSE(list.reserve(max_size_type));
+        ASSERT_EQ(list.size(), list.capacity());
+    }
+    for (uint32_t i = 0; i < num_inserted; ++i) {
+        ASSERT_EQ(i, list[static_cast<size_type>(i)]);
+    }
+}
+
 TEST(list_test, test_erase_index) {
     int values[] = {1, 2, 3};
     ArrayList<int> list(values, 3);
-    ASSERT_EQ(3, list.size());
-    ASSERT_EQ(3, list.capacity());
+    ASSERT_EQ(3u, list.size());
+    ASSERT_EQ(3u, list.capacity());
     ArrayList<int>::iterator it = list.erase(1);
     ASSERT_EQ(3, *it);
     ++it;
     ASSERT_EQ(list.end(), it);
     list.erase(0);
     list.erase(0);
-    ASSERT_EQ(0, list.size());
+    ASSERT_EQ(0u, list.size());
     ASSERT_EQ(list.end(), list.erase(100));
 }
 
@@ -213,13 +233,13 @@ TEST(list_test, test_erase_iterator) {
     it = list.begin();
     it = list.erase(it);
     ASSERT_EQ(2, *it);
-    ASSERT_EQ(2, list.size());
+    ASSERT_EQ(2u, list.size());
     it = list.erase(it);
     ASSERT_EQ(3, *it);
-    ASSERT_EQ(1, list.size());
+    ASSERT_EQ(1u, list.size());
     it = list.erase(it);
     ASSERT_EQ(list.end(), it);
-    ASSERT_EQ(0, list.size());
+    ASSERT_EQ(0u, list.size());
     ASSERT_EQ(list.end(), list.erase(it));
 }
 
@@ -229,10 +249,10 @@ TEST(list_test, test_swap_lists) {
     ArrayList<int> list1(values1, 3, 5);
     ArrayList<int> list2(values2, 5, 10);
     list1.swap(list2);
-    ASSERT_EQ(5, list1.size());
-    ASSERT_EQ(10, list1.capacity());
-    ASSERT_EQ(3, list2.size());
-    ASSERT_EQ(5, list2.capacity());
+    ASSERT_EQ(5u, list1.size());
+    ASSERT_EQ(10u, list1.capacity());
+    ASSERT_EQ(3u, list2.size());
+    ASSERT_EQ(5u, list2.capacity());
     for (size_type i = 0; i < list1.size(); i++) {
         ASSERT_EQ(values2[i], list1[i]);
     }
@@ -243,13 +263,13 @@ TEST(list_test, test_swap_lists) {
 
 TEST(list_test, test_reserve) {
     ArrayList<int> list(10);
-    ASSERT_EQ(10, list.capacity());
+    ASSERT_EQ(10u, list.capacity());
     list.reserve(5);
-    ASSERT_EQ(10, list.capacity());
+    ASSERT_EQ(10u, list.capacity());
     list.push_back(10);
     list.push_back(5);
     list.reserve(15);
-    ASSERT_EQ(15, list.capacity());
+    ASSERT_EQ(15u, list.capacity());
     ASSERT_EQ(10, list.front());
     ASSERT_EQ(5, list.back());
 }
@@ -258,14 +278,14 @@ TEST(list_test, test_shrink) {
     int values[] = {1, 2, 3};
     ArrayList<int> list(values, 3);
     list.shrink();
-    ASSERT_EQ(3, list.size());
-    ASSERT_EQ(3, list.capacity());
+    ASSERT_EQ(3u, list.size());
+    ASSERT_EQ(3u, list.capacity());
     list.pop_back();
     list.pop_back();
-    ASSERT_EQ(1, list.size());
-    ASSERT_EQ(3, list.capacity());
+    ASSERT_EQ(1u, list.size());
+    ASSERT_EQ(3u, list.capacity());
     list.shrink();
-    ASSERT_EQ(1, list.capacity());
+    ASSERT_EQ(1u, list.capacity());
     ASSERT_EQ(1, list[0]);
 }
 
@@ -352,10 +372,10 @@ TEST(list_iterator_test, test_add_subtract) {
     size_type v = 2;
     it1 = it2 - v;
     ASSERT_EQ(3, *it1);
-    ASSERT_EQ(7, list.begin() - list.end());
-    ASSERT_EQ(7, list.end() - list.begin());
+    ASSERT_EQ(7u, list.begin() - list.end());
+    ASSERT_EQ(7u, list.end() - list.begin());
     it1 = list.end();
-    ASSERT_EQ(7, list.begin() - it1);
+    ASSERT_EQ(7u, list.begin() - it1);
 }
 
 TEST(list_const_iterator_test, test_arrow_op) {
@@ -430,12 +450,12 @@ TEST(list_const_iterator_test, test_bulk_functions) {
     cit g8 = g5 - v;
     ASSERT_EQ(g7, g8);
     ASSERT_EQ(2, *g8);
-    ASSERT_EQ(8, list.end() - list.begin());
-    ASSERT_EQ(8, list.begin() - list.end());
+    ASSERT_EQ(8u, list.end() - list.begin());
+    ASSERT_EQ(8u, list.begin() - list.end());
     g8 = list.end();
-    ASSERT_EQ(8, list.begin() - g8);
+    ASSERT_EQ(8u, list.begin() - g8);
     g8 = list.begin();
-    ASSERT_EQ(8, list.end() - g8);
+    ASSERT_EQ(8u, list.end() - g8);
     cit g9 = move(g8);
     ASSERT_EQ(list.begin(), g9);
 }
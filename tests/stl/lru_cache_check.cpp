@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stl/LRUCache.h"
+
+#include "../no_alloc_fixture.h"
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef uint16_t ui16;
+typedef StaticString<16> String16;
+typedef LRUCache<ui16, ui16, 4> small_cache;
+
+TEST(lru_cache_test, test_put_and_get) {
+    small_cache cache;
+    ASSERT_TRUE(cache.empty());
+    ASSERT_EQ(4u, cache.capacity());
+    ASSERT_EQ(nullptr, cache.get(1));
+    ASSERT_TRUE(cache.put(1, 10));
+    ASSERT_TRUE(cache.put(2, 20));
+    ASSERT_FALSE(cache.put(1, 11));
+    ASSERT_EQ(2u, cache.size());
+    ASSERT_EQ(11, *cache.get(1));
+    ASSERT_EQ(20, *cache.get(2));
+    *cache.get(2) = 21;
+    ASSERT_EQ(21, *cache.peek(2));
+    ASSERT_EQ(nullptr, cache.peek(3));
+    ASSERT_TRUE(cache.contains(1));
+    ASSERT_FALSE(cache.contains(3));
+}
+
+TEST(lru_cache_test, test_evicts_least_recently_used) {
+    small_cache cache;
+    for (ui16 i = 0; i < 4; ++i) {
+        cache.put(i, i);
+    }
+    ASSERT_TRUE(cache.full());
+    ASSERT_EQ(0, cache.lru_key());
+    ASSERT_EQ(3, cache.mru_key());
+    // using 0 and assigning 1 makes 2 the least recently used
+    cache.get(0);
+    cache.put(1, 100);
+    ASSERT_EQ(2, cache.lru_key());
+    ASSERT_EQ(1, cache.mru_key());
+    ASSERT_TRUE(cache.put(4, 4));
+    ASSERT_EQ(4u, cache.size());
+    ASSERT_FALSE(cache.contains(2));
+    ASSERT_EQ(3, cache.lru_key());
+    // peeking and containment checks do not count as uses
+    cache.peek(3);
+    cache.contains(3);
+    cache.put(5, 5);
+    ASSERT_FALSE(cache.contains(3));
+    ASSERT_EQ(2u, cache.evictions());
+    ASSERT_EQ(100, *cache.get(1));
+}
+
+TEST(lru_cache_test, test_erase) {
+    small_cache cache;
+    for (ui16 i = 0; i < 4; ++i) {
+        cache.put(i, i);
+    }
+    ASSERT_FALSE(cache.erase(7));
+    ASSERT_TRUE(cache.erase(1));
+    ASSERT_FALSE(cache.contains(1));
+    ASSERT_EQ(3u, cache.size());
+    // the freed slot is reused without evicting
+    ASSERT_TRUE(cache.put(7, 7));
+    ASSERT_EQ(0u, cache.evictions());
+    ASSERT_EQ(0, cache.lru_key());
+    ASSERT_TRUE(cache.erase(0));
+    ASSERT_EQ(2, cache.lru_key());
+    ASSERT_TRUE(cache.erase(7));
+    ASSERT_EQ(3, cache.mru_key());
+    ASSERT_TRUE(cache.erase(2));
+    ASSERT_TRUE(cache.erase(3));
+    ASSERT_TRUE(cache.empty());
+    cache.put(9, 9);
+    ASSERT_EQ(9, cache.lru_key());
+    ASSERT_EQ(9, cache.mru_key());
+    cache.clear();
+    ASSERT_TRUE(cache.empty());
+    ASSERT_FALSE(cache.contains(9));
+}
+
+TEST(lru_cache_test, test_matches_reference_model) {
+    LRUCache<ui16, ui16, 8> cache;
+    // keys ordered from the most to the least recently used
+    std::vector<std::pair<ui16, ui16>> expected;
+    uint32_t state = 12345;
+    for (ui16 i = 0; i < 3000; ++i) {
+        state = state * 1103515245u + 12345u;
+        ui16 key = static_cast<ui16>((state >> 16) % 20);
+        auto it = std::find_if(expected.begin(), expected.end(),
+                               [key](const std::pair<ui16, ui16> &e) { return e.first == key; });
+        switch ((state >> 8) % 4) {
+            case 0:
+            case 1: {
+                ui16 *val = cache.get(key);
+                ASSERT_EQ(it != expected.end(), val != nullptr);
+                if (val) {
+                    ASSERT_EQ(it->second, *val);
+                    std::pair<ui16, ui16> entry = *it;
+                    expected.erase(it);
+                    expected.insert(expected.begin(), entry);
+                }
+                break;
+            }
+            case 2:
+                ASSERT_EQ(it == expected.end(), cache.put(key, i));
+                if (it != expected.end()) {
+                    expected.erase(it);
+                } else if (expected.size() == 8) {
+                    expected.pop_back();
+                }
+                expected.insert(expected.begin(), std::make_pair(key, i));
+                break;
+            default:
+                ASSERT_EQ(it != expected.end(), cache.erase(key));
+                if (it != expected.end()) {
+                    expected.erase(it);
+                }
+                break;
+        }
+        ASSERT_EQ(expected.size(), cache.size());
+        if (!expected.empty()) {
+            ASSERT_EQ(expected.front().first, cache.mru_key());
+            ASSERT_EQ(expected.back().first, cache.lru_key());
+        }
+    }
+    ASSERT_EQ(cache.size(), cache.get_index().size());
+}
+
+TEST(lru_cache_test, test_counters) {
+    small_cache cache;
+    ASSERT_EQ(0, cache.hit_rate());
+    for (ui16 i = 0; i < 6; ++i) {
+        cache.put(i, i);
+    }
+    ASSERT_EQ(6u, cache.insertions());
+    ASSERT_EQ(2u, cache.evictions());
+    for (ui16 i = 0; i < 6; ++i) {
+        cache.get(i);
+    }
+    cache.get(5);
+    cache.get(5);
+    ASSERT_EQ(6u, cache.hits());
+    ASSERT_EQ(2u, cache.misses());
+    ASSERT_EQ(8u, cache.lookups());
+    ASSERT_EQ(75, cache.hit_rate());
+    cache.reset_counters();
+    ASSERT_EQ(0u, cache.lookups());
+    ASSERT_EQ(0u, cache.evictions());
+    ASSERT_EQ(4u, cache.size());
+}
+
+TEST(lru_cache_test, test_single_entry) {
+    LRUCache<ui16, ui16, 1> cache;
+    cache.put(1, 1);
+    cache.put(2, 2);
+    ASSERT_FALSE(cache.contains(1));
+    ASSERT_EQ(2, *cache.get(2));
+    ASSERT_EQ(2, cache.lru_key());
+    ASSERT_TRUE(cache.erase(2));
+    ASSERT_TRUE(cache.empty());
+}
+
+TEST(lru_cache_test, test_string_keys) {
+    LRUCache<String16, ui16, 2> cache;
+    cache.put(String16("alpha"), 1);
+    cache.put(String16("beta"), 2);
+    cache.get(String16("alpha"));
+    cache.put(String16("gamma"), 3);
+    ASSERT_FALSE(cache.contains(String16("beta")));
+    ASSERT_EQ(1, *cache.get(String16("alpha")));
+    ASSERT_STREQ("gamma", cache.lru_key().c_str());
+}
+
+TEST_F(no_alloc_test, test_lru_cache_does_not_allocate) {
+    LRUCache<ui16, ui16, 16> cache;
+    ASSERT_EQ(0u, count_allocations([&]() {
+        for (ui16 i = 0; i < 200; ++i) {
+            cache.put(static_cast<ui16>(i % 37), i);
+            cache.get(static_cast<ui16>(i % 11));
+            if (i % 5 == 0) {
+                cache.erase(static_cast<ui16>(i % 13));
+            }
+        }
+        cache.clear();
+        cache.put(1, 1);
+    }));
+    ASSERT_EQ(1u, cache.size());
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "stl/OpenMap.h"
 
+#include "../no_alloc_fixture.h"
+#include "../tracked_value.h"
 #include "../template_defs.h"
 
 using namespace wlp;
@@ -13,8 +15,8 @@ typedef Pair<imi, bool> P_imi_b;
 
 TEST(open_map_test, test_constructor_parameters) {
     int_map map(15, 61);
-    ASSERT_EQ(15, map.capacity());
-    ASSERT_EQ(0, map.size());
+    ASSERT_EQ(15u, map.capacity());
+    ASSERT_EQ(0u, map.size());
     ASSERT_EQ(61, map.max_load());
 }
 
@@ -26,6 +28,19 @@ TEST(open_map_test, test_constructor_allocator) {
     ASSERT_EQ(expected * 12, alloc->GetPoolSize());
 }
 
+TEST(open_map_test, test_node_pool_fits_the_size_type) {
+    // the pool holds the requested nodes only as far as they fit the size type
+    string_map map(2000, 75);
+    uint64_t node_size = sizeof(string_map::node_type);
+    uint64_t requested = 2000 * node_size;
+    uint64_t fitting = max_size_type / node_size * node_size;
+    ASSERT_EQ(requested < fitting ? requested : fitting, map.get_node_allocator()->GetPoolSize());
+    for (uint16_t i = 0; i < 100; ++i) {
+        map[string16{"key"} + static_cast<char>('a' + i % 26) + static_cast<char>('a' + i / 26)] = string16{"val"};
+    }
+    ASSERT_EQ(100u, map.size());
+}
+
 TEST(open_map_test, test_is_empty_on_construct) {
     string_map map(12, 75);
     ASSERT_TRUE(map.empty());
@@ -116,8 +131,8 @@ TEST(open_map_test, test_insert_find_iterate_integer) {
     ASSERT_EQ(90, *it1);
     ++it1;
     ASSERT_EQ(it1, map.end());
-    ASSERT_EQ(5, map.size());
-    ASSERT_EQ(10, map.capacity());
+    ASSERT_EQ(5u, map.size());
+    ASSERT_EQ(10u, map.capacity());
 }
 
 TEST(open_map_test, test_map_iterator_postfix) {
@@ -132,7 +147,7 @@ TEST(open_map_test, test_map_iterator_postfix) {
     ASSERT_EQ(*it, 12);
     ++it_post;
     ASSERT_EQ(it_post, it);
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
 }
 
 TEST(open_map_test, test_begin_non_empty) {
@@ -154,7 +169,7 @@ TEST(open_map_test, test_map_insert_or_assign) {
     ASSERT_EQ(14, *res1.first());
     ASSERT_EQ(12, *res2.first());
     ASSERT_EQ(14, *res3.first());
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
 }
 
 TEST(open_map_test, test_at_returns_value) {
@@ -163,7 +178,7 @@ TEST(open_map_test, test_at_returns_value) {
     map.insert(16, 15);
     map.insert(20, 19);
     map.insert(4, 16);
-    ASSERT_EQ(4, map.size());
+    ASSERT_EQ(4u, map.size());
     ASSERT_EQ(12, *map.at(10));
     ASSERT_EQ(15, *map.at(16));
     ASSERT_EQ(19, *map.at(20));
@@ -176,12 +191,12 @@ TEST(open_map_test, test_at_is_assignable) {
     map.insert(16, 15);
     ASSERT_EQ(15, *map.at(16));
     ASSERT_EQ(12, *map.at(10));
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
     *map.at(16) = 100;
     *map.at(10) = 101;
     ASSERT_EQ(100, *map.at(16));
     ASSERT_EQ(101, *map.at(10));
-    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(2u, map.size());
 }
 
 TEST(open_map_test, test_at_returns_pass_the_end) {
@@ -264,10 +279,10 @@ TEST(open_map_test, test_clear_map) {
     map[226] = 2216;
     map[337] = 2317;
     map[448] = 2418;
-    ASSERT_EQ(9, map.size());
+    ASSERT_EQ(9u, map.size());
     map.clear();
-    ASSERT_EQ(0, map.size());
-    ASSERT_EQ(20, map.capacity());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(20u, map.capacity());
     ASSERT_EQ(map.begin(), map.end());
 }
 
@@ -309,13 +324,13 @@ TEST(open_map_test, test_erase_iterator_rehash) {
     map[28] = 280;
     map[38] = 380;
     map[48] = 480;
-    ASSERT_EQ(10, map.capacity());
-    ASSERT_EQ(5, map.size());
+    ASSERT_EQ(10u, map.capacity());
+    ASSERT_EQ(5u, map.size());
     imi it = map.begin();
     it = map.erase(it);
     ASSERT_EQ(380, *it);
-    ASSERT_EQ(4, map.size());
-    ASSERT_EQ(10, map.capacity());
+    ASSERT_EQ(4u, map.size());
+    ASSERT_EQ(10u, map.capacity());
 }
 
 TEST(open_map_test, test_erase_nonexisting_key) {
@@ -333,12 +348,12 @@ TEST(open_map_test, test_erase_key_rehash) {
     map[28] = 280;
     map[38] = 380;
     map[48] = 480;
-    ASSERT_EQ(10, map.capacity());
-    ASSERT_EQ(5, map.size());
+    ASSERT_EQ(10u, map.capacity());
+    ASSERT_EQ(5u, map.size());
     uint16_t k = 28;
     ASSERT_TRUE(map.erase(k));
-    ASSERT_EQ(4, map.size());
-    ASSERT_EQ(10, map.capacity());
+    ASSERT_EQ(4u, map.size());
+    ASSERT_EQ(10u, map.capacity());
 }
 
 TEST(open_map_test, test_move_assignment) {
@@ -350,10 +365,10 @@ TEST(open_map_test, test_move_assignment) {
     map[48] = 480;
     int_map map1(12, 91);
     map1 = move(map);
-    ASSERT_EQ(0, map.size());
-    ASSERT_EQ(0, map.capacity());
-    ASSERT_EQ(5, map1.size());
-    ASSERT_EQ(10, map1.capacity());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(0u, map.capacity());
+    ASSERT_EQ(5u, map1.size());
+    ASSERT_EQ(10u, map1.capacity());
     ASSERT_EQ(90, map1.max_load());
     imi it = map1.begin();
     uint16_t expected_traverse[] = {280, 380, 480, 80, 880};
@@ -363,3 +378,523 @@ TEST(open_map_test, test_move_assignment) {
     }
     ASSERT_EQ(map1.end(), it);
 }
+
+TEST(open_map_test, test_erase_keeps_collisions_reachable) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[88] = 880;
+    map[28] = 280;
+    map[9] = 90;
+    map[38] = 380;
+    uint16_t k = 88;
+    ASSERT_TRUE(map.erase(k));
+    k = 8;
+    ASSERT_TRUE(map.erase(k));
+    ASSERT_EQ(3u, map.size());
+    ASSERT_EQ(280, *map.find(28));
+    ASSERT_EQ(90, *map.find(9));
+    ASSERT_EQ(380, *map.find(38));
+    ASSERT_FALSE(map.contains(88));
+    ASSERT_FALSE(map.contains(8));
+}
+
+TEST(open_map_test, test_erase_all_while_iterating) {
+    int_map map(16, 75);
+    for (uint16_t i = 0; i < 10; ++i) {
+        map[static_cast<uint16_t>(i * 16 + 3)] = i;
+    }
+    uint16_t erased = 0;
+    for (imi it = map.begin(); it != map.end(); it = map.erase(it)) {
+        ++erased;
+    }
+    ASSERT_EQ(10, erased);
+    ASSERT_TRUE(map.empty());
+}
+
+TEST_F(no_alloc_test, test_open_map_erase_does_not_allocate) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[88] = 880;
+    map[28] = 280;
+    uint16_t k = 88;
+    ASSERT_NO_ALLOC(map.erase(k));
+    imi it = map.begin();
+    ASSERT_NO_ALLOC(map.erase(it));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST(open_map_test, test_power_of_two_capacity) {
+    OpenHashMap<uint16_t, uint16_t, Hash<uint16_t, uint16_t>, Equal<uint16_t>, PowerOfTwoIndex> map(12, 75);
+    ASSERT_EQ(16u, map.capacity());
+    for (uint16_t i = 0; i < 100; ++i) {
+        map[static_cast<uint16_t>(i * 16)] = i;
+    }
+    ASSERT_EQ(100u, map.size());
+    ASSERT_EQ(256u, map.capacity());
+    for (uint16_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, *map.find(static_cast<uint16_t>(i * 16)));
+    }
+    for (uint16_t i = 0; i < 100; i = static_cast<uint16_t>(i + 2)) {
+        uint16_t k = static_cast<uint16_t>(i * 16);
+        ASSERT_TRUE(map.erase(k));
+    }
+    ASSERT_EQ(50u, map.size());
+    for (uint16_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(i % 2 == 1, map.contains(static_cast<uint16_t>(i * 16)));
+    }
+}
+
+TEST(open_map_test, test_probe_length) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[18] = 180;
+    map[28] = 280;
+    ASSERT_EQ(1u, map.probe_length(8));
+    ASSERT_EQ(2u, map.probe_length(18));
+    ASSERT_EQ(3u, map.probe_length(28));
+    ASSERT_EQ(4u, map.probe_length(38));
+    ASSERT_EQ(1u, map.probe_length(5));
+}
+
+template<class Map>
+static void check_high_load_churn() {
+    Map map(64, 95);
+    for (uint16_t i = 0; i < 60; ++i) {
+        map[static_cast<uint16_t>(i * 37)] = i;
+    }
+    ASSERT_EQ(64u, map.capacity());
+    for (uint16_t i = 0; i < 60; i = static_cast<uint16_t>(i + 2)) {
+        uint16_t k = static_cast<uint16_t>(i * 37);
+        ASSERT_TRUE(map.erase(k));
+    }
+    for (uint16_t i = 60; i < 90; ++i) {
+        ASSERT_TRUE(map.insert(static_cast<uint16_t>(i * 37), i).second());
+    }
+    ASSERT_EQ(60u, map.size());
+    for (uint16_t i = 0; i < 90; ++i) {
+        bool present = i >= 60 || i % 2 == 1;
+        ASSERT_EQ(present, map.contains(static_cast<uint16_t>(i * 37)));
+        if (present) {
+            ASSERT_EQ(i, *map.find(static_cast<uint16_t>(i * 37)));
+        }
+    }
+    uint16_t count = 0;
+    for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    ASSERT_EQ(60, count);
+    for (typename Map::iterator it = map.begin(); it != map.end(); it = map.erase(it));
+    ASSERT_TRUE(map.empty());
+}
+
+typedef Hash<uint16_t, uint16_t> int_hash;
+typedef Equal<uint16_t> int_equal;
+
+TEST(open_map_test, test_linear_probe_high_load) {
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, LinearProbe>>();
+}
+
+TEST(open_map_test, test_quadratic_probe_high_load) {
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, QuadraticProbe>>();
+}
+
+TEST(open_map_test, test_robin_hood_probe_high_load) {
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe>>();
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, RobinHoodProbe>>();
+}
+
+TEST(open_map_test, test_robin_hood_bounds_probe_lengths) {
+    OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, LinearProbe> linear(16, 100);
+    OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe> robin_hood(16, 100);
+    // keys in their home buckets 1 to 6, then a cluster homed at 0
+    for (uint16_t i = 1; i < 7; ++i) {
+        linear[i] = i;
+        robin_hood[i] = i;
+    }
+    for (uint16_t i = 0; i < 8; ++i) {
+        linear[static_cast<uint16_t>(i * 16)] = i;
+        robin_hood[static_cast<uint16_t>(i * 16)] = i;
+    }
+    size_type linear_max = 0;
+    size_type robin_hood_max = 0;
+    for (uint16_t i = 0; i < 8; ++i) {
+        linear_max = max(linear_max, linear.probe_length(static_cast<uint16_t>(i * 16)));
+        robin_hood_max = max(robin_hood_max, robin_hood.probe_length(static_cast<uint16_t>(i * 16)));
+    }
+    for (uint16_t i = 1; i < 7; ++i) {
+        linear_max = max(linear_max, linear.probe_length(i));
+        robin_hood_max = max(robin_hood_max, robin_hood.probe_length(i));
+    }
+    ASSERT_EQ(14u, linear_max);
+    ASSERT_LT(robin_hood_max, linear_max);
+    // a miss stops at the first element closer to home than the key
+    ASSERT_EQ(15u, linear.probe_length(128));
+    ASSERT_EQ(9u, robin_hood.probe_length(128));
+}
+
+struct open_counting_hash {
+    static uint16_t calls;
+
+    uint16_t operator()(uint16_t key) const {
+        ++calls;
+        return key;
+    }
+};
+
+uint16_t open_counting_hash::calls = 0;
+
+TEST(open_map_test, test_iteration_does_not_hash) {
+    OpenHashMap<uint16_t, uint16_t, open_counting_hash, int_equal> map(32, 75);
+    for (uint16_t i = 0; i < 20; ++i) {
+        map[static_cast<uint16_t>(i * 3)] = i;
+    }
+    open_counting_hash::calls = 0;
+    uint16_t count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    const auto &const_map = map;
+    for (auto it = const_map.begin(); it != const_map.end(); it++) {
+        ++count;
+    }
+    ASSERT_EQ(40, count);
+    ASSERT_EQ(0, open_counting_hash::calls);
+}
+
+TEST(open_map_test, test_iterator_key) {
+    int_map map(32, 75);
+    for (uint16_t i = 0; i < 20; ++i) {
+        map[static_cast<uint16_t>(i * 3)] = static_cast<uint16_t>(i * 30);
+    }
+    uint16_t count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(it.key() * 10, *it);
+        ++count;
+    }
+    const auto &const_map = map;
+    for (auto it = const_map.begin(); it != const_map.end(); ++it) {
+        ASSERT_EQ(it.key() * 10, *it);
+        ++count;
+    }
+    ASSERT_EQ(40, count);
+}
+
+TEST(open_map_test, test_erase_iterator_does_not_hash) {
+    OpenHashMap<uint16_t, uint16_t, open_counting_hash, int_equal, ModuloIndex, LinearProbe, StoredHash> map(32, 75);
+    for (uint16_t i = 0; i < 20; ++i) {
+        map[static_cast<uint16_t>(i * 3)] = i;
+    }
+    open_counting_hash::calls = 0;
+    auto it = map.begin();
+    while (it != map.end()) {
+        map.erase(it);
+    }
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(0, open_counting_hash::calls);
+}
+
+TEST(open_map_test, test_iterator_follows_shifted_element) {
+    int_map map(10, 90);
+    map[8] = 80;
+    map[18] = 180;
+    map[28] = 280;
+    imi it = map.find(28);
+    ASSERT_EQ(0u, it.m_index);
+    uint16_t k = 18;
+    ASSERT_TRUE(map.erase(k));
+    // 28 was shifted back into bucket 9
+    ASSERT_EQ(280, *it);
+    ASSERT_EQ(map.end(), ++it);
+}
+
+TEST(open_map_test, test_heterogeneous_lookup) {
+    string_map map(16, 75);
+    map[string16("alpha")] = string16("one");
+    map[string16("beta")] = string16("two");
+    const char *key = "beta";
+    ASSERT_TRUE(map.contains(key));
+    ASSERT_TRUE(map.contains("alpha"));
+    ASSERT_FALSE(map.contains("alph"));
+    ASSERT_FALSE(map.contains("alphabet"));
+    ASSERT_EQ(string16("two"), *map.find(key));
+    ASSERT_EQ(string16("one"), *map.at(StaticString<8>("alpha")));
+    ASSERT_EQ(map.end(), map.find(StaticString<32>("gamma")));
+    const string_map &const_map = map;
+    ASSERT_EQ(string16("two"), *const_map.find("beta"));
+    ASSERT_EQ(string16("one"), *const_map.at("alpha"));
+    ASSERT_FALSE(map.erase("gamma"));
+    ASSERT_TRUE(map.erase(key));
+    ASSERT_FALSE(map.contains(key));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST_F(no_alloc_test, test_open_map_heterogeneous_lookup_does_not_allocate) {
+    string_map map(16, 75);
+    map[string16("packet")] = string16("parsed");
+    const char *key = "packet";
+    ASSERT_NO_ALLOC(ASSERT_TRUE(map.contains(key)));
+    ASSERT_NO_ALLOC(ASSERT_NE(map.end(), map.find(key)));
+    ASSERT_NO_ALLOC(ASSERT_TRUE(map.erase(key)));
+}
+
+TEST(open_map_test, test_stored_hash_high_load) {
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, LinearProbe, StoredHash>>();
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, QuadraticProbe, StoredHash>>();
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe, StoredHash>>();
+}
+
+TEST(open_map_test, test_stored_hash_rehash_does_not_hash) {
+    OpenHashMap<uint16_t, uint16_t, open_counting_hash, int_equal, ModuloIndex, LinearProbe, StoredHash> map(8, 75);
+    for (uint16_t i = 0; i < 6; ++i) {
+        map[i] = i;
+    }
+    ASSERT_EQ(8u, map.capacity());
+    open_counting_hash::calls = 0;
+    map[6] = 6;
+    ASSERT_EQ(16u, map.capacity());
+    ASSERT_EQ(1, open_counting_hash::calls);
+    for (uint16_t i = 0; i < 7; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+struct open_counting_equal {
+    static uint16_t calls;
+
+    bool operator()(uint16_t key1, uint16_t key2) const {
+        ++calls;
+        return key1 == key2;
+    }
+};
+
+uint16_t open_counting_equal::calls = 0;
+
+TEST(open_map_test, test_stored_hash_skips_unequal_keys) {
+    OpenHashMap<uint16_t, uint16_t, int_hash, open_counting_equal, ModuloIndex, LinearProbe, StoredHash> map(16, 75);
+    // all keys share home bucket 1
+    for (uint16_t i = 0; i < 5; ++i) {
+        map[static_cast<uint16_t>(1 + i * 16)] = i;
+    }
+    open_counting_equal::calls = 0;
+    ASSERT_EQ(4, *map.find(65));
+    ASSERT_EQ(1, open_counting_equal::calls);
+    ASSERT_FALSE(map.contains(81));
+    ASSERT_EQ(1, open_counting_equal::calls);
+}
+
+template<class Map>
+static void check_incremental_growth() {
+    Map map(4, 75);
+    for (uint16_t i = 0; i < 300; ++i) {
+        map[static_cast<uint16_t>(i * 7)] = i;
+        // every key is found while both arrays hold elements
+        for (uint16_t j = 0; j <= i; ++j) {
+            ASSERT_EQ(j, *map.find(static_cast<uint16_t>(j * 7)));
+        }
+        ASSERT_FALSE(map.contains(static_cast<uint16_t>(i * 7 + 1)));
+        uint16_t count = 0;
+        for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+            ++count;
+        }
+        ASSERT_EQ(i + 1, count);
+    }
+    ASSERT_EQ(512u, map.capacity());
+    for (uint16_t i = 0; i < 300; i = static_cast<uint16_t>(i + 3)) {
+        uint16_t k = static_cast<uint16_t>(i * 7);
+        ASSERT_TRUE(map.erase(k));
+    }
+    ASSERT_EQ(200u, map.size());
+    for (typename Map::iterator it = map.begin(); it != map.end(); it = map.erase(it));
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(open_map_test, test_incremental_rehash_growth) {
+    check_incremental_growth<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, LinearProbe, NoStoredHash, IncrementalRehash>>();
+    check_incremental_growth<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, QuadraticProbe, StoredHash, IncrementalRehash>>();
+    check_incremental_growth<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe, StoredHash, IncrementalRehash>>();
+}
+
+TEST(open_map_test, test_incremental_rehash_high_load) {
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, LinearProbe, NoStoredHash, IncrementalRehash>>();
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, QuadraticProbe, NoStoredHash, IncrementalRehash>>();
+    check_high_load_churn<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe, StoredHash, IncrementalRehash>>();
+}
+
+TEST(open_map_test, test_incremental_rehash_bounds_insert_work) {
+    typedef OpenHashMap<uint16_t, uint16_t, open_counting_hash, int_equal, ModuloIndex, LinearProbe, NoStoredHash, IncrementalRehash> incremental_map;
+    incremental_map map(8, 75);
+    uint16_t max_calls = 0;
+    for (uint16_t i = 0; i < 1000; ++i) {
+        open_counting_hash::calls = 0;
+        map[i] = i;
+        if (open_counting_hash::calls > max_calls) {
+            max_calls = open_counting_hash::calls;
+        }
+    }
+    // the key itself and at most two moved elements
+    ASSERT_GE(3, max_calls);
+    ASSERT_EQ(2048u, map.capacity());
+    for (uint16_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i, map[i]);
+    }
+}
+
+TEST(open_map_test, test_incremental_rehash_iterator_survives_erase) {
+    OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, LinearProbe, NoStoredHash, IncrementalRehash> map(8, 75);
+    for (uint16_t i = 0; i < 7; ++i) {
+        map[i] = i;
+    }
+    // the last insertion started moving the old array
+    ASSERT_EQ(16u, map.capacity());
+    uint16_t count = 0;
+    for (auto it = map.begin(); it != map.end();) {
+        if (*it % 2 == 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+        ++count;
+    }
+    ASSERT_EQ(7, count);
+    ASSERT_EQ(3u, map.size());
+    ASSERT_TRUE(map.contains(5));
+    ASSERT_FALSE(map.contains(4));
+}
+
+TEST(open_map_test, test_reserve) {
+    int_map map(8, 75);
+    map.reserve(100);
+    size_type capacity = map.capacity();
+    ASSERT_LE(101u, capacity);
+    for (uint16_t i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    ASSERT_EQ(capacity, map.capacity());
+    map.reserve(10);
+    ASSERT_EQ(capacity, map.capacity());
+    for (uint16_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+TEST(open_map_test, test_explicit_rehash) {
+    int_map map(8, 75);
+    for (uint16_t i = 0; i < 6; ++i) {
+        map[i] = i;
+    }
+    map.rehash(40);
+    ASSERT_EQ(40u, map.capacity());
+    // never below the capacity holding the elements
+    map.rehash(2);
+    ASSERT_EQ(7u, map.capacity());
+    ASSERT_EQ(6u, map.size());
+    for (uint16_t i = 0; i < 6; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+TEST(open_map_test, test_range_insert) {
+    typedef Pair<uint16_t, uint16_t> entry;
+    entry entries[50];
+    for (uint16_t i = 0; i < 50; ++i) {
+        entries[i] = entry(static_cast<uint16_t>(i % 40), i);
+    }
+    int_map map(4, 75);
+    map[3] = 300;
+    map.insert(entries, entries + 50);
+    ASSERT_EQ(40u, map.size());
+    ASSERT_EQ(300, map[3]);
+    ASSERT_EQ(4, map[4]);
+    ASSERT_EQ(39, map[39]);
+}
+
+template<class Map>
+static void check_erase_if() {
+    Map map(16, 90);
+    for (uint16_t i = 0; i < 400; ++i) {
+        map[static_cast<uint16_t>(i * 13)] = i;
+    }
+    size_type erased = map.erase_if([](uint16_t, uint16_t val) { return val % 3 != 1; });
+    ASSERT_EQ(267u, erased);
+    ASSERT_EQ(133u, map.size());
+    for (uint16_t i = 0; i < 400; ++i) {
+        bool present = i % 3 == 1;
+        ASSERT_EQ(present, map.contains(static_cast<uint16_t>(i * 13)));
+        if (present) {
+            ASSERT_EQ(i, *map.find(static_cast<uint16_t>(i * 13)));
+        }
+    }
+    uint16_t count = 0;
+    for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    ASSERT_EQ(133, count);
+    ASSERT_EQ(0u, map.erase_if([](uint16_t, uint16_t) { return false; }));
+    for (uint16_t i = 400; i < 500; ++i) {
+        map[static_cast<uint16_t>(i * 13)] = i;
+    }
+    ASSERT_EQ(233u, map.size());
+    ASSERT_EQ(233u, map.erase_if([](uint16_t, uint16_t) { return true; }));
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.end(), map.begin());
+}
+
+TEST(open_map_test, test_erase_if) {
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, LinearProbe>>();
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, LinearProbe, StoredHash>>();
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, QuadraticProbe>>();
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, RobinHoodProbe>>();
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, PowerOfTwoIndex, RobinHoodProbe, StoredHash, IncrementalRehash>>();
+    check_erase_if<OpenHashMap<uint16_t, uint16_t, int_hash, int_equal, ModuloIndex, LinearProbe, NoStoredHash, IncrementalRehash>>();
+}
+
+TEST(open_map_test, test_erase_if_does_not_hash) {
+    OpenHashMap<uint16_t, uint16_t, open_counting_hash, int_equal, ModuloIndex, RobinHoodProbe> map(64, 90);
+    for (uint16_t i = 0; i < 50; ++i) {
+        map[static_cast<uint16_t>(i * 5)] = i;
+    }
+    open_counting_hash::calls = 0;
+    ASSERT_EQ(25u, map.erase_if([](uint16_t key, uint16_t) { return key % 2 == 0; }));
+    ASSERT_EQ(0, open_counting_hash::calls);
+}
+
+TEST(open_map_test, test_emplace_does_not_copy) {
+    typedef OpenHashMap<uint16_t, tracked_value> tracked_map;
+    tracked_map map(16, 75);
+    tracked_value value(1, 2);
+    uint16_t one = 1;
+    uint16_t four = 4;
+    uint16_t seven = 7;
+    uint16_t eight = 8;
+    tracked_value::reset();
+    ASSERT_TRUE(map.insert(one, value).second());
+    ASSERT_EQ(1, tracked_value::copies);
+    ASSERT_TRUE(map.insert(2, tracked_value(3, 4)).second());
+    ASSERT_EQ(1, tracked_value::copies);
+    ASSERT_EQ(1, tracked_value::moves);
+    ASSERT_TRUE(map.try_emplace(3, tracked_value(5, 6)).second());
+    ASSERT_EQ(2, tracked_value::moves);
+    // the value is built in the node from the arguments
+    ASSERT_TRUE(map.emplace(four, seven, eight).second());
+    ASSERT_EQ(1, tracked_value::copies);
+    ASSERT_EQ(2, tracked_value::moves);
+    // an existing key leaves the arguments untouched
+    tracked_value other(9, 9);
+    Pair<tracked_map::iterator, bool> result = map.try_emplace(3, move(other));
+    ASSERT_FALSE(result.second());
+    ASSERT_EQ(9, other.a);
+    ASSERT_EQ(5, result.first()->a);
+    ASSERT_EQ(7, map[4].a);
+    ASSERT_EQ(8, map[4].b);
+    ASSERT_EQ(4u, map.size());
+}
+
+TEST(open_map_test, test_emplace_string) {
+    string_map map(16, 75);
+    ASSERT_TRUE(map.emplace("alpha", "one").second());
+    ASSERT_FALSE(map.emplace("alpha", "two").second());
+    string16 key("beta");
+    ASSERT_TRUE(map.try_emplace(key, "two").second());
+    ASSERT_EQ(string16("one"), map[string16("alpha")]);
+    ASSERT_EQ(string16("two"), map[key]);
+}
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "stl/OpenSet.h"
+
+using namespace wlp;
+
+typedef StaticString<16> string16;
+typedef OpenHashSet<string16> string_set;
+typedef OpenHashSet<uint16_t> int_set;
+
+TEST(open_set_test, test_nodes_store_key_once) {
+    ASSERT_EQ(sizeof(string16), sizeof(string_set::map_type::node_type));
+    ASSERT_LT(sizeof(string_set::map_type::node_type), sizeof(OpenHashMap<string16, string16>::node_type));
+    string_set set(12, 75);
+    ASSERT_EQ(sizeof(string16), set.get_node_allocator()->GetBlockSize());
+}
+
+TEST(open_set_test, test_insert_contains_find) {
+    string_set set;
+    ASSERT_TRUE(set.empty());
+    Pair<string_set::iterator, bool> res = set.insert(string16{"maglev"});
+    ASSERT_TRUE(res.second());
+    ASSERT_EQ(string16{"maglev"}, *res.first());
+    res = set.insert(string16{"maglev"});
+    ASSERT_FALSE(res.second());
+    ASSERT_TRUE(set.insert(string16{"pod"}).second());
+    ASSERT_EQ(2u, set.size());
+    ASSERT_TRUE(set.contains(string16{"pod"}));
+    ASSERT_FALSE(set.contains(string16{"track"}));
+    ASSERT_EQ(string16{"pod"}, *set.find(string16{"pod"}));
+    ASSERT_EQ(set.end(), set.find(string16{"track"}));
+    const string_set &const_set = set;
+    ASSERT_EQ(string16{"maglev"}, *const_set.find(string16{"maglev"}));
+}
+
+TEST(open_set_test, test_erase_and_iterate) {
+    int_set set(32, 75);
+    for (uint16_t i = 0; i < 20; ++i) {
+        set.insert(i);
+    }
+    uint16_t key = 7;
+    ASSERT_TRUE(set.erase(key));
+    ASSERT_FALSE(set.erase(key));
+    int_set::iterator it = set.find(8);
+    set.erase(it);
+    ASSERT_FALSE(set.contains(8));
+    uint16_t sum = 0;
+    uint16_t count = 0;
+    for (int_set::iterator elem = set.begin(); elem != set.end(); ++elem) {
+        sum = static_cast<uint16_t>(sum + *elem);
+        ++count;
+    }
+    ASSERT_EQ(18, count);
+    ASSERT_EQ(190 - 7 - 8, sum);
+    set.clear();
+    ASSERT_TRUE(set.empty());
+}
+
+TEST(open_set_test, test_iterators_give_constant_elements) {
+    int_set set;
+    set.insert(3);
+    int_set::iterator it = set.find(3);
+    static_assert(is_same<decltype(*it), const uint16_t &>::value, "elements cannot be assigned through iterators");
+    static_assert(is_same<decltype(it.operator->()), const uint16_t *>::value, "elements cannot be assigned through iterators");
+    static_assert(is_same<decltype(*set.begin()), const uint16_t &>::value, "elements cannot be assigned through iterators");
+    const int_set &const_set = set;
+    static_assert(is_same<decltype(*const_set.find(3)), const uint16_t &>::value, "elements cannot be assigned through iterators");
+    ASSERT_EQ(3, *it);
+}
@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "stl/PerfectHashMap.h"
+
+#include "../no_alloc_fixture.h"
+
+using namespace wlp;
+
+typedef int (*handler)(int);
+
+static int start(int x) {
+    return x + 1;
+}
+
+static int stop(int x) {
+    return x - 1;
+}
+
+static int reset(int) {
+    return 0;
+}
+
+static constexpr auto commands = make_perfect_hash_map<const char *, handler>({
+        {"start", &start},
+        {"stop", &stop},
+        {"reset", &reset}});
+
+static constexpr PerfectHashEntry<uint16_t, uint16_t> parameter_entries[] = {
+        {100, 1}, {200, 2}, {300, 3}, {400, 4}, {500, 5}, {600, 6},
+        {700, 7}, {800, 8}, {900, 9}, {1000, 10}, {1100, 11}, {1200, 12},
+        {0, 13}, {1, 14}, {2, 15}, {3, 16}, {4, 17}, {5, 18}, {6, 19}, {7, 20}};
+
+static constexpr PerfectHashMap<uint16_t, uint16_t, 20> parameters(parameter_entries);
+
+static_assert(commands.valid(), "command keys are placed without collisions");
+static_assert(parameters.valid(), "parameter keys are placed without collisions");
+static_assert(*parameters.find(700) == 7, "lookups can be evaluated at compile time");
+static_assert(!parameters.contains(701), "missing keys are not found");
+static_assert(hash_string<uint32_t>("abc") == (97u * 127u + 98u) * 127u + 99u, "hash_string is constexpr");
+
+TEST(perfect_hash_map_test, test_string_keys) {
+    ASSERT_EQ(3u, commands.size());
+    ASSERT_EQ(&start, *commands.find("start"));
+    ASSERT_EQ(&stop, *commands.find("stop"));
+    ASSERT_EQ(&reset, *commands.find("reset"));
+    ASSERT_EQ(nullptr, commands.find("restart"));
+    ASSERT_EQ(nullptr, commands.find(""));
+    char key[] = "stop";
+    ASSERT_EQ(4, (*commands.find(key))(5));
+}
+
+TEST(perfect_hash_map_test, test_integer_keys) {
+    for (const PerfectHashEntry<uint16_t, uint16_t> &entry : parameter_entries) {
+        ASSERT_TRUE(parameters.contains(entry.m_key));
+        ASSERT_EQ(entry.m_val, *parameters.find(entry.m_key));
+    }
+    for (uint16_t key = 8; key < 100; ++key) {
+        ASSERT_FALSE(parameters.contains(key));
+    }
+}
+
+TEST(perfect_hash_map_test, test_every_entry_is_iterated_once) {
+    uint16_t sum = 0;
+    uint16_t count = 0;
+    for (const PerfectHashEntry<uint16_t, uint16_t> &entry : parameters) {
+        sum = static_cast<uint16_t>(sum + entry.m_val);
+        ++count;
+    }
+    ASSERT_EQ(20, count);
+    ASSERT_EQ(210, sum);
+}
+
+TEST(perfect_hash_map_test, test_duplicate_keys_are_invalid) {
+    PerfectHashEntry<uint16_t, uint16_t> entries[] = {{1, 1}, {2, 2}, {1, 3}};
+    PerfectHashMap<uint16_t, uint16_t, 3> map(entries);
+    ASSERT_FALSE(map.valid());
+    ASSERT_FALSE(map.contains(2));
+}
+
+TEST(perfect_hash_map_test, test_runtime_construction) {
+    PerfectHashEntry<uint16_t, uint16_t> entries[64] = {};
+    for (uint16_t i = 0; i < 64; ++i) {
+        entries[i].m_key = static_cast<uint16_t>(i * 37);
+        entries[i].m_val = i;
+    }
+    PerfectHashMap<uint16_t, uint16_t, 64> map(entries);
+    ASSERT_TRUE(map.valid());
+    for (uint16_t i = 0; i < 64; ++i) {
+        ASSERT_EQ(i, *map.find(static_cast<uint16_t>(i * 37)));
+    }
+    ASSERT_FALSE(map.contains(1));
+}
+
+TEST(perfect_hash_map_test, test_static_string_hash_matches_string_hash) {
+    StaticString<16> key("reset");
+    ASSERT_EQ(hash_string<uint32_t>("reset"), (hash_static_string<uint32_t, 16>(key)));
+    ASSERT_TRUE(commands.contains(key.c_str()));
+}
+
+TEST_F(no_alloc_test, test_perfect_hash_map_lookup_does_not_allocate) {
+    ASSERT_EQ(0u, count_allocations([]() {
+        commands.find("start");
+        parameters.find(300);
+    }));
+}
@@ -0,0 +1,147 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "stl/SnapshotMap.h"
+
+#include "../no_alloc_fixture.h"
+
+using namespace wlp;
+
+typedef SnapshotHashMap<uint16_t, uint32_t> int_map;
+
+static constexpr uint16_t NUM_KEYS = 64;
+static constexpr uint32_t NUM_UPDATES = 200;
+
+TEST(snapshot_map_test, test_update_publishes_new_version) {
+    int_map map;
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(nullptr, map.find(1));
+    map.insert_or_assign(1, 10);
+    map.insert_or_assign(2, 20);
+    ASSERT_EQ(10u, *map.find(1));
+    ASSERT_EQ(2u, map.size());
+    map.update([](int_map::version_type &version) {
+        version[1] = 11;
+        version.erase(2);
+        version[3] = 30;
+    });
+    ASSERT_EQ(11u, *map.find(1));
+    ASSERT_FALSE(map.contains(2));
+    ASSERT_EQ(30u, *map.find(3));
+    map.erase(1);
+    ASSERT_FALSE(map.contains(1));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST(snapshot_map_test, test_snapshot_is_immutable) {
+    int_map map;
+    map.insert_or_assign(1, 10);
+    int_map::reader_type *reader = map.register_reader();
+    ASSERT_NE(nullptr, reader);
+    const int_map::version_type &before = map.snapshot();
+    const uint32_t *val = map.find(1);
+    map.offline(reader);
+    // a reader that is offline is not waited for, so keep the
+    // references from before only to check that the version changed
+    map.insert_or_assign(1, 11);
+    map.online(reader);
+    ASSERT_NE(&before, &map.snapshot());
+    ASSERT_NE(val, map.find(1));
+    ASSERT_EQ(11u, *map.find(1));
+    map.unregister_reader(reader);
+}
+
+TEST(snapshot_map_test, test_register_readers) {
+    SnapshotHashMap<uint16_t, uint32_t, Hash<uint16_t, size_type>, Equal<uint16_t>, 2> map;
+    SnapshotReader *a = map.register_reader();
+    SnapshotReader *b = map.register_reader();
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    ASSERT_EQ(nullptr, map.register_reader());
+    map.unregister_reader(a);
+    ASSERT_EQ(a, map.register_reader());
+    map.unregister_reader(a);
+    map.unregister_reader(b);
+}
+
+TEST(snapshot_map_test, test_readers_see_consistent_snapshots) {
+    int_map map(128, 75);
+    map.update([](int_map::version_type &version) {
+        for (uint16_t key = 0; key < NUM_KEYS; ++key) {
+            version[key] = 0;
+        }
+    });
+    bool done = false;
+    uint32_t torn[2] = {0, 0};
+    uint32_t last_seen[2] = {0, 0};
+    std::vector<std::thread> readers;
+    for (uint32_t r = 0; r < 2; ++r) {
+        readers.emplace_back([&, r]() {
+            int_map::reader_type *reader = map.register_reader();
+            while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                // every key of one snapshot holds the same value
+                const int_map::version_type &version = map.snapshot();
+                uint32_t first = *version.find(0);
+                for (uint16_t key = 1; key < NUM_KEYS; ++key) {
+                    torn[r] += *version.find(key) != first;
+                }
+                if (first < last_seen[r]) {
+                    ++torn[r];
+                }
+                last_seen[r] = first;
+                map.quiescent(reader);
+            }
+            map.unregister_reader(reader);
+        });
+    }
+    for (uint32_t i = 1; i <= NUM_UPDATES; ++i) {
+        map.update([i](int_map::version_type &version) {
+            for (uint16_t key = 0; key < NUM_KEYS; ++key) {
+                version[key] = i;
+            }
+        });
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(0u, torn[0]);
+    ASSERT_EQ(0u, torn[1]);
+    ASSERT_EQ(NUM_UPDATES, *map.find(NUM_KEYS - 1));
+}
+
+TEST(snapshot_map_test, test_updates_alongside_concurrent_map_growth) {
+    // both maps allocate from the same pools while the other is writing
+    int_map map;
+    ConcurrentHashMap<uint32_t, uint32_t> shared;
+    std::thread writer([&]() {
+        for (uint32_t key = 0; key < 4000; ++key) {
+            shared.insert(key, key);
+        }
+    });
+    for (uint32_t i = 1; i <= NUM_UPDATES; ++i) {
+        map.insert_or_assign(static_cast<uint16_t>(i % NUM_KEYS), i);
+    }
+    writer.join();
+    ASSERT_EQ(4000u, shared.size());
+    for (uint32_t key = 0; key < 4000; ++key) {
+        uint32_t val = 0;
+        ASSERT_TRUE(shared.find(key, val));
+        ASSERT_EQ(key, val);
+    }
+    ASSERT_EQ(NUM_KEYS, map.size());
+    ASSERT_EQ(NUM_UPDATES, *map.find(NUM_UPDATES % NUM_KEYS));
+}
+
+TEST_F(no_alloc_test, test_snapshot_map_lookup_does_not_allocate) {
+    int_map map;
+    map.insert_or_assign(4, 40);
+    int_map::reader_type *reader = map.register_reader();
+    ASSERT_EQ(0u, count_allocations([&]() {
+        map.find(4);
+        map.contains(5);
+        map.quiescent(reader);
+    }));
+    map.unregister_reader(reader);
+}
@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include "stl/StaticOpenMap.h"
+
+#include "../no_alloc_fixture.h"
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef StaticString<16> string16;
+typedef StaticOpenHashMap<string16, string16, 8> string_map;
+typedef StaticOpenHashMap<uint16_t, uint16_t, 12> int_map;
+typedef int_map::iterator smi;
+typedef Pair<smi, bool> P_smi_b;
+
+static_assert(int_map::capacity() == 16, "12 elements fit in 16 slots at 75% load");
+
+static int_map global_map;
+
+TEST(static_open_map_test, test_capacity_is_power_of_two) {
+    ASSERT_EQ(2u, (StaticOpenHashMap<uint16_t, uint16_t, 1>::capacity()));
+    ASSERT_EQ(4u, (StaticOpenHashMap<uint16_t, uint16_t, 3>::capacity()));
+    ASSERT_EQ(16u, (StaticOpenHashMap<uint16_t, uint16_t, 12>::capacity()));
+    ASSERT_EQ(32u, (StaticOpenHashMap<uint16_t, uint16_t, 13>::capacity()));
+    ASSERT_EQ(12u, int_map::max_size());
+}
+
+TEST(static_open_map_test, test_global_map) {
+    ASSERT_TRUE(global_map.empty());
+    ASSERT_EQ(global_map.begin(), global_map.end());
+    global_map[7] = 70;
+    ASSERT_EQ(70, *global_map.find(7));
+    global_map.clear();
+    ASSERT_TRUE(global_map.empty());
+    ASSERT_FALSE(global_map.contains(7));
+}
+
+TEST(static_open_map_test, test_insert_find_iterate_integer) {
+    int_map map;
+    P_smi_b res1 = map.insert(0, 15);
+    P_smi_b res2 = map.insert(1, 20);
+    P_smi_b res3 = map.insert(0, 35);
+    P_smi_b res4 = map.insert(9, 90);
+    ASSERT_TRUE(res1.second());
+    ASSERT_TRUE(res2.second());
+    ASSERT_FALSE(res3.second());
+    ASSERT_TRUE(res4.second());
+    ASSERT_EQ(res1.first(), res3.first());
+    ASSERT_EQ(15, *map.find(0));
+    ASSERT_EQ(90, *map.at(9));
+    ASSERT_EQ(map.end(), map.find(30));
+    uint16_t sum = 0;
+    uint16_t count = 0;
+    for (smi it = map.begin(); it != map.end(); ++it) {
+        sum = static_cast<uint16_t>(sum + *it);
+        ++count;
+    }
+    ASSERT_EQ(3, count);
+    ASSERT_EQ(125, sum);
+    const int_map &const_map = map;
+    ASSERT_EQ(20, *const_map.find(1));
+    ASSERT_EQ(const_map.end(), const_map.at(2));
+}
+
+struct static_open_wide_hash {
+    uint64_t operator()(uint16_t key) const {
+        return static_cast<uint64_t>(key) << 32;
+    }
+};
+
+TEST(static_open_map_test, test_wide_hash_codes) {
+    // the hash codes differ only in their high word
+    StaticOpenHashMap<uint16_t, uint16_t, 12, static_open_wide_hash, Equal<uint16_t>> map;
+    for (uint16_t i = 0; i < 12; ++i) {
+        ASSERT_TRUE(map.insert(i, static_cast<uint16_t>(i * 2)).second());
+    }
+    for (uint16_t i = 0; i < 12; ++i) {
+        ASSERT_EQ(i * 2, *map.find(i));
+    }
+    ASSERT_FALSE(map.contains(12));
+}
+
+TEST(static_open_map_test, test_fails_fast_when_full) {
+    int_map map;
+    for (uint16_t i = 0; i < 12; ++i) {
+        ASSERT_TRUE(map.insert(i, i).second());
+    }
+    ASSERT_TRUE(map.full());
+    P_smi_b res = map.insert(100, 1);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(map.end(), res.first());
+    ASSERT_EQ(map.end(), map.insert_or_assign(100, 1).first());
+    ASSERT_FALSE(map.contains(100));
+    res = map.insert(5, 55);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(5, *res.first());
+    ASSERT_FALSE(map.insert_or_assign(5, 55).second());
+    ASSERT_EQ(55, *map.find(5));
+    map[101] = 1;
+    ASSERT_FALSE(map.contains(101));
+    ASSERT_EQ(12u, map.size());
+    uint16_t k = 3;
+    ASSERT_TRUE(map.erase(k));
+    ASSERT_FALSE(map.full());
+    ASSERT_TRUE(map.insert(100, 1).second());
+    for (uint16_t i = 0; i < 12; ++i) {
+        ASSERT_EQ(i != 3, map.contains(i));
+    }
+}
+
+TEST(static_open_map_test, test_erase_keeps_probe_sequences) {
+    int_map map;
+    for (uint16_t i = 0; i < 12; ++i) {
+        map[static_cast<uint16_t>(i * 16)] = i;
+    }
+    for (uint16_t i = 0; i < 12; i += 2) {
+        uint16_t k = static_cast<uint16_t>(i * 16);
+        ASSERT_TRUE(map.erase(k));
+        ASSERT_FALSE(map.erase(k));
+    }
+    ASSERT_EQ(6u, map.size());
+    for (uint16_t i = 0; i < 12; ++i) {
+        smi it = map.find(static_cast<uint16_t>(i * 16));
+        if (i % 2) {
+            ASSERT_EQ(i, *it);
+        } else {
+            ASSERT_EQ(map.end(), it);
+        }
+    }
+}
+
+TEST(static_open_map_test, test_erase_iterator) {
+    int_map map;
+    for (uint16_t i = 0; i < 10; ++i) {
+        map[i] = i;
+    }
+    int_map::iterator invalid;
+    ASSERT_EQ(map.end(), map.erase(invalid));
+    uint16_t seen = 0;
+    for (smi cur = map.begin(); cur != map.end(); cur = map.erase(cur)) {
+        ++seen;
+    }
+    ASSERT_EQ(10, seen);
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(static_open_map_test, test_copy) {
+    int_map map;
+    map[1] = 10;
+    map[2] = 20;
+    int_map copy(map);
+    map[1] = 11;
+    ASSERT_EQ(10, copy[1]);
+    ASSERT_EQ(20, copy[2]);
+    ASSERT_EQ(2u, copy.size());
+    copy = map;
+    ASSERT_EQ(11, copy[1]);
+}
+
+TEST(static_open_map_test, test_string_keys) {
+    string_map map;
+    string16 key1{"moshi"};
+    string16 key2{"welcome"};
+    string16 val1{"someval"};
+    string16 val2{"anotherval"};
+    ASSERT_TRUE(map.insert(key1, val1).second());
+    ASSERT_TRUE(map.insert(key2, val2).second());
+    ASSERT_TRUE(map.contains(key1));
+    ASSERT_EQ(val2, *map.at(key2));
+    ASSERT_TRUE(map.erase(key1));
+    ASSERT_FALSE(map.contains(key1));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST_F(no_alloc_test, test_static_open_map_does_not_allocate) {
+    ASSERT_EQ(0u, count_allocations([]() {
+        int_map map;
+        for (uint16_t i = 0; i < 20; ++i) {
+            map.insert(i, i);
+        }
+        map.erase(static_cast<uint16_t>(4));
+        map.clear();
+    }));
+}
@@ -0,0 +1,250 @@
+#include "gtest/gtest.h"
+#include "stl/SwissMap.h"
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef StaticString<16> string16;
+typedef SwissHashMap<string16, string16> string_map;
+typedef SwissHashMap<uint16_t, uint16_t> int_map;
+typedef int_map::iterator smi;
+typedef Pair<smi, bool> P_smi_b;
+
+TEST(swiss_map_test, test_group_matches) {
+    uint8_t ctrl[16];
+    for (uint8_t i = 0; i < 16; ++i) {
+        ctrl[i] = SwissHashMapControl::EMPTY;
+    }
+    ctrl[0] = 0x11;
+    ctrl[1] = 0x12;
+    ctrl[5] = 0x11;
+    ctrl[9] = SwissHashMapControl::DELETED;
+    ctrl[15] = 0x11;
+    SwissGroupPortable portable(ctrl);
+    SwissGroup group(ctrl);
+    ASSERT_EQ(0x8021u, group.match(0x11));
+    ASSERT_EQ(0x0002u, group.match(0x12));
+    ASSERT_EQ(0x7ddcu, group.match_empty());
+    ASSERT_EQ(0x7fdcu, group.match_empty_or_deleted());
+    ASSERT_EQ(0x8021u, portable.match(0x11) & 0x8021u);
+    ASSERT_EQ(0x0002u, portable.match(0x12) & ~0x0004u);
+    ASSERT_EQ(0x7ddcu, portable.match_empty());
+    ASSERT_EQ(0x7fdcu, portable.match_empty_or_deleted());
+}
+
+TEST(swiss_map_test, test_portable_group_agrees_after_key_check) {
+    uint8_t ctrl[16];
+    for (uint32_t seed = 1; seed < 200; ++seed) {
+        uint32_t x = seed;
+        for (uint8_t i = 0; i < 16; ++i) {
+            x = x * 1103515245u + 12345u;
+            uint8_t r = static_cast<uint8_t>(x >> 24);
+            ctrl[i] = r < 32 ? SwissHashMapControl::EMPTY : r < 48 ? SwissHashMapControl::DELETED : (r & 0x03);
+        }
+        SwissGroupPortable portable(ctrl);
+        SwissGroup group(ctrl);
+        for (uint8_t tag = 0; tag < 4; ++tag) {
+            uint32_t exact = 0;
+            for (uint32_t m = portable.match(tag); m; m &= m - 1) {
+                uint8_t i = static_cast<uint8_t>(__builtin_ctz(m));
+                if (ctrl[i] == tag) {
+                    exact |= 1u << i;
+                }
+            }
+            ASSERT_EQ(group.match(tag), exact);
+        }
+        ASSERT_EQ(group.match_empty(), portable.match_empty());
+        ASSERT_EQ(group.match_empty_or_deleted(), portable.match_empty_or_deleted());
+    }
+}
+
+TEST(swiss_map_test, test_constructor_parameters) {
+    int_map map(15, 61);
+    ASSERT_EQ(16u, map.capacity());
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(61, map.max_load());
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+    int_map small(2);
+    ASSERT_EQ(16u, small.capacity());
+    ASSERT_EQ(87, small.max_load());
+    int_map large(100);
+    ASSERT_EQ(128u, large.capacity());
+}
+
+TEST(swiss_map_test, test_insert_find_integer) {
+    int_map map(16, 75);
+    P_smi_b res1 = map.insert(0, 15);
+    P_smi_b res2 = map.insert(1, 20);
+    P_smi_b res3 = map.insert(0, 35);
+    P_smi_b res4 = map.insert(9, 90);
+    ASSERT_TRUE(res1.second());
+    ASSERT_TRUE(res2.second());
+    ASSERT_FALSE(res3.second());
+    ASSERT_TRUE(res4.second());
+    ASSERT_EQ(res1.first(), res3.first());
+    ASSERT_EQ(15, *map.find(0));
+    ASSERT_EQ(20, *map.at(1));
+    ASSERT_EQ(map.end(), map.find(30));
+    ASSERT_FALSE(map.contains(30));
+    ASSERT_EQ(3u, map.size());
+    uint16_t sum = 0;
+    for (smi it = map.begin(); it != map.end(); ++it) {
+        sum = static_cast<uint16_t>(sum + *it);
+    }
+    ASSERT_EQ(125, sum);
+}
+
+struct swiss_wide_hash {
+    uint64_t operator()(uint16_t key) const {
+        return static_cast<uint64_t>(key) << 32;
+    }
+};
+
+TEST(swiss_map_test, test_wide_hash_codes) {
+    // the hash codes differ only in their high word
+    SwissHashMap<uint16_t, uint16_t, swiss_wide_hash, Equal<uint16_t>> map(16, 75);
+    for (uint16_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(map.insert(i, static_cast<uint16_t>(i * 2)).second());
+    }
+    for (uint16_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(i * 2, *map.find(i));
+    }
+    ASSERT_FALSE(map.contains(100));
+}
+
+TEST(swiss_map_test, test_access_operator_and_assign) {
+    int_map map;
+    map.insert(5, 100);
+    map[5] = 19;
+    map[10] = 14;
+    map[556] = 9901;
+    ASSERT_EQ(19, map[5]);
+    ASSERT_EQ(14, map[10]);
+    ASSERT_EQ(9901, map[556]);
+    ASSERT_FALSE(map.insert_or_assign(10, 15).second());
+    ASSERT_TRUE(map.insert_or_assign(11, 16).second());
+    ASSERT_EQ(15, map[10]);
+    ASSERT_EQ(4u, map.size());
+}
+
+TEST(swiss_map_test, test_rehash_keeps_elements) {
+    int_map map(16, 75);
+    for (uint16_t i = 0; i < 500; ++i) {
+        map[static_cast<uint16_t>(i * 64)] = i;
+    }
+    ASSERT_EQ(500u, map.size());
+    ASSERT_EQ(1024u, map.capacity());
+    for (uint16_t i = 0; i < 500; ++i) {
+        ASSERT_EQ(i, *map.find(static_cast<uint16_t>(i * 64)));
+    }
+    ASSERT_FALSE(map.contains(1));
+}
+
+TEST(swiss_map_test, test_full_load_keeps_an_empty_slot) {
+    int_map map(16, 100);
+    for (uint16_t i = 0; i < 15; ++i) {
+        map[i] = i;
+    }
+    ASSERT_EQ(16u, map.capacity());
+    map[15] = 15;
+    ASSERT_EQ(32u, map.capacity());
+    ASSERT_FALSE(map.contains(16));
+}
+
+TEST(swiss_map_test, test_growth_stops_at_the_size_type) {
+    // with a 16-bit size type the slots for these keys do not fit in one
+    // block, so the map stops growing and reports itself full instead
+    SwissHashMap<uint32_t, uint32_t> map;
+    uint32_t num_inserted = 0;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        if (map.insert(i, i).second()) {
+            ++num_inserted;
+        }
+    }
+    ASSERT_EQ(num_inserted, map.size());
+    if (num_inserted < 5000) {
+        ASSERT_EQ(map.size() + 1u, map.capacity());
+    }
+    for (uint32_t i = 0; i < num_inserted; ++i) {
+        ASSERT_EQ(i, *map.find(i));
+    }
+}
+
+TEST(swiss_map_test, test_erase_and_reuse) {
+    int_map map(64, 90);
+    for (uint16_t i = 0; i < 50; ++i) {
+        map[i] = i;
+    }
+    for (uint16_t i = 0; i < 50; i = static_cast<uint16_t>(i + 2)) {
+        ASSERT_TRUE(map.erase(i));
+        ASSERT_FALSE(map.erase(i));
+    }
+    ASSERT_EQ(25u, map.size());
+    for (uint16_t round = 0; round < 20; ++round) {
+        for (uint16_t i = 100; i < 125; ++i) {
+            ASSERT_TRUE(map.insert(i, i).second());
+        }
+        for (uint16_t i = 100; i < 125; ++i) {
+            ASSERT_TRUE(map.erase(i));
+        }
+    }
+    ASSERT_EQ(64u, map.capacity());
+    for (uint16_t i = 0; i < 50; ++i) {
+        ASSERT_EQ(i % 2 == 1, map.contains(i));
+    }
+}
+
+TEST(swiss_map_test, test_erase_iterator) {
+    int_map map;
+    for (uint16_t i = 0; i < 10; ++i) {
+        map[i] = i;
+    }
+    int_map::iterator invalid;
+    ASSERT_EQ(map.end(), map.erase(invalid));
+    uint16_t seen = 0;
+    for (smi cur = map.begin(); cur != map.end(); cur = map.erase(cur)) {
+        ++seen;
+    }
+    ASSERT_EQ(10, seen);
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(swiss_map_test, test_string_keys) {
+    string_map map;
+    string16 key1{"moshi"};
+    string16 key2{"welcome"};
+    string16 val1{"someval"};
+    string16 val2{"anotherval"};
+    ASSERT_TRUE(map.insert(key1, val1).second());
+    ASSERT_TRUE(map.insert(key2, val2).second());
+    ASSERT_TRUE(map.contains(key1));
+    ASSERT_EQ(val2, *map.at(key2));
+    ASSERT_TRUE(map.erase(key1));
+    ASSERT_FALSE(map.contains(key1));
+    ASSERT_EQ(1u, map.size());
+}
+
+TEST(swiss_map_test, test_move_and_clear) {
+    int_map map;
+    map[8] = 80;
+    map[18] = 180;
+    int_map map1(32, 91);
+    map1 = move(map);
+    ASSERT_EQ(0u, map.size());
+    ASSERT_EQ(0u, map.capacity());
+    ASSERT_EQ(2u, map1.size());
+    const int_map map2(move(map1));
+    ASSERT_EQ(180, *map2.find(18));
+    uint16_t count = 0;
+    for (int_map::const_iterator it = map2.begin(); it != map2.end(); it++) {
+        ++count;
+    }
+    ASSERT_EQ(2, count);
+    int_map map3(move(const_cast<int_map &>(map2)));
+    map3.clear();
+    ASSERT_EQ(0u, map3.size());
+    ASSERT_EQ(16u, map3.capacity());
+    ASSERT_EQ(map3.begin(), map3.end());
+}
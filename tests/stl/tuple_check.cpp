@@ -36,16 +36,16 @@ TEST(tuple_test, test_make_tuple) {
 
 TEST(tuple_test, test_tuple_size) {
     auto tuple = make_tuple(1, 2, 3, 4, 5, 6);
-    ASSERT_EQ(6, get_tuple_size(tuple));
-    ASSERT_EQ(6, tuple_size<decltype(tuple)>::value);
+    ASSERT_EQ(6u, get_tuple_size(tuple));
+    ASSERT_EQ(6u, tuple_size<decltype(tuple)>::value);
 }
 
 TEST(tuple_test, test_tuple_cat) {
     auto tupleA = make_tuple(45, 65.55, "hello");
     auto tupleB = make_tuple(77.886, "goodbye", 23);
     auto tuple = tuple_cat_pair(tupleA, tupleB);
-    ASSERT_EQ(6, tuple_size<decltype(tuple)>::value);
-    ASSERT_EQ(6, get_tuple_size(tuple));
+    ASSERT_EQ(6u, tuple_size<decltype(tuple)>::value);
+    ASSERT_EQ(6u, get_tuple_size(tuple));
     ASSERT_EQ(45, get<0>(tuple));
     ASSERT_DOUBLE_EQ(65.55, get<1>(tuple));
     ASSERT_STREQ("hello", get<2>(tuple));
@@ -59,7 +59,7 @@ TEST(tuple_test, test_tuple_multi_cat) {
     auto tupleB = make_tuple(56.65, 43.32);
     auto tupleC = make_tuple("string", "string");
     auto tuple = tuple_cat(tupleA, tupleB, tupleC);
-    ASSERT_EQ(5, tuple_size<decltype(tuple)>::value);
+    ASSERT_EQ(5u, tuple_size<decltype(tuple)>::value);
     ASSERT_EQ(1, get<0>(tuple));
     ASSERT_DOUBLE_EQ(56.65, get<1>(tuple));
     ASSERT_DOUBLE_EQ(43.32, get<2>(tuple));
@@ -6,7 +6,12 @@
 #include "stl/Utility.h"
 #include "stl/ChainMap.h"
 #include "stl/OpenMap.h"
+#include "stl/FlatMap.h"
+#include "stl/SwissMap.h"
+#include "stl/StaticOpenMap.h"
 #include "stl/ArrayHeap.h"
+#include "stl/BTreeMap.h"
+#include "stl/LRUCache.h"
 
 namespace wlp {
     template
@@ -107,6 +112,83 @@ namespace wlp {
             Hash<uint16_t, uint16_t>,
             Equal<uint16_t>>;
 
+    template
+    class FlatHashMap<StaticString<16>, StaticString<16>>;
+
+    template
+    class FlatHashMap<uint16_t, uint16_t>;
+
+    template
+    struct FlatHashMapIterator<
+            uint16_t,
+            uint16_t,
+            Hash<uint16_t, uint16_t>,
+            Equal<uint16_t>>;
+
+    template
+    struct FlatHashMapConstIterator<
+            uint16_t,
+            uint16_t,
+            Hash<uint16_t, uint16_t>,
+            Equal<uint16_t>>;
+
+    template
+    class SwissHashMap<StaticString<16>, StaticString<16>>;
+
+    template
+    class SwissHashMap<uint16_t, uint16_t>;
+
+    template
+    struct SwissHashMapIterator<
+            uint16_t,
+            uint16_t,
+            Hash<uint16_t, uint16_t>,
+            Equal<uint16_t>>;
+
+    template
+    struct SwissHashMapConstIterator<
+            uint16_t,
+            uint16_t,
+            Hash<uint16_t, uint16_t>,
+            Equal<uint16_t>>;
+
+    template
+    class StaticOpenHashMap<uint16_t, uint16_t, 12>;
+
+    template
+    struct StaticOpenHashMapIterator<
+            uint16_t,
+            uint16_t,
+            12,
+            Hash<uint16_t, size_type>,
+            Equal<uint16_t>>;
+
+    template
+    struct StaticOpenHashMapConstIterator<
+            uint16_t,
+            uint16_t,
+            12,
+            Hash<uint16_t, size_type>,
+            Equal<uint16_t>>;
+
+    template
+    class BTreeMap<StaticString<16>, StaticString<16>>;
+
+    template
+    class BTreeMap<uint16_t, uint16_t>;
+
+    template
+    struct BTreeMapIterator<uint16_t, uint16_t>;
+
+    template
+    struct BTreeMapConstIterator<uint16_t, uint16_t>;
+
+    template
+    class LRUCache<StaticString<16>, StaticString<16>, 8>;
+
+    template
+    class LRUCache<uint16_t, uint16_t, 8>;
+
     template
     class ArrayHeap<int>;
 
@@ -0,0 +1,68 @@
+#ifndef TRACKED_VALUE_H
+#define TRACKED_VALUE_H
+
+#include "Types.h"
+
+/**
+ * Copy and move counters of tracked_value. They live in a class template
+ * so that the header can define them for every test that includes it.
+ */
+template<typename Tag>
+struct tracked_counts {
+    static uint16_t copies;
+    static uint16_t moves;
+
+    /**
+     * Sets both counters back to zero
+     */
+    static void reset() {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+template<typename Tag>
+uint16_t tracked_counts<Tag>::copies = 0;
+
+template<typename Tag>
+uint16_t tracked_counts<Tag>::moves = 0;
+
+/**
+ * Map value that counts how often it is copied and moved, for asserting
+ * that a container builds its values in place. A moved-from value has
+ * its first member cleared.
+ */
+struct tracked_value : tracked_counts<void> {
+    uint16_t a;
+    uint16_t b;
+
+    tracked_value() : a(0), b(0) {}
+
+    tracked_value(uint16_t a, uint16_t b) : a(a), b(b) {}
+
+    tracked_value(const tracked_value &v) : a(v.a), b(v.b) {
+        ++copies;
+    }
+
+    tracked_value(tracked_value &&v) : a(v.a), b(v.b) {
+        ++moves;
+        v.a = 0;
+    }
+
+    tracked_value &operator=(const tracked_value &v) {
+        ++copies;
+        a = v.a;
+        b = v.b;
+        return *this;
+    }
+
+    tracked_value &operator=(tracked_value &&v) {
+        ++moves;
+        a = v.a;
+        b = v.b;
+        v.a = 0;
+        return *this;
+    }
+};
+
+#endif //TRACKED_VALUE_H